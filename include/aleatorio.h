@@ -0,0 +1,50 @@
+#ifndef ALEATORIO_H
+#define ALEATORIO_H
+
+#include <cstdint>
+
+/**
+ * @brief Gerador de números aleatórios do Diamond-Square, com salto adiante.
+ *
+ * @details Reproduz exatamente a sequência de srand()/rand() da glibc (gerador aditivo
+ * com atraso, r[i] = r[i - 3] + r[i - 31] módulo 2^32, saída r[i] >> 1), então cada
+ * semente continua gerando o mesmo terreno de antes. Ao contrário de rand(), o estado não
+ * é global: vários geradores com a mesma semente podem ler trechos diferentes da mesma
+ * sequência, e avancar() pula n valores em O(log n) (potência de x módulo o polinômio da
+ * recorrência), sem gerar os valores do meio.
+ */
+class GeradorAleatorio {
+public:
+    // Maior valor devolvido por proximo() (o RAND_MAX da glibc)
+    static constexpr int32_t MAXIMO = 2147483647;
+
+    /**
+     * @brief Inicializa o gerador como srand(semente).
+     * @param semente Semente (0 equivale a 1, como na glibc).
+     */
+    explicit GeradorAleatorio(uint32_t semente);
+
+    /**
+     * @brief Próximo valor da sequência, como rand().
+     * @return Inteiro em [0, MAXIMO].
+     */
+    int32_t proximo() {
+        uint32_t valor = estado[frente] += estado[tras];
+        frente = frente + 1 == GRAU ? 0 : frente + 1;
+        tras = tras + 1 == GRAU ? 0 : tras + 1;
+        return static_cast<int32_t>(valor >> 1);
+    }
+
+    /**
+     * @brief Pula valores da sequência, como chamar proximo() n vezes.
+     * @param n Quantidade de valores pulados.
+     */
+    void avancar(uint64_t n);
+
+private:
+    static const unsigned GRAU = 31;  // Atraso maior da recorrência (o menor é 3)
+    uint32_t estado[GRAU];
+    unsigned frente, tras;            // Posições de r[i - 31] (trocado por r[i]) e de r[i - 3]
+};
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef ANALISE_TERRENO_H
+#define ANALISE_TERRENO_H
+
+#include <cstddef>
+#include <vector>
+#include "imagem.h"
+#include "paleta.h"
+#include "renderizacao.h"
+
+/**
+ * @brief Declividade, orientação e curvatura de cada ponto, numa única passada pelo mapa.
+ *
+ * @details As três saídas vêm da mesma vizinhança 3×3, que é lida uma vez só: o gradiente
+ * sai do operador de Sobel (o mesmo do sombreamento de relevo) e a curvatura das diferenças
+ * segundas nos dois eixos. As linhas são divididas em faixas paralelas, e cada linha passa
+ * por um núcleo escalar, SSE4.1 (4 pontos por iteração) ou AVX2 (8 pontos) que produzem os
+ * mesmos bits: as diferenças são feitas em double, o resto em float, e os ângulos saem de
+ * um polinômio próprio (o mesmo nas três versões), não da atan da biblioteca. Na borda do
+ * mapa a vizinhança repete a própria borda, como no relevo.
+ */
+
+// Orientação dos pontos planos, onde a encosta não desce para lado nenhum
+static const float ORIENTACAO_PLANO = -1.0f;
+
+/**
+ * @brief Passos de quantização das saídas (0 = valor contínuo).
+ * @details Cada valor é arredondado para baixo ao múltiplo do passo (ex: declividade de 5 em
+ * 5 graus e orientação de 45 em 45, para classes de bioma), dentro da mesma passada.
+ */
+struct QuantizacaoAnalise {
+    float declividade;  // Em graus
+    float orientacao;   // Em graus
+    float curvatura;    // Na unidade da curvatura (1 / lado do mapa)
+
+    QuantizacaoAnalise() : declividade(0.0f), orientacao(0.0f), curvatura(0.0f) {}
+};
+
+/**
+ * @brief Escalas e passos da análise, pré-calculados para um mapa.
+ */
+struct ParametrosAnalise {
+    double escalaGradiente;  // Converte a soma de Sobel em inclinação (dz/dx), como no relevo
+    double escalaCurvatura;  // Converte a diferença segunda em curvatura, em 1 / lado do mapa
+    QuantizacaoAnalise passos;
+
+    /**
+     * @brief Prepara a análise para um mapa com o lado dado.
+     * @param exagero Multiplicador vertical (1 = o lado do mapa mede 4× a faixa de altitudes).
+     * @param ladoMapa Pontos por lado do mapa.
+     * @param quantizacao Passos de quantização das saídas.
+     */
+    ParametrosAnalise(double exagero, size_t ladoMapa, const QuantizacaoAnalise& quantizacao = QuantizacaoAnalise());
+};
+
+/**
+ * @brief Rasters da análise do terreno, um valor por ponto (lado × lado, linha a linha).
+ */
+struct AnaliseTerreno {
+    size_t lado;
+    std::vector<float> declividade;  // Graus: 0 = plano, 90 = vertical
+    std::vector<float> orientacao;   // Para onde a encosta desce, em graus horários a partir do
+                                     // norte, em [0, 360); ORIENTACAO_PLANO nos pontos planos
+    std::vector<float> curvatura;    // Menos o laplaciano, em 1 / lado do mapa: > 0 em cristas
+                                     // e picos, < 0 em vales (uma calota de raio r lados dá ~2 / r)
+
+    AnaliseTerreno() : lado(0) {}
+};
+
+/**
+ * @brief Analisa as colunas [colInicio, colFim) de uma linha do mapa.
+ * @param parametros Escalas e passos pré-calculados.
+ * @param linhaAcima Linha anterior (na primeira linha, a própria linha).
+ * @param linha Linha do mapa.
+ * @param linhaAbaixo Linha seguinte (na última linha, a própria linha).
+ * @param largura Pontos por linha do mapa.
+ * @param colInicio Primeira coluna.
+ * @param colFim Coluna logo após a última.
+ * @param declividade Recebe colFim - colInicio valores.
+ * @param orientacao Recebe colFim - colInicio valores.
+ * @param curvatura Recebe colFim - colInicio valores.
+ * @param nivel Conjunto de instruções (nunca acima de obterNivelSimd()).
+ */
+void analisarLinha(const ParametrosAnalise& parametros, const double* linhaAcima, const double* linha,
+                   const double* linhaAbaixo, size_t largura, size_t colInicio, size_t colFim, float* declividade,
+                   float* orientacao, float* curvatura, NivelSimd nivel = obterNivelSimd());
+
+/**
+ * @brief Analisa o mapa inteiro, em faixas de linhas paralelas.
+ * @details O resultado é o mesmo para qualquer número de threads.
+ * @param altitudes Mapa lado × lado, linha a linha.
+ * @param lado Pontos por lado do mapa.
+ * @param parametros Escalas e passos (ver ParametrosAnalise).
+ * @param declividade Recebe lado × lado valores.
+ * @param orientacao Recebe lado × lado valores.
+ * @param curvatura Recebe lado × lado valores.
+ */
+void analisarTerreno(const double* altitudes, size_t lado, const ParametrosAnalise& parametros, float* declividade,
+                     float* orientacao, float* curvatura);
+
+/**
+ * @brief Salva um raster como PGM binário (P5) de 16 bits.
+ * @details O intervalo [minimo, maximo] vira [0, 65535], com saturação (os mesmos núcleos de
+ * MapaAltitudes::salvarPGM).
+ * @param nomeArquivo Caminho do arquivo de destino.
+ * @param valores Raster lado × lado.
+ * @param lado Pontos por lado.
+ * @param minimo Valor que vira preto (0).
+ * @param maximo Valor que vira branco (65535).
+ * @return true se salvo com sucesso, false caso contrário.
+ */
+bool salvarRasterPGM(const char* nomeArquivo, const float* valores, size_t lado, double minimo, double maximo);
+
+/**
+ * @brief Colore um raster com uma paleta, como as altitudes em MapaAltitudes::gerarImagem.
+ * @details [minimo, maximo] vira a faixa [0, 1] da paleta (faixas, gradiente e posições
+ * personalizadas valem igual), em faixas de linhas paralelas pelo núcleo vetorial da
+ * renderização, sem sombreamento. Valores fora do intervalo ficam com a cor da ponta.
+ * @param valores Raster lado × lado.
+ * @param lado Pontos por lado.
+ * @param minimo Valor que recebe a primeira cor.
+ * @param maximo Valor que recebe a última cor.
+ * @param paleta Paleta de cores.
+ * @param layout Organização dos pixels da imagem.
+ * @return Imagem lado × lado.
+ */
+Imagem colorirRaster(const float* valores, size_t lado, double minimo, double maximo, const Paleta& paleta,
+                     LayoutImagem layout = LAYOUT_RGB24);
+
+#endif
@@ -0,0 +1,165 @@
+#ifndef ARQUIVO_IO_H
+#define ARQUIVO_IO_H
+
+#include <cstddef>
+
+/**
+ * @brief Arquivo de saída com escrita direta por chamadas de sistema (POSIX).
+ *
+ * @details Diferente do std::ofstream, não há buffer intermediário: cada chamada a
+ * escrever() vira (no máximo algumas) chamadas write(). A ideia é montar blocos grandes
+ * em memória e gravá-los de uma vez, em vez de enviar valor por valor ao stream.
+ * O arquivo é fechado automaticamente no destrutor.
+ */
+class ArquivoSaida {
+private:
+    int descritor;  // -1 quando não há arquivo aberto
+
+    // Não copiável (o descritor tem um único dono)
+    ArquivoSaida(const ArquivoSaida&);
+    ArquivoSaida& operator=(const ArquivoSaida&);
+
+public:
+    /**
+     * @brief Cria (ou trunca) o arquivo para escrita.
+     * @details Um arquivo existente com outros hard links é substituído por um novo, para
+     * não alterar o conteúdo visto pelos outros nomes.
+     * @param nomeArquivo Caminho do arquivo de destino.
+     */
+    explicit ArquivoSaida(const char* nomeArquivo);
+    /**
+     * @brief Destrutor. Fecha o arquivo se ainda estiver aberto.
+     */
+    ~ArquivoSaida();
+
+    /**
+     * @brief Indica se o arquivo foi aberto com sucesso.
+     * @return true se o arquivo está pronto para escrita.
+     */
+    bool aberto() const;
+    /**
+     * @brief Escreve um bloco inteiro de bytes.
+     * @details Repete write() até gravar tudo (write pode gravar apenas parte do bloco).
+     * @param dados Ponteiro para os bytes.
+     * @param tamanho Quantidade de bytes.
+     * @return true se todos os bytes foram gravados.
+     */
+    bool escrever(const void* dados, size_t tamanho);
+    /**
+     * @brief Escreve dois blocos em sequência com uma única chamada writev().
+     * @details Útil para gravar cabeçalho + dados sem copiar os dados para juntar os dois.
+     * @param dados1 Primeiro bloco (ex: cabeçalho).
+     * @param tamanho1 Tamanho do primeiro bloco.
+     * @param dados2 Segundo bloco (ex: pixels).
+     * @param tamanho2 Tamanho do segundo bloco.
+     * @return true se todos os bytes foram gravados.
+     */
+    bool escrever(const void* dados1, size_t tamanho1, const void* dados2, size_t tamanho2);
+    /**
+     * @brief Fecha o arquivo, reportando erros de gravação adiados pelo sistema.
+     * @return true se o arquivo foi fechado sem erros.
+     */
+    bool fechar();
+};
+
+/**
+ * @brief Arquivo de entrada mapeado em memória somente leitura (mmap).
+ *
+ * @details O conteúdo do arquivo fica acessível como um bloco contíguo de bytes sem
+ * nenhuma cópia para buffers do usuário: as páginas são carregadas sob demanda pelo
+ * sistema operacional. Útil para ler formatos binários grandes de uma só vez.
+ */
+class ArquivoMapeado {
+private:
+    const unsigned char* dados;  // nullptr quando não há arquivo mapeado (ou arquivo vazio)
+    size_t tamanho;
+    bool ok;                     // true se o arquivo foi aberto com sucesso
+
+    // Não copiável (o mapeamento tem um único dono)
+    ArquivoMapeado(const ArquivoMapeado&);
+    ArquivoMapeado& operator=(const ArquivoMapeado&);
+
+public:
+    /**
+     * @brief Mapeia o arquivo inteiro em memória.
+     * @param nomeArquivo Caminho do arquivo de origem.
+     */
+    explicit ArquivoMapeado(const char* nomeArquivo);
+    /**
+     * @brief Destrutor. Desfaz o mapeamento.
+     */
+    ~ArquivoMapeado();
+
+    /**
+     * @brief Indica se o arquivo foi aberto e mapeado com sucesso.
+     * @return true se os dados estão acessíveis (arquivo vazio conta como aberto).
+     */
+    bool aberto() const;
+    /**
+     * @brief Retorna o início do conteúdo do arquivo.
+     * @return Ponteiro para o primeiro byte (nullptr se vazio ou não aberto).
+     */
+    const unsigned char* obterDados() const;
+    /**
+     * @brief Retorna o tamanho do arquivo.
+     * @return Quantidade de bytes mapeados.
+     */
+    size_t obterTamanho() const;
+};
+
+/**
+ * @brief Arquivo de entrada com leitura posicional (pread), para acesso aleatório.
+ *
+ * @details Cada leitura informa a posição no arquivo, então não há cursor compartilhado:
+ * várias threads podem ler partes diferentes do mesmo arquivo ao mesmo tempo. Só os
+ * bytes pedidos são lidos, o que importa em arquivos muito maiores que a memória.
+ */
+class ArquivoEntrada {
+private:
+    int descritor;  // -1 quando não há arquivo aberto
+    size_t tamanho;
+
+    // Não copiável (o descritor tem um único dono)
+    ArquivoEntrada(const ArquivoEntrada&);
+    ArquivoEntrada& operator=(const ArquivoEntrada&);
+
+public:
+    /**
+     * @brief Abre o arquivo para leitura.
+     * @param nomeArquivo Caminho do arquivo de origem.
+     */
+    explicit ArquivoEntrada(const char* nomeArquivo);
+    /**
+     * @brief Destrutor. Fecha o arquivo.
+     */
+    ~ArquivoEntrada();
+
+    /**
+     * @brief Indica se o arquivo foi aberto com sucesso.
+     * @return true se o arquivo pode ser lido.
+     */
+    bool aberto() const;
+    /**
+     * @brief Retorna o tamanho do arquivo.
+     * @return Quantidade de bytes.
+     */
+    size_t obterTamanho() const;
+    /**
+     * @brief Lê um bloco a partir de uma posição, sem mover cursor algum (seguro entre threads).
+     * @details Repete pread() até ler tudo (pread pode ler apenas parte do bloco).
+     * @param destino Onde gravar os bytes.
+     * @param quantidade Quantidade de bytes.
+     * @param posicao Posição do primeiro byte no arquivo.
+     * @return true se todos os bytes foram lidos.
+     */
+    bool lerEm(void* destino, size_t quantidade, size_t posicao) const;
+};
+
+/**
+ * @brief Cria um diretório (um nível só, como mkdir).
+ * @param caminho Caminho do diretório.
+ * @return true se o diretório foi criado ou já existia.
+ */
+bool criarDiretorio(const char* caminho);
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef CACHE_RESULTADOS_H
+#define CACHE_RESULTADOS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Cache em disco de resultados já gerados, endereçado pelo conteúdo.
+ *
+ * @details Cada resultado (ex: a imagem final de um terreno) é guardado em um arquivo
+ * cujo nome é o hash de tudo o que determina o seu conteúdo (ver calcularChaveTerreno).
+ * Pedir de novo os mesmos parâmetros vira um hard link (ou uma cópia, se o link não for
+ * possível) em vez de uma execução completa.
+ *
+ * - Tamanho limitado: ao guardar, as entradas usadas há mais tempo são apagadas até o
+ *   total caber no limite (LRU). O "último uso" é a data de modificação do arquivo,
+ *   atualizada a cada acerto, então a ordem sobrevive entre execuções.
+ * - Contadores de acertos e falhas ficam no arquivo "contadores" do diretório, atualizados
+ *   com trava (flock), para acumular entre execuções e processos concorrentes.
+ */
+class CacheResultados {
+private:
+    std::string diretorio;
+    uint64_t limiteBytes;
+    bool ok;
+
+    std::string caminhoEntrada(const std::string& chave, const std::string& extensao) const;
+    void registrar(bool acerto);
+    void liberarEspaco(const std::string& preservar);
+
+public:
+    /**
+     * @brief Abre (criando, se preciso) o diretório do cache.
+     * @param diretorio Diretório do cache.
+     * @param limiteBytes Tamanho máximo somado das entradas.
+     */
+    CacheResultados(const char* diretorio, uint64_t limiteBytes);
+
+    /**
+     * @brief Indica se o diretório do cache está pronto para uso.
+     * @return true se o cache pode ser consultado.
+     */
+    bool aberto() const;
+    /**
+     * @brief Procura uma entrada e, se existir, a entrega em destino.
+     * @details Conta um acerto ou uma falha. No acerto, destino vira um hard link para a
+     * entrada (ou uma cópia, entre sistemas de arquivos diferentes) e a entrada passa a
+     * ser a usada mais recentemente.
+     * @param chave Chave da entrada (ex: calcularChaveTerreno).
+     * @param extensao Extensão da entrada (ex: ".png"), parte do nome do arquivo.
+     * @param destino Caminho onde o resultado deve aparecer.
+     * @return true em caso de acerto (destino pronto).
+     */
+    bool buscar(const std::string& chave, const std::string& extensao, const char* destino);
+    /**
+     * @brief Guarda uma cópia de um arquivo recém-gerado e aplica o limite de tamanho.
+     * @param chave Chave da entrada.
+     * @param extensao Extensão da entrada.
+     * @param origem Arquivo a guardar (não é alterado).
+     * @return true se a entrada foi gravada.
+     */
+    bool guardar(const std::string& chave, const std::string& extensao, const char* origem);
+
+    /**
+     * @brief Retorna o total de acertos registrados neste cache.
+     * @return Número de acertos.
+     */
+    uint64_t obterAcertos() const;
+    /**
+     * @brief Retorna o total de falhas registradas neste cache.
+     * @return Número de falhas.
+     */
+    uint64_t obterFalhas() const;
+};
+
+/**
+ * @brief Calcula a chave de cache de um terreno renderizado.
+ * @details Hash (FNV-1a de 64 bits) de todos os parâmetros que determinam a imagem,
+ * incluindo o conteúdo do arquivo da paleta (não só o nome) e uma versão do
+ * renderizador, que deve mudar sempre que a saída para os mesmos parâmetros mudar.
+ * @param N Expoente de tamanho.
+ * @param rugosidade Rugosidade do terreno.
+ * @param semente Semente do gerador.
+ * @param arquivoPaleta Caminho do arquivo da paleta.
+ * @param aplicarSombreamento Se o sombreamento está ativo.
+ * @param formato Descrição do formato de saída (ex: "png", "ppm-binario").
+ * @param estilo Descrição das demais opções de renderização (ex: "gradiente").
+ * @return Chave com 16 dígitos hexadecimais, ou vazia se a paleta não puder ser lida.
+ */
+std::string calcularChaveTerreno(int N, double rugosidade, unsigned int semente, const char* arquivoPaleta,
+                                 bool aplicarSombreamento, const char* formato, const char* estilo = "");
+
+#endif
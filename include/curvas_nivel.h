@@ -0,0 +1,95 @@
+#ifndef CURVAS_NIVEL_H
+#define CURVAS_NIVEL_H
+
+#include <cstddef>
+#include <vector>
+#include "imagem.h"
+
+/**
+ * @brief Curvas de nível (isolinhas) do mapa, por marching squares.
+ *
+ * @details Cada célula 2×2 de pontos vizinhos é classificada pelos cantos que estão
+ * acima ou abaixo de cada nível, e o trecho da curva que a atravessa liga pontos
+ * interpolados nas arestas (as células em sela são resolvidas pela média dos cantos).
+ * Antes das células, cada ponto recebe o índice do nível logo abaixo dele, então só os
+ * níveis que de fato passam por uma célula são visitados, mesmo com centenas de níveis.
+ * As faixas de linhas são processadas em paralelo: para desenhar, cada faixa pinta só as
+ * suas linhas de pixels; para os vetores, cada faixa emenda seus trechos em polilinhas, e
+ * as pontas que param na fronteira entre faixas são emendadas depois, na ordem das faixas.
+ * Coordenadas em unidades de ponto do mapa: x = coluna, y = linha (o centro do pixel).
+ */
+
+/**
+ * @brief Ponto de uma curva de nível.
+ */
+struct PontoCurva {
+    double x, y;
+};
+
+/**
+ * @brief Polilinha de uma curva de nível.
+ */
+struct CurvaNivel {
+    double altitude;
+    bool fechada;                     // Se fechada, o último ponto repete o primeiro
+    std::vector<PontoCurva> pontos;
+};
+
+/**
+ * @brief Níveis igualmente espaçados que cortam um conjunto de altitudes.
+ * @param altitudes Altitudes (ex: o mapa inteiro).
+ * @param numPontos Quantidade de altitudes.
+ * @param intervalo Distância entre níveis (> 0); os níveis são os múltiplos dela.
+ * @return Múltiplos de intervalo entre a menor e a maior altitude, em ordem crescente.
+ */
+std::vector<double> calcularNiveis(const double* altitudes, size_t numPontos, double intervalo);
+
+/**
+ * @brief Extrai as curvas de nível como polilinhas.
+ * @details As faixas têm altura fixa (não dependem do número de threads), então o
+ * resultado, incluindo a ordem das curvas e dos pontos, é o mesmo com qualquer número de
+ * threads. Curvas que chegam à borda do mapa ficam abertas.
+ * @param altitudes Mapa lado × lado, linha a linha.
+ * @param lado Pontos por lado do mapa.
+ * @param niveis Altitudes das curvas, em ordem crescente.
+ * @return Curvas de todos os níveis.
+ */
+std::vector<CurvaNivel> extrairCurvasNivel(const double* altitudes, size_t lado, const std::vector<double>& niveis);
+
+/**
+ * @brief Desenha as curvas de nível sobre a imagem do mapa (um pixel por ponto).
+ * @details Linhas de 1 pixel com antisserrilhado: a cobertura de cada pixel é a maior
+ * entre os trechos que passam perto dele (não depende da ordem), e a cor da curva é
+ * misturada à do pixel com essa cobertura vezes a opacidade. As faixas de linhas de
+ * pixels são desenhadas em paralelo, sem montar as polilinhas.
+ * @param altitudes Mapa lado × lado, linha a linha.
+ * @param lado Pontos por lado do mapa.
+ * @param niveis Altitudes das curvas, em ordem crescente.
+ * @param cor Cor das curvas.
+ * @param opacidade Opacidade das curvas, em [0, 1].
+ * @param linInicio Primeira linha de pixels desenhada.
+ * @param linFim Linha final (exclusiva).
+ * @param destino Vista cujo pixel (0, 0) é o da coluna 0 da linha linInicio, em qualquer layout.
+ */
+void desenharCurvasNivel(const double* altitudes, size_t lado, const std::vector<double>& niveis, Pixel cor,
+                         double opacidade, size_t linInicio, size_t linFim, const VistaImagem& destino);
+
+/**
+ * @brief Salva as curvas em SVG, alinhadas com a imagem do mapa (1 unidade = 1 pixel).
+ * @param nomeArquivo Caminho do arquivo de destino.
+ * @param curvas Curvas de extrairCurvasNivel.
+ * @param lado Pontos por lado do mapa (tamanho da imagem).
+ * @return true se salvo com sucesso, false caso contrário.
+ */
+bool salvarCurvasSVG(const char* nomeArquivo, const std::vector<CurvaNivel>& curvas, size_t lado);
+
+/**
+ * @brief Salva as curvas em GeoJSON: uma LineString por curva, com a altitude nas propriedades.
+ * @details Sem georreferência: as coordenadas são [coluna, linha] do mapa.
+ * @param nomeArquivo Caminho do arquivo de destino.
+ * @param curvas Curvas de extrairCurvasNivel.
+ * @return true se salvo com sucesso, false caso contrário.
+ */
+bool salvarCurvasGeoJSON(const char* nomeArquivo, const std::vector<CurvaNivel>& curvas);
+
+#endif
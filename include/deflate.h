@@ -0,0 +1,59 @@
+#ifndef DEFLATE_H
+#define DEFLATE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Compressor deflate (RFC 1951) e checksums usados pelos formatos zlib/PNG.
+ *
+ * @details Implementação própria, sem bibliotecas externas: LZ77 guloso com cadeias de
+ * hash (janela de 32 KB) seguido de blocos com códigos de Huffman dinâmicos.
+ *
+ * Para comprimir em paralelo, os dados são divididos em pedaços comprimidos de forma
+ * independente. Cada pedaço não-final termina com um bloco "stored" vazio, que alinha o
+ * fluxo em byte; assim, concatenar os pedaços em ordem gera um único fluxo deflate válido.
+ * Os checksums de cada pedaço podem ser combinados depois (combinarAdler32).
+ */
+
+/**
+ * @brief Comprime um pedaço de dados em blocos deflate, anexando-os à saída.
+ * @param dados Bytes de entrada.
+ * @param tamanho Quantidade de bytes.
+ * @param nivel 0 = sem compressão (blocos stored), 1 = mais rápido ... 9 = melhor compressão.
+ * @param ultimo true se este é o último pedaço do fluxo (marca o bloco final).
+ * @param saida Recebe os bytes comprimidos (sempre termina alinhada em byte).
+ */
+void comprimirDeflate(const unsigned char* dados, size_t tamanho, int nivel, bool ultimo,
+                      std::vector<unsigned char>& saida);
+
+/**
+ * @brief Calcula (ou continua) um CRC-32 (polinômio 0xEDB88320, como no PNG e no gzip).
+ * @details Usa tabelas "slicing-by-8" (8 bytes por iteração).
+ * @param dados Bytes de entrada.
+ * @param tamanho Quantidade de bytes.
+ * @param crc CRC dos bytes anteriores (0 para começar).
+ * @return CRC atualizado.
+ */
+uint32_t calcularCRC32(const unsigned char* dados, size_t tamanho, uint32_t crc = 0);
+
+/**
+ * @brief Calcula (ou continua) um checksum Adler-32 (usado no final do fluxo zlib).
+ * @param dados Bytes de entrada.
+ * @param tamanho Quantidade de bytes.
+ * @param adler Adler-32 dos bytes anteriores (1 para começar).
+ * @return Adler-32 atualizado.
+ */
+uint32_t calcularAdler32(const unsigned char* dados, size_t tamanho, uint32_t adler = 1);
+
+/**
+ * @brief Combina os Adler-32 de dois pedaços consecutivos, sem reler os dados.
+ * @param adler1 Adler-32 do primeiro pedaço.
+ * @param adler2 Adler-32 do segundo pedaço (calculado começando de 1).
+ * @param tamanho2 Tamanho do segundo pedaço em bytes.
+ * @return Adler-32 da concatenação dos dois pedaços.
+ */
+uint32_t combinarAdler32(uint32_t adler1, uint32_t adler2, size_t tamanho2);
+
+#endif
@@ -0,0 +1,147 @@
+#ifndef ESCRITOR_IMAGEM_H
+#define ESCRITOR_IMAGEM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "imagem.h"
+#include "arquivo_io.h"
+
+/**
+ * @brief Interface de gravação incremental de imagens, faixa de linhas por faixa.
+ *
+ * @details Permite codificar e gravar uma imagem sem tê-la inteira em memória: quem
+ * produz os pixels (ex: MapaAltitudes::gerarImagem) entrega as linhas em ordem, em faixas
+ * de qualquer tamanho, e o escritor codifica e grava cada faixa assim que a recebe.
+ * Entregar todas as linhas em uma única faixa gera exatamente o mesmo arquivo.
+ */
+class EscritorImagem {
+protected:
+    ArquivoSaida arquivo;
+    std::vector<unsigned char> codificado;  // Buffer reaproveitado por escreverLinhas/finalizar
+
+    /**
+     * @brief Cria (ou trunca) o arquivo de destino.
+     * @param nomeArquivo Caminho do arquivo de destino.
+     */
+    explicit EscritorImagem(const char* nomeArquivo);
+
+public:
+    virtual ~EscritorImagem() {}
+
+    /**
+     * @brief Indica se o arquivo de destino foi criado com sucesso.
+     * @return true se o escritor está pronto para receber linhas.
+     */
+    bool aberto() const;
+    /**
+     * @brief Codifica as próximas linhas da imagem, sem gravá-las.
+     * @details Separar codificação e gravação permite que as duas etapas rodem em threads
+     * diferentes (ver MapaAltitudes::gerarImagemEmEsteira). Os bytes produzidos devem ir
+     * para o arquivo (com gravar) na mesma ordem em que as faixas foram codificadas.
+     * @param linhas Pixels das linhas, em sequência (numLinhas × largura).
+     * @param numLinhas Quantidade de linhas nesta faixa.
+     * @param saida Recebe os bytes codificados (o conteúdo anterior é descartado).
+     * @return true se a faixa foi codificada com sucesso.
+     */
+    virtual bool codificarLinhas(const Pixel* linhas, size_t numLinhas, std::vector<unsigned char>& saida) = 0;
+    /**
+     * @brief Codifica o que faltar depois da última linha (ex: trailer do formato).
+     * @param saida Recebe os bytes finais (o conteúdo anterior é descartado).
+     * @return true se todas as linhas foram recebidas.
+     */
+    virtual bool codificarFinal(std::vector<unsigned char>& saida) = 0;
+    /**
+     * @brief Grava bytes já codificados no arquivo.
+     * @param dados Ponteiro para os bytes.
+     * @param tamanho Quantidade de bytes.
+     * @return true se todos os bytes foram gravados.
+     */
+    bool gravar(const unsigned char* dados, size_t tamanho);
+    /**
+     * @brief Fecha o arquivo.
+     * @return true se o arquivo foi fechado sem erros.
+     */
+    bool fechar();
+
+    /**
+     * @brief Codifica e grava as próximas linhas da imagem.
+     * @param linhas Pixels das linhas, em sequência (numLinhas × largura).
+     * @param numLinhas Quantidade de linhas nesta faixa.
+     * @return true se a faixa foi gravada com sucesso.
+     */
+    virtual bool escreverLinhas(const Pixel* linhas, size_t numLinhas);
+    /**
+     * @brief Grava o que faltar (ex: trailer do formato) e fecha o arquivo.
+     * @return true se todas as linhas foram recebidas e o arquivo foi fechado sem erros.
+     */
+    bool finalizar();
+};
+
+/**
+ * @brief Escritor incremental de PPM (P3 texto ou P6 binário).
+ *
+ * @details O cabeçalho é gravado junto com a primeira faixa. No P6, escreverLinhas manda
+ * cada faixa direto do buffer de pixels para o arquivo (sem cópia); no P3 cada faixa é
+ * formatada em um buffer de texto reaproveitado e gravada com um write().
+ */
+class EscritorPPM : public EscritorImagem {
+private:
+    size_t largura;
+    size_t altura;
+    FormatoPPM formato;
+    std::string cabecalhoPendente;  // Vazio depois de gravado
+    size_t linhasEscritas;
+
+public:
+    /**
+     * @brief Cria o arquivo PPM.
+     * @param nomeArquivo Caminho do arquivo de destino.
+     * @param largura Largura da imagem.
+     * @param altura Altura da imagem (total de linhas que serão entregues).
+     * @param formato P3, P6 ou automático (P6 acima de Imagem::LIMITE_PIXELS_TEXTO pixels).
+     */
+    EscritorPPM(const char* nomeArquivo, size_t largura, size_t altura,
+                FormatoPPM formato = PPM_AUTOMATICO);
+
+    bool codificarLinhas(const Pixel* linhas, size_t numLinhas, std::vector<unsigned char>& saida);
+    bool codificarFinal(std::vector<unsigned char>& saida);
+    bool escreverLinhas(const Pixel* linhas, size_t numLinhas);
+};
+
+/**
+ * @brief Escritor incremental de PNG (RGB, 8 bits por canal).
+ *
+ * @details Cada faixa recebida é dividida em pedaços processados em paralelo: filtro por
+ * linha, compressão deflate independente, Adler-32 e chunk IDAT com CRC (ver deflate.h).
+ * Os pedaços têm tamanho fixo (~256 KB de linhas filtradas) contado desde o início da
+ * imagem; linhas que não completam um pedaço ficam guardadas até a próxima faixa.
+ */
+class EscritorPNG : public EscritorImagem {
+private:
+    size_t largura;
+    size_t altura;
+    int nivel;
+    std::vector<unsigned char> cabecalhoPendente;  // Assinatura, IHDR e cabeçalho zlib
+    std::vector<unsigned char> ultimaLinha;        // Última linha já comprimida (filtro da seguinte)
+    std::vector<unsigned char> pendentes;          // Linhas que ainda não completam um pedaço
+    size_t linhasPorPedaco;
+    uint32_t adler;
+    size_t linhasEscritas;
+
+public:
+    /**
+     * @brief Cria o arquivo PNG.
+     * @param nomeArquivo Caminho do arquivo de destino.
+     * @param largura Largura da imagem (> 0).
+     * @param altura Altura da imagem (> 0).
+     * @param nivelCompressao 0 = sem compressão, 1 = mais rápido ... 9 = menor arquivo.
+     */
+    EscritorPNG(const char* nomeArquivo, size_t largura, size_t altura, int nivelCompressao = 1);
+
+    bool codificarLinhas(const Pixel* linhas, size_t numLinhas, std::vector<unsigned char>& saida);
+    bool codificarFinal(std::vector<unsigned char>& saida);
+};
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef FILA_CIRCULAR_H
+#define FILA_CIRCULAR_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fila circular limitada, sem travas, para um produtor e um consumidor.
+ *
+ * @details Liga duas etapas de uma esteira (ex: renderização → codificação) que rodam em
+ * threads diferentes. Cada índice só é escrito por uma das threads (o produtor avança
+ * "fim", o consumidor avança "inicio"), então basta a ordem acquire/release dos atômicos,
+ * sem mutex. A capacidade limitada faz o produtor esperar quando o consumidor está
+ * atrasado, o que limita a memória usada pela esteira.
+ */
+template <typename T>
+class FilaCircular {
+private:
+    std::vector<T> itens;
+    alignas(64) std::atomic<size_t> inicio;  // Próximo a retirar (só o consumidor escreve)
+    alignas(64) std::atomic<size_t> fim;     // Próximo a inserir (só o produtor escreve)
+    std::atomic<bool> fechada;
+
+    // Espera ativa curta e depois cochilos, para não roubar o núcleo das outras etapas
+    static void esperar(unsigned int& tentativas) {
+        if (++tentativas < 64) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+public:
+    explicit FilaCircular(size_t capacidade)
+        : itens(capacidade > 0 ? capacidade : 1), inicio(0), fim(0), fechada(false) {}
+
+    // Tenta inserir sem esperar; false se a fila está cheia
+    bool tentarInserir(const T& valor) {
+        size_t f = fim.load(std::memory_order_relaxed);
+        if (f - inicio.load(std::memory_order_acquire) == itens.size()) return false;
+        itens[f % itens.size()] = valor;
+        fim.store(f + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Tenta retirar sem esperar; false se a fila está vazia
+    bool tentarRetirar(T& valor) {
+        size_t i = inicio.load(std::memory_order_relaxed);
+        if (i == fim.load(std::memory_order_acquire)) return false;
+        valor = itens[i % itens.size()];
+        inicio.store(i + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Insere, esperando enquanto a fila estiver cheia
+    void inserir(const T& valor) {
+        unsigned int tentativas = 0;
+        while (!tentarInserir(valor)) {
+            esperar(tentativas);
+        }
+    }
+
+    // Retira, esperando enquanto a fila estiver vazia; false se foi fechada e esvaziou
+    bool retirar(T& valor) {
+        unsigned int tentativas = 0;
+        while (!tentarRetirar(valor)) {
+            if (fechada.load(std::memory_order_acquire)) {
+                return tentarRetirar(valor);  // Algo pode ter entrado antes de fechar
+            }
+            esperar(tentativas);
+        }
+        return true;
+    }
+
+    // Indica ao consumidor que nada mais será inserido (chamado pelo produtor)
+    void fechar() {
+        fechada.store(true, std::memory_order_release);
+    }
+};
+
+#endif
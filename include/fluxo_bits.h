@@ -0,0 +1,93 @@
+#ifndef FLUXO_BITS_H
+#define FLUXO_BITS_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Grava bits em um vetor de bytes, do bit menos significativo para o mais
+ * significativo (a mesma ordem usada pelo formato deflate).
+ */
+class EscritorBits {
+private:
+    std::vector<unsigned char>& saida;
+    uint64_t acumulador;
+    int bits;
+
+public:
+    explicit EscritorBits(std::vector<unsigned char>& saida) : saida(saida), acumulador(0), bits(0) {}
+
+    // Grava os n bits menos significativos de valor (n <= 32)
+    void escrever(uint64_t valor, int n) {
+        acumulador |= (valor & ((uint64_t(1) << n) - 1)) << bits;
+        bits += n;
+        while (bits >= 8) {
+            saida.push_back(static_cast<unsigned char>(acumulador));
+            acumulador >>= 8;
+            bits -= 8;
+        }
+    }
+
+    // Grava q bits 1 seguidos de um bit 0
+    void escreverUnario(unsigned int q) {
+        while (q >= 32) {
+            escrever(0xFFFFFFFFu, 32);
+            q -= 32;
+        }
+        escrever((uint64_t(1) << q) - 1, q + 1);
+    }
+
+    // Completa o último byte com zeros (alinha o fluxo em byte)
+    void finalizar() {
+        if (bits > 0) saida.push_back(static_cast<unsigned char>(acumulador));
+        acumulador = 0;
+        bits = 0;
+    }
+};
+
+/**
+ * @brief Lê bits gravados por EscritorBits. Depois do fim dos dados, lê zeros.
+ */
+class LeitorBits {
+private:
+    const unsigned char* atual;
+    const unsigned char* fim;
+    uint64_t acumulador;
+    int bits;
+
+    // Completa o acumulador com bytes (zeros depois do fim dos dados)
+    void recarregar() {
+        while (bits <= 56) {
+            uint64_t byte = atual < fim ? *atual++ : 0;
+            acumulador |= byte << bits;
+            bits += 8;
+        }
+    }
+
+public:
+    LeitorBits(const unsigned char* inicio, const unsigned char* fim)
+        : atual(inicio), fim(fim), acumulador(0), bits(0) {
+        recarregar();
+    }
+
+    // Lê n bits (n <= 32)
+    uint64_t ler(int n) {
+        uint64_t valor = acumulador & ((uint64_t(1) << n) - 1);
+        acumulador >>= n;
+        bits -= n;
+        recarregar();
+        return valor;
+    }
+
+    // Conta bits 1 até encontrar um 0 (no máximo limite <= 56); consome o 0 se encontrado
+    unsigned int lerUnario(unsigned int limite) {
+        unsigned int q = static_cast<unsigned int>(__builtin_ctzll(~acumulador | (uint64_t(1) << limite)));
+        int consumidos = static_cast<int>(q < limite ? q + 1 : q);
+        acumulador >>= consumidos;
+        bits -= consumidos;
+        recarregar();
+        return q;
+    }
+};
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef GERADOR_LINHAS_H
+#define GERADOR_LINHAS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "aleatorio.h"
+
+/**
+ * @brief Diamond-Square que produz o mapa uma linha de cada vez, sem guardá-lo inteiro.
+ *
+ * @details Produz exatamente as mesmas altitudes de MapaAltitudes::gerar com a mesma
+ * semente, mas em ordem de linhas. Cada nível do algoritmo (passo p → p/2) vira uma etapa
+ * que lê as linhas do nível anterior (múltiplas de p) e entrega as suas (múltiplas de p/2),
+ * guardando só duas linhas de cantos e duas de centros; as etapas são encadeadas até o
+ * passo 1. Como gerar() sorteia nível por nível o mapa inteiro (primeiro todos os losangos,
+ * depois todos os quadrados), cada etapa lê o seu trecho da sequência aleatória com
+ * geradores próprios, posicionados com GeradorAleatorio::avancar. A memória é da ordem de
+ * algumas linhas por nível, em vez de tamanho × tamanho altitudes.
+ */
+class GeradorLinhas {
+public:
+    /**
+     * @brief Prepara a geração (nenhuma linha é calculada ainda).
+     * @param N Expoente de tamanho. O mapa terá dimensão (2^N + 1).
+     * @param rugosidade Fator de decaimento da aleatoriedade [0.0 - 1.0].
+     * @param semente Semente do gerador de números aleatórios.
+     */
+    GeradorLinhas(int N, double rugosidade, uint32_t semente);
+
+    /**
+     * @brief Retorna o lado do mapa.
+     * @return 2^N + 1.
+     */
+    size_t obterTamanho() const;
+
+    /**
+     * @brief Calcula a próxima linha do mapa (chamar no máximo obterTamanho() vezes).
+     * @param destino Recebe obterTamanho() altitudes.
+     */
+    void proximaLinha(double* destino);
+
+private:
+    // Etapa de um nível: quadrados de lado passo viram pontos a cada passo / 2
+    struct Nivel {
+        size_t quadrados;                      // Quadrados por lado (W)
+        double amplitude;
+        GeradorAleatorio sorteioDiamond;       // Trecho da sequência das etapas Diamond do nível
+        GeradorAleatorio sorteioSquare;        // Idem, das etapas Square
+        std::vector<double> cantosCima;        // Linhas j e j + 1 do nível anterior (W + 1 cantos)
+        std::vector<double> cantosBaixo;
+        std::vector<double> centrosAcima;      // Centros dos quadrados das linhas j - 1 e j
+        std::vector<double> centros;
+        std::vector<double> topo, esquerda, baixo;  // Deslocamentos sorteados da linha j
+        double direita;                        // Idem, do ponto direito do último quadrado
+        size_t proxima;                        // Próxima linha a entregar (0 a 2W)
+
+        Nivel(size_t quadrados, double amplitude, uint32_t semente, uint64_t posicaoDiamond,
+              uint64_t posicaoSquare);
+    };
+
+    size_t tamanho;
+    std::vector<Nivel> niveis;       // Do passo tamanho - 1 ao passo 2
+    double cantos[2][2];             // Os quatro cantos do mapa (o "nível" de cima)
+    size_t proximaRaiz;
+
+    // Escreve em destino a próxima linha depois dos primeiros numNiveis níveis (0 = só os cantos)
+    void entregarLinha(size_t numNiveis, double* destino);
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef HORIZONTE_H
+#define HORIZONTE_H
+
+#include <cstddef>
+
+/**
+ * @brief Passes que dependem do horizonte visto de cada ponto (não só dos vizinhos).
+ *
+ * @details O mapa é varrido em linhas retas paralelas a uma direção (retas de Bresenham
+ * deslocadas, que juntas cobrem cada ponto exatamente uma vez). Ao longo de cada reta
+ * só é preciso guardar um resumo do que já passou, então cada varredura custa O(n) no
+ * número de pontos, sem lançar um raio por pixel. As retas são independentes e divididas
+ * entre as threads, e o mapa é lido na ordem da memória (linha a linha) em qualquer direção.
+ */
+
+// Fator aplicado aos pontos que estão na sombra de outro relevo
+static const float FATOR_SOMBRA_PROJETADA = 0.5f;
+
+/**
+ * @brief Calcula a máscara de sombras projetadas por uma luz direcional.
+ * @details Cada reta é percorrida a partir do lado da luz guardando a altura da
+ * "linha de sombra", que desce tan(elevação) por unidade de distância; um ponto abaixo
+ * dela está na sombra, e um ponto acima passa a ser a nova linha de sombra.
+ * @param altitudes Mapa lado × lado, linha a linha.
+ * @param lado Pontos por lado do mapa.
+ * @param azimute Direção de onde vem a luz, em graus, horário a partir do norte (topo).
+ * @param elevacao Altura da luz acima do horizonte, em graus (90 = sem sombras).
+ * @param exagero Multiplicador vertical (como em Sombreamento).
+ * @param mascara Recebe lado × lado fatores: 1 iluminado, FATOR_SOMBRA_PROJETADA na sombra.
+ */
+void calcularSombrasProjetadas(const double* altitudes, size_t lado, double azimute, double elevacao,
+                               double exagero, float* mascara);
+
+/**
+ * @brief Calcula a visibilidade do céu (oclusão ambiente) de cada ponto.
+ * @details Para cada uma das numDirecoes direções (azimutes igualmente espaçados) o mapa
+ * é varrido guardando, em cada reta, o fecho convexo superior dos pontos já vistos: o
+ * horizonte de um ponto é a tangente a esse fecho, achada tirando pontos do topo, e cada
+ * ponto entra e sai do fecho uma vez só (custo linear, não um raio por ponto e direção).
+ * A visibilidade é 1 - média de sen(ângulo do horizonte), com horizontes abaixo da
+ * horizontal contando como zero.
+ * @param altitudes Mapa lado × lado, linha a linha.
+ * @param lado Pontos por lado do mapa.
+ * @param numDirecoes Direções varridas (8 ou 16 bastam; 0 = sem oclusão).
+ * @param exagero Multiplicador vertical (como em Sombreamento).
+ * @param visibilidade Recebe lado × lado valores em [0, 1]: 1 = céu inteiro visível.
+ */
+void calcularOclusaoAmbiente(const double* altitudes, size_t lado, size_t numDirecoes, double exagero,
+                             float* visibilidade);
+
+#endif
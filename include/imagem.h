@@ -3,6 +3,8 @@
 
 #include <cstddef>
 
+class EscritorImagem;
+
 /**
  * @brief Estrutura auxiliar para representar um pixel RGB dentro da imagem.
  */
@@ -26,17 +28,98 @@ struct Pixel {
     Pixel(unsigned char r, unsigned char g, unsigned char b) 
         : r(r), g(g), b(b) {}
 };
+
+/**
+ * @brief Organização dos pixels na memória da imagem.
+ */
+enum LayoutImagem {
+    LAYOUT_RGB24,   // Pixel (3 bytes) intercalado, linhas sem preenchimento (o padrão)
+    LAYOUT_RGBA32,  // 4 bytes por pixel (R, G, B, A = 255), linhas alinhadas
+    LAYOUT_PLANAR   // Três planos de bytes (R, G e B), linhas alinhadas
+};
+
+/**
+ * @brief Acesso aos pixels de uma imagem (ou de um buffer) em qualquer layout.
+ * @details Cada canal é descrito pelo endereço do pixel (0, 0) e pelos passos entre
+ * pixels e entre linhas, então o mesmo código genérico lê e escreve os três layouts; os
+ * núcleos vetoriais (renderizacao.h) olham o layout e gravam vetores inteiros. Os passos
+ * devem ser os do layout: passoPixel 3 no RGB24, 4 no RGBA32 e 1 no planar.
+ */
+struct VistaImagem {
+    LayoutImagem layout;
+    unsigned char* canais[3];  // Byte R, G e B do pixel (0, 0)
+    size_t passoPixel;         // Bytes entre um pixel e o seguinte no mesmo canal (3, 4 ou 1)
+    size_t passoLinha;         // Bytes entre uma linha e a seguinte no mesmo canal
+
+    /**
+     * @brief Vista RGB24 sobre um buffer de pixels contíguo.
+     * @param pixels Primeiro pixel.
+     * @param largura Pixels por linha (0 para uma linha só).
+     */
+    VistaImagem(Pixel* pixels, size_t largura = 0)
+        : layout(LAYOUT_RGB24), canais{&pixels->r, &pixels->g, &pixels->b}, passoPixel(3), passoLinha(3 * largura) {}
+
+    /**
+     * @brief Vista com canais e passos quaisquer.
+     */
+    VistaImagem(LayoutImagem layout, unsigned char* r, unsigned char* g, unsigned char* b, size_t passoPixel,
+                size_t passoLinha)
+        : layout(layout), canais{r, g, b}, passoPixel(passoPixel), passoLinha(passoLinha) {}
+
+    /**
+     * @brief A mesma vista, começando no pixel (x, y).
+     */
+    VistaImagem deslocada(size_t x, size_t y) const {
+        size_t d = y * passoLinha + x * passoPixel;
+        return VistaImagem(layout, canais[0] + d, canais[1] + d, canais[2] + d, passoPixel, passoLinha);
+    }
+
+    /**
+     * @brief Lê o pixel (x, y).
+     */
+    Pixel obter(size_t x, size_t y) const {
+        size_t d = y * passoLinha + x * passoPixel;
+        return Pixel(canais[0][d], canais[1][d], canais[2][d]);
+    }
+
+    /**
+     * @brief Escreve o pixel (x, y).
+     */
+    void definir(size_t x, size_t y, const Pixel& pixel) const {
+        size_t d = y * passoLinha + x * passoPixel;
+        canais[0][d] = pixel.r;
+        canais[1][d] = pixel.g;
+        canais[2][d] = pixel.b;
+    }
+};
+
+/**
+ * @brief Variante do formato PPM usada ao salvar a imagem.
+ */
+enum FormatoPPM {
+    PPM_AUTOMATICO,  // P6 para imagens grandes, P3 para imagens pequenas
+    PPM_TEXTO,       // P3: valores em ASCII, legível por humanos
+    PPM_BINARIO      // P6: bytes RGB crus, 3 bytes por pixel
+};
+
 /**
  * @brief Classe responsável pela manipulação de imagens digitais.
  * 
  * @details Gerencia uma matriz de pixels alocada dinamicamente. Oferece abstração
  * para acesso via coordenadas (x,y) e suporte a leitura/escrita no formato PPM.
+ * Além do Pixel intercalado de 3 bytes, a imagem pode guardar os pixels em RGBA de 32 bits
+ * ou em planos R/G/B, com cada linha começando num endereço alinhado a
+ * ALINHAMENTO_LINHAS bytes, para que os núcleos vetoriais gravem vetores inteiros sem
+ * embaralhar bytes. A conversão para RGB intercalado só acontece ao salvar, faixa a faixa.
  */
 class Imagem {
 private:
     size_t largura;
     size_t altura;
-    Pixel* pixels;  // Array único para armazenar todos os pixels
+    LayoutImagem layout;
+    Pixel* pixels;         // Array único para armazenar todos os pixels (LAYOUT_RGB24)
+    unsigned char* dados;  // Linhas alinhadas (LAYOUT_RGBA32 e LAYOUT_PLANAR; os planos em sequência)
+    size_t passo;          // Bytes entre o início de uma linha e o da seguinte (em cada plano)
     
     // Método auxiliar para calcular índice no array
     /**
@@ -58,8 +141,14 @@ private:
      * @brief Aloca o buffer de pixels com as dimensões especificadas.
      * @param larg Largura desejada.
      * @param alt Altura desejada.
+     * @param novoLayout Organização dos pixels.
+     */
+    void alocar(size_t larg, size_t alt, LayoutImagem novoLayout = LAYOUT_RGB24);
+
+    /**
+     * @brief Grava a imagem com um escritor já aberto, convertendo faixas para RGB24 se preciso.
      */
-    void alocar(size_t larg, size_t alt);
+    bool gravar(EscritorImagem& escritor, const char* nomeArquivo) const;
 
 public:
     // Construtores
@@ -71,8 +160,9 @@ public:
      * @brief Construtor principal. Cria uma imagem preta com tamanho definido.
      * @param largura Largura em pixels.
      * @param altura Altura em pixels.
+     * @param layout Organização dos pixels (padrão: Pixel intercalado de 3 bytes).
      */
-    Imagem(size_t largura, size_t altura);  // Construtor com dimensões
+    Imagem(size_t largura, size_t altura, LayoutImagem layout = LAYOUT_RGB24);  // Construtor com dimensões
     
     // Destrutor
     /**
@@ -91,10 +181,49 @@ public:
      * @return Altura em pixels.
      */
     size_t obterAltura() const;
+    /**
+     * @brief Retorna a organização dos pixels.
+     * @return Layout escolhido na criação (lerPPM sempre cria LAYOUT_RGB24).
+     */
+    LayoutImagem obterLayout() const;
+    /**
+     * @brief Retorna a distância entre o início de duas linhas seguidas.
+     * @return Bytes por linha (em cada plano, no LAYOUT_PLANAR), incluindo o preenchimento.
+     */
+    size_t obterPasso() const;
+    /**
+     * @brief Retorna uma vista sobre os pixels, para os núcleos de renderização e composição.
+     * @return Vista com os canais e passos do layout da imagem (canais nulos numa imagem vazia).
+     */
+    VistaImagem obterVista();
+    /**
+     * @brief Lê um pixel em qualquer layout.
+     * @param x Coordenada da coluna.
+     * @param y Coordenada da linha.
+     * @return Cópia do pixel.
+     */
+    Pixel obterPixel(size_t x, size_t y) const;
+    /**
+     * @brief Escreve um pixel em qualquer layout.
+     * @param x Coordenada da coluna.
+     * @param y Coordenada da linha.
+     * @param pixel Nova cor.
+     */
+    void definirPixel(size_t x, size_t y, const Pixel& pixel);
+    /**
+     * @brief Copia linhas da imagem para RGB intercalado (o formato dos codificadores).
+     * @details Nos layouts alinhados, usa os núcleos vetoriais de renderizacao.h.
+     * @param linInicio Primeira linha.
+     * @param numLinhas Quantidade de linhas.
+     * @param destino Recebe numLinhas × largura pixels, linha a linha.
+     */
+    void converterParaRGB24(size_t linInicio, size_t numLinhas, Pixel* destino) const;
     
     // Operador de acesso aos pixels (x=coluna, y=linha)
     /**
      * @brief Operador de acesso ao pixel (Leitura/Escrita).
+     * @details Só no LAYOUT_RGB24 (verificado por assert); nos outros layouts use
+     * obterPixel/definirPixel ou obterVista.
      * @param x Coordenada da coluna (0 a largura-1).
      * @param y Coordenada da linha (0 a altura-1).
      * @return Referência modificável ao Pixel.
@@ -102,6 +231,7 @@ public:
     Pixel& operator()(size_t x, size_t y);
     /**
      * @brief Operador de acesso ao pixel (Somente Leitura).
+     * @details Só no LAYOUT_RGB24, como o operador de escrita.
      * @param x Coordenada da coluna.
      * @param y Coordenada da linha.
      * @return Referência constante ao Pixel.
@@ -110,17 +240,55 @@ public:
     
     // Métodos de I/O
     /**
-     * @brief Lê uma imagem de um arquivo PPM (formato P3).
+     * @brief Lê uma imagem de um arquivo PPM/PGM (P3, P6, P2 ou P5).
+     * @details Aceita comentários '#' no cabeçalho e qualquer valor máximo até 65535
+     * (amostras são reescaladas para 0-255; tons de cinza viram R=G=B). O arquivo é
+     * mapeado em memória: no P6 com valor máximo 255 o bloco de pixels é copiado com um
+     * único memcpy, e nos formatos texto os números são lidos por um scanner próprio.
+     * Antes de alocar, recusa lados acima de LIMITE_LADO_LEITURA e dimensões que o
+     * restante do arquivo não comporta.
      * @param nomeArquivo Caminho do arquivo a ser lido.
      * @return true se a leitura foi bem sucedida, false caso contrário.
      */
     bool lerPPM(const char* nomeArquivo);
     /**
-     * @brief Salva a imagem atual em um arquivo PPM (formato P3).
+     * @brief Salva a imagem atual em um arquivo PPM (formato P3 ou P6).
+     * @details O arquivo inteiro é montado em memória e gravado com uma única chamada
+     * de sistema. No P6 os pixels são gravados direto do buffer da imagem, sem cópia.
+     * Em PPM_AUTOMATICO, imagens com mais de LIMITE_PIXELS_TEXTO pixels usam P6.
+     * @param nomeArquivo Caminho onde o arquivo será salvo.
+     * @param formato Variante do PPM (padrão: automático pelo tamanho da imagem).
+     * @return true se a gravação foi bem sucedida, false caso contrário.
+     */
+    bool salvarPPM(const char* nomeArquivo, FormatoPPM formato = PPM_AUTOMATICO) const;
+
+    /**
+     * @brief Salva a imagem em um arquivo PNG (RGB, 8 bits por canal).
+     * @details Codificador próprio, sem bibliotecas externas. As linhas são divididas em
+     * pedaços processados em paralelo: cada pedaço escolhe o filtro PNG de cada linha
+     * (o de menor soma de diferenças absolutas), comprime com deflate em blocos
+     * independentes e calcula seus checksums; no fim os pedaços são concatenados em um
+     * único fluxo zlib.
      * @param nomeArquivo Caminho onde o arquivo será salvo.
+     * @param nivelCompressao 0 = sem compressão, 1 = mais rápido (padrão) ... 9 = menor arquivo.
      * @return true se a gravação foi bem sucedida, false caso contrário.
      */
-    bool salvarPPM(const char* nomeArquivo) const;
+    bool salvarPNG(const char* nomeArquivo, int nivelCompressao = 1) const;
+
+    /**
+     * @brief Maior quantidade de pixels salva em texto (P3) no modo automático (256×256).
+     */
+    static const size_t LIMITE_PIXELS_TEXTO = 256 * 256;
+
+    /**
+     * @brief Maior lado aceito por lerPPM (2^24 pixels).
+     */
+    static const size_t LIMITE_LADO_LEITURA = size_t(1) << 24;
+
+    /**
+     * @brief Alinhamento, em bytes, do início de cada linha nos layouts RGBA32 e planar.
+     */
+    static constexpr size_t ALINHAMENTO_LINHAS = 64;
 };
 
 #endif
\ No newline at end of file
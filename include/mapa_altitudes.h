@@ -4,6 +4,36 @@
 #include <cstddef>
 #include "paleta.h"//novos includes (agr o arquivo conhece a paleta e a imagem)
 #include "imagem.h"
+#include "renderizacao.h"
+#include "reamostragem.h"
+#include "curvas_nivel.h"
+#include "perspectiva.h"
+#include "analise_terreno.h"
+
+class EscritorImagem;
+class GeradorAleatorio;
+
+/**
+ * @brief Contagens da exportação feita por MapaAltitudes::salvarPiramideTiles.
+ */
+struct EstatisticasPiramide {
+    int zoomMaximo;         // Nível mais detalhado (1 pixel do mapa por pixel do tile)
+    size_t tilesGravados;   // Arquivos PNG criados
+    size_t tilesUniformes;  // Tiles de uma cor só, que não foram gravados
+};
+
+/**
+ * @brief Tempos medidos por MapaAltitudes::gerarImagemEmEsteira.
+ * @details Cada etapa roda em sua própria thread; o tempo ocupado dividido pelo tempo
+ * total dá a utilização da etapa (a mais próxima de 100% é o gargalo).
+ */
+struct EstatisticasEsteira {
+    double segundosTotal;          // Do início da renderização até o arquivo fechado
+    double segundosRenderizando;   // Etapa 1: altitudes → pixels
+    double segundosCodificando;    // Etapa 2: pixels → bytes do formato
+    double segundosGravando;       // Etapa 3: bytes → arquivo
+    size_t numFaixas;
+};
 /**
  * @brief Classe responsável pela geração e manipulação de mapas de altitudes.
  * 
@@ -41,8 +71,9 @@ private:
      * @param y Coordenada Y (linha) do canto superior esquerdo.
      * @param passo Tamanho do quadrado atual.
      * @param amplitude Fator de aleatoriedade atual.
+     * @param aleatorio Gerador da sequência aleatória.
      */
-    void etapaDiamond(size_t x, size_t y, size_t passo, double amplitude);
+    void etapaDiamond(size_t x, size_t y, size_t passo, double amplitude, GeradorAleatorio& aleatorio);
     /**
      * @brief Executa a etapa "Square" (Quadrado) do algoritmo.
      * @details Calcula os pontos médios das arestas baseando-se nos vizinhos ortogonais.
@@ -50,8 +81,9 @@ private:
      * @param y Coordenada Y (linha) do canto superior esquerdo.
      * @param passo Tamanho do quadrado atual.
      * @param amplitude Fator de aleatoriedade atual.
+     * @param aleatorio Gerador da sequência aleatória.
      */
-    void etapaSquare(size_t x, size_t y, size_t passo, double amplitude);
+    void etapaSquare(size_t x, size_t y, size_t passo, double amplitude, GeradorAleatorio& aleatorio);
      /**
      * @brief Obtém uma altitude tratando limites da matriz.
      * @details Útil para a etapa Square nas bordas do mapa (onde não há vizinhos).
@@ -62,23 +94,47 @@ private:
      */
     double obterAltitudaSegura(int lin, int col, double padrao) const;
     
-    // Novos métodos auxiliares para geração de imagem
     /**
-     * @brief Converte um valor de altitude [0..1] em uma Cor baseada na Paleta.
-     * @param altitude Valor normalizado da altura.
-     * @param paleta Referência para a paleta de cores a ser usada.
-     * @return Objeto Cor correspondente à altitude.
+     * @brief Renderiza a região [linInicio, linFim) × [colInicio, colFim) do mapa em um buffer de pixels.
+     * @details Regiões grandes são divididas em faixas de linhas processadas em paralelo.
+     * @param paleta Paleta de cores.
+     * @param sombreamento Tipo de sombreamento (Noroeste, nenhum ou relevo).
+     * @param linInicio Primeira linha.
+     * @param linFim Linha final (exclusiva).
+     * @param colInicio Primeira coluna.
+     * @param colFim Coluna final (exclusiva).
+     * @param destino Vista com (linFim - linInicio) × (colFim - colInicio) pixels, em qualquer layout.
+     * @param multiplicador Fator extra de cada ponto do mapa inteiro (tamanho × tamanho), ou nullptr.
      */
-    Cor mapearAltitudeCor(double altitude, const Paleta& paleta) const;//encapsula a lógica de escolher a cor
+    void renderizarRegiao(const Paleta& paleta, const Sombreamento& sombreamento, size_t linInicio, size_t linFim,
+                          size_t colInicio, size_t colFim, const VistaImagem& destino,
+                          const float* multiplicador = nullptr) const;
     /**
-     * @brief Calcula o fator de sombreamento para um pixel.
-     * @details Simula uma luz vinda do Noroeste. Compara a altitude atual com o vizinho
-     * superior esquerdo para determinar se o ponto está na sombra.
-     * @param lin Linha do ponto.
-     * @param col Coluna do ponto.
-     * @return Fator de luminosidade entre 0.3 (sombra forte) e 1.0 (iluminado).
+     * @brief Renderiza as linhas [linInicio, linFim) da imagem reamostrada para a grade de saída.
+     * @details Faixas de linhas em paralelo; cada faixa mantém uma janela das linhas do
+     * mapa já reamostradas na horizontal.
+     * @param paleta Paleta de cores.
+     * @param sombreamento Tipo de sombreamento, aplicado na grade de saída.
+     * @param horizontal Pesos do eixo horizontal (tamanho → largura da imagem).
+     * @param vertical Pesos do eixo vertical (tamanho → altura da imagem).
+     * @param linInicio Primeira linha da imagem.
+     * @param linFim Linha final (exclusiva).
+     * @param destino Vista com (linFim - linInicio) × largura pixels, em qualquer layout.
+     * @param multiplicador Fator extra de cada ponto do mapa (tamanho × tamanho), ou nullptr.
      */
-    double calcularSombreamento(size_t lin, size_t col) const;//lógica da luz, pode ser alterada (queremos noroeste, mas poderia ser parametrizada)
+    void renderizarReamostrado(const Paleta& paleta, const Sombreamento& sombreamento,
+                               const PesosReamostragem& horizontal, const PesosReamostragem& vertical,
+                               size_t linInicio, size_t linFim, const VistaImagem& destino,
+                               const float* multiplicador = nullptr) const;
+    /**
+     * @brief Calcula, para o mapa inteiro, os fatores que dependem do horizonte (sombras projetadas
+     * e oclusão ambiente), já multiplicados.
+     * @details Feito uma vez por imagem, antes da renderização em faixas ou tiles, porque a
+     * sombra de um ponto pode vir de qualquer lugar do mapa.
+     * @param sombreamento Opções de sombreamento.
+     * @return tamanho × tamanho fatores, ou vazio se nenhum passe de horizonte foi pedido.
+     */
+    std::vector<float> calcularMultiplicador(const Sombreamento& sombreamento) const;
 
 public:
     // Construtores e destrutor (já existentes)
@@ -104,6 +160,13 @@ public:
      *        Valores maiores criam terrenos mais acidentados.
      */
     void gerar(int N, double rugosidade);
+    /**
+     * @brief Gera o terreno com uma semente fixa (mesma semente, mesmo terreno).
+     * @param N Expoente de tamanho. O mapa terá dimensão (2^N + 1).
+     * @param rugosidade Fator de decaimento da aleatoriedade [0.0 - 1.0].
+     * @param semente Semente do gerador de números aleatórios.
+     */
+    void gerar(int N, double rugosidade, unsigned int semente);
     /**
      * @brief Consulta a altitude em uma coordenada específica.
      * @param lin Linha.
@@ -123,6 +186,9 @@ public:
     size_t obterColunas() const;
     /**
      * @brief Salva os dados brutos do mapa em um arquivo de texto.
+     * @details Cada altitude é escrita com a menor quantidade de dígitos que, ao ser
+     * lida de volta por ler(), reproduz exatamente o mesmo valor (sem perdas).
+     * A formatação é feita em paralelo, por faixas de linhas.
      * @param nomeArquivo Caminho do arquivo de destino.
      * @return true se salvo com sucesso, false caso contrário.
      */
@@ -130,22 +196,250 @@ public:
     bool salvar(const char* nomeArquivo) const;
     /**
      * @brief Lê dados de um arquivo e reconstrói o mapa.
+     * @details Recusa, antes de alocar, dimensões que o restante do arquivo não comporta.
      * @param nomeArquivo Caminho do arquivo de origem.
      * @return true se lido com sucesso, false caso contrário.
      */
     bool ler(const char* nomeArquivo);
+    /**
+     * @brief Exporta o mapa como imagem PGM binária (P5) de 16 bits em tons de cinza.
+     * @details O intervalo [minimo, maximo] é mapeado em [0, 65535]; altitudes fora dele
+     * são saturadas. O arquivo é montado em um único buffer e gravado com um só write().
+     * @param nomeArquivo Caminho do arquivo de destino.
+     * @param minimo Altitude que vira preto (0).
+     * @param maximo Altitude que vira branco (65535).
+     * @return true se salvo com sucesso, false caso contrário.
+     */
+    bool salvarPGM(const char* nomeArquivo, double minimo = 0.0, double maximo = 1.0) const;
+    /**
+     * @brief Importa um mapa de uma imagem PGM binária (P5) de 8 ou 16 bits.
+     * @details O arquivo é mapeado em memória (mmap) e convertido diretamente para o
+     * array de altitudes. A imagem deve ser quadrada e estar completa.
+     * @param nomeArquivo Caminho do arquivo de origem.
+     * @param minimo Altitude correspondente ao preto (0).
+     * @param maximo Altitude correspondente ao branco (valor máximo do arquivo).
+     * @return true se lido com sucesso, false caso contrário.
+     */
+    bool lerPGM(const char* nomeArquivo, double minimo = 0.0, double maximo = 1.0);
+    /**
+     * @brief Salva o mapa no formato compactado (quantização + predição + código de Rice).
+     * @details O mapa é dividido em tiles comprimidos em paralelo e de forma independente
+     * (ver mapa_compactado.h). Cada altitude lida de volta difere da original em no
+     * máximo erroMaximo.
+     * @param nomeArquivo Caminho do arquivo de destino.
+     * @param erroMaximo Erro absoluto máximo permitido por altitude.
+     * @param ladoTile Dimensão lateral dos tiles.
+     * @return true se salvo com sucesso, false caso contrário.
+     */
+    bool salvarCompactado(const char* nomeArquivo, double erroMaximo = 1e-5, size_t ladoTile = 256) const;
+    /**
+     * @brief Lê um mapa salvo com salvarCompactado, descomprimindo os tiles em paralelo.
+     * @param nomeArquivo Caminho do arquivo de origem.
+     * @return true se lido com sucesso, false caso contrário.
+     */
+    bool lerCompactado(const char* nomeArquivo);
+    /**
+     * @brief Lê só uma janela quadrada de um mapa salvo com salvarCompactado.
+     * @details Apenas os tiles que a janela toca são lidos do disco (em paralelo), então o
+     * custo depende do tamanho da janela, não do tamanho do arquivo. O mapa passa a ter
+     * lado × lado pontos, com (0, 0) correspondendo a (linInicio, colInicio) no arquivo.
+     * @param nomeArquivo Caminho do arquivo de origem.
+     * @param linInicio Primeira linha da janela no mapa salvo.
+     * @param colInicio Primeira coluna da janela no mapa salvo.
+     * @param lado Dimensão lateral da janela.
+     * @return true se a janela está dentro do mapa salvo e foi lida com sucesso.
+     */
+    bool lerRegiaoCompactado(const char* nomeArquivo, size_t linInicio, size_t colInicio, size_t lado);
     
     // NOVO: Método principal da Etapa 4
     /**
      * @brief Gera uma representação visual (Imagem) do mapa de altitudes.
+     * @details As linhas são renderizadas em faixas paralelas (quantidade de threads em
+     * definirNumThreads, paralelo.h); a imagem é idêntica para qualquer número de threads.
      * @param paleta Objeto contendo as cores para mapeamento de alturas.
-     * @param aplicarSombreamento Se true, aplica efeito de luz/sombra (Noroeste).
+     * @param sombreamento Efeito de luz/sombra: true/false (Noroeste ou nenhum) ou Sombreamento::relevo.
+     * @param layout Organização dos pixels da imagem; os núcleos gravam direto nela, e a
+     *               conversão para RGB intercalado só acontece ao salvar.
      * @return Objeto Imagem pronto para ser salvo como PPM.
      */
     //recebe a paleta por ref constante
-    //o bool aplicarSombreamento é para gerar imagens flat para debug, como sugeria o pdf
+    //sombreamento false é para gerar imagens flat para debug, como sugeria o pdf
     //const pq gerar a img n vai alterar as altitudes do terreno
-    Imagem gerarImagem(const Paleta& paleta, bool aplicarSombreamento = true) const;
+    Imagem gerarImagem(const Paleta& paleta, const Sombreamento& sombreamento = Sombreamento(),
+                       LayoutImagem layout = LAYOUT_RGB24) const;
+    /**
+     * @brief Renderiza o mapa direto para um arquivo, faixa de linhas por faixa.
+     * @details Cada faixa (~1 MB de pixels) é renderizada em um buffer reaproveitado e
+     * entregue ao escritor, que a codifica e grava; a Imagem inteira nunca existe em
+     * memória. O arquivo é idêntico ao de gerarImagem seguido de salvarPPM/salvarPNG.
+     * @param destino Escritor já aberto, com largura e altura iguais ao tamanho do mapa.
+     * @param paleta Objeto contendo as cores para mapeamento de alturas.
+     * @param sombreamento Efeito de luz/sombra: true/false (Noroeste ou nenhum) ou Sombreamento::relevo.
+     * @return true se todas as faixas foram gravadas e o escritor finalizado com sucesso.
+     */
+    bool gerarImagem(EscritorImagem& destino, const Paleta& paleta, const Sombreamento& sombreamento = Sombreamento()) const;
+    /**
+     * @brief Gera a imagem do mapa em outra resolução (ex: 4K de um mapa 2049², miniatura de um 16385²).
+     * @details As altitudes são reamostradas direto para a grade de saída (separável:
+     * horizontal, depois vertical), e só então viram cor e sombra; a imagem no tamanho do
+     * mapa nunca é renderizada. As faixas de linhas de saída rodam em paralelo, e cada uma
+     * lê só as linhas do mapa de que precisa. Com largura e altura iguais ao tamanho do
+     * mapa, o resultado é idêntico ao de gerarImagem(paleta, sombreamento).
+     * @param paleta Objeto contendo as cores para mapeamento de alturas.
+     * @param largura Largura da imagem, em pixels.
+     * @param altura Altura da imagem, em pixels.
+     * @param sombreamento Efeito de luz/sombra (calculado na grade de saída).
+     * @param filtro Filtro da reamostragem (padrão: bicúbico para ampliar, caixa para reduzir).
+     * @param layout Organização dos pixels da imagem.
+     * @return Imagem largura × altura.
+     */
+    Imagem gerarImagem(const Paleta& paleta, size_t largura, size_t altura,
+                       const Sombreamento& sombreamento = Sombreamento(),
+                       FiltroReamostragem filtro = FILTRO_AUTOMATICO, LayoutImagem layout = LAYOUT_RGB24) const;
+    /**
+     * @brief Como gerarImagem(paleta, largura, altura, ...), mas direto para um arquivo, faixa por faixa.
+     * @param destino Escritor já aberto, com a largura e a altura pedidas.
+     * @param paleta Objeto contendo as cores para mapeamento de alturas.
+     * @param largura Largura da imagem, em pixels.
+     * @param altura Altura da imagem, em pixels.
+     * @param sombreamento Efeito de luz/sombra (calculado na grade de saída).
+     * @param filtro Filtro da reamostragem (padrão: bicúbico para ampliar, caixa para reduzir).
+     * @return true se todas as faixas foram gravadas e o escritor finalizado com sucesso.
+     */
+    bool gerarImagem(EscritorImagem& destino, const Paleta& paleta, size_t largura, size_t altura,
+                     const Sombreamento& sombreamento = Sombreamento(),
+                     FiltroReamostragem filtro = FILTRO_AUTOMATICO) const;
+    /**
+     * @brief Gera o terreno e a imagem juntos, faixa por faixa, sem guardar o mapa.
+     * @details As linhas do mapa saem em ordem de um GeradorLinhas (o Diamond-Square por
+     * linhas, gerador_linhas.h); cada faixa de ~1 MB de pixels é renderizada assim que suas
+     * linhas (e uma de margem de cada lado, para o sombreamento) ficam prontas, entregue ao
+     * escritor e descartada. Nem o mapa inteiro nem a imagem inteira existem na memória, e
+     * cada altitude é escrita e lida uma vez só. O arquivo é idêntico ao de gerar(N,
+     * rugosidade, semente) seguido de gerarImagem(destino, paleta, sombreamento).
+     * @param destino Escritor já aberto, com largura e altura iguais a 2^N + 1.
+     * @param N Expoente de tamanho. O mapa terá dimensão (2^N + 1).
+     * @param rugosidade Fator de decaimento da aleatoriedade [0.0 - 1.0].
+     * @param semente Semente do gerador de números aleatórios.
+     * @param paleta Objeto contendo as cores para mapeamento de alturas.
+     * @param sombreamento Efeito de luz/sombra: Noroeste, nenhum ou relevo (sombras projetadas
+     * e oclusão ambiente dependem do mapa inteiro e não são aceitas).
+     * @return true se todas as faixas foram gravadas e o escritor finalizado com sucesso.
+     */
+    static bool gerarImagemDireto(EscritorImagem& destino, int N, double rugosidade, unsigned int semente,
+                                  const Paleta& paleta, const Sombreamento& sombreamento = Sombreamento());
+    /**
+     * @brief Como gerarImagem(EscritorImagem&, ...), mas com as etapas em paralelo.
+     * @details Renderização (thread chamadora), codificação e gravação rodam em threads
+     * separadas, ligadas por filas circulares sem travas (fila_circular.h): enquanto uma
+     * faixa é gravada, a seguinte é codificada e a outra renderizada. Poucas faixas ficam
+     * em trânsito ao mesmo tempo, então a memória continua sendo o mapa mais alguns MB.
+     * O arquivo é idêntico ao da versão sequencial.
+     * @param destino Escritor já aberto, com largura e altura iguais ao tamanho do mapa.
+     * @param paleta Objeto contendo as cores para mapeamento de alturas.
+     * @param sombreamento Efeito de luz/sombra: true/false (Noroeste ou nenhum) ou Sombreamento::relevo.
+     * @param estatisticas Se não for nullptr, recebe o tempo ocupado de cada etapa.
+     * @return true se todas as faixas foram gravadas e o arquivo fechado com sucesso.
+     */
+    bool gerarImagemEmEsteira(EscritorImagem& destino, const Paleta& paleta, const Sombreamento& sombreamento = Sombreamento(),
+                              EstatisticasEsteira* estatisticas = nullptr) const;
+    /**
+     * @brief Exporta o mapa como pirâmide de tiles 256×256 no padrão "slippy map" (z/x/y.png).
+     * @details O mapa de (2^k + 1)² pontos vira uma imagem de 2^k × 2^k pixels (a última
+     * linha e a última coluna, que repetem a borda da grade do Diamond-Square, ficam de
+     * fora). No zoom máximo cada tile é renderizado direto do mapa; cada tile dos níveis
+     * acima é a média 2×2 dos seus quatro filhos, sem voltar ao mapa. As subárvores são
+     * processadas em paralelo, cada thread renderizando, reduzindo e gravando seus próprios
+     * tiles. Tiles de uma cor só não são gravados (o visualizador usa a cor de fundo).
+     * @param diretorio Diretório raiz da pirâmide (criado se não existir).
+     * @param paleta Objeto contendo as cores para mapeamento de alturas.
+     * @param sombreamento Efeito de luz/sombra: true/false (Noroeste ou nenhum) ou Sombreamento::relevo.
+     * @param nivelCompressao Nível de compressão dos PNG (ver Imagem::salvarPNG).
+     * @param estatisticas Se não for nullptr, recebe o zoom máximo e as contagens de tiles.
+     * @return true se todos os tiles foram gravados; false se o mapa não tem 2^k + 1 pontos
+     * por lado (k >= 8) ou se houve erro de gravação.
+     */
+    bool salvarPiramideTiles(const char* diretorio, const Paleta& paleta, const Sombreamento& sombreamento = Sombreamento(),
+                             int nivelCompressao = 1, EstatisticasPiramide* estatisticas = nullptr) const;
+    /**
+     * @brief Níveis das curvas de nível: os múltiplos de intervalo entre a menor e a maior altitude.
+     * @param intervalo Distância entre curvas (ex: 0.01 dá 100 curvas em [0, 1]).
+     * @return Altitudes dos níveis, em ordem crescente (vazio se intervalo <= 0).
+     */
+    std::vector<double> niveisCurvas(double intervalo) const;
+    /**
+     * @brief Extrai as curvas de nível do mapa como polilinhas (ver curvas_nivel.h).
+     * @param niveis Altitudes das curvas, em ordem crescente (ex: de niveisCurvas).
+     * @return Curvas em coordenadas de ponto (x = coluna, y = linha), prontas para
+     * salvarCurvasSVG ou salvarCurvasGeoJSON.
+     */
+    std::vector<CurvaNivel> extrairCurvasNivel(const std::vector<double>& niveis) const;
+    /**
+     * @brief Desenha as curvas de nível sobre a imagem do mapa (a de gerarImagem), em paralelo.
+     * @param img Imagem do tamanho do mapa.
+     * @param niveis Altitudes das curvas, em ordem crescente.
+     * @param cor Cor das curvas.
+     * @param opacidade Opacidade das curvas, em [0, 1].
+     * @return false se a imagem não tem o tamanho do mapa.
+     */
+    bool desenharCurvasNivel(Imagem& img, const std::vector<double>& niveis, Pixel cor, double opacidade = 1.0) const;
+    /**
+     * @brief Renderiza o terreno em perspectiva (ver perspectiva.h), com as cores de uma imagem do mapa.
+     * @details Para um voo sobre o terreno, a mesma imagem de cores e a mesma tela servem
+     * para todos os quadros; só a câmera muda.
+     * @param tela Imagem de destino, em qualquer tamanho e layout.
+     * @param cores Cor de cada ponto (ex: gerarImagem, com ou sem curvas de nível), do tamanho do mapa.
+     * @param camera Posição e lente.
+     * @return false se a imagem de cores não tem o tamanho do mapa.
+     */
+    bool gerarPerspectiva(Imagem& tela, const Imagem& cores, const Camera& camera) const;
+    /**
+     * @brief Como gerarPerspectiva(tela, cores, camera), com as cores de gerarImagem(paleta, sombreamento).
+     * @param tela Imagem de destino, em qualquer tamanho e layout.
+     * @param paleta Paleta de cores.
+     * @param sombreamento Sombreamento aplicado às cores do terreno.
+     * @param camera Posição e lente.
+     * @return true se a tela foi renderizada.
+     */
+    bool gerarPerspectiva(Imagem& tela, const Paleta& paleta, const Sombreamento& sombreamento,
+                          const Camera& camera) const;
+    /**
+     * @brief Gera o normal map do terreno, uma normal por ponto empacotada em RGB de 8 bits.
+     * @details Normais por diferenças centrais, no espaço tangente do padrão OpenGL (ver
+     * calcularNormaisLinha, renderizacao.h). As linhas são divididas em faixas paralelas e cada
+     * linha passa por um núcleo vetorial que grava os bytes direto no layout da imagem; a
+     * imagem é a mesma para qualquer número de threads.
+     * @param exagero Multiplicador vertical (1 = o lado do mapa mede 4× a faixa de altitudes, como no relevo).
+     * @param layout Organização dos pixels da imagem.
+     * @return Imagem do tamanho do mapa (o terreno plano fica (128, 128, 255)).
+     */
+    Imagem gerarMapaNormais(double exagero = 1.0, LayoutImagem layout = LAYOUT_RGB24) const;
+    /**
+     * @brief Como gerarMapaNormais(exagero), mas direto para um arquivo, faixa de linhas por faixa.
+     * @details Cada faixa (~1 MB de pixels) é calculada em paralelo num buffer reaproveitado e
+     * entregue ao escritor; a imagem inteira nunca existe em memória.
+     * @param destino Escritor já aberto, com largura e altura iguais ao tamanho do mapa.
+     * @param exagero Multiplicador vertical.
+     * @return true se todas as faixas foram gravadas e o escritor finalizado com sucesso.
+     */
+    bool gerarMapaNormais(EscritorImagem& destino, double exagero = 1.0) const;
+    /**
+     * @brief Como gerarMapaNormais, mas com as normais unitárias em float.
+     * @param exagero Multiplicador vertical.
+     * @return 3 × tamanho × tamanho floats: x (leste), y (norte) e z (cima) de cada ponto, linha a linha.
+     */
+    std::vector<float> calcularNormais(double exagero = 1.0) const;
+    /**
+     * @brief Calcula declividade, orientação e curvatura de cada ponto numa única passada.
+     * @details Uma vizinhança 3×3 por ponto alimenta as três saídas (ver analise_terreno.h),
+     * em faixas de linhas paralelas; o resultado é o mesmo para qualquer número de threads.
+     * Os rasters podem ser salvos com salvarRasterPGM ou coloridos com colorirRaster.
+     * @param exagero Multiplicador vertical (como em gerarMapaNormais).
+     * @param quantizacao Passos de quantização das saídas (padrão: valores contínuos).
+     * @return Os três rasters, com lado igual ao tamanho do mapa.
+     */
+    AnaliseTerreno analisarTerreno(double exagero = 1.0,
+                                   const QuantizacaoAnalise& quantizacao = QuantizacaoAnalise()) const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,117 @@
+#ifndef MAPA_COMPACTADO_H
+#define MAPA_COMPACTADO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "arquivo_io.h"
+
+/**
+ * @brief Formato compactado de mapas de altitudes, dividido em tiles independentes.
+ *
+ * @details Pipeline de compressão de cada tile:
+ * 1. Quantização: k = round(altitude / passo), com passo = 2 × erroMaximo, então a
+ *    altitude reconstruída difere da original em no máximo erroMaximo.
+ * 2. Predição (MED, do JPEG-LS): cada k é previsto a partir dos vizinhos da esquerda,
+ *    de cima e de cima-esquerda; apenas o resíduo (k - previsão) é guardado.
+ * 3. Codificação de entropia: os resíduos passam por um código de Rice adaptativo.
+ *
+ * Como cada tile só usa vizinhos dentro dele mesmo, os tiles são comprimidos e
+ * descomprimidos em paralelo, e qualquer tile pode ser decodificado isoladamente.
+ *
+ * Layout do arquivo (inteiros little-endian):
+ *   "MAPC" | versao u32 | tamanho u64 | ladoTile u32 | passo f64 |
+ *   deslocamentos u64 [numTiles + 1] | dados dos tiles (linha a linha de tiles)
+ */
+
+/**
+ * @brief Comprime um mapa de altitudes e grava no formato compactado.
+ * @param altitudes Matriz tamanho × tamanho armazenada linha a linha.
+ * @param tamanho Dimensão lateral do mapa.
+ * @param nomeArquivo Caminho do arquivo de destino.
+ * @param erroMaximo Maior diferença absoluta aceita entre original e reconstruída (> 0).
+ * @param ladoTile Dimensão lateral de cada tile.
+ * @return true se gravado com sucesso, false caso contrário.
+ */
+bool comprimirMapa(const double* altitudes, size_t tamanho, const char* nomeArquivo,
+                   double erroMaximo, size_t ladoTile);
+
+/**
+ * @brief Leitor de arquivos compactados com acesso aleatório por tile.
+ *
+ * @details Na abertura só o cabeçalho e a tabela de deslocamentos são lidos (e
+ * validados). Decodificar um tile lê do disco, com pread, apenas os bytes daquele tile,
+ * então threads diferentes podem decodificar tiles ao mesmo tempo e ler uma pequena
+ * região custa o mesmo em um arquivo de 1 MB ou de vários GB.
+ */
+class MapaCompactado {
+private:
+    ArquivoEntrada arquivo;
+    bool valido;
+    size_t tamanho;
+    size_t ladoTile;
+    size_t tilesPorLado;
+    double passo;
+    std::vector<uint64_t> deslocamentos;  // Início de cada tile (+ fim do último)
+
+    // Decodifica o tile até a linha linFim e grava só a janela [linInicio, linFim) ×
+    // [colInicio, colFim) (coordenadas do tile), com destino apontando para o canto da janela.
+    // As linhas acima da janela são decodificadas de qualquer forma: a predição depende delas
+    bool decodificarTile(size_t tileLin, size_t tileCol, double* destino, size_t passoLinha, size_t linInicio,
+                         size_t linFim, size_t colInicio, size_t colFim) const;
+
+public:
+    /**
+     * @brief Abre e valida um arquivo compactado.
+     * @param nomeArquivo Caminho do arquivo.
+     */
+    explicit MapaCompactado(const char* nomeArquivo);
+
+    /**
+     * @brief Indica se o arquivo foi aberto e o cabeçalho é válido.
+     * @return true se os tiles podem ser decodificados.
+     */
+    bool ehValido() const;
+    /**
+     * @brief Retorna a dimensão lateral do mapa completo.
+     * @return Tamanho do mapa.
+     */
+    size_t obterTamanho() const;
+    /**
+     * @brief Retorna a dimensão lateral dos tiles (os da borda podem ser menores).
+     * @return Lado do tile.
+     */
+    size_t obterLadoTile() const;
+    /**
+     * @brief Retorna quantos tiles há em cada linha (e coluna) do mapa.
+     * @return Número de tiles por lado.
+     */
+    size_t obterTilesPorLado() const;
+
+    /**
+     * @brief Decodifica um único tile.
+     * @param tileLin Linha do tile (0 a tilesPorLado-1).
+     * @param tileCol Coluna do tile (0 a tilesPorLado-1).
+     * @param destino Onde gravar a altitude do canto superior esquerdo do tile.
+     * @param passoLinha Distância (em doubles) entre linhas consecutivas em destino.
+     * @return true se o tile foi decodificado com sucesso.
+     */
+    bool decodificarTile(size_t tileLin, size_t tileCol, double* destino, size_t passoLinha) const;
+    /**
+     * @brief Lê uma região retangular do mapa, decodificando só os tiles que ela toca.
+     * @details Os tiles envolvidos são lidos e decodificados em paralelo, direto para o
+     * destino; tiles que a região corta embaixo são decodificados só até a última linha
+     * necessária.
+     * @param lin Primeira linha da região.
+     * @param col Primeira coluna da região.
+     * @param altura Número de linhas da região.
+     * @param largura Número de colunas da região.
+     * @param destino Onde gravar a altitude (lin, col).
+     * @param passoLinha Distância (em doubles) entre linhas consecutivas em destino.
+     * @return true se a região está dentro do mapa e foi lida com sucesso.
+     */
+    bool lerRegiao(size_t lin, size_t col, size_t altura, size_t largura,
+                   double* destino, size_t passoLinha) const;
+};
+
+#endif
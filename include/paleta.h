@@ -10,6 +10,15 @@
 #include "cor.h"
 #include "sequencia.h"
 
+/**
+ * @brief Como as altitudes entre duas cores da paleta são coloridas.
+ */
+enum InterpolacaoPaleta {
+    PALETA_FAIXAS,            // Cor da entrada imediatamente abaixo (faixas, o padrão)
+    PALETA_GRADIENTE,         // Mistura as duas entradas vizinhas em sRGB
+    PALETA_GRADIENTE_LINEAR   // Mistura em luz linear (transições de brilho mais uniformes)
+};
+
 /**
  * @brief Gerencia um conjunto de cores (esquema de cores).
  * 
@@ -29,6 +38,9 @@
 class Paleta {
 private:
     Sequencia<Cor> cores; // Uma paleta TEM uma sequência de cores (diferente de É uma paleta de cores)
+    Sequencia<double> posicoes; // Posição de cada cor em [0, 1], ou -1 se não informada
+    bool posicoesValidas;       // Resultado de temPosicoes, atualizado a cada cor adicionada
+    InterpolacaoPaleta interpolacao;
     /*
     Por que Composição?
 
@@ -53,6 +65,7 @@ public:
     /**
      * @brief Construtor que carrega a paleta de um arquivo.
      * @details O arquivo deve conter códigos hexadecimais (ex: #RRGGBB) separados por quebra de linha.
+     * Cada código pode vir seguido da posição da cor em [0, 1] (ex: "#RRGGBB 0.35").
      * @param nomeArquivo Caminho para o arquivo .hex ou .txt.
      */
     explicit Paleta(const char* nomeArquivo);
@@ -63,6 +76,12 @@ public:
      * @param cor Objeto Cor a ser adicionado.
      */
     void adicionarCor(Cor cor);
+    /**
+     * @brief Adiciona uma cor em uma posição específica do gradiente.
+     * @param cor Objeto Cor a ser adicionado.
+     * @param posicao Altitude normalizada [0..1] onde a cor fica.
+     */
+    void adicionarCor(Cor cor, double posicao);
     /**
      * @brief Retorna a quantidade de cores disponíveis na paleta.
      * @return Número inteiro de cores.
@@ -74,6 +93,30 @@ public:
      * @return Cópia da Cor desejada.
      */
     Cor obterCor(int indice) const;
+    /**
+     * @brief Indica se as posições das cores valem para a paleta inteira.
+     * @details Só vale se todas as cores têm posição e as posições não diminuem; senão as
+     * cores ficam igualmente espaçadas. A verificação é feita ao adicionar cada cor, então a
+     * consulta é O(1).
+     * @return true se as posições informadas são usadas.
+     */
+    bool temPosicoes() const;
+    /**
+     * @brief Obtém a posição (altitude normalizada) de uma cor.
+     * @param indice Posição da cor (0 a tamanho-1).
+     * @return A posição informada ou, sem posições válidas, indice / (tamanho - 1).
+     */
+    double obterPosicao(int indice) const;
+    /**
+     * @brief Define como as altitudes entre duas cores são coloridas.
+     * @param modo Faixas (padrão), gradiente sRGB ou gradiente em luz linear.
+     */
+    void definirInterpolacao(InterpolacaoPaleta modo);
+    /**
+     * @brief Retorna o modo de interpolação da paleta.
+     * @return Modo definido por definirInterpolacao.
+     */
+    InterpolacaoPaleta obterInterpolacao() const;
     
 private:
     // Método auxiliar para converter hexadecimal para Cor
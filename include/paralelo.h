@@ -0,0 +1,54 @@
+#ifndef PARALELO_H
+#define PARALELO_H
+
+#include <cstddef>
+#include <functional>
+
+/**
+ * @brief Utilitários para dividir laços em faixas processadas em paralelo.
+ *
+ * @details O mapa e a imagem são matrizes armazenadas linha a linha, então quase todo
+ * processamento pesado pode ser dividido em faixas de linhas independentes. Estas funções
+ * concentram a criação de threads em um único lugar, para que o resto do código só precise
+ * dizer "o que" fazer com cada faixa.
+ */
+
+/**
+ * @brief Define quantas threads os laços paralelos podem usar.
+ * @param num Quantidade de threads (0 = usar todos os núcleos disponíveis).
+ */
+void definirNumThreads(unsigned int num);
+
+/**
+ * @brief Retorna quantas threads os laços paralelos vão usar.
+ * @return Número de threads (sempre >= 1).
+ */
+unsigned int obterNumThreads();
+
+/**
+ * @brief Calcula os limites de uma faixa quando [0, total) é dividido em numFaixas partes.
+ * @param total Tamanho do intervalo.
+ * @param numFaixas Quantidade de faixas.
+ * @param faixa Índice da faixa desejada (0 a numFaixas-1).
+ * @param inicio Recebe o primeiro índice da faixa.
+ * @param fim Recebe o índice logo após o último da faixa.
+ */
+void limitesFaixa(size_t total, size_t numFaixas, size_t faixa, size_t& inicio, size_t& fim);
+
+/**
+ * @brief Divide o intervalo [0, total) em faixas contíguas e as processa em paralelo.
+ * @details As faixas são distribuídas dinamicamente entre as threads (cada thread pega
+ * a próxima faixa livre), então numFaixas pode ser maior que o número de threads.
+ * A thread chamadora também processa faixas; as demais vêm de um pool criado na primeira
+ * chamada e reaproveitado depois, então chamar esta função muitas vezes (ex: uma vez por
+ * faixa de 1 MB de imagem) não custa a criação de threads a cada vez.
+ * Se uma tarefa lança uma exceção, as faixas ainda não iniciadas são abandonadas e a
+ * primeira exceção é relançada aqui, depois que todas as threads saíram do laço.
+ * @param total Tamanho do intervalo (ex: número de linhas).
+ * @param numFaixas Quantidade de faixas em que o intervalo será dividido.
+ * @param tarefa Função chamada como tarefa(faixa, inicio, fim) para cada faixa.
+ */
+void executarEmFaixas(size_t total, size_t numFaixas,
+                      const std::function<void(size_t, size_t, size_t)>& tarefa);
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef PERSPECTIVA_H
+#define PERSPECTIVA_H
+
+#include <cstddef>
+#include "imagem.h"
+
+/**
+ * @brief Vista em perspectiva do terreno, sem GPU (o "voxel space" dos simuladores antigos).
+ *
+ * @details Cada coluna da tela é um raio que anda pelo mapa da câmera para longe. Em cada
+ * passo, a altitude do ponto vira uma altura na tela; se ela passa acima do que a coluna
+ * já desenhou (o y-buffer da coluna), o trecho novo é pintado com a cor daquele ponto.
+ * Como o raio vai de perto para longe, cada pixel é escrito uma vez só e o que está atrás
+ * de um morro nunca é desenhado. O passo cresce com a distância (nível de detalhe), então
+ * o custo por coluna é quase logarítmico no alcance. As colunas são independentes e
+ * divididas em faixas entre as threads; a imagem é a mesma com qualquer número de threads.
+ */
+
+/**
+ * @brief Posição e lente da câmera.
+ * @details A posição é dada em fração do lado do mapa, então a mesma câmera serve para
+ * mapas de qualquer tamanho.
+ */
+struct Camera {
+    double x, y;        // Posição: 0 = borda oeste/norte, 1 = borda leste/sul
+    double altura;      // Altura do olho acima do terreno sob a câmera, na escala das altitudes
+    double direcao;     // Para onde a câmera olha, em graus, horário a partir do norte (topo)
+    double inclinacao;  // Graus abaixo da horizontal (0 = olhar reto para o horizonte)
+    double campoVisao;  // Abertura horizontal, em graus
+    double alcance;     // Distância máxima desenhada, em lados do mapa
+    double exagero;     // Multiplicador vertical (como em Sombreamento)
+    Pixel ceu;          // Cor dos pixels onde nenhum terreno é visto
+
+    /**
+     * @brief Câmera no meio da borda sul, acima do terreno, olhando para o norte.
+     */
+    Camera()
+        : x(0.5), y(1.0), altura(0.5), direcao(0.0), inclinacao(10.0), campoVisao(70.0), alcance(1.5),
+          exagero(1.0), ceu(150, 190, 230) {}
+};
+
+/**
+ * @brief Renderiza o terreno visto pela câmera.
+ * @param altitudes Mapa lado × lado, linha a linha.
+ * @param lado Pontos por lado do mapa.
+ * @param cores Cor de cada ponto do mapa (lado × lado, ex: a imagem de gerarImagem).
+ * @param camera Posição e lente.
+ * @param largura Largura da tela, em pixels.
+ * @param altura Altura da tela, em pixels.
+ * @param destino Vista com largura × altura pixels, em qualquer layout.
+ */
+void renderizarPerspectiva(const double* altitudes, size_t lado, const VistaImagem& cores, const Camera& camera,
+                           size_t largura, size_t altura, const VistaImagem& destino);
+
+#endif
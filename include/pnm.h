@@ -0,0 +1,41 @@
+#ifndef PNM_H
+#define PNM_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Informações do cabeçalho de um arquivo da família PNM (PGM/PPM).
+ *
+ * @details Formato: "P<n>" largura altura valorMaximo, separados por espaços em branco,
+ * com comentários iniciados por '#' permitidos até o fim da linha. Nos formatos binários
+ * (P5/P6) os dados começam logo após o único espaço em branco que segue o valorMaximo.
+ */
+struct CabecalhoPNM {
+    int tipo;             // Número após o 'P' (2/3 = texto, 5/6 = binário)
+    size_t largura;
+    size_t altura;
+    unsigned int valorMaximo;
+    size_t inicioDados;   // Posição (em bytes) do primeiro byte de dados
+};
+
+/**
+ * @brief Interpreta o cabeçalho de um arquivo PNM já carregado em memória.
+ * @param dados Conteúdo do arquivo.
+ * @param tamanho Quantidade de bytes disponíveis.
+ * @param cabecalho Recebe as informações lidas.
+ * @return true se o cabeçalho é válido (tipo P2, P3, P5 ou P6, dimensões e valorMaximo em [1, 65535]).
+ */
+bool lerCabecalhoPNM(const unsigned char* dados, size_t tamanho, CabecalhoPNM& cabecalho);
+
+/**
+ * @brief Monta o texto do cabeçalho PNM (ex: "P5\n513 513\n65535\n").
+ * @param tipo Número após o 'P'.
+ * @param largura Largura em pixels.
+ * @param altura Altura em pixels.
+ * @param valorMaximo Maior valor de amostra.
+ * @return Cabeçalho pronto para ser gravado antes dos dados.
+ */
+std::string montarCabecalhoPNM(int tipo, size_t largura, size_t altura, unsigned int valorMaximo);
+
+#endif
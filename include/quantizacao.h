@@ -0,0 +1,51 @@
+#ifndef QUANTIZACAO_H
+#define QUANTIZACAO_H
+
+#include <cstddef>
+
+/**
+ * @brief Kernels de conversão entre altitudes (double) e amostras inteiras de 16 bits.
+ *
+ * @details Usados na exportação/importação de mapas como imagens em tons de cinza.
+ * O intervalo [minimo, maximo] é mapeado linearmente em [0, valorMaximo]; valores fora do
+ * intervalo são saturados. As amostras são gravadas em big-endian (byte mais significativo
+ * primeiro), como exige o formato PGM de 16 bits. Em processadores x86-64 os laços usam
+ * SSE2 (8 valores por iteração); o resultado é idêntico ao da versão escalar.
+ */
+
+/**
+ * @brief Converte altitudes em amostras de 16 bits big-endian.
+ * @param origem Altitudes de entrada.
+ * @param destino Recebe 2 * n bytes.
+ * @param n Quantidade de valores.
+ * @param minimo Altitude que vira 0.
+ * @param maximo Altitude que vira 65535.
+ */
+void quantizarU16BE(const double* origem, unsigned char* destino, size_t n,
+                    double minimo, double maximo);
+
+/**
+ * @brief Converte amostras de 16 bits big-endian de volta em altitudes.
+ * @param origem Amostras de entrada (2 * n bytes).
+ * @param destino Recebe n altitudes.
+ * @param n Quantidade de valores.
+ * @param minimo Altitude correspondente à amostra 0.
+ * @param maximo Altitude correspondente à amostra valorMaximo.
+ * @param valorMaximo Maior amostra possível no arquivo (65535 no caso usual).
+ */
+void desquantizarU16BE(const unsigned char* origem, double* destino, size_t n,
+                       double minimo, double maximo, unsigned int valorMaximo = 65535);
+
+/**
+ * @brief Converte amostras de 8 bits de volta em altitudes.
+ * @param origem Amostras de entrada (n bytes).
+ * @param destino Recebe n altitudes.
+ * @param n Quantidade de valores.
+ * @param minimo Altitude correspondente à amostra 0.
+ * @param maximo Altitude correspondente à amostra valorMaximo.
+ * @param valorMaximo Maior amostra possível no arquivo (255 no caso usual).
+ */
+void desquantizarU8(const unsigned char* origem, double* destino, size_t n,
+                    double minimo, double maximo, unsigned int valorMaximo = 255);
+
+#endif
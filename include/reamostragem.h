@@ -0,0 +1,110 @@
+#ifndef REAMOSTRAGEM_H
+#define REAMOSTRAGEM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "renderizacao.h"
+
+/**
+ * @brief Reamostragem separável de grades de altitudes (ou de qualquer campo em double).
+ *
+ * @details Cada eixo tem sua tabela de pesos: cada ponto de saída é a soma ponderada de um
+ * número fixo de pontos de origem consecutivos. A grade é reamostrada primeiro na
+ * horizontal (linha a linha) e depois na vertical (combinando linhas já reamostradas), e
+ * só as linhas de origem de que a linha de saída atual precisa ficam na memória. Os laços
+ * têm versões SSE4.1 e AVX2 que produzem os mesmos bits da versão escalar.
+ */
+
+/**
+ * @brief Filtro usado para reamostrar.
+ */
+enum FiltroReamostragem {
+    FILTRO_AUTOMATICO,  // Bicúbico para ampliar, caixa para reduzir (escolhido por eixo)
+    FILTRO_BILINEAR,    // 2 pontos por eixo
+    FILTRO_BICUBICO,    // 4 pontos por eixo (Catmull-Rom)
+    FILTRO_CAIXA        // Média ponderada pela área coberta (para reduzir sem serrilhado)
+};
+
+/**
+ * @brief Pesos da reamostragem de um eixo.
+ * @details Os centros dos pontos ficam alinhados (o ponto de saída i corresponde à posição
+ * (i + 0.5) × origem / destino - 0.5 da origem), então com origem == destino qualquer filtro
+ * copia a grade exatamente. Fora da grade vale a borda mais próxima.
+ */
+struct PesosReamostragem {
+    size_t numSaidas;
+    size_t pontosPorSaida;         // Pontos de origem consecutivos por saída (iguais para todas)
+    std::vector<int32_t> inicio;   // Primeiro ponto de origem de cada saída
+    std::vector<double> pesos;     // pesos[p * numSaidas + i]: peso do ponto inicio[i] + p na saída i
+
+    /**
+     * @brief Calcula os pesos de um eixo.
+     * @param origem Pontos no eixo de origem (> 0).
+     * @param destino Pontos no eixo de saída (> 0).
+     * @param filtro Filtro; FILTRO_AUTOMATICO escolhe pelo sentido da mudança.
+     */
+    PesosReamostragem(size_t origem, size_t destino, FiltroReamostragem filtro);
+};
+
+/**
+ * @brief Reamostra uma linha na horizontal.
+ * @param origem Linha de origem (com os pontos que os pesos indicam).
+ * @param pesos Pesos do eixo horizontal.
+ * @param destino Recebe pesos.numSaidas valores.
+ * @param nivel Conjunto de instruções (nunca acima de obterNivelSimd()).
+ */
+void reamostrarLinha(const double* origem, const PesosReamostragem& pesos, double* destino,
+                     NivelSimd nivel = obterNivelSimd());
+
+/**
+ * @brief Soma ponderada, coluna a coluna, de várias linhas (a etapa vertical).
+ * @param linhas Linhas a combinar.
+ * @param pesos Peso de cada linha.
+ * @param numLinhas Quantidade de linhas.
+ * @param largura Valores por linha.
+ * @param destino Recebe largura valores.
+ * @param nivel Conjunto de instruções (nunca acima de obterNivelSimd()).
+ */
+void combinarLinhas(const double* const* linhas, const double* pesos, size_t numLinhas, size_t largura,
+                    double* destino, NivelSimd nivel = obterNivelSimd());
+
+/**
+ * @brief Produz linhas de uma grade reamostrada, uma de cada vez.
+ * @details Guarda as últimas linhas de origem já reamostradas na horizontal (tantas quanto
+ * os pontos por saída do eixo vertical); pedindo as linhas de saída em ordem crescente,
+ * cada linha de origem é lida e reamostrada uma única vez.
+ */
+class JanelaReamostragem {
+public:
+    // Devolve a linha de origem pedida (válida até a próxima chamada)
+    using LeitorLinha = std::function<const double*(size_t linha)>;
+
+    /**
+     * @brief Prepara a janela.
+     * @param horizontal Pesos do eixo horizontal.
+     * @param vertical Pesos do eixo vertical.
+     * @param lerLinha Acesso às linhas de origem.
+     */
+    JanelaReamostragem(const PesosReamostragem& horizontal, const PesosReamostragem& vertical,
+                       LeitorLinha lerLinha);
+
+    /**
+     * @brief Calcula uma linha da grade reamostrada.
+     * @param linha Linha de saída.
+     * @param destino Recebe horizontal.numSaidas valores.
+     */
+    void calcularLinha(size_t linha, double* destino);
+
+private:
+    const PesosReamostragem& horizontal;
+    const PesosReamostragem& vertical;
+    LeitorLinha lerLinha;
+    std::vector<double> linhas;           // Vagas de linhas reamostradas na horizontal
+    std::vector<std::ptrdiff_t> origemDaVaga;  // Linha de origem em cada vaga (-1 = vazia)
+    std::vector<const double*> ponteiros;
+    std::vector<double> pesosDaLinha;
+};
+
+#endif
@@ -0,0 +1,254 @@
+#ifndef RENDERIZACAO_H
+#define RENDERIZACAO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "imagem.h"
+#include "paleta.h"
+
+/**
+ * @brief Núcleo da renderização altitude → cor → sombra → Pixel, linha a linha.
+ *
+ * @details Usado por MapaAltitudes::gerarImagem e pelas variantes em faixas/esteira.
+ * Há três versões do mesmo laço: escalar, SSE4.1 (4 pixels por iteração) e AVX2
+ * (8 pixels por iteração, com gather da paleta). A melhor suportada pela CPU é
+ * escolhida em tempo de execução, e todas produzem exatamente os mesmos bytes: as
+ * contas são feitas em double, na mesma ordem, e os truncamentos são os mesmos.
+ * A saída pode estar em qualquer LayoutImagem: os núcleos vetoriais são instanciados por
+ * layout e gravam 4 ou 8 pixels por vez direto no formato do destino.
+ */
+
+/**
+ * @brief Conjunto de instruções usado pelo núcleo de renderização.
+ */
+enum NivelSimd {
+    SIMD_ESCALAR,  // Laço comum, sem intrínsecos
+    SIMD_SSE41,    // 4 pixels por iteração
+    SIMD_AVX2      // 8 pixels por iteração
+};
+
+// Com exagero 1, o lado do mapa mede 4× a faixa de altitudes [0, 1]: encostas médias
+// de ~35° para rugosidade 0.5, em qualquer tamanho de mapa
+static const double LADO_POR_ALTURA = 4.0;
+
+/**
+ * @brief Tipo de sombreamento aplicado sobre as cores da paleta.
+ */
+enum TipoSombreamento {
+    SOMBREAMENTO_NENHUM,    // Cores puras da paleta
+    SOMBREAMENTO_NOROESTE,  // Compara cada ponto com o vizinho NO (o padrão original)
+    SOMBREAMENTO_RELEVO     // Lambert com normais de Sobel e luz configurável
+};
+
+/**
+ * @brief Opções de sombreamento da renderização.
+ * @details Construído a partir de um bool (true = Noroeste, false = nenhum), então as
+ * chamadas antigas com aplicarSombreamento continuam valendo.
+ */
+struct Sombreamento {
+    TipoSombreamento tipo;
+    double azimute;   // Direção de onde vem a luz, em graus, horário a partir do norte (topo)
+    double elevacao;  // Altura da luz acima do horizonte, em graus
+    double exagero;   // Multiplicador vertical das altitudes
+    bool sombrasProjetadas;  // Escurece o que fica atrás de relevos mais altos (mesma luz)
+    unsigned int direcoesOclusao;  // Direções da oclusão ambiente (0 = sem oclusão; 8 ou 16)
+
+    /**
+     * @brief Sombreamento Noroeste (ou nenhum), como o parâmetro bool original.
+     * @param aplicar Se true, sombreamento Noroeste; se false, nenhum.
+     */
+    Sombreamento(bool aplicar = true)
+        : tipo(aplicar ? SOMBREAMENTO_NOROESTE : SOMBREAMENTO_NENHUM), azimute(315.0), elevacao(45.0), exagero(1.0),
+          sombrasProjetadas(false), direcoesOclusao(0) {}
+
+    /**
+     * @brief Sombreamento de relevo (hillshade) com a luz dada.
+     * @param azimute Direção da luz em graus (315 = noroeste).
+     * @param elevacao Altura da luz em graus (90 = a pino).
+     * @param exagero Multiplicador vertical (1 = o lado do mapa mede 4× a faixa de altitudes).
+     * @return Opções prontas para gerarImagem.
+     */
+    static Sombreamento relevo(double azimute, double elevacao, double exagero) {
+        Sombreamento s(true);
+        s.tipo = SOMBREAMENTO_RELEVO;
+        s.azimute = azimute;
+        s.elevacao = elevacao;
+        s.exagero = exagero;
+        return s;
+    }
+};
+
+/**
+ * @brief Luz do sombreamento de relevo, pré-calculada para um mapa.
+ * @details O vetor da luz e a escala do gradiente de Sobel são calculados uma vez, e
+ * não a cada pixel.
+ */
+struct IluminacaoRelevo {
+    double luzX, luzY, luzZ;   // Vetor unitário apontando para a luz (x = leste, y = norte)
+    double escalaGradiente;    // Converte a soma de Sobel em inclinação (dz/dx)
+    double difusa;             // Peso da parte de Lambert; o resto (AMBIENTE) é fixo
+
+    /**
+     * @brief Prepara a luz para um mapa com o lado dado.
+     * @param sombreamento Direção da luz e exagero vertical.
+     * @param ladoMapa Pontos por lado do mapa.
+     */
+    IluminacaoRelevo(const Sombreamento& sombreamento, size_t ladoMapa);
+};
+
+/**
+ * @brief Paleta preparada para a renderização: cores num array denso.
+ * @details Cada cor vira um inteiro r | g << 8 | b << 16, o formato lido pelo gather
+ * vetorial. Paleta vazia vira uma única cor preta.
+ * Em modo gradiente, ou com posições personalizadas, o array é uma tabela de 4096 cores
+ * já misturadas (pesos em ponto fixo, em sRGB ou em luz linear), indexada da mesma forma,
+ * então o custo por pixel é o mesmo das faixas.
+ */
+struct PaletaCompilada {
+    std::vector<uint32_t> cores;  // Nunca vazio
+    double escala;                // cores.size() - 1 (com faixas, uma entrada por cor)
+
+    /**
+     * @brief Copia as cores da paleta.
+     * @param paleta Paleta de origem.
+     */
+    explicit PaletaCompilada(const Paleta& paleta);
+};
+
+/**
+ * @brief Fator de sombreamento a partir da altitude do ponto e da do vizinho noroeste.
+ * @param altitudeAtual Altitude do ponto.
+ * @param altitudeNoroeste Altitude do vizinho superior esquerdo.
+ * @return Fator entre 0.3 (sombra forte) e 1.0 (iluminado).
+ */
+inline double fatorSombreamento(double altitudeAtual, double altitudeNoroeste) {
+    // Calcula diferença de altura
+    double diferenca = altitudeNoroeste - altitudeAtual;
+
+    // Se vizinho NO é mais alto, este ponto está "na sombra"
+    if (diferenca > 0) {
+        // Fator de escurecimento proporcional à diferença
+        // diferenca = 0.1 → fator = 0.5 (escurece 50%)
+        // diferenca = 0.3 → fator = 0.1 (escurece 90%)
+        double fator = 1.0 - (diferenca * 5.0);
+
+        // Garante que fator está em [0.3, 1.0]
+        // (nunca escurece mais que 70%)
+        if (fator < 0.3) fator = 0.3;
+        if (fator > 1.0) fator = 1.0;
+
+        return fator;
+    }
+
+    // Sem sombra (ou iluminado)
+    return 1.0;
+}
+
+/**
+ * @brief Retorna o melhor conjunto de instruções suportado por esta CPU.
+ * @details Detectado uma única vez (cpuid) e guardado.
+ * @return Nível SIMD a usar por padrão.
+ */
+NivelSimd obterNivelSimd();
+
+/**
+ * @brief Calcula o fator de relevo (Lambert sobre normais de Sobel) de um trecho de linha.
+ * @details Fora do mapa vale a borda mais próxima (linhas e colunas repetidas). O fator
+ * fica entre o ambiente (encosta de costas para a luz) e 1.0 (de frente para a luz).
+ * @param luz Luz pré-calculada.
+ * @param linhaAcima Linha anterior (na primeira linha, a própria linha).
+ * @param linha Linha do mapa.
+ * @param linhaAbaixo Linha seguinte (na última linha, a própria linha).
+ * @param largura Pontos por linha do mapa.
+ * @param colInicio Primeira coluna.
+ * @param colFim Coluna logo após a última.
+ * @param fatores Recebe colFim - colInicio fatores.
+ * @param nivel Conjunto de instruções (nunca acima de obterNivelSimd()).
+ */
+void calcularRelevoLinha(const IluminacaoRelevo& luz, const double* linhaAcima, const double* linha,
+                         const double* linhaAbaixo, size_t largura, size_t colInicio, size_t colFim,
+                         double* fatores, NivelSimd nivel = obterNivelSimd());
+
+/**
+ * @brief Calcula as normais de um trecho de linha por diferenças centrais, em float.
+ * @details A normal de cada ponto é (-dz/dx, dz/dy, 1) normalizada, com x para o leste, y para
+ * o norte e z para cima: o espaço tangente dos normal maps no padrão OpenGL (verde apontando
+ * para o topo da imagem). Na borda do mapa a diferença é de um lado só (o ponto e o vizinho
+ * que existe), então a inclinação da borda não cai pela metade.
+ * @param escala Converte a diferença de altitude entre dois pontos vizinhos em inclinação
+ *               (ex: exagero × (lado - 1) / LADO_POR_ALTURA, a mesma escala do relevo).
+ * @param linhaAcima Linha anterior (na primeira linha, a própria linha).
+ * @param linha Linha do mapa.
+ * @param linhaAbaixo Linha seguinte (na última linha, a própria linha).
+ * @param largura Pontos por linha do mapa.
+ * @param colInicio Primeira coluna.
+ * @param colFim Coluna logo após a última.
+ * @param normais Recebe 3 × (colFim - colInicio) floats: x, y e z de cada ponto.
+ * @param nivel Conjunto de instruções (nunca acima de obterNivelSimd()).
+ */
+void calcularNormaisLinha(double escala, const double* linhaAcima, const double* linha, const double* linhaAbaixo,
+                          size_t largura, size_t colInicio, size_t colFim, float* normais,
+                          NivelSimd nivel = obterNivelSimd());
+
+/**
+ * @brief Como calcularNormaisLinha, mas empacotando cada normal direto num pixel RGB de 8 bits.
+ * @details Cada componente n, em [-1, 1], vira o byte (int)(n × 127.5 + 128): o terreno plano
+ * fica (128, 128, 255).
+ * @param escala Converte a diferença de altitude entre dois pontos vizinhos em inclinação.
+ * @param linhaAcima Linha anterior (na primeira linha, a própria linha).
+ * @param linha Linha do mapa.
+ * @param linhaAbaixo Linha seguinte (na última linha, a própria linha).
+ * @param largura Pontos por linha do mapa.
+ * @param colInicio Primeira coluna.
+ * @param colFim Coluna logo após a última.
+ * @param destino Recebe colFim - colInicio pixels a partir do seu pixel (0, 0), em qualquer layout.
+ * @param nivel Conjunto de instruções (nunca acima de obterNivelSimd()).
+ */
+void renderizarNormaisLinha(double escala, const double* linhaAcima, const double* linha, const double* linhaAbaixo,
+                            size_t largura, size_t colInicio, size_t colFim, const VistaImagem& destino,
+                            NivelSimd nivel = obterNivelSimd());
+
+/**
+ * @brief Renderiza as colunas [colInicio, colFim) de uma linha do mapa.
+ * @param paleta Paleta compilada.
+ * @param linha Início da linha do mapa (altitudes).
+ * @param linhaAcima Início da linha anterior, para a sombra; nullptr na primeira linha.
+ * @param colInicio Primeira coluna.
+ * @param colFim Coluna logo após a última.
+ * @param aplicarSombreamento Se true, aplica o sombreamento Noroeste.
+ * @param destino Recebe colFim - colInicio pixels a partir do seu pixel (0, 0), em
+ *                qualquer layout (um Pixel* vira uma vista RGB24).
+ * @param nivel Conjunto de instruções (nunca acima de obterNivelSimd()).
+ */
+void renderizarLinha(const PaletaCompilada& paleta, const double* linha, const double* linhaAcima,
+                     size_t colInicio, size_t colFim, bool aplicarSombreamento, const VistaImagem& destino,
+                     NivelSimd nivel = obterNivelSimd());
+
+/**
+ * @brief Como renderizarLinha, mas multiplicando cada cor por um fator já calculado.
+ * @param paleta Paleta compilada.
+ * @param linha Início da linha do mapa (altitudes).
+ * @param fatores Fator de cada coluna (fatores[0] é o de colInicio), em [0, 1].
+ * @param colInicio Primeira coluna.
+ * @param colFim Coluna logo após a última.
+ * @param destino Recebe colFim - colInicio pixels a partir do seu pixel (0, 0), em qualquer layout.
+ * @param nivel Conjunto de instruções (nunca acima de obterNivelSimd()).
+ */
+void renderizarLinhaComFatores(const PaletaCompilada& paleta, const double* linha, const double* fatores,
+                               size_t colInicio, size_t colFim, const VistaImagem& destino,
+                               NivelSimd nivel = obterNivelSimd());
+
+/**
+ * @brief Converte uma linha de pixels de qualquer layout para RGB intercalado.
+ * @details Feito só na hora de codificar (PPM/PNG). RGBA32 é compactado com um shuffle
+ * por vetor; o planar intercala os três planos, 16 pixels por vez.
+ * @param origem Vista começando no primeiro pixel da linha.
+ * @param largura Pixels a converter.
+ * @param destino Recebe largura pixels.
+ * @param nivel Conjunto de instruções (nunca acima de obterNivelSimd()).
+ */
+void converterLinhaRGB24(const VistaImagem& origem, size_t largura, Pixel* destino,
+                         NivelSimd nivel = obterNivelSimd());
+
+#endif
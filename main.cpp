@@ -1,10 +1,19 @@
 // main.cpp - Programa principal do gerador de terrenos
 #include <iostream>
 #include <cstring>//para o strcmp (comparar strings C)
+#include <cstdlib>
+#include <cstdio>
+#include <memory>
+#include <chrono>
 #include <iomanip>//formatar saida (tabelas, casas decimais) | deixa o console mais bonito
+#include <ctime>
+#include <cmath>
 #include "mapa_altitudes.h"
 #include "paleta.h"
 #include "imagem.h"
+#include "escritor_imagem.h"
+#include "cache_resultados.h"
+#include "paralelo.h"
 
 using namespace std;
 
@@ -23,6 +32,22 @@ string alinharEsquerda(const string& texto, int largura) {
     return texto + string(largura - texto.length(), ' ');
 }
 
+// Verifica se o nome do arquivo termina com a extensão dada
+bool terminaCom(const char* texto, const char* sufixo) {
+    size_t n = strlen(texto), m = strlen(sufixo);
+    return n >= m && strcmp(texto + n - m, sufixo) == 0;
+}
+
+// Bits exatos de um double em hexadecimal, para a chave do cache: to_string guarda só 6 casas,
+// e valores como 315 e 315.0000001 dariam a mesma chave
+string bitsExatos(double valor) {
+    uint64_t bits;
+    memcpy(&bits, &valor, sizeof(bits));
+    char texto[17];
+    snprintf(texto, sizeof(texto), "%016llx", static_cast<unsigned long long>(bits));
+    return string(texto);
+}
+
 void mostrarAjuda() {
     const int LARGURA = 60;
     
@@ -35,13 +60,52 @@ void mostrarAjuda() {
     cout << "  gerador_terrenos [opcoes]\n\n";
     
     cout << "OPCOES:\n";
-    cout << "  -n <numero>     Tamanho do mapa: 2^n + 1\n";
+    cout << "  -n <numero>     Tamanho do mapa: 2^n + 1 (n de 1 a 13)\n";
     cout << "                  Exemplos: n=3 -> 9x9, n=5 -> 33x33, n=7 -> 129x129\n";
     cout << "  -r <decimal>    Rugosidade do terreno [0.0 - 1.0]\n";
     cout << "                  0.0 = muito suave, 1.0 = muito acidentado\n";
+    cout << "  -s <numero>     Semente do gerador (mesma semente, mesmo terreno)\n";
+    cout << "  -t <numero>     Threads usadas na geracao e na renderizacao\n";
+    cout << "                  (padrao: 0 = todos os nucleos)\n";
     cout << "  -p <arquivo>    Arquivo da paleta de cores (padrao: cores.hex)\n";
     cout << "  -o <arquivo>    Nome do arquivo de saida (padrao: terreno.ppm)\n";
+    cout << "                  Terminado em .png salva em PNG\n";
     cout << "  --sem-sombra    Desativa sombreamento (debug)\n";
+    cout << "  --relevo        Sombreamento de relevo (luz direcional sobre as encostas)\n";
+    cout << "  --sombras       Sombras projetadas pelo relevo (mesma luz do --relevo)\n";
+    cout << "  --oclusao <8|16>    Oclusao ambiente: escurece vales e fendas pela\n";
+    cout << "                  parte do ceu que o relevo esconde (8 ou 16 direcoes)\n";
+    cout << "  --azimute <graus>   Direcao da luz do relevo (padrao: 315 = noroeste)\n";
+    cout << "  --elevacao <graus>  Altura da luz do relevo (padrao: 45)\n";
+    cout << "  --exagero <fator>   Exagero vertical do relevo (padrao: 1.0)\n";
+    cout << "  --gradiente     Mistura as cores vizinhas da paleta (sem faixas)\n";
+    cout << "  --gradiente-linear  Idem, misturando em luz linear\n";
+    cout << "  --largura <px>  Largura da imagem (padrao: a do mapa); reamostra as altitudes\n";
+    cout << "  --altura <px>   Altura da imagem (padrao: igual a largura)\n";
+    cout << "  --filtro <nome> Reamostragem: bilinear, bicubico ou caixa\n";
+    cout << "                  (padrao: bicubico para ampliar, caixa para reduzir)\n";
+    cout << "  --ppm-texto     Salva em PPM texto (P3)\n";
+    cout << "  --ppm-binario   Salva em PPM binario (P6)\n";
+    cout << "                  (padrao: P6 acima de 256x256 pixels, senao P3)\n";
+    cout << "  --curvas <intervalo>  Desenha curvas de nivel a cada <intervalo> de\n";
+    cout << "                  altitude (ex: 0.02)\n";
+    cout << "  --curvas-vetor <arq>  Salva tambem as curvas como polilinhas (.svg ou\n";
+    cout << "                  .geojson); exige --curvas\n";
+    cout << "  --perspectiva <x,y,altura,direcao[,inclinacao]>  Vista 3D do terreno:\n";
+    cout << "                  camera em (x, y) (fracao do lado do mapa, 0 a 1), altura\n";
+    cout << "                  acima do terreno, direcao e inclinacao em graus\n";
+    cout << "                  (tela de --largura x --altura; padrao 1920x1080)\n";
+    cout << "  --normais <arq> Salva tambem o mapa de normais do terreno (.png ou .ppm),\n";
+    cout << "                  com o exagero de --exagero\n";
+    cout << "  --analise <prefixo>  Salva tambem declividade, orientacao e curvatura\n";
+    cout << "                  (prefixo_declividade.pgm, _orientacao.pgm, _curvatura.pgm)\n";
+    cout << "  --tiles <dir>   Exporta uma piramide de tiles 256x256 (dir/z/x/y.png)\n";
+    cout << "                  em vez da imagem unica (n >= 8)\n";
+    cout << "  --cache <dir>   Reaproveita imagens ja geradas com os mesmos parametros\n";
+    cout << "                  (exige -s; a imagem e entregue por hard link)\n";
+    cout << "  --cache-limite <MB>  Tamanho maximo do cache (padrao: 1024 MB)\n";
+    cout << "  --esteira       Renderiza, codifica e grava em paralelo (threads\n";
+    cout << "                  separadas) e mostra o tempo de cada etapa\n";
     cout << "  -h, --help      Mostra esta ajuda\n\n";
     
     cout << "EXEMPLOS:\n";
@@ -61,6 +125,29 @@ int main(int argc, char* argv[]) {
     const char* arquivoPaleta = "data/cores.hex";
     const char* arquivoSaida = "output/terreno.ppm";
     bool aplicarSombra = true;
+    bool usarRelevo = false;
+    bool usarSombras = false;
+    int direcoesOclusao = 0;
+    long larguraSaida = 0, alturaSaida = 0;  // 0 = tamanho do mapa
+    FiltroReamostragem filtro = FILTRO_AUTOMATICO;
+    bool filtroValido = true;
+    double azimute = 315.0, elevacao = 45.0, exagero = 1.0;
+    FormatoPPM formatoSaida = PPM_AUTOMATICO;
+    bool usarEsteira = false;
+    const char* diretorioTiles = nullptr;
+    bool temSemente = false;
+    unsigned int semente = 0;
+    const char* diretorioCache = nullptr;
+    double limiteCacheMB = 1024.0;
+    int numThreads = 0;
+    InterpolacaoPaleta interpolacao = PALETA_FAIXAS;
+    double intervaloCurvas = 0.0;  // 0 = sem curvas de nivel
+    const char* arquivoCurvas = nullptr;
+    const char* arquivoNormais = nullptr;
+    const char* prefixoAnalise = nullptr;
+    bool usarPerspectiva = false;
+    bool cameraValida = true;
+    Camera camera;
     
     // PASSO 2: Processar argumentos da linha de comando
     for (int i = 1; i < argc; i++) {
@@ -70,6 +157,19 @@ int main(int argc, char* argv[]) {
         else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
             rugosidade = atof(argv[++i]);
         }
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            semente = static_cast<unsigned int>(strtoul(argv[++i], nullptr, 10));
+            temSemente = true;
+        }
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            numThreads = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+            diretorioCache = argv[++i];
+        }
+        else if (strcmp(argv[i], "--cache-limite") == 0 && i + 1 < argc) {
+            limiteCacheMB = atof(argv[++i]);
+        }
         else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
             arquivoPaleta = argv[++i];
         }
@@ -79,6 +179,74 @@ int main(int argc, char* argv[]) {
         else if (strcmp(argv[i], "--sem-sombra") == 0) {
             aplicarSombra = false;
         }
+        else if (strcmp(argv[i], "--relevo") == 0) {
+            usarRelevo = true;
+        }
+        else if (strcmp(argv[i], "--sombras") == 0) {
+            usarSombras = true;
+        }
+        else if (strcmp(argv[i], "--oclusao") == 0 && i + 1 < argc) {
+            direcoesOclusao = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--azimute") == 0 && i + 1 < argc) {
+            azimute = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--elevacao") == 0 && i + 1 < argc) {
+            elevacao = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--exagero") == 0 && i + 1 < argc) {
+            exagero = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--gradiente") == 0) {
+            interpolacao = PALETA_GRADIENTE;
+        }
+        else if (strcmp(argv[i], "--gradiente-linear") == 0) {
+            interpolacao = PALETA_GRADIENTE_LINEAR;
+        }
+        else if (strcmp(argv[i], "--largura") == 0 && i + 1 < argc) {
+            larguraSaida = atol(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--altura") == 0 && i + 1 < argc) {
+            alturaSaida = atol(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--filtro") == 0 && i + 1 < argc) {
+            const char* nome = argv[++i];
+            filtro = strcmp(nome, "bilinear") == 0 ? FILTRO_BILINEAR
+                : strcmp(nome, "bicubico") == 0 ? FILTRO_BICUBICO
+                : strcmp(nome, "caixa") == 0 ? FILTRO_CAIXA : FILTRO_AUTOMATICO;
+            filtroValido = filtro != FILTRO_AUTOMATICO;
+        }
+        else if (strcmp(argv[i], "--ppm-texto") == 0) {
+            formatoSaida = PPM_TEXTO;
+        }
+        else if (strcmp(argv[i], "--ppm-binario") == 0) {
+            formatoSaida = PPM_BINARIO;
+        }
+        else if (strcmp(argv[i], "--curvas") == 0 && i + 1 < argc) {
+            intervaloCurvas = atof(argv[++i]);
+            if (intervaloCurvas <= 0.0) intervaloCurvas = -1.0;  // Invalido (validado no passo 3)
+        }
+        else if (strcmp(argv[i], "--curvas-vetor") == 0 && i + 1 < argc) {
+            arquivoCurvas = argv[++i];
+        }
+        else if (strcmp(argv[i], "--normais") == 0 && i + 1 < argc) {
+            arquivoNormais = argv[++i];
+        }
+        else if (strcmp(argv[i], "--analise") == 0 && i + 1 < argc) {
+            prefixoAnalise = argv[++i];
+        }
+        else if (strcmp(argv[i], "--perspectiva") == 0 && i + 1 < argc) {
+            usarPerspectiva = true;
+            int lidos = sscanf(argv[++i], "%lf,%lf,%lf,%lf,%lf", &camera.x, &camera.y, &camera.altura,
+                               &camera.direcao, &camera.inclinacao);
+            cameraValida = lidos >= 4;
+        }
+        else if (strcmp(argv[i], "--tiles") == 0 && i + 1 < argc) {
+            diretorioTiles = argv[++i];
+        }
+        else if (strcmp(argv[i], "--esteira") == 0) {
+            usarEsteira = true;
+        }
         else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
             mostrarAjuda();
             return 0;
@@ -91,9 +259,9 @@ int main(int argc, char* argv[]) {
     }
     
     // PASSO 3: Validar parâmetros
-    if (N < 1 || N > 10) {
-        cerr << "ERRO: N deve estar entre 1 e 10\n";
-        cerr << "       (mapas de 3x3 ate 1025x1025)\n";
+    if (N < 1 || N > 13) {
+        cerr << "ERRO: N deve estar entre 1 e 13\n";
+        cerr << "       (mapas de 3x3 ate 8193x8193)\n";
         return 1;
     }
     
@@ -102,8 +270,122 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
+    if (elevacao < 0.0 || elevacao > 90.0) {
+        cerr << "ERRO: Elevacao deve estar entre 0 e 90 graus\n";
+        return 1;
+    }
+    
+    if (exagero <= 0.0) {
+        cerr << "ERRO: Exagero deve ser maior que 0\n";
+        return 1;
+    }
+    
+    if (direcoesOclusao != 0 && direcoesOclusao != 8 && direcoesOclusao != 16) {
+        cerr << "ERRO: Oclusao ambiente usa 8 ou 16 direcoes\n";
+        return 1;
+    }
+    
+    Sombreamento sombreamento(aplicarSombra);
+    if (aplicarSombra && usarRelevo) {
+        sombreamento = Sombreamento::relevo(azimute, elevacao, exagero);
+    }
+    if (aplicarSombra && usarSombras) {
+        sombreamento.azimute = azimute;
+        sombreamento.elevacao = elevacao;
+        sombreamento.exagero = exagero;
+        sombreamento.sombrasProjetadas = true;
+    }
+    if (aplicarSombra && direcoesOclusao > 0) {
+        sombreamento.exagero = exagero;
+        sombreamento.direcoesOclusao = static_cast<unsigned int>(direcoesOclusao);
+    }
+    
+    // Dimensoes da imagem: limite de 65535 por lado (o mesmo dos visualizadores comuns)
+    if (larguraSaida < 0 || larguraSaida > 65535 || alturaSaida < 0 || alturaSaida > 65535) {
+        cerr << "ERRO: Largura e altura devem estar entre 1 e 65535 pixels\n";
+        return 1;
+    }
+    
+    if (!filtroValido) {
+        cerr << "ERRO: Filtro deve ser bilinear, bicubico ou caixa\n";
+        return 1;
+    }
+    
+    if ((larguraSaida > 0 || alturaSaida > 0) && (diretorioTiles || usarEsteira)) {
+        cerr << "ERRO: --largura/--altura nao podem ser usados com --tiles nem com --esteira\n";
+        return 1;
+    }
+    
+    if (intervaloCurvas < 0.0) {
+        cerr << "ERRO: Intervalo das curvas de nivel deve ser maior que 0\n";
+        return 1;
+    }
+    
+    if (intervaloCurvas > 0.0 && (diretorioTiles || usarEsteira
+                                  || (!usarPerspectiva && (larguraSaida > 0 || alturaSaida > 0)))) {
+        cerr << "ERRO: --curvas nao pode ser usado com --tiles, --esteira nem --largura/--altura\n";
+        return 1;
+    }
+    
+    if (usarPerspectiva && !cameraValida) {
+        cerr << "ERRO: --perspectiva espera x,y,altura,direcao[,inclinacao]\n";
+        return 1;
+    }
+    
+    if (usarPerspectiva && (camera.x < 0.0 || camera.x > 1.0 || camera.y < 0.0 || camera.y > 1.0
+                            || camera.inclinacao <= -90.0 || camera.inclinacao >= 90.0)) {
+        cerr << "ERRO: A camera deve estar dentro do mapa (x e y de 0 a 1), com inclinacao entre -90 e 90\n";
+        return 1;
+    }
+    
+    if (usarPerspectiva && (diretorioTiles || usarEsteira)) {
+        cerr << "ERRO: --perspectiva nao pode ser usado com --tiles nem com --esteira\n";
+        return 1;
+    }
+    
+    if (arquivoCurvas && intervaloCurvas == 0.0) {
+        cerr << "ERRO: --curvas-vetor exige --curvas\n";
+        return 1;
+    }
+    
+    if (arquivoCurvas && !terminaCom(arquivoCurvas, ".svg") && !terminaCom(arquivoCurvas, ".geojson")) {
+        cerr << "ERRO: O arquivo das curvas deve terminar em .svg ou .geojson\n";
+        return 1;
+    }
+    
+    if (!(limiteCacheMB >= 0.0) || limiteCacheMB > 1048576.0) {
+        cerr << "ERRO: --cache-limite deve estar entre 0 e 1048576 MB\n";
+        return 1;
+    }
+    
+    if (numThreads < 0 || numThreads > 256) {
+        cerr << "ERRO: Threads deve estar entre 0 (automatico) e 256\n";
+        return 1;
+    }
+    definirNumThreads(static_cast<unsigned int>(numThreads));
+    
     // PASSO 4: Exibir configuração
     int tamanho = (1 << N) + 1;
+    if (usarPerspectiva && larguraSaida == 0 && alturaSaida == 0) {
+        larguraSaida = 1920;
+        alturaSaida = 1080;
+    }
+    camera.exagero = exagero;
+    size_t larguraImagem = larguraSaida > 0 ? static_cast<size_t>(larguraSaida)
+        : alturaSaida > 0 ? static_cast<size_t>(alturaSaida) : static_cast<size_t>(tamanho);
+    size_t alturaImagem = alturaSaida > 0 ? static_cast<size_t>(alturaSaida) : larguraImagem;
+    
+    // Sem -s, uma semente diferente a cada execucao (como em MapaAltitudes::gerar)
+    if (!temSemente) {
+        semente = static_cast<unsigned int>(time(nullptr));
+    }
+    
+    // Quando so a imagem interessa e nada precisa do mapa inteiro (sombras projetadas,
+    // oclusao, tiles, reamostragem, curvas), o terreno e gerado junto com a imagem, faixa por faixa
+    bool direto = !diretorioTiles && !usarEsteira && !sombreamento.sombrasProjetadas && intervaloCurvas == 0.0
+        && !usarPerspectiva && !arquivoNormais && !prefixoAnalise
+        && sombreamento.direcoesOclusao == 0
+        && larguraImagem == static_cast<size_t>(tamanho) && alturaImagem == static_cast<size_t>(tamanho);
     
     cout << "\n" << string(LARGURA, '=') << "\n";
     cout << centralizar("CONFIGURACAO", LARGURA) << "\n";
@@ -112,6 +394,11 @@ int main(int argc, char* argv[]) {
     cout << left << setw(25) << "  Tamanho do mapa:" 
          << right << setw(10) << tamanho << "x" << tamanho << "\n";
     
+    if (larguraImagem != static_cast<size_t>(tamanho) || alturaImagem != static_cast<size_t>(tamanho)) {
+        cout << left << setw(25) << "  Imagem:" 
+             << right << setw(10) << larguraImagem << "x" << alturaImagem << "\n";
+    }
+    
     cout << left << setw(25) << "  Rugosidade:" 
          << right << setw(10) << fixed << setprecision(2) << rugosidade << "\n";
     
@@ -119,22 +406,150 @@ int main(int argc, char* argv[]) {
          << right << setw(10) << arquivoPaleta << "\n";
     
     cout << left << setw(25) << "  Saida:" 
-         << right << setw(10) << arquivoSaida << "\n";
+         << right << setw(10) << (diretorioTiles ? diretorioTiles : arquivoSaida) << "\n";
     
     cout << left << setw(25) << "  Sombreamento:" 
-         << right << setw(10) << (aplicarSombra ? "Sim" : "Nao") << "\n";
+         << right << setw(10) << (!aplicarSombra ? "Nao" : usarRelevo ? "Relevo" : "Sim")
+         << (sombreamento.sombrasProjetadas ? " + sombras" : "")
+         << (sombreamento.direcoesOclusao > 0 ? " + oclusao" : "") << "\n";
+    
+    if (usarPerspectiva) {
+        cout << left << setw(25) << "  Perspectiva:" 
+             << right << setw(10) << setprecision(2) << camera.x << ", " << camera.y << ", "
+             << camera.altura << ", " << camera.direcao << " graus\n";
+    }
+    
+    if (intervaloCurvas > 0.0) {
+        cout << left << setw(25) << "  Curvas de nivel:" 
+             << right << setw(10) << setprecision(4) << intervaloCurvas << "\n";
+    }
+    
+    cout << left << setw(25) << "  Threads:" 
+         << right << setw(10) << obterNumThreads() << "\n";
+    
+    cout << left << setw(25) << "  Geracao:" 
+         << right << setw(10) << (direto ? "Em faixas" : "Mapa inteiro") << "\n";
     
     cout << string(LARGURA, '=') << "\n\n";
     
-    // PASSO 5: Gerar mapa de altitudes
+    auto inicioTotal = chrono::steady_clock::now();
+    
+    // PASSO 4.5: Consultar o cache (so faz sentido com semente fixa: sem -s cada execucao
+    // gera um terreno diferente)
+    unique_ptr<CacheResultados> cache;
+    string chaveCache, extensaoCache;
+    if (diretorioCache && !diretorioTiles) {
+        if (!temSemente) {
+            cout << "[cache] Ignorado: use -s para fixar a semente\n";
+        } else if (arquivoCurvas) {
+            cout << "[cache] Ignorado: o cache guarda so a imagem, nao as curvas em vetor\n";
+        } else if (arquivoNormais) {
+            cout << "[cache] Ignorado: o cache guarda so a imagem, nao o mapa de normais\n";
+        } else if (prefixoAnalise) {
+            cout << "[cache] Ignorado: o cache guarda so a imagem, nao a analise do terreno\n";
+        } else {
+            bool png = terminaCom(arquivoSaida, ".png");
+            const char* formato = png ? "png"
+                : formatoSaida == PPM_TEXTO ? "ppm-texto"
+                : formatoSaida == PPM_BINARIO ? "ppm-binario" : "ppm-automatico";
+            extensaoCache = png ? ".png" : ".ppm";
+            string estilo = interpolacao == PALETA_GRADIENTE ? "gradiente"
+                : interpolacao == PALETA_GRADIENTE_LINEAR ? "gradiente-linear" : "faixas";
+            if (sombreamento.tipo == SOMBREAMENTO_RELEVO) {
+                estilo += " relevo " + bitsExatos(azimute) + " " + bitsExatos(elevacao) + " " + bitsExatos(exagero);
+            }
+            if (sombreamento.sombrasProjetadas) {
+                estilo += " sombras " + bitsExatos(azimute) + " " + bitsExatos(elevacao) + " " + bitsExatos(exagero);
+            }
+            if (sombreamento.direcoesOclusao > 0) {
+                estilo += " oclusao " + to_string(sombreamento.direcoesOclusao) + " " + bitsExatos(exagero);
+            }
+            if (larguraImagem != static_cast<size_t>(tamanho) || alturaImagem != static_cast<size_t>(tamanho)) {
+                estilo += " imagem " + to_string(larguraImagem) + "x" + to_string(alturaImagem)
+                    + " filtro " + to_string(static_cast<int>(filtro));
+            }
+            if (intervaloCurvas > 0.0) {
+                estilo += " curvas " + bitsExatos(intervaloCurvas);
+            }
+            if (usarPerspectiva) {
+                estilo += " perspectiva " + bitsExatos(camera.x) + " " + bitsExatos(camera.y) + " "
+                    + bitsExatos(camera.altura) + " " + bitsExatos(camera.direcao) + " "
+                    + bitsExatos(camera.inclinacao) + " " + bitsExatos(camera.exagero);
+            }
+            chaveCache = calcularChaveTerreno(N, rugosidade, semente, arquivoPaleta, aplicarSombra, formato,
+                                              estilo.c_str());
+            cache.reset(new CacheResultados(diretorioCache, static_cast<uint64_t>(limiteCacheMB * 1024 * 1024)));
+            
+            if (cache->aberto() && cache->buscar(chaveCache, extensaoCache, arquivoSaida)) {
+                cout << "[cache] Resultado encontrado (" << chaveCache << "): geracao e renderizacao puladas\n\n";
+                cout << string(LARGURA, '=') << "\n";
+                cout << centralizar("SUCESSO!", LARGURA) << "\n";
+                cout << string(LARGURA, '=') << "\n";
+                cout << left << setw(20) << "  Imagem gerada:" << arquivoSaida << " (do cache)\n";
+                cout << left << setw(20) << "  Tempo total:" << setprecision(3)
+                     << chrono::duration<double>(chrono::steady_clock::now() - inicioTotal).count() << " s\n";
+                cout << left << setw(20) << "  Cache:" << cache->obterAcertos() << " acertos, "
+                     << cache->obterFalhas() << " falhas\n";
+                cout << string(LARGURA, '=') << "\n";
+                return 0;
+            }
+        }
+    }
+    
+    // PASSO 5: Gerar mapa de altitudes (no modo direto, so no passo 8, junto com a imagem)
     cout << "[1/4] Gerando mapa de altitudes...";
     MapaAltitudes mapa;
-    mapa.gerar(N, rugosidade);
-    cout << " [OK]\n";
+    if (direto) {
+        cout << " [junto com a imagem]\n";
+    } else {
+        mapa.gerar(N, rugosidade, semente);
+        cout << " [OK]\n";
+    }
+    
+    // PASSO 5.5: Mapa de normais do mesmo terreno, faixa por faixa direto para o arquivo
+    if (arquivoNormais) {
+        cout << "      Salvando mapa de normais...";
+        unique_ptr<EscritorImagem> escritorNormais;
+        if (terminaCom(arquivoNormais, ".png")) {
+            escritorNormais.reset(new EscritorPNG(arquivoNormais, tamanho, tamanho));
+        } else {
+            escritorNormais.reset(new EscritorPPM(arquivoNormais, tamanho, tamanho, formatoSaida));
+        }
+        if (!mapa.gerarMapaNormais(*escritorNormais, exagero)) {
+            cout << " [ERRO]\n";
+            cerr << "ERRO: Nao foi possivel salvar o mapa de normais: " << arquivoNormais << "\n";
+            return 1;
+        }
+        cout << " [OK]\n";
+    }
+    
+    // PASSO 5.6: Declividade, orientacao e curvatura numa unica passada, cada uma num PGM de 16 bits
+    if (prefixoAnalise) {
+        cout << "      Salvando analise do terreno...";
+        AnaliseTerreno analise = mapa.analisarTerreno(exagero);
+        // A curvatura e simetrica em torno de zero (cinza medio = plano)
+        double curvaturaMaxima = 0.0;
+        for (float k : analise.curvatura) {
+            curvaturaMaxima = max(curvaturaMaxima, static_cast<double>(fabs(k)));
+        }
+        string prefixo(prefixoAnalise);
+        if (!salvarRasterPGM((prefixo + "_declividade.pgm").c_str(), analise.declividade.data(), analise.lado,
+                             0.0, 90.0)
+            || !salvarRasterPGM((prefixo + "_orientacao.pgm").c_str(), analise.orientacao.data(), analise.lado,
+                                0.0, 360.0)
+            || !salvarRasterPGM((prefixo + "_curvatura.pgm").c_str(), analise.curvatura.data(), analise.lado,
+                                -curvaturaMaxima, curvaturaMaxima)) {
+            cout << " [ERRO]\n";
+            cerr << "ERRO: Nao foi possivel salvar a analise do terreno: " << prefixoAnalise << "\n";
+            return 1;
+        }
+        cout << " [OK]\n";
+    }
     
     // PASSO 6: Carregar paleta de cores
     cout << "[2/4] Carregando paleta de cores...";
     Paleta paleta(arquivoPaleta);
+    paleta.definirInterpolacao(interpolacao);
     
     if (paleta.obterTamanho() == 0) {
         cout << " [ERRO]\n";
@@ -144,14 +559,80 @@ int main(int argc, char* argv[]) {
     }
     cout << " [OK] (" << paleta.obterTamanho() << " cores)\n";
     
-    // PASSO 7: Gerar imagem
-    cout << "[3/4] Convertendo mapa em imagem...";
-    Imagem img = mapa.gerarImagem(paleta, aplicarSombra);
+    // PASSO 7 (alternativo): Piramide de tiles no lugar da imagem unica
+    if (diretorioTiles) {
+        cout << "[3/4] Exportando piramide de tiles...";
+        EstatisticasPiramide piramide;
+        if (!mapa.salvarPiramideTiles(diretorioTiles, paleta, sombreamento, 1, &piramide)) {
+            cout << " [ERRO]\n";
+            cerr << "ERRO: Nao foi possivel exportar os tiles (n deve ser >= 8).\n";
+            return 1;
+        }
+        cout << " [OK]\n";
+        cout << "[4/4] " << piramide.tilesGravados << " tiles gravados, " << piramide.tilesUniformes
+             << " de cor unica ignorados (zoom 0 a " << piramide.zoomMaximo << ")\n\n";
+        cout << left << setw(20) << "  Tempo total:" << setprecision(3)
+             << chrono::duration<double>(chrono::steady_clock::now() - inicioTotal).count() << " s\n";
+        return 0;
+    }
+    
+    // PASSO 7: Criar arquivo de saida (PNG pela extensao, senao PPM)
+    cout << "[3/4] Criando arquivo de saida...";
+    unique_ptr<EscritorImagem> escritor;
+    if (terminaCom(arquivoSaida, ".png")) {
+        escritor.reset(new EscritorPNG(arquivoSaida, larguraImagem, alturaImagem));
+    } else {
+        escritor.reset(new EscritorPPM(arquivoSaida, larguraImagem, alturaImagem, formatoSaida));
+    }
+    if (!escritor->aberto()) {
+        cout << " [ERRO]\n";
+        cerr << "ERRO: Nao foi possivel criar o arquivo: " << arquivoSaida << "\n";
+        return 1;
+    }
     cout << " [OK]\n";
     
-    // PASSO 8: Salvar imagem
-    cout << "[4/4] Salvando imagem...";
-    if (img.salvarPPM(arquivoSaida)) {
+    // PASSO 8: Gerar e salvar imagem, faixa por faixa (a imagem inteira nunca fica na memoria)
+    // (com --esteira, as tres etapas de cada faixa rodam em paralelo com as das vizinhas)
+    cout << "[4/4] Convertendo mapa e salvando imagem...";
+    EstatisticasEsteira estatisticas;
+    size_t numNiveis = 0, numCurvas = 0;
+    bool salvo;
+    if (intervaloCurvas > 0.0 || usarPerspectiva) {
+        // Curvas de nivel: a imagem inteira e renderizada, recebe as curvas e so entao e gravada
+        // (na perspectiva, ela da as cores do terreno visto pela camera)
+        Imagem img = mapa.gerarImagem(paleta, sombreamento);
+        vector<double> niveis;
+        if (intervaloCurvas > 0.0) {
+            niveis = mapa.niveisCurvas(intervaloCurvas);
+            numNiveis = niveis.size();
+            mapa.desenharCurvasNivel(img, niveis, Pixel(60, 40, 20), 0.6);
+        }
+        if (usarPerspectiva) {
+            Imagem tela(larguraImagem, alturaImagem);
+            if (!mapa.gerarPerspectiva(tela, img, camera)) {
+                cout << " [ERRO]\n";
+                cerr << "ERRO: Nao foi possivel renderizar a vista em perspectiva\n";
+                return 1;
+            }
+            salvo = escritor->escreverLinhas(&tela(0, 0), tela.obterAltura()) && escritor->finalizar();
+        } else {
+            salvo = escritor->escreverLinhas(&img(0, 0), img.obterAltura()) && escritor->finalizar();
+        }
+        if (salvo && arquivoCurvas) {
+            vector<CurvaNivel> curvas = mapa.extrairCurvasNivel(niveis);
+            numCurvas = curvas.size();
+            salvo = terminaCom(arquivoCurvas, ".svg") ? salvarCurvasSVG(arquivoCurvas, curvas, mapa.obterLinhas())
+                                                      : salvarCurvasGeoJSON(arquivoCurvas, curvas);
+        }
+    } else {
+        salvo = direto
+            ? MapaAltitudes::gerarImagemDireto(*escritor, N, rugosidade, semente, paleta, sombreamento)
+            : usarEsteira
+            ? mapa.gerarImagemEmEsteira(*escritor, paleta, sombreamento, &estatisticas)
+            : mapa.gerarImagem(*escritor, paleta, larguraImagem, alturaImagem, sombreamento, filtro);
+    }
+    double segundosTotal = chrono::duration<double>(chrono::steady_clock::now() - inicioTotal).count();
+    if (salvo) {
         cout << " [OK]\n\n";
         
         cout << string(LARGURA, '=') << "\n";
@@ -160,7 +641,35 @@ int main(int argc, char* argv[]) {
         
         cout << left << setw(20) << "  Imagem gerada:" << arquivoSaida << "\n";
         cout << left << setw(20) << "  Dimensoes:" 
-             << img.obterLargura() << "x" << img.obterAltura() << "\n";
+             << larguraImagem << "x" << alturaImagem << "\n";
+        cout << left << setw(20) << "  Tempo total:" << setprecision(3) << segundosTotal << " s\n";
+        if (intervaloCurvas > 0.0) {
+            cout << left << setw(20) << "  Curvas de nivel:" << numNiveis << " niveis";
+            if (arquivoCurvas) {
+                cout << ", " << numCurvas << " polilinhas em " << arquivoCurvas;
+            }
+            cout << "\n";
+        }
+        
+        // Guarda o resultado para as proximas execucoes com os mesmos parametros
+        if (cache && cache->aberto()) {
+            cache->guardar(chaveCache, extensaoCache, arquivoSaida);
+            cout << left << setw(20) << "  Cache:" << cache->obterAcertos() << " acertos, "
+                 << cache->obterFalhas() << " falhas\n";
+        }
+        
+        if (usarEsteira) {
+            // Utilizacao = tempo ocupado / tempo da esteira (a maior indica o gargalo)
+            double t = estatisticas.segundosTotal > 0 ? estatisticas.segundosTotal : 1.0;
+            cout << left << setw(20) << "  Esteira:" << estatisticas.numFaixas << " faixas em "
+                 << estatisticas.segundosTotal << " s\n";
+            cout << left << setw(20) << "    Renderizar:" << setprecision(0)
+                 << 100.0 * estatisticas.segundosRenderizando / t << "%\n";
+            cout << left << setw(20) << "    Codificar:"
+                 << 100.0 * estatisticas.segundosCodificando / t << "%\n";
+            cout << left << setw(20) << "    Gravar:"
+                 << 100.0 * estatisticas.segundosGravando / t << "%\n";
+        }
         
         cout << string(LARGURA, '=') << "\n";
         return 0;
@@ -0,0 +1,85 @@
+#include "aleatorio.h"
+#include <algorithm>
+
+// Atraso menor da recorrência r[i] = r[i - 3] + r[i - 31]
+static const unsigned ATRASO_MENOR = 3;
+
+GeradorAleatorio::GeradorAleatorio(uint32_t semente) : frente(ATRASO_MENOR), tras(0) {
+    // Mesma inicialização de srandom_r (TYPE_3): gerador de Lehmer 16807 módulo 2^31 - 1
+    // (pelo método de Schrage, com a aritmética com sinal da glibc) e 310 valores descartados
+    if (semente == 0) semente = 1;
+    int32_t palavra = static_cast<int32_t>(semente);
+    estado[0] = static_cast<uint32_t>(palavra);
+    for (unsigned i = 1; i < GRAU; i++) {
+        int64_t alto = palavra / 127773;
+        int64_t baixo = palavra % 127773;
+        palavra = static_cast<int32_t>(16807 * baixo - 2836 * alto);
+        if (palavra < 0) palavra += MAXIMO;
+        estado[i] = static_cast<uint32_t>(palavra);
+    }
+    for (unsigned i = 0; i < GRAU * 10; i++) {
+        proximo();
+    }
+}
+
+// Produto de dois polinômios de grau < GRAU módulo x^31 - x^28 - 1, com coeficientes
+// módulo 2^32 (a recorrência é linear, então x^n módulo esse polinômio dá r[i + n] como
+// combinação de r[i], ..., r[i + 30])
+static void multiplicarModulo(const uint32_t* a, const uint32_t* b, uint32_t* resultado) {
+    const unsigned grau = 31;
+    uint32_t produto[2 * grau - 1] = {};
+    for (unsigned i = 0; i < grau; i++) {
+        for (unsigned j = 0; j < grau; j++) {
+            produto[i + j] += a[i] * b[j];
+        }
+    }
+    // x^d = x^(d - 3) + x^(d - 31), de cima para baixo
+    for (unsigned d = 2 * grau - 2; d >= grau; d--) {
+        produto[d - ATRASO_MENOR] += produto[d];
+        produto[d - grau] += produto[d];
+    }
+    for (unsigned i = 0; i < grau; i++) {
+        resultado[i] = produto[i];
+    }
+}
+
+void GeradorAleatorio::avancar(uint64_t n) {
+    if (n < 4 * GRAU) {
+        for (; n > 0; n--) proximo();
+        return;
+    }
+
+    // potencia = x^n módulo o polinômio, por quadrados sucessivos
+    uint32_t potencia[GRAU] = {1}, base[GRAU] = {0, 1}, temporario[GRAU];
+    for (uint64_t resto = n; resto > 0; resto >>= 1) {
+        if (resto & 1) {
+            multiplicarModulo(potencia, base, temporario);
+            std::copy(temporario, temporario + GRAU, potencia);
+        }
+        multiplicarModulo(base, base, temporario);
+        std::copy(temporario, temporario + GRAU, base);
+    }
+
+    // A janela atual é w[t] = r[i + t] = estado[(frente + t) % 31]; a nova é r[i + n + t],
+    // com os coeficientes de x^(n + t) (cada t seguinte multiplica a potência por x)
+    uint32_t janela[GRAU], nova[GRAU];
+    for (unsigned t = 0; t < GRAU; t++) {
+        janela[t] = estado[(frente + t) % GRAU];
+    }
+    for (unsigned t = 0; t < GRAU; t++) {
+        uint32_t soma = 0;
+        for (unsigned d = 0; d < GRAU; d++) {
+            soma += potencia[d] * janela[d];
+        }
+        nova[t] = soma;
+        uint32_t topo = potencia[GRAU - 1];
+        for (unsigned d = GRAU - 1; d > 0; d--) {
+            potencia[d] = potencia[d - 1];
+        }
+        potencia[0] = topo;
+        potencia[GRAU - ATRASO_MENOR] += topo;
+    }
+    for (unsigned t = 0; t < GRAU; t++) {
+        estado[(frente + t) % GRAU] = nova[t];
+    }
+}
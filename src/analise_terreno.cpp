@@ -0,0 +1,372 @@
+#include "analise_terreno.h"
+#include "arquivo_io.h"
+#include "paralelo.h"
+#include "pnm.h"
+#include "quantizacao.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ANALISE_X86 1
+#endif
+
+// Abaixo disto (em pontos) uma thread só dá conta, e dividir custaria mais que ganharia
+static const size_t PONTOS_MINIMOS_POR_FAIXA = 64 * 1024;
+
+static const float MEIO_PI = 1.57079632679489662f;
+static const float PI = 3.14159265358979324f;
+static const float GRAUS_POR_RADIANO = 57.2957795130823209f;
+
+// atan(a) = a (1 + A2 a² + A4 a⁴ + ... + A16 a¹⁶) em [0, 1], erro < 2e-8
+// (Abramowitz e Stegun, 4.4.47): abaixo da precisão do float
+static const float A2 = -0.3333314528f, A4 = 0.1999355085f, A6 = -0.1420889944f, A8 = 0.1065626393f;
+static const float A10 = -0.0752896400f, A12 = 0.0429096138f, A14 = -0.0161657367f, A16 = 0.0028662257f;
+
+ParametrosAnalise::ParametrosAnalise(double exagero, size_t ladoMapa, const QuantizacaoAnalise& quantizacao)
+    : passos(quantizacao) {
+    double passosMapa = ladoMapa > 1 ? static_cast<double>(ladoMapa - 1) : 0.0;
+    // Sobel soma 8 vezes a diferença entre vizinhos (como em IluminacaoRelevo)
+    escalaGradiente = exagero * passosMapa / LADO_POR_ALTURA / 8.0;
+    // Altitude em lados do mapa (exagero / 4) e distância em lados (1 / passos, ao quadrado)
+    escalaCurvatura = exagero * passosMapa * passosMapa / LADO_POR_ALTURA;
+}
+
+// ═══════════════════════════════════════════════════════════
+// VERSÃO ESCALAR (referência)
+// ═══════════════════════════════════════════════════════════
+
+static inline float atanUnitario(float a) {
+    float s = a * a;
+    float p = A16;
+    p = p * s + A14;
+    p = p * s + A12;
+    p = p * s + A10;
+    p = p * s + A8;
+    p = p * s + A6;
+    p = p * s + A4;
+    p = p * s + A2;
+    return a + a * s * p;
+}
+
+// atan2(y, x) em graus, reduzida ao primeiro octante; indefinida só com x = y = 0
+static inline float atan2Graus(float y, float x) {
+    float ax = std::fabs(x), ay = std::fabs(y);
+    float r = atanUnitario(std::min(ax, ay) / std::max(ax, ay));
+    if (ay > ax) r = MEIO_PI - r;
+    if (x < 0.0f) r = PI - r;
+    if (y < 0.0f) r = -r;
+    return r * GRAUS_POR_RADIANO;
+}
+
+// Arredonda para baixo ao múltiplo do passo (passo 0: o próprio valor)
+static inline float quantizar(float valor, float passo) {
+    return passo > 0.0f ? std::floor(valor * (1.0f / passo)) * passo : valor;
+}
+
+// Vizinhança 3×3:  a b c / d e f / g h i
+static inline void analisarPonto(const ParametrosAnalise& p, double a, double b, double c, double d, double e,
+                                 double f, double g, double h, double i, float& declividade, float& orientacao,
+                                 float& curvatura) {
+    float gx = static_cast<float>(((c + 2.0 * f + i) - (a + 2.0 * d + g)) * p.escalaGradiente);  // Sobe para o leste
+    float gy = static_cast<float>(((g + 2.0 * h + i) - (a + 2.0 * b + c)) * p.escalaGradiente);  // Sobe para o sul
+    float k = static_cast<float>((4.0 * e - ((b + d) + (f + h))) * p.escalaCurvatura);
+
+    declividade = quantizar(atan2Graus(std::sqrt(gx * gx + gy * gy), 1.0f), p.passos.declividade);
+    // A encosta desce para (-gx, gy) em (leste, norte): ângulo horário a partir do norte
+    float o = atan2Graus(-gx, gy);
+    o = o < 0.0f ? o + 360.0f : o;
+    o = o >= 360.0f ? o - 360.0f : o;
+    o = quantizar(o, p.passos.orientacao);
+    orientacao = gx == 0.0f && gy == 0.0f ? ORIENTACAO_PLANO : o;
+    curvatura = quantizar(k, p.passos.curvatura);
+}
+
+// Um ponto qualquer da linha, repetindo a borda fora do mapa
+static inline void analisarPontoEm(const ParametrosAnalise& p, const double* acima, const double* linha,
+                                   const double* abaixo, size_t largura, size_t col, float& declividade,
+                                   float& orientacao, float& curvatura) {
+    size_t e = col > 0 ? col - 1 : col;
+    size_t d = col + 1 < largura ? col + 1 : col;
+    analisarPonto(p, acima[e], acima[col], acima[d], linha[e], linha[col], linha[d], abaixo[e], abaixo[col],
+                  abaixo[d], declividade, orientacao, curvatura);
+}
+
+#ifdef ANALISE_X86
+
+// ═══════════════════════════════════════════════════════════
+// SSE4.1: 4 PONTOS POR ITERAÇÃO
+// ═══════════════════════════════════════════════════════════
+
+// Derivadas de 2 pontos internos a partir de col, em double e na ordem de analisarPonto,
+// convertidas para float nas 2 posições de baixo
+__attribute__((target("sse4.1")))
+static inline void derivadasSSE(const double* acima, const double* linha, const double* abaixo, size_t col,
+                                __m128d escalaGradiente, __m128d escalaCurvatura, __m128& gx, __m128& gy,
+                                __m128& k) {
+    const __m128d dois = _mm_set1_pd(2.0), quatro = _mm_set1_pd(4.0);
+    __m128d a = _mm_loadu_pd(acima + col - 1), b = _mm_loadu_pd(acima + col), c = _mm_loadu_pd(acima + col + 1);
+    __m128d d = _mm_loadu_pd(linha + col - 1), e = _mm_loadu_pd(linha + col), f = _mm_loadu_pd(linha + col + 1);
+    __m128d g = _mm_loadu_pd(abaixo + col - 1), h = _mm_loadu_pd(abaixo + col), i = _mm_loadu_pd(abaixo + col + 1);
+    __m128d dx = _mm_sub_pd(_mm_add_pd(_mm_add_pd(c, _mm_mul_pd(dois, f)), i),
+                            _mm_add_pd(_mm_add_pd(a, _mm_mul_pd(dois, d)), g));
+    __m128d dy = _mm_sub_pd(_mm_add_pd(_mm_add_pd(g, _mm_mul_pd(dois, h)), i),
+                            _mm_add_pd(_mm_add_pd(a, _mm_mul_pd(dois, b)), c));
+    __m128d lap = _mm_sub_pd(_mm_mul_pd(quatro, e), _mm_add_pd(_mm_add_pd(b, d), _mm_add_pd(f, h)));
+    gx = _mm_cvtpd_ps(_mm_mul_pd(dx, escalaGradiente));
+    gy = _mm_cvtpd_ps(_mm_mul_pd(dy, escalaGradiente));
+    k = _mm_cvtpd_ps(_mm_mul_pd(lap, escalaCurvatura));
+}
+
+__attribute__((target("sse4.1")))
+static inline __m128 atanUnitarioSSE(__m128 a) {
+    __m128 s = _mm_mul_ps(a, a);
+    __m128 p = _mm_set1_ps(A16);
+    p = _mm_add_ps(_mm_mul_ps(p, s), _mm_set1_ps(A14));
+    p = _mm_add_ps(_mm_mul_ps(p, s), _mm_set1_ps(A12));
+    p = _mm_add_ps(_mm_mul_ps(p, s), _mm_set1_ps(A10));
+    p = _mm_add_ps(_mm_mul_ps(p, s), _mm_set1_ps(A8));
+    p = _mm_add_ps(_mm_mul_ps(p, s), _mm_set1_ps(A6));
+    p = _mm_add_ps(_mm_mul_ps(p, s), _mm_set1_ps(A4));
+    p = _mm_add_ps(_mm_mul_ps(p, s), _mm_set1_ps(A2));
+    return _mm_add_ps(a, _mm_mul_ps(_mm_mul_ps(a, s), p));
+}
+
+__attribute__((target("sse4.1")))
+static inline __m128 atan2GrausSSE(__m128 y, __m128 x) {
+    const __m128 sinal = _mm_set1_ps(-0.0f), zero = _mm_setzero_ps();
+    __m128 ax = _mm_andnot_ps(sinal, x), ay = _mm_andnot_ps(sinal, y);
+    __m128 r = atanUnitarioSSE(_mm_div_ps(_mm_min_ps(ay, ax), _mm_max_ps(ay, ax)));
+    r = _mm_blendv_ps(r, _mm_sub_ps(_mm_set1_ps(MEIO_PI), r), _mm_cmpgt_ps(ay, ax));
+    r = _mm_blendv_ps(r, _mm_sub_ps(_mm_set1_ps(PI), r), _mm_cmplt_ps(x, zero));
+    r = _mm_blendv_ps(r, _mm_xor_ps(r, sinal), _mm_cmplt_ps(y, zero));
+    return _mm_mul_ps(r, _mm_set1_ps(GRAUS_POR_RADIANO));
+}
+
+__attribute__((target("sse4.1")))
+static inline __m128 quantizarSSE(__m128 valor, float passo) {
+    if (!(passo > 0.0f)) return valor;
+    return _mm_mul_ps(_mm_floor_ps(_mm_mul_ps(valor, _mm_set1_ps(1.0f / passo))), _mm_set1_ps(passo));
+}
+
+__attribute__((target("sse4.1")))
+static size_t analisarSSE41(const ParametrosAnalise& p, const double* acima, const double* linha,
+                            const double* abaixo, size_t col, size_t colFim, float* declividade, float* orientacao,
+                            float* curvatura) {
+    const __m128d escalaGradiente = _mm_set1_pd(p.escalaGradiente), escalaCurvatura = _mm_set1_pd(p.escalaCurvatura);
+    const __m128 zero = _mm_setzero_ps(), um = _mm_set1_ps(1.0f), volta = _mm_set1_ps(360.0f);
+    for (size_t n = 0; col + 4 <= colFim; col += 4, n += 4) {
+        __m128 gx0, gy0, k0, gx1, gy1, k1;
+        derivadasSSE(acima, linha, abaixo, col, escalaGradiente, escalaCurvatura, gx0, gy0, k0);
+        derivadasSSE(acima, linha, abaixo, col + 2, escalaGradiente, escalaCurvatura, gx1, gy1, k1);
+        __m128 gx = _mm_movelh_ps(gx0, gx1), gy = _mm_movelh_ps(gy0, gy1), k = _mm_movelh_ps(k0, k1);
+
+        __m128 modulo = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(gx, gx), _mm_mul_ps(gy, gy)));
+        _mm_storeu_ps(declividade + n, quantizarSSE(atan2GrausSSE(modulo, um), p.passos.declividade));
+
+        __m128 o = atan2GrausSSE(_mm_xor_ps(gx, _mm_set1_ps(-0.0f)), gy);
+        o = _mm_blendv_ps(o, _mm_add_ps(o, volta), _mm_cmplt_ps(o, zero));
+        o = _mm_blendv_ps(o, _mm_sub_ps(o, volta), _mm_cmpge_ps(o, volta));
+        o = quantizarSSE(o, p.passos.orientacao);
+        __m128 plano = _mm_and_ps(_mm_cmpeq_ps(gx, zero), _mm_cmpeq_ps(gy, zero));
+        _mm_storeu_ps(orientacao + n, _mm_blendv_ps(o, _mm_set1_ps(ORIENTACAO_PLANO), plano));
+
+        _mm_storeu_ps(curvatura + n, quantizarSSE(k, p.passos.curvatura));
+    }
+    return col;
+}
+
+// ═══════════════════════════════════════════════════════════
+// AVX2: 8 PONTOS POR ITERAÇÃO
+// ═══════════════════════════════════════════════════════════
+
+// Idem, 4 pontos
+__attribute__((target("avx2")))
+static inline void derivadasAVX(const double* acima, const double* linha, const double* abaixo, size_t col,
+                                __m256d escalaGradiente, __m256d escalaCurvatura, __m128& gx, __m128& gy,
+                                __m128& k) {
+    const __m256d dois = _mm256_set1_pd(2.0), quatro = _mm256_set1_pd(4.0);
+    __m256d a = _mm256_loadu_pd(acima + col - 1), b = _mm256_loadu_pd(acima + col);
+    __m256d c = _mm256_loadu_pd(acima + col + 1);
+    __m256d d = _mm256_loadu_pd(linha + col - 1), e = _mm256_loadu_pd(linha + col);
+    __m256d f = _mm256_loadu_pd(linha + col + 1);
+    __m256d g = _mm256_loadu_pd(abaixo + col - 1), h = _mm256_loadu_pd(abaixo + col);
+    __m256d i = _mm256_loadu_pd(abaixo + col + 1);
+    __m256d dx = _mm256_sub_pd(_mm256_add_pd(_mm256_add_pd(c, _mm256_mul_pd(dois, f)), i),
+                               _mm256_add_pd(_mm256_add_pd(a, _mm256_mul_pd(dois, d)), g));
+    __m256d dy = _mm256_sub_pd(_mm256_add_pd(_mm256_add_pd(g, _mm256_mul_pd(dois, h)), i),
+                               _mm256_add_pd(_mm256_add_pd(a, _mm256_mul_pd(dois, b)), c));
+    __m256d lap = _mm256_sub_pd(_mm256_mul_pd(quatro, e),
+                                _mm256_add_pd(_mm256_add_pd(b, d), _mm256_add_pd(f, h)));
+    gx = _mm256_cvtpd_ps(_mm256_mul_pd(dx, escalaGradiente));
+    gy = _mm256_cvtpd_ps(_mm256_mul_pd(dy, escalaGradiente));
+    k = _mm256_cvtpd_ps(_mm256_mul_pd(lap, escalaCurvatura));
+}
+
+__attribute__((target("avx2")))
+static inline __m256 atanUnitarioAVX(__m256 a) {
+    __m256 s = _mm256_mul_ps(a, a);
+    __m256 p = _mm256_set1_ps(A16);
+    p = _mm256_add_ps(_mm256_mul_ps(p, s), _mm256_set1_ps(A14));
+    p = _mm256_add_ps(_mm256_mul_ps(p, s), _mm256_set1_ps(A12));
+    p = _mm256_add_ps(_mm256_mul_ps(p, s), _mm256_set1_ps(A10));
+    p = _mm256_add_ps(_mm256_mul_ps(p, s), _mm256_set1_ps(A8));
+    p = _mm256_add_ps(_mm256_mul_ps(p, s), _mm256_set1_ps(A6));
+    p = _mm256_add_ps(_mm256_mul_ps(p, s), _mm256_set1_ps(A4));
+    p = _mm256_add_ps(_mm256_mul_ps(p, s), _mm256_set1_ps(A2));
+    return _mm256_add_ps(a, _mm256_mul_ps(_mm256_mul_ps(a, s), p));
+}
+
+__attribute__((target("avx2")))
+static inline __m256 atan2GrausAVX(__m256 y, __m256 x) {
+    const __m256 sinal = _mm256_set1_ps(-0.0f), zero = _mm256_setzero_ps();
+    __m256 ax = _mm256_andnot_ps(sinal, x), ay = _mm256_andnot_ps(sinal, y);
+    __m256 r = atanUnitarioAVX(_mm256_div_ps(_mm256_min_ps(ay, ax), _mm256_max_ps(ay, ax)));
+    r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(MEIO_PI), r), _mm256_cmp_ps(ay, ax, _CMP_GT_OQ));
+    r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(PI), r), _mm256_cmp_ps(x, zero, _CMP_LT_OQ));
+    r = _mm256_blendv_ps(r, _mm256_xor_ps(r, sinal), _mm256_cmp_ps(y, zero, _CMP_LT_OQ));
+    return _mm256_mul_ps(r, _mm256_set1_ps(GRAUS_POR_RADIANO));
+}
+
+__attribute__((target("avx2")))
+static inline __m256 quantizarAVX(__m256 valor, float passo) {
+    if (!(passo > 0.0f)) return valor;
+    return _mm256_mul_ps(_mm256_floor_ps(_mm256_mul_ps(valor, _mm256_set1_ps(1.0f / passo))), _mm256_set1_ps(passo));
+}
+
+__attribute__((target("avx2")))
+static size_t analisarAVX2(const ParametrosAnalise& p, const double* acima, const double* linha,
+                           const double* abaixo, size_t col, size_t colFim, float* declividade, float* orientacao,
+                           float* curvatura) {
+    const __m256d escalaGradiente = _mm256_set1_pd(p.escalaGradiente);
+    const __m256d escalaCurvatura = _mm256_set1_pd(p.escalaCurvatura);
+    const __m256 zero = _mm256_setzero_ps(), um = _mm256_set1_ps(1.0f), volta = _mm256_set1_ps(360.0f);
+    for (size_t n = 0; col + 8 <= colFim; col += 8, n += 8) {
+        __m128 gx0, gy0, k0, gx1, gy1, k1;
+        derivadasAVX(acima, linha, abaixo, col, escalaGradiente, escalaCurvatura, gx0, gy0, k0);
+        derivadasAVX(acima, linha, abaixo, col + 4, escalaGradiente, escalaCurvatura, gx1, gy1, k1);
+        __m256 gx = _mm256_set_m128(gx1, gx0), gy = _mm256_set_m128(gy1, gy0), k = _mm256_set_m128(k1, k0);
+
+        __m256 modulo = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(gx, gx), _mm256_mul_ps(gy, gy)));
+        _mm256_storeu_ps(declividade + n, quantizarAVX(atan2GrausAVX(modulo, um), p.passos.declividade));
+
+        __m256 o = atan2GrausAVX(_mm256_xor_ps(gx, _mm256_set1_ps(-0.0f)), gy);
+        o = _mm256_blendv_ps(o, _mm256_add_ps(o, volta), _mm256_cmp_ps(o, zero, _CMP_LT_OQ));
+        o = _mm256_blendv_ps(o, _mm256_sub_ps(o, volta), _mm256_cmp_ps(o, volta, _CMP_GE_OQ));
+        o = quantizarAVX(o, p.passos.orientacao);
+        __m256 plano = _mm256_and_ps(_mm256_cmp_ps(gx, zero, _CMP_EQ_OQ), _mm256_cmp_ps(gy, zero, _CMP_EQ_OQ));
+        _mm256_storeu_ps(orientacao + n, _mm256_blendv_ps(o, _mm256_set1_ps(ORIENTACAO_PLANO), plano));
+
+        _mm256_storeu_ps(curvatura + n, quantizarAVX(k, p.passos.curvatura));
+    }
+    return col;
+}
+
+#endif
+
+// ═══════════════════════════════════════════════════════════
+// DESPACHO
+// ═══════════════════════════════════════════════════════════
+
+void analisarLinha(const ParametrosAnalise& parametros, const double* linhaAcima, const double* linha,
+                   const double* linhaAbaixo, size_t largura, size_t colInicio, size_t colFim, float* declividade,
+                   float* orientacao, float* curvatura, NivelSimd nivel) {
+    // Colunas internas (com vizinhos dos dois lados) vão para o núcleo vetorial
+    size_t internoInicio = std::max<size_t>(colInicio, 1);
+    size_t internoFim = std::max(internoInicio, std::min(colFim, largura - 1));
+    auto pontoEm = [&](size_t col) {
+        size_t n = col - colInicio;
+        analisarPontoEm(parametros, linhaAcima, linha, linhaAbaixo, largura, col, declividade[n], orientacao[n],
+                        curvatura[n]);
+    };
+    size_t col = colInicio;
+    for (; col < internoInicio && col < colFim; col++) {
+        pontoEm(col);
+    }
+#ifdef ANALISE_X86
+    size_t n = col - colInicio;
+    if (nivel == SIMD_AVX2) {
+        col = analisarAVX2(parametros, linhaAcima, linha, linhaAbaixo, col, internoFim, declividade + n,
+                           orientacao + n, curvatura + n);
+    } else if (nivel == SIMD_SSE41) {
+        col = analisarSSE41(parametros, linhaAcima, linha, linhaAbaixo, col, internoFim, declividade + n,
+                            orientacao + n, curvatura + n);
+    }
+#else
+    (void)nivel;
+#endif
+    for (; col < colFim; col++) {
+        pontoEm(col);
+    }
+}
+
+void analisarTerreno(const double* altitudes, size_t lado, const ParametrosAnalise& parametros, float* declividade,
+                     float* orientacao, float* curvatura) {
+    // Cada ponto só lê a vizinhança imediata, então as faixas de linhas são independentes
+    size_t numFaixas = std::min<size_t>(obterNumThreads(), lado * lado / PONTOS_MINIMOS_POR_FAIXA);
+    executarEmFaixas(lado, std::max<size_t>(1, numFaixas), [&](size_t, size_t inicio, size_t fim) {
+        for (size_t lin = inicio; lin < fim; lin++) {
+            const double* linha = altitudes + lin * lado;
+            size_t primeiro = lin * lado;
+            analisarLinha(parametros, lin > 0 ? linha - lado : linha, linha, lin + 1 < lado ? linha + lado : linha,
+                          lado, 0, lado, declividade + primeiro, orientacao + primeiro, curvatura + primeiro);
+        }
+    });
+}
+
+// ═══════════════════════════════════════════════════════════
+// EXPORTAÇÃO
+// ═══════════════════════════════════════════════════════════
+
+bool salvarRasterPGM(const char* nomeArquivo, const float* valores, size_t lado, double minimo, double maximo) {
+    ArquivoSaida arquivo(nomeArquivo);
+    if (!arquivo.aberto()) {
+        std::cerr << "Erro ao criar arquivo: " << nomeArquivo << "\n";
+        return false;
+    }
+
+    // Cabeçalho + amostras em um único buffer, quantizado em faixas paralelas
+    std::string cabecalho = montarCabecalhoPNM(5, lado, lado, 65535);
+    size_t bytes = cabecalho.size() + 2 * lado * lado;
+    std::unique_ptr<unsigned char[]> buffer(new unsigned char[bytes]);
+    std::copy(cabecalho.begin(), cabecalho.end(), buffer.get());
+    unsigned char* amostras = buffer.get() + cabecalho.size();
+    executarEmFaixas(lado, obterNumThreads(), [&](size_t, size_t inicio, size_t fim) {
+        std::vector<double> linha(lado);
+        for (size_t lin = inicio; lin < fim; lin++) {
+            std::copy(valores + lin * lado, valores + (lin + 1) * lado, linha.begin());
+            quantizarU16BE(linha.data(), amostras + 2 * lin * lado, lado, minimo, maximo);
+        }
+    });
+
+    if (!arquivo.escrever(buffer.get(), bytes) || !arquivo.fechar()) {
+        std::cerr << "Erro ao gravar arquivo: " << nomeArquivo << "\n";
+        return false;
+    }
+    return true;
+}
+
+Imagem colorirRaster(const float* valores, size_t lado, double minimo, double maximo, const Paleta& paleta,
+                     LayoutImagem layout) {
+    Imagem img(lado, lado, layout);
+    if (lado == 0) return img;
+    PaletaCompilada cores(paleta);
+    VistaImagem destino = img.obterVista();
+    double escala = maximo > minimo ? 1.0 / (maximo - minimo) : 0.0;
+    size_t numFaixas = std::min<size_t>(obterNumThreads(), lado * lado / PONTOS_MINIMOS_POR_FAIXA);
+    executarEmFaixas(lado, std::max<size_t>(1, numFaixas), [&](size_t, size_t inicio, size_t fim) {
+        // Cada linha vira "altitudes" em [0, 1] e passa pelo mesmo núcleo das imagens do mapa
+        std::vector<double> linha(lado);
+        for (size_t lin = inicio; lin < fim; lin++) {
+            const float* origem = valores + lin * lado;
+            for (size_t col = 0; col < lado; col++) {
+                linha[col] = (origem[col] - minimo) * escala;
+            }
+            renderizarLinha(cores, linha.data(), nullptr, 0, lado, false, destino.deslocada(0, lin));
+        }
+    });
+    return img;
+}
@@ -0,0 +1,161 @@
+#include "arquivo_io.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <cerrno>
+
+ArquivoSaida::ArquivoSaida(const char* nomeArquivo)
+    : descritor(open(nomeArquivo, O_WRONLY | O_CREAT, 0644)) {
+    // Se o arquivo existente tem outros nomes (hard links, ex: uma entrada do cache de
+    // resultados), cria um arquivo novo em vez de truncar o conteúdo compartilhado
+    struct stat info;
+    if (descritor >= 0 && fstat(descritor, &info) == 0 && info.st_nlink > 1) {
+        close(descritor);
+        unlink(nomeArquivo);
+        descritor = open(nomeArquivo, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    } else if (descritor >= 0 && ftruncate(descritor, 0) != 0) {
+        close(descritor);
+        descritor = -1;
+    }
+}
+
+ArquivoSaida::~ArquivoSaida() {
+    fechar();
+}
+
+bool ArquivoSaida::aberto() const {
+    return descritor >= 0;
+}
+
+bool ArquivoSaida::escrever(const void* dados, size_t tamanho) {
+    if (descritor < 0) return false;
+
+    const char* p = static_cast<const char*>(dados);
+    while (tamanho > 0) {
+        ssize_t gravados = write(descritor, p, tamanho);
+        if (gravados < 0) {
+            if (errno == EINTR) continue;  // Interrompido por sinal: tenta de novo
+            return false;
+        }
+        p += gravados;
+        tamanho -= static_cast<size_t>(gravados);
+    }
+    return true;
+}
+
+bool ArquivoSaida::escrever(const void* dados1, size_t tamanho1, const void* dados2, size_t tamanho2) {
+    if (descritor < 0) return false;
+
+    struct iovec blocos[2];
+    blocos[0].iov_base = const_cast<void*>(dados1);
+    blocos[0].iov_len = tamanho1;
+    blocos[1].iov_base = const_cast<void*>(dados2);
+    blocos[1].iov_len = tamanho2;
+
+    ssize_t gravados;
+    do {
+        gravados = writev(descritor, blocos, 2);
+    } while (gravados < 0 && errno == EINTR);
+    if (gravados < 0) return false;
+
+    // Gravação parcial: completa o que faltou bloco a bloco
+    size_t feitos = static_cast<size_t>(gravados);
+    if (feitos < tamanho1) {
+        return escrever(static_cast<const char*>(dados1) + feitos, tamanho1 - feitos) &&
+               escrever(dados2, tamanho2);
+    }
+    feitos -= tamanho1;
+    return escrever(static_cast<const char*>(dados2) + feitos, tamanho2 - feitos);
+}
+
+bool ArquivoSaida::fechar() {
+    if (descritor < 0) return false;
+    int resultado = close(descritor);
+    descritor = -1;
+    return resultado == 0;
+}
+
+
+// ArquivoMapeado: abre, descobre o tamanho e mapeia; o descritor pode ser fechado logo
+// em seguida, pois o mapeamento continua válido até munmap.
+ArquivoMapeado::ArquivoMapeado(const char* nomeArquivo) : dados(nullptr), tamanho(0), ok(false) {
+    int descritor = open(nomeArquivo, O_RDONLY);
+    if (descritor < 0) return;
+
+    struct stat info;
+    if (fstat(descritor, &info) == 0) {
+        if (info.st_size == 0) {
+            ok = true;  // Arquivo vazio: nada a mapear
+        } else {
+            size_t bytes = static_cast<size_t>(info.st_size);
+            void* mapa = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, descritor, 0);
+            if (mapa != MAP_FAILED) {
+                madvise(mapa, bytes, MADV_SEQUENTIAL);  // Leitura linear: pede leitura antecipada
+                dados = static_cast<const unsigned char*>(mapa);
+                tamanho = bytes;
+                ok = true;
+            }
+        }
+    }
+    close(descritor);
+}
+
+ArquivoMapeado::~ArquivoMapeado() {
+    if (dados != nullptr) {
+        munmap(const_cast<unsigned char*>(dados), tamanho);
+    }
+}
+
+bool ArquivoMapeado::aberto() const {
+    return ok;
+}
+
+const unsigned char* ArquivoMapeado::obterDados() const {
+    return dados;
+}
+
+size_t ArquivoMapeado::obterTamanho() const {
+    return tamanho;
+}
+
+ArquivoEntrada::ArquivoEntrada(const char* nomeArquivo) : descritor(-1), tamanho(0) {
+    descritor = open(nomeArquivo, O_RDONLY);
+    struct stat info;
+    if (descritor >= 0 && fstat(descritor, &info) == 0) {
+        tamanho = static_cast<size_t>(info.st_size);
+    }
+}
+
+ArquivoEntrada::~ArquivoEntrada() {
+    if (descritor >= 0) {
+        close(descritor);
+    }
+}
+
+bool ArquivoEntrada::aberto() const {
+    return descritor >= 0;
+}
+
+size_t ArquivoEntrada::obterTamanho() const {
+    return tamanho;
+}
+
+bool ArquivoEntrada::lerEm(void* destino, size_t quantidade, size_t posicao) const {
+    if (descritor < 0) return false;
+    unsigned char* p = static_cast<unsigned char*>(destino);
+    while (quantidade > 0) {
+        ssize_t lidos = pread(descritor, p, quantidade, static_cast<off_t>(posicao));
+        if (lidos < 0 && errno == EINTR) continue;
+        if (lidos <= 0) return false;  // Erro ou fim do arquivo antes do esperado
+        p += lidos;
+        posicao += static_cast<size_t>(lidos);
+        quantidade -= static_cast<size_t>(lidos);
+    }
+    return true;
+}
+
+bool criarDiretorio(const char* caminho) {
+    return mkdir(caminho, 0755) == 0 || errno == EEXIST;
+}
@@ -0,0 +1,212 @@
+#include "cache_resultados.h"
+#include "arquivo_io.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Versão do renderizador: incrementar quando a mesma entrada passar a gerar outra saída
+static const uint32_t VERSAO_RESULTADOS = 1;
+
+// Nome do arquivo de contadores dentro do diretório do cache
+static const char* ARQUIVO_CONTADORES = "contadores";
+
+// Tamanho do bloco usado para copiar arquivos
+static const size_t BLOCO_COPIA = 1024 * 1024;
+
+// ═══════════════════════════════════════════════════════════
+// HASH (FNV-1a 64 bits)
+// ═══════════════════════════════════════════════════════════
+
+static const uint64_t FNV_BASE = 14695981039346656037ULL;
+static const uint64_t FNV_PRIMO = 1099511628211ULL;
+
+static void misturar(uint64_t& hash, const void* dados, size_t tamanho) {
+    const unsigned char* p = static_cast<const unsigned char*>(dados);
+    for (size_t i = 0; i < tamanho; i++) {
+        hash = (hash ^ p[i]) * FNV_PRIMO;
+    }
+}
+
+// Campo com tamanho antes do conteúdo: ("ab", "c") e ("a", "bc") não colidem
+static void misturarCampo(uint64_t& hash, const void* dados, size_t tamanho) {
+    uint64_t n = tamanho;
+    misturar(hash, &n, sizeof(n));
+    misturar(hash, dados, tamanho);
+}
+
+std::string calcularChaveTerreno(int N, double rugosidade, unsigned int semente, const char* arquivoPaleta,
+                                 bool aplicarSombreamento, const char* formato, const char* estilo) {
+    ArquivoEntrada paleta(arquivoPaleta);
+    if (!paleta.aberto()) return std::string();
+    std::vector<unsigned char> conteudo(paleta.obterTamanho());
+    if (!conteudo.empty() && !paleta.lerEm(conteudo.data(), conteudo.size(), 0)) return std::string();
+
+    unsigned char sombra = aplicarSombreamento ? 1 : 0;
+    uint64_t hash = FNV_BASE;
+    misturarCampo(hash, &VERSAO_RESULTADOS, sizeof(VERSAO_RESULTADOS));
+    misturarCampo(hash, &N, sizeof(N));
+    misturarCampo(hash, &rugosidade, sizeof(rugosidade));  // Bits exatos do double
+    misturarCampo(hash, &semente, sizeof(semente));
+    misturarCampo(hash, conteudo.data(), conteudo.size());
+    misturarCampo(hash, &sombra, sizeof(sombra));
+    misturarCampo(hash, formato, std::strlen(formato));
+    misturarCampo(hash, estilo, std::strlen(estilo));
+
+    char texto[17];
+    std::snprintf(texto, sizeof(texto), "%016llx", static_cast<unsigned long long>(hash));
+    return std::string(texto);
+}
+
+// ═══════════════════════════════════════════════════════════
+// AUXILIARES DE ARQUIVO
+// ═══════════════════════════════════════════════════════════
+
+// Copia um arquivo em blocos
+static bool copiarArquivo(const char* origem, const char* destino) {
+    ArquivoEntrada entrada(origem);
+    if (!entrada.aberto()) return false;
+    ArquivoSaida saida(destino);
+    std::vector<unsigned char> bloco(BLOCO_COPIA);
+    bool ok = saida.aberto();
+    for (size_t pos = 0; ok && pos < entrada.obterTamanho(); pos += bloco.size()) {
+        size_t n = std::min(bloco.size(), entrada.obterTamanho() - pos);
+        ok = entrada.lerEm(bloco.data(), n, pos) && saida.escrever(bloco.data(), n);
+    }
+    return saida.fechar() && ok;
+}
+
+// ═══════════════════════════════════════════════════════════
+// CACHE
+// ═══════════════════════════════════════════════════════════
+
+CacheResultados::CacheResultados(const char* diretorio, uint64_t limiteBytes)
+    : diretorio(diretorio), limiteBytes(limiteBytes), ok(criarDiretorio(diretorio)) {}
+
+bool CacheResultados::aberto() const {
+    return ok;
+}
+
+std::string CacheResultados::caminhoEntrada(const std::string& chave, const std::string& extensao) const {
+    return diretorio + "/" + chave + extensao;
+}
+
+void CacheResultados::registrar(bool acerto) {
+    std::string caminho = diretorio + "/" + ARQUIVO_CONTADORES;
+    int descritor = open(caminho.c_str(), O_RDWR | O_CREAT, 0644);
+    if (descritor < 0) return;
+    flock(descritor, LOCK_EX);  // Outros processos podem estar usando o mesmo cache
+
+    char texto[64] = {0};
+    unsigned long long acertos = 0, falhas = 0;
+    if (pread(descritor, texto, sizeof(texto) - 1, 0) > 0) {
+        std::sscanf(texto, "%llu %llu", &acertos, &falhas);
+    }
+    (acerto ? acertos : falhas)++;
+    int n = std::snprintf(texto, sizeof(texto), "%llu %llu\n", acertos, falhas);
+    if (ftruncate(descritor, 0) == 0) {
+        ssize_t gravados = pwrite(descritor, texto, static_cast<size_t>(n), 0);
+        (void)gravados;  // Contadores são só informativos: uma falha aqui não afeta o cache
+    }
+    close(descritor);  // Libera a trava
+}
+
+static void lerContadores(const std::string& diretorio, uint64_t& acertos, uint64_t& falhas) {
+    acertos = falhas = 0;
+    std::string caminho = diretorio + "/" + ARQUIVO_CONTADORES;
+    FILE* arquivo = std::fopen(caminho.c_str(), "r");
+    if (!arquivo) return;
+    unsigned long long a = 0, f = 0;
+    if (std::fscanf(arquivo, "%llu %llu", &a, &f) == 2) {
+        acertos = a;
+        falhas = f;
+    }
+    std::fclose(arquivo);
+}
+
+uint64_t CacheResultados::obterAcertos() const {
+    uint64_t acertos, falhas;
+    lerContadores(diretorio, acertos, falhas);
+    return acertos;
+}
+
+uint64_t CacheResultados::obterFalhas() const {
+    uint64_t acertos, falhas;
+    lerContadores(diretorio, acertos, falhas);
+    return falhas;
+}
+
+bool CacheResultados::buscar(const std::string& chave, const std::string& extensao, const char* destino) {
+    if (!ok || chave.empty()) return false;
+    std::string entrada = caminhoEntrada(chave, extensao);
+
+    struct stat info;
+    if (stat(entrada.c_str(), &info) != 0) {
+        registrar(false);
+        return false;
+    }
+
+    // Acerto: a entrada vira a usada mais recentemente (data de modificação = agora)
+    utimensat(AT_FDCWD, entrada.c_str(), nullptr, 0);
+
+    // Hard link se possível (instantâneo, sem espaço extra); senão, cópia
+    unlink(destino);
+    bool entregue = link(entrada.c_str(), destino) == 0 || copiarArquivo(entrada.c_str(), destino);
+    registrar(entregue);
+    return entregue;
+}
+
+bool CacheResultados::guardar(const std::string& chave, const std::string& extensao, const char* origem) {
+    if (!ok || chave.empty()) return false;
+    std::string entrada = caminhoEntrada(chave, extensao);
+
+    // Copia para um nome temporário e renomeia: quem consulta nunca vê uma entrada pela metade.
+    // Cópia (e não link) porque o arquivo de origem pode ser reescrito depois.
+    std::string temporario = diretorio + "/.temp." + std::to_string(getpid()) + "." + chave;
+    if (!copiarArquivo(origem, temporario.c_str()) || rename(temporario.c_str(), entrada.c_str()) != 0) {
+        unlink(temporario.c_str());
+        return false;
+    }
+    liberarEspaco(entrada);
+    return true;
+}
+
+void CacheResultados::liberarEspaco(const std::string& preservar) {
+    struct Entrada {
+        std::string caminho;
+        uint64_t bytes;
+        struct timespec usado;
+    };
+    std::vector<Entrada> entradas;
+    uint64_t total = 0;
+
+    DIR* dir = opendir(diretorio.c_str());
+    if (!dir) return;
+    while (struct dirent* item = readdir(dir)) {
+        // Ignora ".", "..", temporários e o arquivo de contadores
+        if (item->d_name[0] == '.' || std::strcmp(item->d_name, ARQUIVO_CONTADORES) == 0) continue;
+        std::string caminho = diretorio + "/" + item->d_name;
+        struct stat info;
+        if (stat(caminho.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) continue;
+        entradas.push_back({caminho, static_cast<uint64_t>(info.st_size), info.st_mtim});
+        total += static_cast<uint64_t>(info.st_size);
+    }
+    closedir(dir);
+
+    // Apaga da menos recentemente usada para a mais recente até caber no limite
+    std::sort(entradas.begin(), entradas.end(), [](const Entrada& a, const Entrada& b) {
+        return a.usado.tv_sec != b.usado.tv_sec ? a.usado.tv_sec < b.usado.tv_sec
+                                                : a.usado.tv_nsec < b.usado.tv_nsec;
+    });
+    for (size_t i = 0; i < entradas.size() && total > limiteBytes; i++) {
+        if (entradas[i].caminho == preservar) continue;
+        if (unlink(entradas[i].caminho.c_str()) == 0) {
+            total -= entradas[i].bytes;
+        }
+    }
+}
@@ -0,0 +1,597 @@
+#include "curvas_nivel.h"
+#include "arquivo_io.h"
+#include "paralelo.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+// Linhas de células por faixa na extração dos vetores. Fixo (e não obterNumThreads())
+// para que as curvas saiam na mesma ordem com qualquer número de threads
+static const size_t LINHAS_POR_FAIXA_CURVAS = 128;
+
+// Arestas ligadas pelo trecho de cada caso (0 = cima, 1 = direita, 2 = baixo, 3 = esquerda).
+// Bits do caso, cantos no nível ou acima: 8 = cima-esquerda, 4 = cima-direita,
+// 2 = baixo-direita, 1 = baixo-esquerda. As selas (5 e 10) são tratadas à parte
+static const int8_t ARESTAS_DO_CASO[16][2] = {
+    {-1, -1}, {3, 2}, {2, 1}, {3, 1}, {0, 1}, {-1, -1}, {0, 2}, {3, 0},
+    {3, 0},   {0, 2}, {-1, -1}, {0, 1}, {3, 1}, {2, 1}, {3, 2}, {-1, -1}};
+
+/**
+ * @brief Célula visitada, com a posição dos cruzamentos das suas arestas.
+ * @details Os níveis que cruzam uma aresta são os do intervalo entre os índices das suas
+ * pontas. Numerando em sequência os cruzamentos das arestas horizontais de uma linha de
+ * pontos (e das verticais de uma linha de células), o nível i cruza a aresta a na posição
+ * vaga[a] + i - primeiroNivel[a]; células vizinhas chegam à mesma posição.
+ */
+struct Celula {
+    size_t lin, col;
+    uint32_t primeiroNivel[4];  // Menor nível que cruza cada aresta
+    size_t vaga[4];             // Posição do cruzamento de primeiroNivel (cima/baixo: na sua linha de pontos)
+};
+
+/**
+ * @brief Trecho de curva dentro de uma célula, de ponto[0] a ponto[1].
+ */
+struct Trecho {
+    uint32_t nivel;
+    int aresta[2];       // Arestas das pontas (0 = cima, 1 = direita, 2 = baixo, 3 = esquerda)
+    PontoCurva ponto[2];
+    uint64_t chave[2];   // Identificam nível e aresta no mapa inteiro (iguais nas células vizinhas)
+};
+
+// Índice de cada ponto da linha na lista de níveis: quantos níveis ficam no ponto ou abaixo
+// dele. Parte do índice do ponto anterior, porque vizinhos costumam ter altitudes próximas
+static void indicesDaLinha(const double* linha, size_t lado, const std::vector<double>& niveis, uint32_t* indices) {
+    size_t numNiveis = niveis.size();
+    size_t k = 0;
+    for (size_t col = 0; col < lado; col++) {
+        double v = linha[col];
+        while (k < numNiveis && niveis[k] <= v) k++;
+        while (k > 0 && niveis[k - 1] > v) k--;
+        indices[col] = static_cast<uint32_t>(k);
+    }
+}
+
+static uint32_t distancia(uint32_t a, uint32_t b) {
+    return a > b ? a - b : b - a;
+}
+
+// Numera os cruzamentos das arestas horizontais de uma linha de pontos; retorna o total
+static size_t vagasHorizontais(const uint32_t* indices, size_t lado, size_t* vagas) {
+    size_t total = 0;
+    for (size_t col = 0; col + 1 < lado; col++) {
+        vagas[col] = total;
+        total += distancia(indices[col], indices[col + 1]);
+    }
+    return total;
+}
+
+// Idem, das arestas verticais entre duas linhas de pontos
+static size_t vagasVerticais(const uint32_t* cima, const uint32_t* baixo, size_t lado, size_t* vagas) {
+    size_t total = 0;
+    for (size_t col = 0; col < lado; col++) {
+        vagas[col] = total;
+        total += distancia(cima[col], baixo[col]);
+    }
+    return total;
+}
+
+// Percorre as linhas de células [linInicio, linFim), chamando visitante.iniciarLinha(lin,
+// cruzamentos da linha de pontos de baixo, cruzamentos das arestas verticais) no começo de
+// cada linha e visitante.trecho(celula, trecho) para cada trecho de curva. A interpolação
+// numa aresta é sempre feita do mesmo canto para o outro, então as duas células que a
+// dividem calculam o mesmo ponto
+template <typename Visitante>
+static void percorrerCelulas(const double* altitudes, size_t lado, const std::vector<double>& niveis,
+                             size_t linInicio, size_t linFim, Visitante& visitante) {
+    std::vector<uint32_t> indicesCima(lado), indicesBaixo(lado);
+    std::vector<size_t> vagasCima(lado), vagasBaixo(lado), vagasLaterais(lado);
+    indicesDaLinha(altitudes + linInicio * lado, lado, niveis, indicesCima.data());
+    vagasHorizontais(indicesCima.data(), lado, vagasCima.data());
+    uint64_t arestasPorNivel = 2 * static_cast<uint64_t>(lado) * lado;
+
+    Celula celula;
+    Trecho trecho;
+    for (size_t lin = linInicio; lin < linFim; lin++) {
+        const double* cima = altitudes + lin * lado;
+        const double* baixo = cima + lado;
+        indicesDaLinha(baixo, lado, niveis, indicesBaixo.data());
+        size_t numBaixo = vagasHorizontais(indicesBaixo.data(), lado, vagasBaixo.data());
+        size_t numLaterais = vagasVerticais(indicesCima.data(), indicesBaixo.data(), lado, vagasLaterais.data());
+        visitante.iniciarLinha(lin, numBaixo, numLaterais);
+        double y = static_cast<double>(lin);
+        celula.lin = lin;
+
+        for (size_t col = 0; col + 1 < lado; col++) {
+            uint32_t ka = indicesCima[col], kb = indicesCima[col + 1];
+            uint32_t kc = indicesBaixo[col + 1], kd = indicesBaixo[col];
+            uint32_t kMin = std::min(std::min(ka, kb), std::min(kc, kd));
+            uint32_t kMax = std::max(std::max(ka, kb), std::max(kc, kd));
+            if (kMin == kMax) continue;  // Nenhum nível passa pela célula
+
+            celula.col = col;
+            celula.primeiroNivel[0] = std::min(ka, kb);
+            celula.primeiroNivel[1] = std::min(kb, kc);
+            celula.primeiroNivel[2] = std::min(kd, kc);
+            celula.primeiroNivel[3] = std::min(ka, kd);
+            celula.vaga[0] = vagasCima[col];
+            celula.vaga[1] = vagasLaterais[col + 1];
+            celula.vaga[2] = vagasBaixo[col];
+            celula.vaga[3] = vagasLaterais[col];
+
+            double a = cima[col], b = cima[col + 1], c = baixo[col + 1], d = baixo[col];
+            double x = static_cast<double>(col);
+            // Arestas horizontais em 2 * índice do ponto da esquerda, verticais em 2 * índice do de cima + 1
+            uint64_t base = 2 * (static_cast<uint64_t>(lin) * lado + col);
+            uint64_t arestas[4] = {base, base + 3, base + 2 * lado, base + 1};
+
+            for (uint32_t i = kMin; i < kMax; i++) {
+                double nivel = niveis[i];
+                auto ponto = [&](int aresta) -> PontoCurva {
+                    switch (aresta) {
+                        case 0: return {x + (nivel - a) / (b - a), y};
+                        case 1: return {x + 1, y + (nivel - b) / (c - b)};
+                        case 2: return {x + (nivel - d) / (c - d), y + 1};
+                        default: return {x, y + (nivel - a) / (d - a)};
+                    }
+                };
+                auto visitar = [&](int arestaP, int arestaQ) {
+                    trecho.aresta[0] = arestaP;
+                    trecho.aresta[1] = arestaQ;
+                    trecho.ponto[0] = ponto(arestaP);
+                    trecho.ponto[1] = ponto(arestaQ);
+                    trecho.chave[0] = i * arestasPorNivel + arestas[arestaP];
+                    trecho.chave[1] = i * arestasPorNivel + arestas[arestaQ];
+                    visitante.trecho(celula, trecho);
+                };
+                trecho.nivel = i;
+                int caso = (ka > i) << 3 | (kb > i) << 2 | (kc > i) << 1 | (kd > i);
+                if (caso == 5 || caso == 10) {
+                    // Sela: a média dos cantos decide se os cantos de cima-esquerda e
+                    // baixo-direita ficam ligados (dois trechos cortando os outros cantos)
+                    bool centroAcima = (a + b + c + d) / 4 >= nivel;
+                    bool separaAC = (caso == 5) == centroAcima;
+                    visitar(separaAC ? 3 : 0, separaAC ? 0 : 1);
+                    visitar(separaAC ? 1 : 3, 2);
+                } else {
+                    visitar(ARESTAS_DO_CASO[caso][0], ARESTAS_DO_CASO[caso][1]);
+                }
+            }
+        }
+        indicesCima.swap(indicesBaixo);
+        vagasCima.swap(vagasBaixo);
+    }
+}
+
+std::vector<double> calcularNiveis(const double* altitudes, size_t numPontos, double intervalo) {
+    std::vector<double> niveis;
+    if (numPontos == 0 || !(intervalo > 0)) return niveis;
+    auto limites = std::minmax_element(altitudes, altitudes + numPontos);
+    double primeiro = std::ceil(*limites.first / intervalo);
+    double ultimo = std::floor(*limites.second / intervalo);
+    for (double k = primeiro; k <= ultimo; k++) {
+        niveis.push_back(k * intervalo);
+    }
+    return niveis;
+}
+
+/**
+ * @brief Polilinhas em construção, emendadas pelas arestas das pontas.
+ * @details Cada polilinha aberta guarda as chaves de aresta das suas duas pontas; um trecho
+ * (ou polilinha) que chega numa ponta é emendado nela, e quando as duas pontas de uma mesma
+ * polilinha se encontram ela fica fechada. Ao juntar duas polilinhas os pontos da menor
+ * são copiados para a maior, e a menor passa a apontar para ela (como numa união de
+ * conjuntos), então quem guardou o índice da menor chega à maior por raiz().
+ */
+class Costura {
+public:
+    struct Cadeia {
+        std::vector<PontoCurva> frente;  // Pontos antes de tras[0], do mais próximo ao mais distante
+        std::vector<PontoCurva> tras;
+        uint64_t chaveInicio, chaveFim;  // Arestas das pontas (frente.back() ou tras[0], e tras.back())
+        uint32_t nivel;
+        bool fechada;
+        size_t destino;                  // Ela mesma, ou a cadeia em que foi emendada
+
+        size_t tamanho() const { return frente.size() + tras.size(); }
+    };
+
+    std::vector<Cadeia> cadeias;
+
+    // Cadeia em que x está hoje
+    size_t raiz(size_t x) {
+        while (cadeias[x].destino != x) {
+            cadeias[x].destino = cadeias[cadeias[x].destino].destino;
+            x = cadeias[x].destino;
+        }
+        return x;
+    }
+
+    size_t novaCadeia(const Trecho& trecho) {
+        size_t nova = cadeias.size();
+        cadeias.push_back(Cadeia{{}, {trecho.ponto[0], trecho.ponto[1]}, trecho.chave[0], trecho.chave[1],
+                                 trecho.nivel, false, nova});
+        return nova;
+    }
+
+    // Acrescenta ponto na ponta chave da cadeia x, que passa a ser a ponta novaChave
+    void estender(size_t x, uint64_t chave, const PontoCurva& ponto, uint64_t novaChave) {
+        Cadeia& cadeia = cadeias[x];
+        if (cadeia.chaveFim == chave) {
+            cadeia.tras.push_back(ponto);
+            cadeia.chaveFim = novaChave;
+        } else {
+            cadeia.frente.push_back(ponto);
+            cadeia.chaveInicio = novaChave;
+        }
+    }
+
+    // Junta as cadeias x e y, que terminam ambas na aresta chave (com o mesmo ponto)
+    size_t unir(size_t x, size_t y, uint64_t chave) {
+        size_t grande = cadeias[x].tamanho() >= cadeias[y].tamanho() ? x : y;
+        size_t pequena = grande == x ? y : x;
+        Cadeia& g = cadeias[grande];
+        Cadeia& p = cadeias[pequena];
+
+        // Pontos da menor a partir da ponta comum (sem repeti-la) e a sua outra ponta
+        std::vector<PontoCurva> pontos = pontosEmOrdem(p);
+        uint64_t outraChave;
+        if (p.chaveInicio == chave) {
+            outraChave = p.chaveFim;
+        } else {
+            std::reverse(pontos.begin(), pontos.end());
+            outraChave = p.chaveInicio;
+        }
+        bool noFim = g.chaveFim == chave;
+        std::vector<PontoCurva>& destino = noFim ? g.tras : g.frente;
+        destino.insert(destino.end(), pontos.begin() + 1, pontos.end());
+        (noFim ? g.chaveFim : g.chaveInicio) = outraChave;
+
+        p.destino = grande;
+        std::vector<PontoCurva>().swap(p.frente);
+        std::vector<PontoCurva>().swap(p.tras);
+        return grande;
+    }
+
+    // Trecho na célula, com as pontas que chegam de outras células já resolvidas (ou NENHUMA)
+    size_t adicionarTrecho(const Trecho& trecho, size_t cadeiaP, size_t cadeiaQ) {
+        if (cadeiaP == NENHUMA && cadeiaQ == NENHUMA) return novaCadeia(trecho);
+        if (cadeiaQ == NENHUMA) {
+            estender(cadeiaP, trecho.chave[0], trecho.ponto[1], trecho.chave[1]);
+            return cadeiaP;
+        }
+        if (cadeiaP == NENHUMA) {
+            estender(cadeiaQ, trecho.chave[1], trecho.ponto[0], trecho.chave[0]);
+            return cadeiaQ;
+        }
+        estender(cadeiaP, trecho.chave[0], trecho.ponto[1], trecho.chave[1]);
+        if (cadeiaP == cadeiaQ) {
+            cadeias[cadeiaP].fechada = true;
+            return cadeiaP;
+        }
+        return unir(cadeiaP, cadeiaQ, trecho.chave[1]);
+    }
+
+    // Polilinha aberta já montada (ex: por outra faixa), emendada pelas chaves das pontas
+    void adicionarCadeia(Cadeia&& cadeia) {
+        uint64_t chaveInicio = cadeia.chaveInicio, chaveFim = cadeia.chaveFim;
+        size_t nova = cadeias.size();
+        cadeia.destino = nova;
+        cadeias.push_back(std::move(cadeia));
+        conectar(conectar(nova, chaveInicio), chaveFim);
+    }
+
+    // Pontos da cadeia do começo ao fim
+    static std::vector<PontoCurva> pontosEmOrdem(const Cadeia& cadeia) {
+        std::vector<PontoCurva> pontos;
+        pontos.reserve(cadeia.tamanho());
+        pontos.insert(pontos.end(), cadeia.frente.rbegin(), cadeia.frente.rend());
+        pontos.insert(pontos.end(), cadeia.tras.begin(), cadeia.tras.end());
+        return pontos;
+    }
+
+    static constexpr size_t NENHUMA = static_cast<size_t>(-1);
+
+private:
+    std::unordered_map<uint64_t, size_t> pontas;  // Só em adicionarCadeia
+
+    // Liga a ponta chave da cadeia x à que estiver registrada nela; retorna a cadeia resultante
+    size_t conectar(size_t x, uint64_t chave) {
+        auto it = pontas.find(chave);
+        if (it == pontas.end()) {
+            pontas.emplace(chave, x);
+            return x;
+        }
+        size_t y = raiz(it->second);
+        pontas.erase(it);
+        if (y == x) {
+            cadeias[x].fechada = true;
+            return x;
+        }
+        return unir(x, y, chave);
+    }
+};
+
+/**
+ * @brief Monta as polilinhas de uma faixa, na ordem em que as células são visitadas.
+ * @details Um trecho só pode continuar pelas arestas de cima e da esquerda (as outras
+ * células delas já foram visitadas); as suas pontas nas arestas de baixo e da direita
+ * ficam anotadas na posição do cruzamento, para a célula de baixo ou da direita. Com isso a
+ * emenda dentro da faixa é só indexar vetores, sem busca por chave.
+ */
+struct CosturaFaixa {
+    Costura& costura;
+    size_t linInicio;
+    std::vector<size_t> pontasCima, pontasBaixo;  // Cadeias nos cruzamentos das linhas de pontos lin e lin + 1
+    std::vector<size_t> pontasLaterais;           // Idem, das arestas verticais da linha de células
+
+    void iniciarLinha(size_t, size_t numBaixo, size_t numLaterais) {
+        pontasCima.swap(pontasBaixo);
+        pontasBaixo.resize(numBaixo);
+        pontasLaterais.resize(numLaterais);
+    }
+
+    size_t& ponta(const Celula& celula, int aresta, uint32_t nivel) {
+        size_t i = celula.vaga[aresta] + nivel - celula.primeiroNivel[aresta];
+        return aresta == 0 ? pontasCima[i] : aresta == 2 ? pontasBaixo[i] : pontasLaterais[i];
+    }
+
+    // Cadeia que chega pela aresta, se a célula do outro lado é da faixa e já foi visitada
+    size_t chegando(const Celula& celula, int aresta, uint32_t nivel) {
+        bool visitada = (aresta == 0 && celula.lin > linInicio) || (aresta == 3 && celula.col > 0);
+        return visitada ? costura.raiz(ponta(celula, aresta, nivel)) : Costura::NENHUMA;
+    }
+
+    void trecho(const Celula& celula, const Trecho& trecho) {
+        size_t cadeia = costura.adicionarTrecho(trecho, chegando(celula, trecho.aresta[0], trecho.nivel),
+                                                chegando(celula, trecho.aresta[1], trecho.nivel));
+        for (int k = 0; k < 2; k++) {
+            if (trecho.aresta[k] == 1 || trecho.aresta[k] == 2) {
+                ponta(celula, trecho.aresta[k], trecho.nivel) = cadeia;
+            }
+        }
+    }
+};
+
+std::vector<CurvaNivel> extrairCurvasNivel(const double* altitudes, size_t lado, const std::vector<double>& niveis) {
+    std::vector<CurvaNivel> curvas;
+    if (lado < 2 || niveis.empty()) return curvas;
+
+    size_t numLinhas = lado - 1;
+    size_t numFaixas = (numLinhas + LINHAS_POR_FAIXA_CURVAS - 1) / LINHAS_POR_FAIXA_CURVAS;
+    std::vector<std::vector<CurvaNivel>> fechadas(numFaixas);
+    std::vector<std::vector<Costura::Cadeia>> abertas(numFaixas);
+
+    executarEmFaixas(numLinhas, numFaixas, [&](size_t faixa, size_t inicio, size_t fim) {
+        Costura costura;
+        CosturaFaixa visitante{costura, inicio, {}, {}, {}};
+        percorrerCelulas(altitudes, lado, niveis, inicio, fim, visitante);
+        for (size_t i = 0; i < costura.cadeias.size(); i++) {
+            Costura::Cadeia& cadeia = costura.cadeias[i];
+            if (cadeia.destino != i) continue;
+            if (cadeia.fechada) {
+                fechadas[faixa].push_back(CurvaNivel{niveis[cadeia.nivel], true, Costura::pontosEmOrdem(cadeia)});
+            } else {
+                abertas[faixa].push_back(std::move(cadeia));
+            }
+        }
+    });
+
+    // Pedaços que param nas fronteiras entre faixas, emendados na ordem das faixas
+    Costura costura;
+    for (size_t faixa = 0; faixa < numFaixas; faixa++) {
+        for (CurvaNivel& curva : fechadas[faixa]) {
+            curvas.push_back(std::move(curva));
+        }
+        for (Costura::Cadeia& cadeia : abertas[faixa]) {
+            costura.adicionarCadeia(std::move(cadeia));
+        }
+        std::vector<CurvaNivel>().swap(fechadas[faixa]);
+        std::vector<Costura::Cadeia>().swap(abertas[faixa]);
+    }
+    for (size_t i = 0; i < costura.cadeias.size(); i++) {
+        const Costura::Cadeia& cadeia = costura.cadeias[i];
+        if (cadeia.destino != i) continue;
+        curvas.push_back(CurvaNivel{niveis[cadeia.nivel], cadeia.fechada, Costura::pontosEmOrdem(cadeia)});
+    }
+    return curvas;
+}
+
+/**
+ * @brief Acumula a cobertura dos trechos nos pixels das linhas [primeira, ultima).
+ */
+struct CoberturaFaixa {
+    size_t lado, primeira, ultima;
+    std::vector<float> cobertura;
+
+    void iniciarLinha(size_t, size_t, size_t) {}
+
+    void trecho(const Celula&, const Trecho& trecho) {
+        const PontoCurva& p = trecho.ponto[0];
+        const PontoCurva& q = trecho.ponto[1];
+        double dx = q.x - p.x, dy = q.y - p.y;
+        double comprimento2 = dx * dx + dy * dy;
+        double inverso = comprimento2 > 0 ? 1.0 / comprimento2 : 0.0;
+        // Pixels a menos de 1 do trecho
+        size_t x0 = static_cast<size_t>(std::floor(std::min(p.x, q.x)));
+        size_t x1 = std::min(lado - 1, static_cast<size_t>(std::ceil(std::max(p.x, q.x))));
+        size_t y0 = std::max(primeira, static_cast<size_t>(std::floor(std::min(p.y, q.y))));
+        size_t y1 = std::min(ultima - 1, static_cast<size_t>(std::ceil(std::max(p.y, q.y))));
+        for (size_t yp = y0; yp <= y1; yp++) {
+            float* linha = cobertura.data() + (yp - primeira) * lado;
+            for (size_t xp = x0; xp <= x1; xp++) {
+                // Distância do centro do pixel ao trecho
+                double t = ((xp - p.x) * dx + (yp - p.y) * dy) * inverso;
+                t = std::min(1.0, std::max(0.0, t));
+                double ex = p.x + t * dx - xp, ey = p.y + t * dy - yp;
+                float valor = static_cast<float>(1.0 - std::sqrt(ex * ex + ey * ey));
+                if (valor > linha[xp]) linha[xp] = valor;
+            }
+        }
+    }
+};
+
+void desenharCurvasNivel(const double* altitudes, size_t lado, const std::vector<double>& niveis, Pixel cor,
+                         double opacidade, size_t linInicio, size_t linFim, const VistaImagem& destino) {
+    if (lado < 2 || niveis.empty() || linFim <= linInicio) return;
+    float opacidadeCurva = static_cast<float>(std::min(1.0, std::max(0.0, opacidade)));
+
+    executarEmFaixas(linFim - linInicio, obterNumThreads(), [&](size_t, size_t inicio, size_t fim) {
+        size_t primeira = linInicio + inicio;
+        size_t ultima = linInicio + fim;  // Exclusiva
+        CoberturaFaixa visitante{lado, primeira, ultima, std::vector<float>((ultima - primeira) * lado, 0.0f)};
+
+        // Os trechos que passam a menos de 1 pixel destas linhas estão nas células das
+        // linhas primeira - 1 a ultima - 1
+        size_t celulaInicio = primeira > 0 ? primeira - 1 : 0;
+        size_t celulaFim = std::min(ultima, lado - 1);
+        percorrerCelulas(altitudes, lado, niveis, celulaInicio, celulaFim, visitante);
+
+        for (size_t lin = primeira; lin < ultima; lin++) {
+            const float* linha = visitante.cobertura.data() + (lin - primeira) * lado;
+            // Mistura canal a canal, direto no layout do destino
+            VistaImagem pixels = destino.deslocada(0, lin - linInicio);
+            const unsigned char corCanal[3] = {cor.r, cor.g, cor.b};
+            for (size_t col = 0; col < lado; col++) {
+                if (linha[col] <= 0.0f) continue;
+                float alfa = linha[col] * opacidadeCurva;
+                size_t d = col * pixels.passoPixel;
+                for (size_t c = 0; c < 3; c++) {
+                    unsigned char& canal = pixels.canais[c][d];
+                    canal = static_cast<unsigned char>(canal + (corCanal[c] - canal) * alfa + 0.5f);
+                }
+            }
+        }
+    });
+}
+
+/**
+ * @brief Texto montado em blocos grandes antes de ir para o arquivo.
+ */
+class SaidaTexto {
+public:
+    explicit SaidaTexto(const char* nomeArquivo) : arquivo(nomeArquivo), ok(arquivo.aberto()) {
+        if (!ok) {
+            std::cerr << "Erro ao criar arquivo: " << nomeArquivo << std::endl;
+        }
+        bloco.reserve(TAMANHO_BLOCO + 256);
+    }
+
+    bool aberto() const { return ok; }
+
+    void texto(const char* s) {
+        bloco.append(s);
+        if (bloco.size() >= TAMANHO_BLOCO) descarregar();
+    }
+
+    // Número com até 3 casas decimais, sem zeros à direita
+    void coordenada(double v) {
+        char buffer[64];
+        auto resultado = std::to_chars(buffer, buffer + sizeof(buffer), v, std::chars_format::fixed, 3);
+        char* fim = resultado.ptr;
+        while (fim[-1] == '0') fim--;
+        if (fim[-1] == '.') fim--;
+        if (fim - buffer == 2 && buffer[0] == '-' && buffer[1] == '0') {
+            buffer[0] = '0';
+            fim = buffer + 1;
+        }
+        bloco.append(buffer, fim);
+    }
+
+    // Número com 12 algarismos significativos (0.15 em vez de 0.15000000000000002)
+    void numero(double v) {
+        char buffer[64];
+        auto resultado = std::to_chars(buffer, buffer + sizeof(buffer), v, std::chars_format::general, 12);
+        bloco.append(buffer, resultado.ptr);
+    }
+
+    bool fechar() {
+        descarregar();
+        return arquivo.fechar() && ok;
+    }
+
+private:
+    static constexpr size_t TAMANHO_BLOCO = 1 << 20;
+    ArquivoSaida arquivo;
+    bool ok;
+    std::string bloco;
+
+    void descarregar() {
+        if (ok && !bloco.empty()) ok = arquivo.escrever(bloco.data(), bloco.size());
+        bloco.clear();
+    }
+};
+
+bool salvarCurvasSVG(const char* nomeArquivo, const std::vector<CurvaNivel>& curvas, size_t lado) {
+    SaidaTexto saida(nomeArquivo);
+    if (!saida.aberto()) return false;
+
+    std::string tamanho = std::to_string(lado);
+    saida.texto("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"");
+    saida.texto(tamanho.c_str());
+    saida.texto("\" height=\"");
+    saida.texto(tamanho.c_str());
+    saida.texto("\" viewBox=\"-0.5 -0.5 ");
+    saida.texto(tamanho.c_str());
+    saida.texto(" ");
+    saida.texto(tamanho.c_str());
+    saida.texto("\">\n<g fill=\"none\" stroke=\"black\" stroke-width=\"1\">\n");
+    for (const CurvaNivel& curva : curvas) {
+        if (curva.pontos.empty()) continue;
+        saida.texto("<path data-altitude=\"");
+        saida.numero(curva.altitude);
+        saida.texto("\" d=\"M");
+        // Nas fechadas o último ponto repete o primeiro e vira o Z
+        size_t numPontos = curva.pontos.size() - (curva.fechada ? 1 : 0);
+        for (size_t i = 0; i < numPontos; i++) {
+            if (i > 0) saida.texto(i == 1 ? " L" : " ");
+            saida.coordenada(curva.pontos[i].x);
+            saida.texto(",");
+            saida.coordenada(curva.pontos[i].y);
+        }
+        saida.texto(curva.fechada ? " Z\"/>\n" : "\"/>\n");
+    }
+    saida.texto("</g>\n</svg>\n");
+
+    if (!saida.fechar()) {
+        std::cerr << "Erro ao gravar arquivo: " << nomeArquivo << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool salvarCurvasGeoJSON(const char* nomeArquivo, const std::vector<CurvaNivel>& curvas) {
+    SaidaTexto saida(nomeArquivo);
+    if (!saida.aberto()) return false;
+
+    saida.texto("{\"type\":\"FeatureCollection\",\"features\":[");
+    bool primeira = true;
+    for (const CurvaNivel& curva : curvas) {
+        if (curva.pontos.empty()) continue;
+        saida.texto(primeira ? "\n" : ",\n");
+        primeira = false;
+        saida.texto("{\"type\":\"Feature\",\"properties\":{\"altitude\":");
+        saida.numero(curva.altitude);
+        saida.texto("},\"geometry\":{\"type\":\"LineString\",\"coordinates\":[");
+        for (size_t i = 0; i < curva.pontos.size(); i++) {
+            saida.texto(i == 0 ? "[" : ",[");
+            saida.coordenada(curva.pontos[i].x);
+            saida.texto(",");
+            saida.coordenada(curva.pontos[i].y);
+            saida.texto("]");
+        }
+        saida.texto("]}}");
+    }
+    saida.texto("\n]}\n");
+
+    if (!saida.fechar()) {
+        std::cerr << "Erro ao gravar arquivo: " << nomeArquivo << std::endl;
+        return false;
+    }
+    return true;
+}
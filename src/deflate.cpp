@@ -0,0 +1,501 @@
+#include "deflate.h"
+#include "fluxo_bits.h"
+#include <algorithm>
+#include <cstring>
+
+// ═══════════════════════════════════════════════════════════
+// TABELAS DO FORMATO (RFC 1951)
+// ═══════════════════════════════════════════════════════════
+
+static const uint16_t BASE_COMPRIMENTO[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const uint8_t EXTRA_COMPRIMENTO[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const uint16_t BASE_DISTANCIA[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+static const uint8_t EXTRA_DISTANCIA[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+// Ordem em que os comprimentos do código de comprimentos são gravados
+static const uint8_t ORDEM_COMPRIMENTOS[19] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+static const int NUM_LITERAIS = 286;   // 0-255 literais, 256 fim de bloco, 257-285 comprimentos
+static const int NUM_DISTANCIAS = 30;
+static const int NUM_CODIGOS_COMPRIMENTO = 19;
+static const int FIM_DE_BLOCO = 256;
+
+static const size_t JANELA = 32768;
+static const int BITS_HASH = 15;
+static const unsigned int COMPRIMENTO_MINIMO = 3;
+static const unsigned int COMPRIMENTO_MAXIMO = 258;
+static const size_t SIMBOLOS_POR_BLOCO = 64 * 1024;
+static const size_t MAXIMO_STORED = 65535;
+
+// Parâmetros do LZ77 por nível (inspirados nos do zlib): tamanho máximo da cadeia de
+// hash, comprimento "bom o suficiente" para parar a busca e maior par cujas posições
+// internas ainda são inseridas no hash (nos níveis rápidos, pares longos são pulados)
+static const int CADEIA_POR_NIVEL[10] = {0, 4, 6, 8, 16, 32, 64, 128, 512, 4096};
+static const unsigned int BOM_POR_NIVEL[10] = {0, 8, 16, 32, 64, 128, 128, 258, 258, 258};
+static const unsigned int INSERCAO_POR_NIVEL[10] = {0, 4, 5, 6, 258, 258, 258, 258, 258, 258};
+
+// Símbolos do LZ77: literal = valor do byte; par (comprimento, distância) marcado no bit 31
+static const uint32_t MARCA_PAR = 0x80000000u;
+
+static inline int codigoComprimento(unsigned int comprimento) {
+    if (comprimento == 258) return 28;
+    unsigned int v = comprimento - 3;
+    if (v < 8) return static_cast<int>(v);
+    int bits = 31 - __builtin_clz(v);
+    return 4 * (bits - 1) + static_cast<int>((v >> (bits - 2)) & 3);
+}
+
+static inline int codigoDistancia(unsigned int distancia) {
+    if (distancia <= 4) return static_cast<int>(distancia - 1);
+    unsigned int v = distancia - 1;
+    int bits = 31 - __builtin_clz(v);
+    return 2 * bits + static_cast<int>((v >> (bits - 1)) & 1);
+}
+
+// ═══════════════════════════════════════════════════════════
+// CÓDIGOS DE HUFFMAN
+// ═══════════════════════════════════════════════════════════
+
+// Calcula comprimentos de código de Huffman (no máximo "limite" bits) a partir das
+// frequências. Se a árvore ficar funda demais, as frequências são reduzidas à metade
+// (mantendo-se >= 1) e a árvore é refeita.
+static void construirComprimentos(const uint32_t* frequencias, int n, int limite, uint8_t* comprimentos) {
+    std::vector<uint32_t> freq(frequencias, frequencias + n);
+    std::vector<std::pair<uint32_t, int>> folhas;
+    std::vector<uint64_t> peso;
+    std::vector<int> pai, profundidade;
+
+    for (;;) {
+        std::fill(comprimentos, comprimentos + n, 0);
+        folhas.clear();
+        for (int i = 0; i < n; i++) {
+            if (freq[i] > 0) folhas.push_back(std::make_pair(freq[i], i));
+        }
+        size_t m = folhas.size();
+        if (m == 0) return;
+        if (m == 1) {
+            comprimentos[folhas[0].second] = 1;
+            return;
+        }
+        std::sort(folhas.begin(), folhas.end());
+
+        // Duas filas: folhas ordenadas e nós internos (criados em ordem crescente de peso)
+        size_t total = 2 * m - 1;
+        peso.assign(total, 0);
+        pai.assign(total, -1);
+        for (size_t i = 0; i < m; i++) peso[i] = folhas[i].first;
+
+        size_t proximaFolha = 0, proximoInterno = m;
+        for (size_t novo = m; novo < total; novo++) {
+            size_t filhos[2];
+            for (int k = 0; k < 2; k++) {
+                if (proximaFolha < m && (proximoInterno >= novo || peso[proximaFolha] <= peso[proximoInterno])) {
+                    filhos[k] = proximaFolha++;
+                } else {
+                    filhos[k] = proximoInterno++;
+                }
+            }
+            peso[novo] = peso[filhos[0]] + peso[filhos[1]];
+            pai[filhos[0]] = static_cast<int>(novo);
+            pai[filhos[1]] = static_cast<int>(novo);
+        }
+
+        // Pais sempre têm índice maior: percorre da raiz para as folhas
+        profundidade.assign(total, 0);
+        int maior = 0;
+        for (size_t k = total - 1; k-- > 0;) {
+            profundidade[k] = profundidade[pai[k]] + 1;
+            if (k < m) maior = std::max(maior, profundidade[k]);
+        }
+
+        if (maior <= limite) {
+            for (size_t i = 0; i < m; i++) {
+                comprimentos[folhas[i].second] = static_cast<uint8_t>(profundidade[i]);
+            }
+            return;
+        }
+        for (int i = 0; i < n; i++) {
+            if (freq[i] > 0) freq[i] = (freq[i] + 1) / 2;
+        }
+    }
+}
+
+// Códigos canônicos (RFC 1951, 3.2.2), já com os bits invertidos: o deflate grava os
+// códigos de Huffman a partir do bit mais significativo
+static void construirCodigos(const uint8_t* comprimentos, int n, uint16_t* codigos) {
+    int contagem[16] = {0};
+    for (int i = 0; i < n; i++) contagem[comprimentos[i]]++;
+    contagem[0] = 0;
+
+    int proximo[16] = {0};
+    int codigo = 0;
+    for (int bits = 1; bits <= 15; bits++) {
+        codigo = (codigo + contagem[bits - 1]) << 1;
+        proximo[bits] = codigo;
+    }
+
+    for (int i = 0; i < n; i++) {
+        int len = comprimentos[i];
+        if (len == 0) continue;
+        unsigned int c = static_cast<unsigned int>(proximo[len]++);
+        unsigned int invertido = 0;
+        for (int b = 0; b < len; b++) {
+            invertido = (invertido << 1) | ((c >> b) & 1);
+        }
+        codigos[i] = static_cast<uint16_t>(invertido);
+    }
+}
+
+// Garante pelo menos dois símbolos com frequência > 0, para que o código de Huffman seja
+// completo (decodificadores como o zlib rejeitam alguns códigos incompletos)
+static void garantirDoisSimbolos(uint32_t* frequencias, int n) {
+    int usados = 0;
+    for (int i = 0; i < n && usados < 2; i++) {
+        if (frequencias[i] > 0) usados++;
+    }
+    for (int i = 0; i < n && usados < 2; i++) {
+        if (frequencias[i] == 0) {
+            frequencias[i] = 1;
+            usados++;
+        }
+    }
+}
+
+// ═══════════════════════════════════════════════════════════
+// BLOCOS
+// ═══════════════════════════════════════════════════════════
+
+static void emitirStored(EscritorBits& escritor, std::vector<unsigned char>& saida,
+                         const unsigned char* dados, size_t tamanho) {
+    do {
+        size_t parte = std::min(tamanho, MAXIMO_STORED);
+        escritor.escrever(0, 1);  // Não final
+        escritor.escrever(0, 2);  // Tipo 00: stored
+        escritor.finalizar();     // Alinha em byte
+        saida.push_back(static_cast<unsigned char>(parte & 0xFF));
+        saida.push_back(static_cast<unsigned char>(parte >> 8));
+        saida.push_back(static_cast<unsigned char>(~parte & 0xFF));
+        saida.push_back(static_cast<unsigned char>((~parte >> 8) & 0xFF));
+        saida.insert(saida.end(), dados, dados + parte);
+        dados += parte;
+        tamanho -= parte;
+    } while (tamanho > 0);
+}
+
+// Emite um bloco com Huffman dinâmico, ou stored se isso ocupar menos
+static void emitirBloco(EscritorBits& escritor, std::vector<unsigned char>& saida,
+                        const std::vector<uint32_t>& simbolos,
+                        const unsigned char* original, size_t tamanhoOriginal) {
+    uint32_t freqLit[NUM_LITERAIS] = {0};
+    uint32_t freqDist[NUM_DISTANCIAS] = {0};
+    uint64_t bitsExtras = 0;
+    for (uint32_t s : simbolos) {
+        if (s & MARCA_PAR) {
+            int cl = codigoComprimento((s >> 16) & 0x1FF);
+            int cd = codigoDistancia(s & 0xFFFF);
+            freqLit[257 + cl]++;
+            freqDist[cd]++;
+            bitsExtras += EXTRA_COMPRIMENTO[cl] + EXTRA_DISTANCIA[cd];
+        } else {
+            freqLit[s]++;
+        }
+    }
+    freqLit[FIM_DE_BLOCO] = 1;
+    garantirDoisSimbolos(freqLit, NUM_LITERAIS);
+    garantirDoisSimbolos(freqDist, NUM_DISTANCIAS);
+
+    uint8_t compLit[NUM_LITERAIS], compDist[NUM_DISTANCIAS];
+    construirComprimentos(freqLit, NUM_LITERAIS, 15, compLit);
+    construirComprimentos(freqDist, NUM_DISTANCIAS, 15, compDist);
+
+    int numLit = NUM_LITERAIS;
+    while (numLit > 257 && compLit[numLit - 1] == 0) numLit--;
+    int numDist = NUM_DISTANCIAS;
+    while (numDist > 1 && compDist[numDist - 1] == 0) numDist--;
+
+    // Comprimentos dos dois códigos, em sequência, compactados com RLE (símbolos 16/17/18)
+    std::vector<uint8_t> sequencia(compLit, compLit + numLit);
+    sequencia.insert(sequencia.end(), compDist, compDist + numDist);
+    std::vector<std::pair<uint8_t, uint8_t>> tokens;  // (símbolo, valor dos bits extras)
+    for (size_t i = 0; i < sequencia.size();) {
+        uint8_t valor = sequencia[i];
+        size_t corrida = 1;
+        while (i + corrida < sequencia.size() && sequencia[i + corrida] == valor) corrida++;
+        i += corrida;
+
+        if (valor == 0) {
+            while (corrida >= 11) {
+                size_t r = std::min<size_t>(corrida, 138);
+                tokens.push_back(std::make_pair(18, static_cast<uint8_t>(r - 11)));
+                corrida -= r;
+            }
+            if (corrida >= 3) {
+                tokens.push_back(std::make_pair(17, static_cast<uint8_t>(corrida - 3)));
+                corrida = 0;
+            }
+        } else {
+            tokens.push_back(std::make_pair(valor, 0));
+            corrida--;
+            while (corrida >= 3) {
+                size_t r = std::min<size_t>(corrida, 6);
+                tokens.push_back(std::make_pair(16, static_cast<uint8_t>(r - 3)));
+                corrida -= r;
+            }
+        }
+        for (; corrida > 0; corrida--) tokens.push_back(std::make_pair(valor, 0));
+    }
+
+    uint32_t freqCL[NUM_CODIGOS_COMPRIMENTO] = {0};
+    for (size_t t = 0; t < tokens.size(); t++) freqCL[tokens[t].first]++;
+    garantirDoisSimbolos(freqCL, NUM_CODIGOS_COMPRIMENTO);
+    uint8_t compCL[NUM_CODIGOS_COMPRIMENTO];
+    construirComprimentos(freqCL, NUM_CODIGOS_COMPRIMENTO, 7, compCL);
+    int numCL = NUM_CODIGOS_COMPRIMENTO;
+    while (numCL > 4 && compCL[ORDEM_COMPRIMENTOS[numCL - 1]] == 0) numCL--;
+
+    // Compara o tamanho do bloco dinâmico com o de blocos stored
+    uint64_t custo = 3 + 5 + 5 + 4 + 3 * static_cast<uint64_t>(numCL) + bitsExtras;
+    for (size_t t = 0; t < tokens.size(); t++) {
+        uint8_t s = tokens[t].first;
+        custo += compCL[s] + (s == 16 ? 2 : s == 17 ? 3 : s == 18 ? 7 : 0);
+    }
+    for (int i = 0; i < NUM_LITERAIS; i++) custo += static_cast<uint64_t>(freqLit[i]) * compLit[i];
+    for (int i = 0; i < NUM_DISTANCIAS; i++) custo += static_cast<uint64_t>(freqDist[i]) * compDist[i];
+    uint64_t custoStored = 8 * (tamanhoOriginal + 5 * (tamanhoOriginal / MAXIMO_STORED + 1)) + 7;
+    if (custo >= custoStored) {
+        emitirStored(escritor, saida, original, tamanhoOriginal);
+        return;
+    }
+
+    uint16_t codLit[NUM_LITERAIS], codDist[NUM_DISTANCIAS], codCL[NUM_CODIGOS_COMPRIMENTO];
+    construirCodigos(compLit, NUM_LITERAIS, codLit);
+    construirCodigos(compDist, NUM_DISTANCIAS, codDist);
+    construirCodigos(compCL, NUM_CODIGOS_COMPRIMENTO, codCL);
+
+    // Cabeçalho do bloco
+    escritor.escrever(0, 1);  // Não final (o bloco final vazio é emitido no fim do fluxo)
+    escritor.escrever(2, 2);  // Tipo 10: Huffman dinâmico
+    escritor.escrever(static_cast<uint64_t>(numLit - 257), 5);
+    escritor.escrever(static_cast<uint64_t>(numDist - 1), 5);
+    escritor.escrever(static_cast<uint64_t>(numCL - 4), 4);
+    for (int k = 0; k < numCL; k++) escritor.escrever(compCL[ORDEM_COMPRIMENTOS[k]], 3);
+    for (size_t t = 0; t < tokens.size(); t++) {
+        uint8_t s = tokens[t].first;
+        escritor.escrever(codCL[s], compCL[s]);
+        if (s == 16) escritor.escrever(tokens[t].second, 2);
+        else if (s == 17) escritor.escrever(tokens[t].second, 3);
+        else if (s == 18) escritor.escrever(tokens[t].second, 7);
+    }
+
+    // Dados
+    for (uint32_t s : simbolos) {
+        if (s & MARCA_PAR) {
+            unsigned int comprimento = (s >> 16) & 0x1FF;
+            unsigned int distancia = s & 0xFFFF;
+            int cl = codigoComprimento(comprimento);
+            int cd = codigoDistancia(distancia);
+            escritor.escrever(codLit[257 + cl], compLit[257 + cl]);
+            escritor.escrever(comprimento - BASE_COMPRIMENTO[cl], EXTRA_COMPRIMENTO[cl]);
+            escritor.escrever(codDist[cd], compDist[cd]);
+            escritor.escrever(distancia - BASE_DISTANCIA[cd], EXTRA_DISTANCIA[cd]);
+        } else {
+            escritor.escrever(codLit[s], compLit[s]);
+        }
+    }
+    escritor.escrever(codLit[FIM_DE_BLOCO], compLit[FIM_DE_BLOCO]);
+}
+
+// ═══════════════════════════════════════════════════════════
+// LZ77
+// ═══════════════════════════════════════════════════════════
+
+static inline uint32_t calcularHash(const unsigned char* p) {
+    uint32_t v = static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+                 (static_cast<uint32_t>(p[2]) << 16);
+    return (v * 2654435761u) >> (32 - BITS_HASH);
+}
+
+// Quantos bytes iguais há a partir de a e b (no máximo "limite"), 8 bytes por vez
+static inline unsigned int compararBytes(const unsigned char* a, const unsigned char* b, unsigned int limite) {
+    unsigned int n = 0;
+    while (n + 8 <= limite) {
+        uint64_t x, y;
+        std::memcpy(&x, a + n, 8);
+        std::memcpy(&y, b + n, 8);
+        if (x != y) return n + static_cast<unsigned int>(__builtin_ctzll(x ^ y) / 8);
+        n += 8;
+    }
+    while (n < limite && a[n] == b[n]) n++;
+    return n;
+}
+
+void comprimirDeflate(const unsigned char* dados, size_t tamanho, int nivel, bool ultimo,
+                      std::vector<unsigned char>& saida) {
+    EscritorBits escritor(saida);
+    if (nivel < 0) nivel = 0;
+    if (nivel > 9) nivel = 9;
+
+    if (nivel == 0) {
+        if (tamanho > 0) emitirStored(escritor, saida, dados, tamanho);
+    } else if (tamanho > 0) {
+        std::vector<int32_t> cabeca(static_cast<size_t>(1) << BITS_HASH, -1);
+        std::vector<int32_t> anterior(JANELA, -1);
+        std::vector<uint32_t> simbolos;
+        simbolos.reserve(SIMBOLOS_POR_BLOCO + 1);
+        int maxCadeia = CADEIA_POR_NIVEL[nivel];
+        unsigned int bom = BOM_POR_NIVEL[nivel];
+        unsigned int maxInsercao = INSERCAO_POR_NIVEL[nivel];
+
+        size_t inicioBloco = 0;
+        size_t pos = 0;
+        auto inserir = [&](size_t p) {
+            uint32_t h = calcularHash(dados + p);
+            anterior[p & (JANELA - 1)] = cabeca[h];
+            cabeca[h] = static_cast<int32_t>(p);
+        };
+
+        while (pos < tamanho) {
+            unsigned int melhorComp = 0, melhorDist = 0;
+            if (pos + COMPRIMENTO_MINIMO <= tamanho) {
+                unsigned int limite = static_cast<unsigned int>(std::min<size_t>(COMPRIMENTO_MAXIMO, tamanho - pos));
+                int32_t candidato = cabeca[calcularHash(dados + pos)];
+                for (int cadeia = maxCadeia; candidato >= 0 && cadeia > 0; cadeia--) {
+                    size_t distancia = pos - static_cast<size_t>(candidato);
+                    if (distancia > JANELA) break;
+                    // Rejeição rápida: só compara se o byte que melhoraria o resultado bate
+                    if (dados[candidato + melhorComp] == dados[pos + melhorComp]) {
+                        unsigned int comp = compararBytes(dados + candidato, dados + pos, limite);
+                        if (comp > melhorComp) {
+                            melhorComp = comp;
+                            melhorDist = static_cast<unsigned int>(distancia);
+                            if (comp >= bom || comp == limite) break;
+                        }
+                    }
+                    candidato = anterior[candidato & (JANELA - 1)];
+                }
+                inserir(pos);
+            }
+
+            if (melhorComp >= COMPRIMENTO_MINIMO) {
+                simbolos.push_back(MARCA_PAR | (melhorComp << 16) | melhorDist);
+                size_t fimPar = pos + melhorComp;
+                if (melhorComp <= maxInsercao) {
+                    for (size_t p = pos + 1; p < fimPar && p + COMPRIMENTO_MINIMO <= tamanho; p++) {
+                        inserir(p);
+                    }
+                }
+                pos = fimPar;
+            } else {
+                simbolos.push_back(dados[pos]);
+                pos++;
+            }
+
+            if (simbolos.size() >= SIMBOLOS_POR_BLOCO) {
+                emitirBloco(escritor, saida, simbolos, dados + inicioBloco, pos - inicioBloco);
+                simbolos.clear();
+                inicioBloco = pos;
+            }
+        }
+        if (!simbolos.empty()) {
+            emitirBloco(escritor, saida, simbolos, dados + inicioBloco, pos - inicioBloco);
+        }
+    }
+
+    if (ultimo) {
+        // Bloco final vazio com Huffman fixo: 1 (final), 01 (tipo), 0000000 (fim de bloco)
+        escritor.escrever(1, 1);
+        escritor.escrever(1, 2);
+        escritor.escrever(0, 7);
+    } else {
+        // Bloco stored vazio: alinha o fluxo em byte para o próximo pedaço ser concatenado
+        escritor.escrever(0, 1);
+        escritor.escrever(0, 2);
+        escritor.finalizar();
+        const unsigned char vazio[4] = {0x00, 0x00, 0xFF, 0xFF};
+        saida.insert(saida.end(), vazio, vazio + 4);
+    }
+    escritor.finalizar();
+}
+
+// ═══════════════════════════════════════════════════════════
+// CHECKSUMS
+// ═══════════════════════════════════════════════════════════
+
+// Tabelas do CRC-32 "slicing-by-8": tabela[k][b] = CRC do byte b seguido de k bytes zero
+struct TabelasCRC32 {
+    uint32_t tabela[8][256];
+
+    TabelasCRC32() {
+        for (uint32_t b = 0; b < 256; b++) {
+            uint32_t c = b;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            tabela[0][b] = c;
+        }
+        for (uint32_t b = 0; b < 256; b++) {
+            for (int k = 1; k < 8; k++) {
+                uint32_t c = tabela[k - 1][b];
+                tabela[k][b] = tabela[0][c & 0xFF] ^ (c >> 8);
+            }
+        }
+    }
+};
+
+static const TabelasCRC32 TABELAS_CRC32;
+
+uint32_t calcularCRC32(const unsigned char* dados, size_t tamanho, uint32_t crc) {
+    const uint32_t (*t)[256] = TABELAS_CRC32.tabela;
+    crc = ~crc;
+    while (tamanho >= 8) {
+        uint32_t a = crc ^ (static_cast<uint32_t>(dados[0]) | (static_cast<uint32_t>(dados[1]) << 8) |
+                            (static_cast<uint32_t>(dados[2]) << 16) | (static_cast<uint32_t>(dados[3]) << 24));
+        crc = t[7][a & 0xFF] ^ t[6][(a >> 8) & 0xFF] ^ t[5][(a >> 16) & 0xFF] ^ t[4][a >> 24] ^
+              t[3][dados[4]] ^ t[2][dados[5]] ^ t[1][dados[6]] ^ t[0][dados[7]];
+        dados += 8;
+        tamanho -= 8;
+    }
+    while (tamanho-- > 0) {
+        crc = t[0][(crc ^ *dados++) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static const uint32_t BASE_ADLER = 65521;
+// Maior bloco que pode ser somado sem que s2 transborde 32 bits
+static const size_t BLOCO_ADLER = 5552;
+
+uint32_t calcularAdler32(const unsigned char* dados, size_t tamanho, uint32_t adler) {
+    uint32_t s1 = adler & 0xFFFF;
+    uint32_t s2 = adler >> 16;
+    while (tamanho > 0) {
+        size_t bloco = std::min(tamanho, BLOCO_ADLER);
+        tamanho -= bloco;
+        while (bloco-- > 0) {
+            s1 += *dados++;
+            s2 += s1;
+        }
+        s1 %= BASE_ADLER;
+        s2 %= BASE_ADLER;
+    }
+    return (s2 << 16) | s1;
+}
+
+uint32_t combinarAdler32(uint32_t adler1, uint32_t adler2, size_t tamanho2) {
+    uint32_t resto = static_cast<uint32_t>(tamanho2 % BASE_ADLER);
+    uint32_t s1 = adler1 & 0xFFFF;
+    uint32_t s2 = static_cast<uint32_t>((static_cast<uint64_t>(resto) * s1) % BASE_ADLER);
+    s1 += (adler2 & 0xFFFF) + BASE_ADLER - 1;
+    s2 += (adler1 >> 16) + (adler2 >> 16) + BASE_ADLER - resto;
+    if (s1 >= BASE_ADLER) s1 -= BASE_ADLER;
+    if (s1 >= BASE_ADLER) s1 -= BASE_ADLER;
+    if (s2 >= 2 * BASE_ADLER) s2 -= 2 * BASE_ADLER;
+    if (s2 >= BASE_ADLER) s2 -= BASE_ADLER;
+    return (s2 << 16) | s1;
+}
@@ -0,0 +1,342 @@
+#include "escritor_imagem.h"
+#include "pnm.h"
+#include "deflate.h"
+#include "paralelo.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+// ═══════════════════════════════════════════════════════════
+// BASE
+// ═══════════════════════════════════════════════════════════
+
+EscritorImagem::EscritorImagem(const char* nomeArquivo) : arquivo(nomeArquivo) {
+    if (!arquivo.aberto()) {
+        std::cerr << "Erro ao criar arquivo: " << nomeArquivo << std::endl;
+    }
+}
+
+bool EscritorImagem::aberto() const {
+    return arquivo.aberto();
+}
+
+bool EscritorImagem::gravar(const unsigned char* dados, size_t tamanho) {
+    return arquivo.escrever(dados, tamanho);
+}
+
+bool EscritorImagem::fechar() {
+    return arquivo.fechar();
+}
+
+bool EscritorImagem::escreverLinhas(const Pixel* linhas, size_t numLinhas) {
+    return codificarLinhas(linhas, numLinhas, codificado) && gravar(codificado.data(), codificado.size());
+}
+
+bool EscritorImagem::finalizar() {
+    bool ok = codificarFinal(codificado) && gravar(codificado.data(), codificado.size());
+    return fechar() && ok;
+}
+
+// ═══════════════════════════════════════════════════════════
+// PPM
+// ═══════════════════════════════════════════════════════════
+
+// Escreve um byte em decimal (sem zeros à esquerda) e avança o ponteiro
+static inline char* escreverDecimal(char* p, unsigned char valor) {
+    if (valor >= 100) {
+        *p++ = static_cast<char>('0' + valor / 100);
+        *p++ = static_cast<char>('0' + (valor / 10) % 10);
+    } else if (valor >= 10) {
+        *p++ = static_cast<char>('0' + valor / 10);
+    }
+    *p++ = static_cast<char>('0' + valor % 10);
+    return p;
+}
+
+EscritorPPM::EscritorPPM(const char* nomeArquivo, size_t largura, size_t altura, FormatoPPM formato)
+    : EscritorImagem(nomeArquivo), largura(largura), altura(altura), formato(formato), linhasEscritas(0) {
+    if (this->formato == PPM_AUTOMATICO) {
+        this->formato = largura * altura > Imagem::LIMITE_PIXELS_TEXTO ? PPM_BINARIO : PPM_TEXTO;
+    }
+    cabecalhoPendente = montarCabecalhoPNM(this->formato == PPM_BINARIO ? 6 : 3, largura, altura, 255);
+}
+
+bool EscritorPPM::codificarLinhas(const Pixel* linhas, size_t numLinhas, std::vector<unsigned char>& saida) {
+    if (linhasEscritas + numLinhas > altura) return false;
+    size_t totalPixels = numLinhas * largura;
+    
+    if (formato == PPM_BINARIO) {
+        // P6: os bytes RGB intercalados, como estão na memória
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(linhas);
+        saida.assign(cabecalhoPendente.begin(), cabecalhoPendente.end());
+        saida.insert(saida.end(), bytes, bytes + totalPixels * sizeof(Pixel));
+    } else {
+        // P3: "r g b" por linha de texto (no máximo "255 255 255\n" = 12 caracteres por pixel)
+        saida.resize(cabecalhoPendente.size() + totalPixels * 12);
+        char* inicio = reinterpret_cast<char*>(saida.data());
+        char* p = std::copy(cabecalhoPendente.begin(), cabecalhoPendente.end(), inicio);
+        for (size_t i = 0; i < totalPixels; i++) {
+            p = escreverDecimal(p, linhas[i].r);
+            *p++ = ' ';
+            p = escreverDecimal(p, linhas[i].g);
+            *p++ = ' ';
+            p = escreverDecimal(p, linhas[i].b);
+            *p++ = '\n';
+        }
+        saida.resize(static_cast<size_t>(p - inicio));
+    }
+    
+    cabecalhoPendente.clear();
+    linhasEscritas += numLinhas;
+    return true;
+}
+
+bool EscritorPPM::codificarFinal(std::vector<unsigned char>& saida) {
+    // Imagem sem linhas: só o cabeçalho
+    saida.assign(cabecalhoPendente.begin(), cabecalhoPendente.end());
+    cabecalhoPendente.clear();
+    return linhasEscritas == altura;
+}
+
+bool EscritorPPM::escreverLinhas(const Pixel* linhas, size_t numLinhas) {
+    if (formato != PPM_BINARIO) {
+        return EscritorImagem::escreverLinhas(linhas, numLinhas);
+    }
+    if (linhasEscritas + numLinhas > altura) return false;
+    
+    // P6: o array de pixels já é RGB intercalado (3 bytes por pixel), então a faixa
+    // (com o cabeçalho, na primeira vez) vai direto para o arquivo, sem cópia
+    bool ok = arquivo.escrever(cabecalhoPendente.data(), cabecalhoPendente.size(),
+                               linhas, numLinhas * largura * sizeof(Pixel));
+    cabecalhoPendente.clear();
+    linhasEscritas += numLinhas;
+    return ok;
+}
+
+// ═══════════════════════════════════════════════════════════
+// PNG
+// ═══════════════════════════════════════════════════════════
+
+// Linhas filtradas por pedaço comprimido em paralelo: pedaços de ~256 KB
+static const size_t BYTES_POR_PEDACO_PNG = 256 * 1024;
+
+static void anexarU32BE(std::vector<unsigned char>& saida, uint32_t valor) {
+    saida.push_back(static_cast<unsigned char>(valor >> 24));
+    saida.push_back(static_cast<unsigned char>(valor >> 16));
+    saida.push_back(static_cast<unsigned char>(valor >> 8));
+    saida.push_back(static_cast<unsigned char>(valor));
+}
+
+// Anexa um chunk PNG completo: comprimento, tipo, dados e CRC (de tipo + dados)
+static void anexarChunkPNG(std::vector<unsigned char>& saida, const char* tipo,
+                           const unsigned char* dados, size_t tamanho) {
+    anexarU32BE(saida, static_cast<uint32_t>(tamanho));
+    size_t inicioTipo = saida.size();
+    saida.insert(saida.end(), tipo, tipo + 4);
+    saida.insert(saida.end(), dados, dados + tamanho);
+    anexarU32BE(saida, calcularCRC32(saida.data() + inicioTipo, saida.size() - inicioTipo));
+}
+
+// Preditor Paeth do PNG: escolhe o vizinho (esquerda, cima, cima-esquerda) mais próximo de a + b - c
+static inline unsigned char paeth(int a, int b, int c) {
+    int p = a + b - c;
+    int pa = p > a ? p - a : a - p;
+    int pb = p > b ? p - b : b - p;
+    int pc = p > c ? p - c : c - p;
+    if (pa <= pb && pa <= pc) return static_cast<unsigned char>(a);
+    if (pb <= pc) return static_cast<unsigned char>(b);
+    return static_cast<unsigned char>(c);
+}
+
+// Filtra uma linha (bytes RGB) com o filtro PNG de índice "filtro"; anterior = nullptr na
+// primeira linha (equivale a uma linha de zeros). Um laço por filtro, para que o
+// compilador consiga vetorizar os casos simples.
+static void filtrarLinha(int filtro, const unsigned char* linha, const unsigned char* anterior,
+                         size_t bytes, unsigned char* saida) {
+    const size_t BPP = 3;
+    size_t inicio = std::min(BPP, bytes);
+    if (anterior == nullptr) {
+        // Sem linha anterior: Up = None, Average = Sub com a/2 e Paeth = Sub
+        switch (filtro) {
+            case 1: case 4:
+                std::memcpy(saida, linha, inicio);
+                for (size_t i = BPP; i < bytes; i++) saida[i] = static_cast<unsigned char>(linha[i] - linha[i - BPP]);
+                return;
+            case 3:
+                std::memcpy(saida, linha, inicio);
+                for (size_t i = BPP; i < bytes; i++) saida[i] = static_cast<unsigned char>(linha[i] - linha[i - BPP] / 2);
+                return;
+            default:
+                std::memcpy(saida, linha, bytes);
+                return;
+        }
+    }
+    switch (filtro) {
+        case 1:
+            std::memcpy(saida, linha, inicio);
+            for (size_t i = BPP; i < bytes; i++) saida[i] = static_cast<unsigned char>(linha[i] - linha[i - BPP]);
+            break;
+        case 2:
+            for (size_t i = 0; i < bytes; i++) saida[i] = static_cast<unsigned char>(linha[i] - anterior[i]);
+            break;
+        case 3:
+            for (size_t i = 0; i < inicio; i++) saida[i] = static_cast<unsigned char>(linha[i] - anterior[i] / 2);
+            for (size_t i = BPP; i < bytes; i++) {
+                saida[i] = static_cast<unsigned char>(linha[i] - (linha[i - BPP] + anterior[i]) / 2);
+            }
+            break;
+        case 4:
+            for (size_t i = 0; i < inicio; i++) saida[i] = static_cast<unsigned char>(linha[i] - anterior[i]);
+            for (size_t i = BPP; i < bytes; i++) {
+                saida[i] = static_cast<unsigned char>(linha[i] - paeth(linha[i - BPP], anterior[i], anterior[i - BPP]));
+            }
+            break;
+        default:
+            std::memcpy(saida, linha, bytes);
+            break;
+    }
+}
+
+// Escolhe o filtro com menor soma dos resíduos vistos como bytes com sinal (heurística
+// sugerida pela especificação do PNG) e grava "tipo do filtro + linha filtrada"
+static void filtrarLinhaAdaptativo(const unsigned char* linha, const unsigned char* anterior,
+                                   size_t bytes, unsigned char* saida, unsigned char* temporario) {
+    unsigned long melhorSoma = ~0ul;
+    int melhorFiltro = 0;
+    for (int filtro = 0; filtro <= 4; filtro++) {
+        filtrarLinha(filtro, linha, anterior, bytes, temporario);
+        unsigned long soma = 0;
+        for (size_t i = 0; i < bytes; i++) {
+            int v = static_cast<signed char>(temporario[i]);
+            soma += static_cast<unsigned long>(v < 0 ? -v : v);
+        }
+        if (soma < melhorSoma) {
+            melhorSoma = soma;
+            melhorFiltro = filtro;
+        }
+    }
+    saida[0] = static_cast<unsigned char>(melhorFiltro);
+    filtrarLinha(melhorFiltro, linha, anterior, bytes, saida + 1);
+}
+
+EscritorPNG::EscritorPNG(const char* nomeArquivo, size_t largura, size_t altura, int nivelCompressao)
+    : EscritorImagem(nomeArquivo), largura(largura), altura(altura), nivel(nivelCompressao),
+      adler(1), linhasEscritas(0) {
+    linhasPorPedaco = std::max<size_t>(1, BYTES_POR_PEDACO_PNG / (3 * largura + 1));
+    
+    // Assinatura, IHDR e o cabeçalho zlib (em um IDAT próprio, de 2 bytes)
+    static const unsigned char ASSINATURA[8] = {137, 'P', 'N', 'G', '\r', '\n', 26, '\n'};
+    cabecalhoPendente.assign(ASSINATURA, ASSINATURA + 8);
+    std::vector<unsigned char> ihdr;
+    anexarU32BE(ihdr, static_cast<uint32_t>(largura));
+    anexarU32BE(ihdr, static_cast<uint32_t>(altura));
+    const unsigned char resto[5] = {8, 2, 0, 0, 0};  // 8 bits, RGB, deflate, filtro adaptativo, sem entrelaçamento
+    ihdr.insert(ihdr.end(), resto, resto + 5);
+    anexarChunkPNG(cabecalhoPendente, "IHDR", ihdr.data(), ihdr.size());
+    
+    // CMF = 0x78 (deflate, janela 32K); FLG indica o nível e torna CMF·256+FLG múltiplo de 31
+    unsigned char flg = nivel <= 1 ? 0x01 : nivel <= 5 ? 0x5E : nivel == 6 ? 0x9C : 0xDA;
+    const unsigned char zlib[2] = {0x78, flg};
+    anexarChunkPNG(cabecalhoPendente, "IDAT", zlib, 2);
+}
+
+bool EscritorPNG::codificarLinhas(const Pixel* linhas, size_t numLinhas, std::vector<unsigned char>& saida) {
+    saida.clear();
+    if (linhasEscritas + numLinhas > altura) return false;
+    if (numLinhas == 0) return true;
+    
+    // Os pedaços comprimidos têm sempre linhasPorPedaco linhas (exceto o último da
+    // imagem), independentemente de como as faixas chegam: o arquivo não depende da
+    // divisão em faixas. Linhas que não completam um pedaço esperam em "pendentes".
+    struct Pedaco {
+        const unsigned char* linhas;
+        size_t numLinhas;
+        const unsigned char* anterior;  // Linha acima da primeira (nullptr na linha 0)
+    };
+    const unsigned char* bytesFaixa = reinterpret_cast<const unsigned char*>(linhas);
+    size_t bytesLinha = 3 * largura;
+    bool faixaFinal = (linhasEscritas + numLinhas == altura);
+    const unsigned char* acima = ultimaLinha.empty() ? nullptr : ultimaLinha.data();
+    std::vector<Pedaco> pedacos;
+    size_t usadas = 0;
+    
+    if (!pendentes.empty()) {
+        size_t linhasPendentes = pendentes.size() / bytesLinha;
+        usadas = std::min(numLinhas, linhasPorPedaco - linhasPendentes);
+        pendentes.insert(pendentes.end(), bytesFaixa, bytesFaixa + usadas * bytesLinha);
+        if (linhasPendentes + usadas < linhasPorPedaco && !faixaFinal) {
+            linhasEscritas += numLinhas;  // A faixa inteira coube no pedaço pendente
+            return true;
+        }
+        pedacos.push_back({pendentes.data(), linhasPendentes + usadas, acima});
+    }
+    while (usadas < numLinhas) {
+        size_t n = std::min(linhasPorPedaco, numLinhas - usadas);
+        if (n < linhasPorPedaco && !faixaFinal) break;
+        const unsigned char* inicio = bytesFaixa + usadas * bytesLinha;
+        pedacos.push_back({inicio, n, usadas > 0 ? inicio - bytesLinha : acima});
+        usadas += n;
+    }
+    if (pedacos.empty()) {  // Faixa menor que um pedaço: só acumula
+        pendentes.assign(bytesFaixa, bytesFaixa + numLinhas * bytesLinha);
+        linhasEscritas += numLinhas;
+        return true;
+    }
+    
+    // Cada pedaço: filtra suas linhas, comprime e monta seu próprio chunk IDAT
+    size_t numPedacos = pedacos.size();
+    std::vector<std::vector<unsigned char>> chunks(numPedacos);
+    std::vector<uint32_t> adlers(numPedacos);
+    std::vector<size_t> tamanhosFiltrados(numPedacos);
+    
+    executarEmFaixas(numPedacos, numPedacos, [&](size_t p, size_t, size_t) {
+        const Pedaco& pedaco = pedacos[p];
+        std::vector<unsigned char> filtrado(pedaco.numLinhas * (bytesLinha + 1));
+        std::vector<unsigned char> temporario(bytesLinha);
+        for (size_t y = 0; y < pedaco.numLinhas; y++) {
+            const unsigned char* linha = pedaco.linhas + y * bytesLinha;
+            const unsigned char* anterior = y > 0 ? linha - bytesLinha : pedaco.anterior;
+            unsigned char* saida = filtrado.data() + y * (bytesLinha + 1);
+            if (nivel <= 0) {
+                saida[0] = 0;  // Sem compressão: filtro "None" (cópia direta)
+                std::memcpy(saida + 1, linha, bytesLinha);
+            } else {
+                filtrarLinhaAdaptativo(linha, anterior, bytesLinha, saida, temporario.data());
+            }
+        }
+        adlers[p] = calcularAdler32(filtrado.data(), filtrado.size());
+        tamanhosFiltrados[p] = filtrado.size();
+        
+        std::vector<unsigned char> comprimido;
+        comprimirDeflate(filtrado.data(), filtrado.size(), nivel,
+                         faixaFinal && p == numPedacos - 1, comprimido);
+        chunks[p].reserve(comprimido.size() + 12);
+        anexarChunkPNG(chunks[p], "IDAT", comprimido.data(), comprimido.size());
+    });
+    
+    saida.swap(cabecalhoPendente);  // Cabeçalho antes dos primeiros chunks (e vazio depois)
+    cabecalhoPendente.clear();
+    for (size_t p = 0; p < numPedacos; p++) {
+        adler = combinarAdler32(adler, adlers[p], tamanhosFiltrados[p]);
+        saida.insert(saida.end(), chunks[p].begin(), chunks[p].end());
+    }
+    
+    // Guarda a última linha comprimida e as linhas que sobraram para a próxima faixa
+    const Pedaco& ultimo = pedacos.back();
+    const unsigned char* linhaFinal = ultimo.linhas + (ultimo.numLinhas - 1) * bytesLinha;
+    ultimaLinha.assign(linhaFinal, linhaFinal + bytesLinha);
+    pendentes.assign(bytesFaixa + usadas * bytesLinha, bytesFaixa + numLinhas * bytesLinha);
+    
+    linhasEscritas += numLinhas;
+    return true;
+}
+
+bool EscritorPNG::codificarFinal(std::vector<unsigned char>& saida) {
+    // Adler-32 do fluxo inteiro (combinado pedaço a pedaço) e o IEND
+    std::vector<unsigned char> adlerBE;
+    anexarU32BE(adlerBE, adler);
+    saida.clear();
+    anexarChunkPNG(saida, "IDAT", adlerBE.data(), adlerBE.size());
+    anexarChunkPNG(saida, "IEND", nullptr, 0);
+    return linhasEscritas == altura && cabecalhoPendente.empty();
+}
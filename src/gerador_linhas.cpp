@@ -0,0 +1,138 @@
+#include "gerador_linhas.h"
+
+// Deslocamento aleatório de um ponto, com a mesma conta de MapaAltitudes::gerar
+static double sortear(GeradorAleatorio& aleatorio, double amplitude) {
+    return (static_cast<double>(aleatorio.proximo()) / GeradorAleatorio::MAXIMO * 2.0 - 1.0) * amplitude;
+}
+
+// Média da etapa Square: o centro do quadrado, os dois cantos da aresta e o centro vizinho
+// do outro lado dela (o próprio centro fora do mapa), somados na ordem de gerar()
+static double mediaSquare(double centro, double canto1, double canto2, double vizinho) {
+    double soma = centro;
+    soma += canto1;
+    soma += canto2;
+    soma += vizinho;
+    return soma / 4;
+}
+
+GeradorLinhas::Nivel::Nivel(size_t quadrados, double amplitude, uint32_t semente, uint64_t posicaoDiamond,
+                            uint64_t posicaoSquare)
+    : quadrados(quadrados), amplitude(amplitude), sorteioDiamond(semente), sorteioSquare(semente),
+      cantosCima(quadrados + 1), cantosBaixo(quadrados + 1), centrosAcima(quadrados), centros(quadrados),
+      topo(quadrados), esquerda(quadrados), baixo(quadrados), direita(0.0), proxima(0) {
+    sorteioDiamond.avancar(posicaoDiamond);
+    sorteioSquare.avancar(posicaoSquare);
+}
+
+GeradorLinhas::GeradorLinhas(int N, double rugosidade, uint32_t semente)
+    : tamanho((static_cast<size_t>(1) << N) + 1), proximaRaiz(0) {
+    GeradorAleatorio aleatorio(semente);
+    cantos[0][0] = static_cast<double>(aleatorio.proximo()) / GeradorAleatorio::MAXIMO;
+    cantos[0][1] = static_cast<double>(aleatorio.proximo()) / GeradorAleatorio::MAXIMO;
+    cantos[1][0] = static_cast<double>(aleatorio.proximo()) / GeradorAleatorio::MAXIMO;
+    cantos[1][1] = static_cast<double>(aleatorio.proximo()) / GeradorAleatorio::MAXIMO;
+
+    // Posição de cada trecho na sequência: gerar() sorteia os 4 cantos e, em cada nível,
+    // um valor por losango (W²) e depois os pontos das arestas dos quadrados (4W² - 2W + 2,
+    // porque as arestas de cima e da esquerda do mapa só são sorteadas no primeiro quadrado)
+    uint64_t posicao = 4;
+    double amplitude = 1.0;
+    niveis.reserve(static_cast<size_t>(N));
+    for (size_t quadrados = 1; quadrados < tamanho - 1; quadrados *= 2) {
+        uint64_t w = quadrados;
+        niveis.emplace_back(quadrados, amplitude, semente, posicao, posicao + w * w);
+        posicao += w * w + 4 * w * w - 2 * w + 2;
+        amplitude *= rugosidade;
+    }
+}
+
+size_t GeradorLinhas::obterTamanho() const {
+    return tamanho;
+}
+
+void GeradorLinhas::proximaLinha(double* destino) {
+    entregarLinha(niveis.size(), destino);
+}
+
+void GeradorLinhas::entregarLinha(size_t numNiveis, double* destino) {
+    if (numNiveis == 0) {
+        // Acima do primeiro nível: as linhas 0 e tamanho - 1, só com os cantos
+        destino[0] = cantos[proximaRaiz][0];
+        destino[1] = cantos[proximaRaiz][1];
+        proximaRaiz++;
+        return;
+    }
+
+    Nivel& nivel = niveis[numNiveis - 1];
+    size_t w = nivel.quadrados;
+    size_t j = nivel.proxima / 2;
+    if (nivel.proxima % 2 == 0) {
+        // Linha de cantos j: os cantos já existentes e, entre eles, o ponto de cima do
+        // quadrado j (o de baixo do quadrado j - 1 é sorteado antes e sobrescrito)
+        if (j == 0) {
+            entregarLinha(numNiveis - 1, nivel.cantosCima.data());
+        } else {
+            nivel.cantosCima.swap(nivel.cantosBaixo);
+        }
+        if (j < w) {
+            entregarLinha(numNiveis - 1, nivel.cantosBaixo.data());
+            nivel.centrosAcima.swap(nivel.centros);
+            // Etapa Diamond da linha de quadrados j
+            for (size_t i = 0; i < w; i++) {
+                double media = (nivel.cantosCima[i] + nivel.cantosCima[i + 1] + nivel.cantosBaixo[i] +
+                                nivel.cantosBaixo[i + 1]) / 4.0;
+                nivel.centros[i] = media + sortear(nivel.sorteioDiamond, nivel.amplitude);
+            }
+            // Etapa Square da linha j: sorteia na ordem de gerar() (cima, esquerda, direita,
+            // baixo de cada quadrado), guardando os que não serão sobrescritos
+            for (size_t i = 0; i < w; i++) {
+                if (j > 0 || i == 0) nivel.topo[i] = sortear(nivel.sorteioSquare, nivel.amplitude);
+                if (i > 0 || j == 0) nivel.esquerda[i] = sortear(nivel.sorteioSquare, nivel.amplitude);
+                nivel.direita = sortear(nivel.sorteioSquare, nivel.amplitude);
+                nivel.baixo[i] = sortear(nivel.sorteioSquare, nivel.amplitude);
+            }
+        }
+        for (size_t i = 0; i <= w; i++) {
+            destino[2 * i] = nivel.cantosCima[i];
+        }
+        for (size_t i = 0; i < w; i++) {
+            double ponto;
+            if (j == 0) {
+                // Na borda de cima, gerar() só calcula o ponto do primeiro quadrado
+                ponto = i == 0 ? mediaSquare(nivel.centros[0], nivel.cantosCima[0], nivel.cantosCima[1],
+                                             nivel.centros[0]) + nivel.topo[0] : 0.0;
+            } else if (j < w) {
+                ponto = mediaSquare(nivel.centros[i], nivel.cantosCima[i], nivel.cantosCima[i + 1],
+                                    nivel.centrosAcima[i]) + nivel.topo[i];
+            } else {
+                // Borda de baixo: o ponto de baixo dos quadrados da última linha
+                ponto = mediaSquare(nivel.centros[i], nivel.cantosCima[i], nivel.cantosCima[i + 1],
+                                    nivel.centros[i]) + nivel.baixo[i];
+            }
+            destino[2 * i + 1] = ponto;
+        }
+    } else {
+        // Linha de centros j: os centros e, entre eles, o ponto da esquerda de cada quadrado
+        // (o da direita do quadrado anterior é sorteado antes e sobrescrito)
+        for (size_t i = 0; i < w; i++) {
+            destino[2 * i + 1] = nivel.centros[i];
+        }
+        for (size_t i = 0; i <= w; i++) {
+            double ponto;
+            if (i == 0) {
+                // Na borda esquerda, gerar() só calcula o ponto da primeira linha
+                ponto = j == 0 ? mediaSquare(nivel.centros[0], nivel.cantosCima[0], nivel.cantosBaixo[0],
+                                             nivel.centros[0]) + nivel.esquerda[0] : 0.0;
+            } else if (i < w) {
+                ponto = mediaSquare(nivel.centros[i], nivel.cantosCima[i], nivel.cantosBaixo[i],
+                                    nivel.centros[i - 1]) + nivel.esquerda[i];
+            } else {
+                // Borda direita: o ponto da direita do último quadrado
+                ponto = mediaSquare(nivel.centros[w - 1], nivel.cantosCima[w], nivel.cantosBaixo[w],
+                                    nivel.centros[w - 1]) + nivel.direita;
+            }
+            destino[2 * i] = ponto;
+        }
+    }
+    nivel.proxima++;
+}
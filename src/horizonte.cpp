@@ -0,0 +1,179 @@
+#include "horizonte.h"
+#include "paralelo.h"
+#include "renderizacao.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+/**
+ * @brief Família de retas paralelas que cobre o mapa, no sentido em que a luz anda.
+ * @details O eixo principal (x ou y) é o de maior componente da direção. Em coordenadas
+ * normalizadas (p no eixo principal, c no cruzado, espelhadas para que a reta ande no
+ * sentido de p e c crescentes), a reta j passa no passo p pelo ponto c = j + deslocamento[p].
+ * Como o deslocamento nunca diminui, os pontos anteriores de uma reta nunca estão numa
+ * linha do mapa posterior, e o mapa pode ser lido na ordem da memória, linha a linha.
+ */
+struct Varredura {
+    size_t lado;
+    bool eixoX;                     // Eixo principal: x (colunas) ou y (linhas)
+    std::ptrdiff_t origem;          // Índice do ponto (p, c) = (0, 0)
+    std::ptrdiff_t passoPrincipal;  // Distância na memória entre p e p + 1
+    std::ptrdiff_t passoCruzado;    // Idem, entre c e c + 1
+    std::vector<std::ptrdiff_t> deslocamento;
+    std::ptrdiff_t primeiraReta, numRetas;
+    double distanciaPorPasso;       // Em unidades de ponto
+
+    // dx, dy: direção em que a varredura anda (x = coluna, y = linha)
+    Varredura(size_t lado, double dx, double dy) : lado(lado), deslocamento(lado) {
+        std::ptrdiff_t n = static_cast<std::ptrdiff_t>(lado);
+        eixoX = std::fabs(dx) >= std::fabs(dy);
+        double principal = eixoX ? dx : dy;
+        double cruzado = eixoX ? dy : dx;
+        double inclinacao = std::fabs(cruzado) / std::fabs(principal);
+        passoPrincipal = eixoX ? 1 : n;
+        passoCruzado = eixoX ? n : 1;
+        origem = 0;
+        if (principal < 0) {
+            origem += (n - 1) * passoPrincipal;
+            passoPrincipal = -passoPrincipal;
+        }
+        if (cruzado < 0) {
+            origem += (n - 1) * passoCruzado;
+            passoCruzado = -passoCruzado;
+        }
+        for (size_t k = 0; k < lado; k++) {
+            deslocamento[k] = static_cast<std::ptrdiff_t>(std::floor(k * inclinacao + 0.5));
+        }
+        primeiraReta = lado > 0 ? -deslocamento[lado - 1] : 0;
+        numRetas = n - primeiraReta;
+        distanciaPorPasso = std::sqrt(1.0 + inclinacao * inclinacao);
+    }
+
+    // Percorre as retas [inicio, fim) (contadas a partir de primeiraReta), chamando
+    // visitar(p, reta - inicio, indice) em cada ponto delas, na ordem da memória
+    template <typename Visitar>
+    void percorrer(size_t inicio, size_t fim, Visitar visitar) const {
+        std::ptrdiff_t n = static_cast<std::ptrdiff_t>(lado);
+        std::ptrdiff_t j0 = primeiraReta + static_cast<std::ptrdiff_t>(inicio);
+        std::ptrdiff_t j1 = primeiraReta + static_cast<std::ptrdiff_t>(fim);
+        if (!eixoX) {
+            // Uma linha do mapa por passo: as retas ocupam um trecho contíguo dela
+            for (std::ptrdiff_t p = 0; p < n; p++) {
+                std::ptrdiff_t cInicio = std::max<std::ptrdiff_t>(0, j0 + deslocamento[p]);
+                std::ptrdiff_t cFim = std::min<std::ptrdiff_t>(n, j1 + deslocamento[p]);
+                std::ptrdiff_t base = origem + p * passoPrincipal;
+                for (std::ptrdiff_t c = cInicio; c < cFim; c++) {
+                    visitar(static_cast<size_t>(p), static_cast<size_t>(c - deslocamento[p] - j0),
+                            static_cast<size_t>(base + c * passoCruzado));
+                }
+            }
+        } else {
+            // Cada linha c do mapa tem os passos p com deslocamento[p] em [c - j1 + 1, c - j0]
+            for (std::ptrdiff_t c = 0; c < n; c++) {
+                std::ptrdiff_t pInicio = std::lower_bound(deslocamento.begin(), deslocamento.end(), c - j1 + 1) -
+                                         deslocamento.begin();
+                std::ptrdiff_t pFim = std::upper_bound(deslocamento.begin(), deslocamento.end(), c - j0) -
+                                      deslocamento.begin();
+                std::ptrdiff_t base = origem + c * passoCruzado;
+                for (std::ptrdiff_t p = pInicio; p < pFim; p++) {
+                    visitar(static_cast<size_t>(p), static_cast<size_t>(c - deslocamento[p] - j0),
+                            static_cast<size_t>(base + p * passoPrincipal));
+                }
+            }
+        }
+    }
+};
+
+// Graus → radianos
+static const double GRAUS = 3.14159265358979323846 / 180.0;
+
+// Varredura que anda no sentido da luz vinda do azimute dado: a luz vem de (sen az, cos az)
+// em (leste, norte), e em (coluna, linha), com as linhas crescendo para o sul, anda em
+// (-sen az, cos az). Olhando para trás ao longo da reta, vê-se o horizonte daquele azimute
+static Varredura varreduraDoAzimute(size_t lado, double azimute) {
+    return Varredura(lado, -std::sin(azimute * GRAUS), std::cos(azimute * GRAUS));
+}
+
+// Alturas em unidades de ponto, para comparar com distâncias horizontais
+static double alturaPorPonto(size_t lado, double exagero) {
+    return exagero * static_cast<double>(lado - 1) / LADO_POR_ALTURA;
+}
+
+void calcularSombrasProjetadas(const double* altitudes, size_t lado, double azimute, double elevacao,
+                               double exagero, float* mascara) {
+    if (lado < 2 || elevacao >= 90.0) {
+        std::fill(mascara, mascara + lado * lado, 1.0f);
+        return;
+    }
+
+    Varredura varredura = varreduraDoAzimute(lado, azimute);
+    double escala = alturaPorPonto(lado, exagero);
+    double quedaPorPasso = std::tan(std::max(0.0, elevacao) * GRAUS) * varredura.distanciaPorPasso;
+
+    size_t numRetas = static_cast<size_t>(varredura.numRetas);
+    executarEmFaixas(numRetas, obterNumThreads(), [&](size_t, size_t inicio, size_t fim) {
+        // A linha de sombra desce quedaPorPasso a cada passo; somando p × queda a todas as
+        // alturas ela fica parada, e basta guardar o maior valor visto em cada reta
+        std::vector<double> linhaDeSombra(fim - inicio, -std::numeric_limits<double>::infinity());
+        varredura.percorrer(inicio, fim, [&](size_t p, size_t reta, size_t indice) {
+            double altura = altitudes[indice] * escala + static_cast<double>(p) * quedaPorPasso;
+            // Sem desvios: metade dos pontos costuma estar na sombra, sem padrão previsível
+            mascara[indice] = altura < linhaDeSombra[reta] ? FATOR_SOMBRA_PROJETADA : 1.0f;
+            linhaDeSombra[reta] = std::max(linhaDeSombra[reta], altura);
+        });
+    });
+}
+
+// Ponto do fecho convexo superior de uma reta: distância desde o início dela e altura,
+// ambas em unidades de ponto (float basta, e o fecho de uma reta côncava guarda todos)
+struct PontoHorizonte {
+    float distancia, altura;
+};
+
+void calcularOclusaoAmbiente(const double* altitudes, size_t lado, size_t numDirecoes, double exagero,
+                             float* visibilidade) {
+    if (lado < 2 || numDirecoes == 0) {
+        std::fill(visibilidade, visibilidade + lado * lado, 1.0f);
+        return;
+    }
+    std::fill(visibilidade, visibilidade + lado * lado, 0.0f);
+    double escala = alturaPorPonto(lado, exagero);
+
+    // Soma sen(ângulo do horizonte) de cada direção; as direções rodam uma depois da outra e
+    // cada ponto é visitado uma vez por direção, então as threads nunca escrevem no mesmo ponto
+    for (size_t d = 0; d < numDirecoes; d++) {
+        Varredura varredura = varreduraDoAzimute(lado, 360.0 * d / numDirecoes);
+        size_t numRetas = static_cast<size_t>(varredura.numRetas);
+        executarEmFaixas(numRetas, obterNumThreads(), [&](size_t, size_t inicio, size_t fim) {
+            std::vector<std::vector<PontoHorizonte>> fechos(fim - inicio);
+            varredura.percorrer(inicio, fim, [&](size_t p, size_t reta, size_t indice) {
+                std::vector<PontoHorizonte>& fecho = fechos[reta];
+                double s = static_cast<double>(p) * varredura.distanciaPorPasso;
+                // Arredondada como no fecho, para um plano dar inclinação exatamente zero
+                double z = static_cast<float>(altitudes[indice] * escala);
+                // Tira do topo os pontos que ficam abaixo da reta entre o anterior e este
+                // (vistos daqui, o anterior os esconde): cada ponto entra e sai uma vez só
+                while (fecho.size() >= 2) {
+                    const PontoHorizonte& a = fecho[fecho.size() - 2];
+                    const PontoHorizonte& b = fecho.back();
+                    if ((a.altura - z) * (s - b.distancia) < (b.altura - z) * (s - a.distancia)) break;
+                    fecho.pop_back();
+                }
+                // O topo agora é o ponto de tangência: a inclinação até ele é a do horizonte
+                if (!fecho.empty()) {
+                    double inclinacao = (fecho.back().altura - z) / (s - fecho.back().distancia);
+                    if (inclinacao > 0) {
+                        visibilidade[indice] += static_cast<float>(inclinacao / std::sqrt(1.0 + inclinacao * inclinacao));
+                    }
+                }
+                fecho.push_back({static_cast<float>(s), static_cast<float>(z)});
+            });
+        });
+    }
+
+    float porDirecao = 1.0f / static_cast<float>(numDirecoes);
+    for (size_t i = 0; i < lado * lado; i++) {
+        visibilidade[i] = 1.0f - visibilidade[i] * porDirecao;
+    }
+}
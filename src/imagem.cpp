@@ -8,14 +8,29 @@ O destrutor sempre é chamado ao sair do escopo. Isso permite que a memória sem
 #include <sstream>
 #include <string>
 #include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include "arquivo_io.h"
+#include "pnm.h"
+#include "escritor_imagem.h"
+#include "renderizacao.h"
+
+// Leitura e escrita binárias tratam o array de pixels como bytes RGB intercalados
+static_assert(sizeof(Pixel) == 3, "Pixel deve ocupar exatamente 3 bytes");
+
+// Faixa convertida para RGB24 de cada vez ao salvar os layouts alinhados (~1 MB)
+static const size_t BYTES_POR_FAIXA_CONVERSAO = 1024 * 1024;
 
 // Construtor padrão - imagem vazia
-Imagem::Imagem() : largura(0), altura(0), pixels(nullptr) {}
+Imagem::Imagem() : largura(0), altura(0), layout(LAYOUT_RGB24), pixels(nullptr), dados(nullptr), passo(0) {}
 
 // Construtor com dimensões
-Imagem::Imagem(size_t largura, size_t altura) 
-    : largura(largura), altura(altura), pixels(nullptr) {
-    alocar(largura, altura);
+Imagem::Imagem(size_t largura, size_t altura, LayoutImagem layout) 
+    : largura(largura), altura(altura), layout(layout), pixels(nullptr), dados(nullptr), passo(0) {
+    alocar(largura, altura, layout);
 }
 
 // Destrutor
@@ -29,21 +44,49 @@ void Imagem::liberar() {
         delete[] pixels; // ... Então llibere. Se Pixel* pixels = new Pixel[100];  // Aloca espaço para 100 Pixels + metadados, então delete[] pixels chama ~Pixel() 100 vezes. 
         pixels = nullptr;
     }
+    std::free(dados);
+    dados = nullptr;
     largura = 0;
     altura = 0;
+    passo = 0;
 }
 
-void Imagem::alocar(size_t larg, size_t alt) {
+void Imagem::alocar(size_t larg, size_t alt, LayoutImagem novoLayout) {
     liberar();  // Libera memória antiga existente, se houver
     
     largura = larg;
     altura = alt;
+    layout = novoLayout;
     
+    if (layout == LAYOUT_RGB24) {
+        passo = 3 * largura;
+        if (largura > 0 && altura > 0) {
+            pixels = new Pixel[largura * altura];
+            // Inicializa todos os pixels como preto (0, 0, 0)
+            for (size_t i = 0; i < largura * altura; i++) {
+                pixels[i] = Pixel(0, 0, 0);
+            }
+        }
+        return;
+    }
+    
+    // Layouts alinhados: cada linha arredondada para um múltiplo do alinhamento, então
+    // todas começam alinhadas (o preenchimento fica zerado)
+    size_t bytesPorLinha = layout == LAYOUT_RGBA32 ? 4 * largura : largura;
+    passo = (bytesPorLinha + ALINHAMENTO_LINHAS - 1) / ALINHAMENTO_LINHAS * ALINHAMENTO_LINHAS;
     if (largura > 0 && altura > 0) {
-        pixels = new Pixel[largura * altura];
-        // Inicializa todos os pixels como preto (0, 0, 0)
-        for (size_t i = 0; i < largura * altura; i++) {
-            pixels[i] = Pixel(0, 0, 0);
+        size_t total = passo * altura * (layout == LAYOUT_PLANAR ? 3 : 1);
+        dados = static_cast<unsigned char*>(std::aligned_alloc(ALINHAMENTO_LINHAS, total));
+        if (!dados) throw std::bad_alloc();
+        std::memset(dados, 0, total);
+        if (layout == LAYOUT_RGBA32) {
+            // Preto opaco: A = 255
+            for (size_t y = 0; y < altura; y++) {
+                unsigned char* linha = dados + y * passo;
+                for (size_t x = 0; x < largura; x++) {
+                    linha[4 * x + 3] = 255;
+                }
+            }
         }
     }
 }
@@ -63,94 +106,215 @@ size_t Imagem::obterAltura() const {
     return altura;
 }
 
+LayoutImagem Imagem::obterLayout() const {
+    return layout;
+}
+
+size_t Imagem::obterPasso() const {
+    return passo;
+}
+
+VistaImagem Imagem::obterVista() {
+    // Imagem vazia: vista sem canais, com os passos do layout (não há pixel para ler nem escrever)
+    if (pixels == nullptr && dados == nullptr) {
+        size_t passoPixel = layout == LAYOUT_RGBA32 ? 4 : layout == LAYOUT_PLANAR ? 1 : 3;
+        return VistaImagem(layout, nullptr, nullptr, nullptr, passoPixel, 0);
+    }
+    switch (layout) {
+        case LAYOUT_RGBA32:
+            return VistaImagem(layout, dados, dados + 1, dados + 2, 4, passo);
+        case LAYOUT_PLANAR:
+            return VistaImagem(layout, dados, dados + passo * altura, dados + 2 * passo * altura, 1, passo);
+        default:
+            return VistaImagem(pixels, largura);
+    }
+}
+
+Pixel Imagem::obterPixel(size_t x, size_t y) const {
+    return const_cast<Imagem*>(this)->obterVista().obter(x, y);
+}
+
+void Imagem::definirPixel(size_t x, size_t y, const Pixel& pixel) {
+    obterVista().definir(x, y, pixel);
+}
+
+void Imagem::converterParaRGB24(size_t linInicio, size_t numLinhas, Pixel* destino) const {
+    if (layout == LAYOUT_RGB24) {
+        std::memcpy(destino, pixels + linInicio * largura, numLinhas * largura * sizeof(Pixel));
+        return;
+    }
+    VistaImagem vista = const_cast<Imagem*>(this)->obterVista();
+    for (size_t i = 0; i < numLinhas; i++) {
+        converterLinhaRGB24(vista.deslocada(0, linInicio + i), largura, destino + i * largura);
+    }
+}
+
 // Operadores de acesso
 Pixel& Imagem::operator()(size_t x, size_t y) {
+    assert(layout == LAYOUT_RGB24 && pixels != nullptr);  // Nos outros layouts não há Pixel na memória
     return pixels[calcularIndice(x, y)];
 }
 
 const Pixel& Imagem::operator()(size_t x, size_t y) const {
+    assert(layout == LAYOUT_RGB24 && pixels != nullptr);
     return pixels[calcularIndice(x, y)];
 }
 
-// Leitura de arquivo PPM
+// Lê o próximo inteiro decimal de um PPM/PGM texto, pulando espaços e comentários.
+// Avança p até logo depois do número; retorna false no fim dos dados ou se houver lixo.
+static inline bool lerInteiroTexto(const unsigned char*& p, const unsigned char* fim, unsigned int& valor) {
+    for (;;) {
+        while (p < fim && *p <= ' ') p++;           // Espaços, tabs e quebras de linha
+        if (p < fim && *p == '#') {                 // Comentário até o fim da linha
+            while (p < fim && *p != '\n') p++;
+            continue;
+        }
+        break;
+    }
+    if (p >= fim || static_cast<unsigned char>(*p - '0') > 9) return false;
+
+    unsigned int v = 0;
+    do {
+        v = v * 10 + (*p - '0');
+        if (v > 65535) return false;
+        p++;
+    } while (p < fim && static_cast<unsigned char>(*p - '0') <= 9);
+    valor = v;
+    return true;
+}
+
+// Converte uma amostra com valorMaximo arbitrário para [0, 255] (arredondando)
+static inline unsigned char escalarAmostra(unsigned int valor, unsigned int valorMaximo) {
+    return static_cast<unsigned char>((valor * 255u + valorMaximo / 2) / valorMaximo);
+}
+
+// Leitura de arquivo PPM/PGM (P3, P6 coloridos; P2, P5 em tons de cinza)
 bool Imagem::lerPPM(const char* nomeArquivo) {
-    std::ifstream arquivo(nomeArquivo);
-    if (!arquivo.is_open()) {
+    ArquivoMapeado arquivo(nomeArquivo);
+    if (!arquivo.aberto()) {
         std::cerr << "Erro ao abrir arquivo: " << nomeArquivo << std::endl;
         return false;
     }
     
-    std::string linha;
-    
-    // Lê o identificador (P3)
-    std::getline(arquivo, linha);
-    if (linha != "P3") {
-        std::cerr << "Formato inválido. Esperado P3, encontrado: " << linha << std::endl;
+    // Lê o cabeçalho (tipo, dimensões e valor máximo; aceita comentários '#')
+    CabecalhoPNM cabecalho;
+    if (!lerCabecalhoPNM(arquivo.obterDados(), arquivo.obterTamanho(), cabecalho)) {
+        std::cerr << "Formato inválido. Esperado P2, P3, P5 ou P6: " << nomeArquivo << std::endl;
         return false;
     }
     
-    // Lê dimensões (largura e altura)
-    size_t novaLargura, novaAltura;
-    arquivo >> novaLargura >> novaAltura;
+    const unsigned char* dados = arquivo.obterDados() + cabecalho.inicioDados;
+    const unsigned char* fim = arquivo.obterDados() + arquivo.obterTamanho();
+    bool colorido = (cabecalho.tipo == 3 || cabecalho.tipo == 6);
+    size_t canais = colorido ? 3 : 1;
+    unsigned int maxVal = cabecalho.valorMaximo;
+    bool binario = cabecalho.tipo == 5 || cabecalho.tipo == 6;
+    
+    // As dimensões vêm do cabeçalho: o tamanho dos dados é verificado antes de qualquer alocação.
+    // Em texto, cada amostra ocupa ao menos 2 bytes (um dígito e um separador)
+    size_t bytesPorAmostra = binario ? (maxVal < 256 ? 1 : 2) : 2;
+    size_t totalPixels, bytes;
+    if (cabecalho.largura > LIMITE_LADO_LEITURA || cabecalho.altura > LIMITE_LADO_LEITURA ||
+        __builtin_mul_overflow(cabecalho.largura, cabecalho.altura, &totalPixels) ||
+        __builtin_mul_overflow(totalPixels, canais * bytesPorAmostra, &bytes)) {
+        std::cerr << "Erro: dimensões inválidas no cabeçalho: " << nomeArquivo << std::endl;
+        return false;
+    }
     
-    // Lê o valor máximo (255)
-    int maxVal;
-    arquivo >> maxVal;
+    if (binario) {
+        // Binário: confere se o bloco de pixels está completo antes de alocar
+        if (static_cast<size_t>(fim - dados) < bytes) {
+            std::cerr << "Erro: arquivo truncado: " << nomeArquivo << std::endl;
+            return false;
+        }
+        
+        alocar(cabecalho.largura, cabecalho.altura);
+        unsigned char* destino = reinterpret_cast<unsigned char*>(pixels);
+        
+        if (colorido && maxVal == 255) {
+            // Caso comum: o bloco já está no layout RGB intercalado do Pixel
+            std::memcpy(destino, dados, bytes);
+        } else {
+            for (size_t i = 0; i < totalPixels; i++) {
+                for (size_t c = 0; c < 3; c++) {
+                    size_t amostra = i * canais + (colorido ? c : 0);
+                    unsigned int v = bytesPorAmostra == 1
+                        ? dados[amostra]
+                        : (static_cast<unsigned int>(dados[2 * amostra]) << 8) | dados[2 * amostra + 1];
+                    destino[3 * i + c] = escalarAmostra(v > maxVal ? maxVal : v, maxVal);
+                }
+            }
+        }
+        return true;
+    }
     
-    if (maxVal != 255) {
-        std::cerr << "Valor máximo inválido: " << maxVal << std::endl;
+    // Texto (P2/P3): o último número pode não ter separador depois dele
+    if (bytes > 0 && static_cast<size_t>(fim - dados) < bytes - 1) {
+        std::cerr << "Erro: arquivo truncado: " << nomeArquivo << std::endl;
         return false;
     }
     
-    // Aloca memória com as novas dimensões
-    alocar(novaLargura, novaAltura);
+    // Scanner de inteiros direto sobre o arquivo mapeado
+    alocar(cabecalho.largura, cabecalho.altura);
+    unsigned char* destino = reinterpret_cast<unsigned char*>(pixels);
     
-    // Lê os pixels
-    for (size_t y = 0; y < altura; y++) {
-        for (size_t x = 0; x < largura; x++) {
-            int r, g, b;
-            arquivo >> r >> g >> b;
-            
-            if (arquivo.fail()) {
-                std::cerr << "Erro ao ler pixel (" << x << ", " << y << ")" << std::endl;
+    for (size_t i = 0; i < totalPixels; i++) {
+        for (size_t c = 0; c < canais; c++) {
+            unsigned int v;
+            if (!lerInteiroTexto(dados, fim, v) || v > maxVal) {
+                std::cerr << "Erro ao ler pixel (" << i % largura << ", " << i / largura << ")" << std::endl;
                 return false;
             }
-            
-            pixels[calcularIndice(x, y)] = Pixel(
-                static_cast<unsigned char>(r),
-                static_cast<unsigned char>(g),
-                static_cast<unsigned char>(b)
-            );
+            destino[3 * i + c] = maxVal == 255 ? static_cast<unsigned char>(v) : escalarAmostra(v, maxVal);
+        }
+        if (!colorido) {
+            destino[3 * i + 1] = destino[3 * i + 2] = destino[3 * i];
         }
     }
     
-    arquivo.close();
     return true;
 }
 
 // Salvamento em arquivo PPM
-bool Imagem::salvarPPM(const char* nomeArquivo) const {
-    std::ofstream arquivo(nomeArquivo);
-    if (!arquivo.is_open()) {
-        std::cerr << "Erro ao criar arquivo: " << nomeArquivo << std::endl;
+bool Imagem::salvarPPM(const char* nomeArquivo, FormatoPPM formato) const {
+    EscritorPPM escritor(nomeArquivo, largura, altura, formato);
+    if (!escritor.aberto()) {
         return false;
     }
-    
-    // Escreve cabeçalho
-    arquivo << "P3" << std::endl;
-    arquivo << largura << " " << altura << std::endl;
-    arquivo << "255" << std::endl;
-    
-    // Escreve pixels linha por linha
-    for (size_t y = 0; y < altura; y++) {
-        for (size_t x = 0; x < largura; x++) {
-            const Pixel& p = pixels[calcularIndice(x, y)];
-            arquivo << static_cast<int>(p.r) << " " 
-                   << static_cast<int>(p.g) << " " 
-                   << static_cast<int>(p.b) << std::endl;
+    return gravar(escritor, nomeArquivo);
+}
+
+// Salvamento em arquivo PNG
+bool Imagem::salvarPNG(const char* nomeArquivo, int nivelCompressao) const {
+    if (largura == 0 || altura == 0) {
+        std::cerr << "Erro: PNG não suporta imagem vazia" << std::endl;
+        return false;
+    }
+    EscritorPNG escritor(nomeArquivo, largura, altura, nivelCompressao);
+    if (!escritor.aberto()) {
+        return false;
+    }
+    return gravar(escritor, nomeArquivo);
+}
+
+bool Imagem::gravar(EscritorImagem& escritor, const char* nomeArquivo) const {
+    bool ok = true;
+    if (layout == LAYOUT_RGB24) {
+        // Uma única faixa com a imagem inteira -> uma única chamada de sistema
+        ok = escritor.escreverLinhas(pixels, altura);
+    } else if (largura > 0) {
+        // Layouts alinhados: convertidos para RGB intercalado uma faixa de cada vez
+        size_t linhasPorFaixa = std::max<size_t>(1, BYTES_POR_FAIXA_CONVERSAO / (largura * sizeof(Pixel)));
+        std::vector<Pixel> faixa(std::min(linhasPorFaixa, altura) * largura);
+        for (size_t lin = 0; ok && lin < altura; lin += linhasPorFaixa) {
+            size_t numLinhas = std::min(linhasPorFaixa, altura - lin);
+            converterParaRGB24(lin, numLinhas, faixa.data());
+            ok = escritor.escreverLinhas(faixa.data(), numLinhas);
         }
     }
-    
-    arquivo.close();
+    if (!ok || !escritor.finalizar()) {
+        std::cerr << "Erro ao gravar arquivo: " << nomeArquivo << std::endl;
+        return false;
+    }
     return true;
-}
\ No newline at end of file
+}
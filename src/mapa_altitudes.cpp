@@ -5,6 +5,26 @@
 #include <cstdlib>
 #include <ctime>
 #include <algorithm>
+#include <charconv>
+#include <memory>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <functional>
+#include "paralelo.h"
+#include "arquivo_io.h"
+#include "pnm.h"
+#include "quantizacao.h"
+#include "mapa_compactado.h"
+#include "escritor_imagem.h"
+#include "fila_circular.h"
+#include "renderizacao.h"
+#include "horizonte.h"
+#include "reamostragem.h"
+#include "aleatorio.h"
+#include "gerador_linhas.h"
 
 using namespace std;
 
@@ -66,7 +86,7 @@ double MapaAltitudes::obterAltitudaSegura(int lin, int col, double padrao) const
 // ALGORITMO DIAMOND-SQUARE
 // ═══════════════════════════════════════════════════════════
 
-void MapaAltitudes::etapaDiamond(size_t x, size_t y, size_t passo, double amplitude) {
+void MapaAltitudes::etapaDiamond(size_t x, size_t y, size_t passo, double amplitude, GeradorAleatorio& aleatorio) {
     // Calcula o centro do quadrado
     size_t meio = passo / 2;
     size_t centroX = x + meio;
@@ -80,12 +100,12 @@ void MapaAltitudes::etapaDiamond(size_t x, size_t y, size_t passo, double amplit
     
     // Média dos 4 cantos + deslocamento aleatório
     double media = (cantoA + cantoB + cantoC + cantoD) / 4.0;
-    double deslocamento = ((double)rand() / RAND_MAX * 2.0 - 1.0) * amplitude;
+    double deslocamento = ((double)aleatorio.proximo() / GeradorAleatorio::MAXIMO * 2.0 - 1.0) * amplitude;
     
     altitudes[calcularIndice(centroY, centroX)] = media + deslocamento;
 }
 
-void MapaAltitudes::etapaSquare(size_t x, size_t y, size_t passo, double amplitude) {
+void MapaAltitudes::etapaSquare(size_t x, size_t y, size_t passo, double amplitude, GeradorAleatorio& aleatorio) {
     size_t meio = passo / 2;
     size_t centroX = x + meio;
     size_t centroY = y + meio;
@@ -107,7 +127,7 @@ void MapaAltitudes::etapaSquare(size_t x, size_t y, size_t passo, double amplitu
         cont++;
         
         double media = soma / cont;
-        double deslocamento = ((double)rand() / RAND_MAX * 2.0 - 1.0) * amplitude;
+        double deslocamento = ((double)aleatorio.proximo() / GeradorAleatorio::MAXIMO * 2.0 - 1.0) * amplitude;
         altitudes[calcularIndice(y, centroX)] = media + deslocamento;
     }
     
@@ -124,7 +144,7 @@ void MapaAltitudes::etapaSquare(size_t x, size_t y, size_t passo, double amplitu
         cont++;
         
         double media = soma / cont;
-        double deslocamento = ((double)rand() / RAND_MAX * 2.0 - 1.0) * amplitude;
+        double deslocamento = ((double)aleatorio.proximo() / GeradorAleatorio::MAXIMO * 2.0 - 1.0) * amplitude;
         altitudes[calcularIndice(centroY, x)] = media + deslocamento;
     }
     
@@ -141,7 +161,7 @@ void MapaAltitudes::etapaSquare(size_t x, size_t y, size_t passo, double amplitu
         cont++;
         
         double media = soma / cont;
-        double deslocamento = ((double)rand() / RAND_MAX * 2.0 - 1.0) * amplitude;
+        double deslocamento = ((double)aleatorio.proximo() / GeradorAleatorio::MAXIMO * 2.0 - 1.0) * amplitude;
         altitudes[calcularIndice(centroY, x + passo)] = media + deslocamento;
     }
     
@@ -158,24 +178,30 @@ void MapaAltitudes::etapaSquare(size_t x, size_t y, size_t passo, double amplitu
         cont++;
         
         double media = soma / cont;
-        double deslocamento = ((double)rand() / RAND_MAX * 2.0 - 1.0) * amplitude;
+        double deslocamento = ((double)aleatorio.proximo() / GeradorAleatorio::MAXIMO * 2.0 - 1.0) * amplitude;
         altitudes[calcularIndice(y + passo, centroX)] = media + deslocamento;
     }
 }
 
 void MapaAltitudes::gerar(int N, double rugosidade) {
+    // Semente diferente a cada execução
+    gerar(N, rugosidade, static_cast<unsigned int>(time(nullptr)));
+}
+
+void MapaAltitudes::gerar(int N, double rugosidade, unsigned int semente) {
     // Calcula tamanho: 2^N + 1
     size_t tam = static_cast<size_t>(pow(2, N)) + 1;
     alocar(tam);
     
-    // Inicializa gerador de números aleatórios
-    srand(static_cast<unsigned int>(time(nullptr)));
+    // Inicializa gerador de números aleatórios (a mesma sequência de srand/rand da glibc,
+    // mas sem estado global: ver aleatorio.h)
+    GeradorAleatorio aleatorio(semente);
     
     // Define alturas aleatórias para os 4 cantos [0, 1]
-    altitudes[calcularIndice(0, 0)] = (double)rand() / RAND_MAX;
-    altitudes[calcularIndice(0, tamanho - 1)] = (double)rand() / RAND_MAX;
-    altitudes[calcularIndice(tamanho - 1, 0)] = (double)rand() / RAND_MAX;
-    altitudes[calcularIndice(tamanho - 1, tamanho - 1)] = (double)rand() / RAND_MAX;
+    altitudes[calcularIndice(0, 0)] = (double)aleatorio.proximo() / GeradorAleatorio::MAXIMO;
+    altitudes[calcularIndice(0, tamanho - 1)] = (double)aleatorio.proximo() / GeradorAleatorio::MAXIMO;
+    altitudes[calcularIndice(tamanho - 1, 0)] = (double)aleatorio.proximo() / GeradorAleatorio::MAXIMO;
+    altitudes[calcularIndice(tamanho - 1, tamanho - 1)] = (double)aleatorio.proximo() / GeradorAleatorio::MAXIMO;
     
     // Amplitude inicial
     double amplitude = 1.0;
@@ -185,14 +211,14 @@ void MapaAltitudes::gerar(int N, double rugosidade) {
         // Para cada quadrado neste nível
         for (size_t y = 0; y < tamanho - 1; y += passo) {
             for (size_t x = 0; x < tamanho - 1; x += passo) {
-                etapaDiamond(x, y, passo, amplitude);
+                etapaDiamond(x, y, passo, amplitude, aleatorio);
             }
         }
         
         // Para cada losango neste nível
         for (size_t y = 0; y < tamanho - 1; y += passo) {
             for (size_t x = 0; x < tamanho - 1; x += passo) {
-                etapaSquare(x, y, passo, amplitude);
+                etapaSquare(x, y, passo, amplitude, aleatorio);
             }
         }
         
@@ -221,22 +247,70 @@ size_t MapaAltitudes::obterColunas() const {
 // I/O DE ARQUIVOS
 // ═══════════════════════════════════════════════════════════
 
+// Quantidade aproximada de altitudes formatadas por faixa antes de gravar
+// (~256K valores ≈ 5 MB de texto por buffer)
+static const size_t VALORES_POR_FAIXA = 256 * 1024;
+
+// Maior texto possível para um double no formato mais curto ("-2.2250738585072014e-308")
+static const size_t MAX_CARACTERES_DOUBLE = 24;
+
 bool MapaAltitudes::salvar(const char* nomeArquivo) const {
-    ofstream arquivo(nomeArquivo);
-    if (!arquivo.is_open()) {
+    ArquivoSaida arquivo(nomeArquivo);
+    if (!arquivo.aberto()) {
         cerr << "Erro ao criar arquivo: " << nomeArquivo << "\n";
         return false;
     }
     
     // Escreve dimensões
-    arquivo << tamanho << " " << tamanho << "\n";
+    string cabecalho = to_string(tamanho) + " " + to_string(tamanho) + "\n";
+    if (!arquivo.escrever(cabecalho.data(), cabecalho.size())) {
+        cerr << "Erro ao gravar arquivo: " << nomeArquivo << "\n";
+        return false;
+    }
     
-    // Escreve altitudes (uma por linha para facilitar leitura)
-    for (size_t i = 0; i < tamanho * tamanho; i++) {
-        arquivo << altitudes[i] << "\n";
+    // Escreve altitudes (uma por linha para facilitar leitura).
+    // Cada valor usa a menor representação decimal que, lida de volta, reproduz
+    // exatamente o mesmo double (std::to_chars, algoritmo Ryu) -> salvar/ler sem perdas.
+    //
+    // As linhas são processadas em rodadas: em cada rodada, cada thread formata uma
+    // faixa de linhas no seu próprio buffer e depois os buffers são gravados em ordem,
+    // com um write() grande por faixa.
+    size_t numThreads = obterNumThreads();
+    size_t linhasPorFaixa = tamanho > 0 ? max<size_t>(1, VALORES_POR_FAIXA / tamanho) : 1;
+    vector<vector<char>> buffers(numThreads);
+    vector<size_t> usados(numThreads, 0);
+    
+    for (size_t linhaRodada = 0; linhaRodada < tamanho; linhaRodada += numThreads * linhasPorFaixa) {
+        size_t linhasRodada = min(numThreads * linhasPorFaixa, tamanho - linhaRodada);
+        size_t numFaixas = (linhasRodada + linhasPorFaixa - 1) / linhasPorFaixa;
+        
+        executarEmFaixas(linhasRodada, numFaixas, [&](size_t faixa, size_t inicio, size_t fim) {
+            vector<char>& buffer = buffers[faixa];
+            buffer.resize((fim - inicio) * tamanho * (MAX_CARACTERES_DOUBLE + 1));
+            
+            char* p = buffer.data();
+            char* limite = p + buffer.size();
+            const double* valor = altitudes + calcularIndice(linhaRodada + inicio, 0);
+            const double* ultimo = altitudes + calcularIndice(linhaRodada + fim, 0);
+            for (; valor != ultimo; ++valor) {
+                p = to_chars(p, limite, *valor).ptr;
+                *p++ = '\n';
+            }
+            usados[faixa] = static_cast<size_t>(p - buffer.data());
+        });
+        
+        for (size_t faixa = 0; faixa < numFaixas; faixa++) {
+            if (!arquivo.escrever(buffers[faixa].data(), usados[faixa])) {
+                cerr << "Erro ao gravar arquivo: " << nomeArquivo << "\n";
+                return false;
+            }
+        }
     }
     
-    arquivo.close();
+    if (!arquivo.fechar()) {
+        cerr << "Erro ao gravar arquivo: " << nomeArquivo << "\n";
+        return false;
+    }
     return true;
 }
 
@@ -251,11 +325,24 @@ bool MapaAltitudes::ler(const char* nomeArquivo) {
     size_t linhas, colunas;
     arquivo >> linhas >> colunas;
     
-    if (linhas != colunas) {
+    if (arquivo.fail() || linhas != colunas) {
         cerr << "Erro: mapa deve ser quadrado\n";
         return false;
     }
     
+    // Cada altitude ocupa ao menos 2 bytes (um dígito e um separador, exceto a última):
+    // um cabeçalho que pede mais altitudes do que o restante do arquivo comporta é recusado
+    streamoff posicao = arquivo.tellg();
+    arquivo.seekg(0, ios::end);
+    streamoff fim = arquivo.tellg();
+    arquivo.seekg(posicao);
+    size_t total;
+    if (posicao < 0 || fim < posicao || __builtin_mul_overflow(linhas, colunas, &total) ||
+        total > (static_cast<size_t>(fim - posicao) + 1) / 2) {
+        cerr << "Erro: dimensões maiores que o arquivo: " << nomeArquivo << "\n";
+        return false;
+    }
+    
     // Aloca memória
     alocar(linhas);
     
@@ -272,119 +359,744 @@ bool MapaAltitudes::ler(const char* nomeArquivo) {
     return true;
 }
 
-// ═══════════════════════════════════════════════════════════
-// MÉTODO AUXILIAR 1: Mapear altitude para cor
-// ═══════════════════════════════════════════════════════════
+bool MapaAltitudes::salvarPGM(const char* nomeArquivo, double minimo, double maximo) const {
+    ArquivoSaida arquivo(nomeArquivo);
+    if (!arquivo.aberto()) {
+        cerr << "Erro ao criar arquivo: " << nomeArquivo << "\n";
+        return false;
+    }
+    
+    // Monta cabeçalho + amostras em um único buffer
+    string cabecalho = montarCabecalhoPNM(5, tamanho, tamanho, 65535);
+    size_t bytes = cabecalho.size() + 2 * tamanho * tamanho;
+    unique_ptr<unsigned char[]> buffer(new unsigned char[bytes]);  // Sem zerar: tudo é sobrescrito
+    copy(cabecalho.begin(), cabecalho.end(), buffer.get());
+    unsigned char* amostras = buffer.get() + cabecalho.size();
+    
+    // Quantiza por faixas de linhas em paralelo
+    executarEmFaixas(tamanho, obterNumThreads(), [&](size_t, size_t inicio, size_t fim) {
+        size_t primeiro = calcularIndice(inicio, 0);
+        quantizarU16BE(altitudes + primeiro, amostras + 2 * primeiro,
+                       (fim - inicio) * tamanho, minimo, maximo);
+    });
+    
+    if (!arquivo.escrever(buffer.get(), bytes) || !arquivo.fechar()) {
+        cerr << "Erro ao gravar arquivo: " << nomeArquivo << "\n";
+        return false;
+    }
+    return true;
+}
 
-Cor MapaAltitudes::mapearAltitudeCor(double altitude, const Paleta& paleta) const {
-    // Normaliza altitude para índice da paleta
-    // altitude está em [0, 1]
-    // Precisamos mapear para [0, paleta.obterTamanho()-1]
+bool MapaAltitudes::lerPGM(const char* nomeArquivo, double minimo, double maximo) {
+    ArquivoMapeado arquivo(nomeArquivo);
+    if (!arquivo.aberto()) {
+        cerr << "Erro ao abrir arquivo: " << nomeArquivo << "\n";
+        return false;
+    }
+    
+    CabecalhoPNM cabecalho;
+    if (!lerCabecalhoPNM(arquivo.obterDados(), arquivo.obterTamanho(), cabecalho) ||
+        cabecalho.tipo != 5) {
+        cerr << "Formato inválido. Esperado PGM binário (P5): " << nomeArquivo << "\n";
+        return false;
+    }
     
-    int numCores = paleta.obterTamanho();
+    if (cabecalho.largura != cabecalho.altura) {
+        cerr << "Erro: mapa deve ser quadrado\n";
+        return false;
+    }
     
-    // Caso especial: paleta vazia
-    if (numCores == 0) {
-        return Cor(0, 0, 0);  // Preto
+    // Amostras de 1 byte se valorMaximo < 256, senão 2 bytes (big-endian). As dimensões vêm
+    // do cabeçalho: o tamanho dos dados é verificado contra o arquivo antes de alocar
+    size_t bytesPorAmostra = cabecalho.valorMaximo < 256 ? 1 : 2;
+    size_t total, bytes;
+    if (__builtin_mul_overflow(cabecalho.largura, cabecalho.altura, &total) ||
+        __builtin_mul_overflow(total, bytesPorAmostra, &bytes) ||
+        arquivo.obterTamanho() - cabecalho.inicioDados < bytes) {
+        cerr << "Erro: arquivo PGM truncado: " << nomeArquivo << "\n";
+        return false;
     }
     
-    // Caso especial: apenas uma cor
-    if (numCores == 1) {
-        return paleta.obterCor(0);
+    alocar(cabecalho.largura);
+    const unsigned char* amostras = arquivo.obterDados() + cabecalho.inicioDados;
+    
+    executarEmFaixas(tamanho, obterNumThreads(), [&](size_t, size_t inicio, size_t fim) {
+        size_t primeiro = calcularIndice(inicio, 0);
+        size_t n = (fim - inicio) * tamanho;
+        if (bytesPorAmostra == 2) {
+            desquantizarU16BE(amostras + 2 * primeiro, altitudes + primeiro, n,
+                              minimo, maximo, cabecalho.valorMaximo);
+        } else {
+            desquantizarU8(amostras + primeiro, altitudes + primeiro, n,
+                           minimo, maximo, cabecalho.valorMaximo);
+        }
+    });
+    
+    return true;
+}
+
+bool MapaAltitudes::salvarCompactado(const char* nomeArquivo, double erroMaximo, size_t ladoTile) const {
+    return comprimirMapa(altitudes, tamanho, nomeArquivo, erroMaximo, ladoTile);
+}
+
+bool MapaAltitudes::lerCompactado(const char* nomeArquivo) {
+    MapaCompactado arquivo(nomeArquivo);
+    if (!arquivo.ehValido()) {
+        cerr << "Erro: arquivo compactado inválido ou inexistente: " << nomeArquivo << "\n";
+        return false;
     }
     
-    // Calcula índice na paleta
-    // Exemplo: altitude=0.5, numCores=10
-    // indice = 0.5 × (10-1) = 0.5 × 9 = 4.5
-    double indiceContinuo = altitude * (numCores - 1);
+    alocar(arquivo.obterTamanho());
+    
+    // Cada tile é independente: descomprime todos em paralelo direto no array
+    size_t tilesPorLado = arquivo.obterTilesPorLado();
+    size_t numTiles = tilesPorLado * tilesPorLado;
+    vector<char> sucesso(numTiles, 0);
+    executarEmFaixas(numTiles, numTiles, [&](size_t tile, size_t, size_t) {
+        size_t tileLin = tile / tilesPorLado;
+        size_t tileCol = tile % tilesPorLado;
+        double* destino = altitudes + calcularIndice(tileLin * arquivo.obterLadoTile(),
+                                                     tileCol * arquivo.obterLadoTile());
+        sucesso[tile] = arquivo.decodificarTile(tileLin, tileCol, destino, tamanho);
+    });
     
-    // Converte para inteiro (trunca)
-    int indice = static_cast<int>(indiceContinuo);
+    if (find(sucesso.begin(), sucesso.end(), 0) != sucesso.end()) {
+        cerr << "Erro ao descomprimir arquivo: " << nomeArquivo << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool MapaAltitudes::lerRegiaoCompactado(const char* nomeArquivo, size_t linInicio, size_t colInicio, size_t lado) {
+    MapaCompactado arquivo(nomeArquivo);
+    if (!arquivo.ehValido()) {
+        cerr << "Erro: arquivo compactado inválido ou inexistente: " << nomeArquivo << "\n";
+        return false;
+    }
     
-    // Garante que está no range válido [0, numCores-1]
-    if (indice < 0) indice = 0;
-    if (indice >= numCores) indice = numCores - 1;
+    size_t tamanhoArquivo = arquivo.obterTamanho();
+    if (linInicio > tamanhoArquivo || colInicio > tamanhoArquivo ||
+        lado > tamanhoArquivo - linInicio || lado > tamanhoArquivo - colInicio) {
+        cerr << "Erro: janela fora do mapa salvo em: " << nomeArquivo << "\n";
+        return false;
+    }
     
-    return paleta.obterCor(indice);
+    alocar(lado);
+    if (!arquivo.lerRegiao(linInicio, colInicio, lado, lado, altitudes, tamanho)) {
+        cerr << "Erro ao descomprimir arquivo: " << nomeArquivo << "\n";
+        return false;
+    }
+    return true;
 }
 
 // ═══════════════════════════════════════════════════════════
-// MÉTODO AUXILIAR 2: Calcular sombreamento
+// MÉTODO PRINCIPAL: Gerar imagem a partir do mapa
 // ═══════════════════════════════════════════════════════════
 
-double MapaAltitudes::calcularSombreamento(size_t lin, size_t col) const {
-    // Simula iluminação vinda do noroeste (canto superior esquerdo)
-    // Pontos que estão "na sombra" (mais baixos que vizinho NO) são escurecidos
-    
-    double altitudeAtual = obterAltitude(lin, col);
+// Tamanho da faixa de pixels renderizada por vez na geração direta para arquivo
+static const size_t BYTES_POR_FAIXA_IMAGEM = 1024 * 1024;
+
+// Menor quantidade de pixels que vale a pena entregar a outra thread na renderização
+static const size_t PIXELS_MINIMOS_POR_THREAD = 64 * 1024;
+
+// Faixas em trânsito ao mesmo tempo na esteira (uma por etapa, mais uma de folga)
+static const size_t FAIXAS_NA_ESTEIRA = 4;
+
+// Segundos desde um instante
+static double segundosDesde(std::chrono::steady_clock::time_point inicio) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+}
+
+// Renderiza as colunas [colInicio, colFim) de uma linha com o sombreamento pedido.
+// acima/abaixo: linhas vizinhas (nullptr fora do mapa); multiplicador: fatores extras da
+// linha inteira (nullptr = nenhum); fatores: rascunho com colFim - colInicio posições
+static void renderizarLinhaSombreada(const PaletaCompilada& cores, const Sombreamento& sombreamento,
+                                     const IluminacaoRelevo& luz, const double* acima, const double* linha,
+                                     const double* abaixo, size_t largura, size_t colInicio, size_t colFim,
+                                     const float* multiplicador, double* fatores, const VistaImagem& saida) {
+    bool relevo = sombreamento.tipo == SOMBREAMENTO_RELEVO;
+    if (!relevo && !multiplicador) {
+        renderizarLinha(cores, linha, acima, colInicio, colFim, sombreamento.tipo == SOMBREAMENTO_NOROESTE, saida);
+        return;
+    }
+    if (relevo) {
+        // Vizinhança 3×3 de Sobel; nas bordas do mapa a própria linha se repete
+        calcularRelevoLinha(luz, acima ? acima : linha, linha, abaixo ? abaixo : linha, largura,
+                            colInicio, colFim, fatores);
+    } else {
+        bool noroeste = sombreamento.tipo == SOMBREAMENTO_NOROESTE && acima;
+        for (size_t col = colInicio; col < colFim; col++) {
+            fatores[col - colInicio] = noroeste && col > 0 ? fatorSombreamento(linha[col], acima[col - 1]) : 1.0;
+        }
+    }
+    if (multiplicador) {
+        for (size_t col = colInicio; col < colFim; col++) {
+            fatores[col - colInicio] *= multiplicador[col];
+        }
+    }
+    renderizarLinhaComFatores(cores, linha, fatores, colInicio, colFim, saida);
+}
+
+// Renderiza numLinhas linhas seguidas de altitudes (largura pontos cada, a partir de primeira)
+// em faixas paralelas, a linha lin no pixel (0, lin) do destino. temAcima/temAbaixo: se a linha antes da primeira e a depois da última
+// existem (senão são a borda do mapa); multiplicador: fatores extras das mesmas linhas, ou nullptr
+static void renderizarLinhas(const PaletaCompilada& cores, const Sombreamento& sombreamento,
+                             const IluminacaoRelevo& luz, const double* primeira, size_t largura, size_t numLinhas,
+                             bool temAcima, bool temAbaixo, size_t colInicio, size_t colFim,
+                             const float* multiplicador, const VistaImagem& destino) {
+    size_t larguraRegiao = colFim - colInicio;
     
-    // Verifica vizinho noroeste (diagonal superior-esquerda)
-    // Se não existir (bordas), considera mesma altura (sem sombra)
-    double altitudeNoroeste = altitudeAtual;
+    // Cada pixel só depende da vizinhança imediata (lida, nunca escrita), então as linhas são
+    // divididas em faixas independentes; regiões pequenas (ex: um tile) ficam numa thread só
+    size_t numFaixas = std::min<size_t>(obterNumThreads(), numLinhas * larguraRegiao / PIXELS_MINIMOS_POR_THREAD);
+    executarEmFaixas(numLinhas, std::max<size_t>(1, numFaixas), [&](size_t, size_t inicio, size_t fim) {
+        vector<double> fatores(larguraRegiao);
+        for (size_t lin = inicio; lin < fim; lin++) {
+            const double* linha = primeira + lin * largura;
+            renderizarLinhaSombreada(cores, sombreamento, luz, lin > 0 || temAcima ? linha - largura : nullptr, linha,
+                                     lin + 1 < numLinhas || temAbaixo ? linha + largura : nullptr, largura,
+                                     colInicio, colFim, multiplicador ? multiplicador + lin * largura : nullptr,
+                                     fatores.data(), destino.deslocada(0, lin));
+        }
+    });
+}
+
+void MapaAltitudes::renderizarRegiao(const Paleta& paleta, const Sombreamento& sombreamento,
+                                     size_t linInicio, size_t linFim, size_t colInicio, size_t colFim,
+                                     const VistaImagem& destino, const float* multiplicador) const {
+    // Cores copiadas uma vez para um array denso; o laço por pixel (cor, sombra Noroeste,
+    // empacotamento RGB) fica no núcleo vetorizado de renderizacao.cpp
+    PaletaCompilada cores(paleta);
+    IluminacaoRelevo luz(sombreamento, tamanho);
+    renderizarLinhas(cores, sombreamento, luz, altitudes + linInicio * tamanho, tamanho, linFim - linInicio,
+                     linInicio > 0, linFim < tamanho, colInicio, colFim,
+                     multiplicador ? multiplicador + linInicio * tamanho : nullptr, destino);
+}
+
+void MapaAltitudes::renderizarReamostrado(const Paleta& paleta, const Sombreamento& sombreamento,
+                                          const PesosReamostragem& horizontal, const PesosReamostragem& vertical,
+                                          size_t linInicio, size_t linFim, const VistaImagem& destino,
+                                          const float* multiplicador) const {
+    PaletaCompilada cores(paleta);
+    size_t largura = horizontal.numSaidas;
+    size_t altura = vertical.numSaidas;
+    size_t numLinhas = linFim - linInicio;
     
-    if (lin > 0 && col > 0) {
-        altitudeNoroeste = obterAltitude(lin - 1, col - 1);
+    // O relevo é calculado na grade de saída: com a largura dela, a inclinação de cada
+    // encosta é a mesma em qualquer resolução
+    IluminacaoRelevo luz(sombreamento, largura);
+    size_t numFaixas = std::min<size_t>(obterNumThreads(), numLinhas * largura / PIXELS_MINIMOS_POR_THREAD);
+    executarEmFaixas(numLinhas, std::max<size_t>(1, numFaixas), [&](size_t, size_t inicio, size_t fim) {
+        // Cada faixa lê só as linhas do mapa de que precisa; as vizinhas (para a sombra)
+        // são recalculadas nas fronteiras entre faixas
+        JanelaReamostragem janela(horizontal, vertical, [&](size_t lin) { return altitudes + lin * tamanho; });
+        vector<double> origemMultiplicador(multiplicador ? tamanho : 0);
+        JanelaReamostragem janelaMultiplicador(horizontal, vertical, [&](size_t lin) {
+            std::copy(multiplicador + lin * tamanho, multiplicador + (lin + 1) * tamanho, origemMultiplicador.begin());
+            return static_cast<const double*>(origemMultiplicador.data());
+        });
+        vector<double> acima(largura), linha(largura), abaixo(largura), multiplicadorLinha(multiplicador ? largura : 0);
+        vector<float> multiplicadorSaida(multiplicador ? largura : 0);
+        vector<double> fatores(largura);
+        
+        size_t primeira = linInicio + inicio;
+        if (primeira > 0) janela.calcularLinha(primeira - 1, acima.data());
+        janela.calcularLinha(primeira, linha.data());
+        for (size_t lin = primeira; lin < linInicio + fim; lin++) {
+            if (lin + 1 < altura) janela.calcularLinha(lin + 1, abaixo.data());
+            if (multiplicador) {
+                janelaMultiplicador.calcularLinha(lin, multiplicadorLinha.data());
+                std::copy(multiplicadorLinha.begin(), multiplicadorLinha.end(), multiplicadorSaida.begin());
+            }
+            renderizarLinhaSombreada(cores, sombreamento, luz, lin > 0 ? acima.data() : nullptr, linha.data(),
+                                     lin + 1 < altura ? abaixo.data() : nullptr, largura, 0, largura,
+                                     multiplicador ? multiplicadorSaida.data() : nullptr, fatores.data(),
+                                     destino.deslocada(0, lin - linInicio));
+            acima.swap(linha);
+            linha.swap(abaixo);
+        }
+    });
+}
+
+vector<float> MapaAltitudes::calcularMultiplicador(const Sombreamento& sombreamento) const {
+    vector<float> multiplicador;
+    if (tamanho == 0 || (!sombreamento.sombrasProjetadas && sombreamento.direcoesOclusao == 0)) {
+        return multiplicador;
+    }
+    multiplicador.assign(tamanho * tamanho, 1.0f);
+    if (sombreamento.sombrasProjetadas) {
+        calcularSombrasProjetadas(altitudes, tamanho, sombreamento.azimute, sombreamento.elevacao,
+                                  sombreamento.exagero, multiplicador.data());
+    }
+    if (sombreamento.direcoesOclusao > 0) {
+        vector<float> visibilidade(tamanho * tamanho);
+        calcularOclusaoAmbiente(altitudes, tamanho, sombreamento.direcoesOclusao, sombreamento.exagero,
+                                visibilidade.data());
+        for (size_t i = 0; i < multiplicador.size(); i++) {
+            multiplicador[i] *= visibilidade[i];
+        }
+    }
+    return multiplicador;
+}
+
+Imagem MapaAltitudes::gerarImagem(const Paleta& paleta, const Sombreamento& sombreamento, LayoutImagem layout) const {
+    // Cria imagem com mesmas dimensões do mapa
+    Imagem img(tamanho, tamanho, layout);
+    if (tamanho > 0) {
+        vector<float> multiplicador = calcularMultiplicador(sombreamento);
+        renderizarRegiao(paleta, sombreamento, 0, tamanho, 0, tamanho, img.obterVista(),
+                         multiplicador.empty() ? nullptr : multiplicador.data());
+    }
+    return img;
+}
+
+bool MapaAltitudes::gerarImagem(EscritorImagem& destino, const Paleta& paleta, const Sombreamento& sombreamento) const {
+    if (!destino.aberto()) {
+        return false;
     }
     
-    // Calcula diferença de altura
-    double diferenca = altitudeNoroeste - altitudeAtual;
+    // Uma faixa de ~1 MB de pixels, reaproveitada do começo ao fim
+    size_t linhasPorFaixa = tamanho > 0 ? std::max<size_t>(1, BYTES_POR_FAIXA_IMAGEM / (tamanho * sizeof(Pixel))) : 1;
+    vector<Pixel> faixa(std::min(linhasPorFaixa, tamanho) * tamanho);
+    vector<float> multiplicador = calcularMultiplicador(sombreamento);
     
-    // Se vizinho NO é mais alto, este ponto está "na sombra"
-    if (diferenca > 0) {
-        // Fator de escurecimento proporcional à diferença
-        // diferenca = 0.1 → fator = 0.5 (escurece 50%)
-        // diferenca = 0.3 → fator = 0.1 (escurece 90%)
-        double fator = 1.0 - (diferenca * 5.0);
-        
-        // Garante que fator está em [0.3, 1.0]
-        // (nunca escurece mais que 70%)
-        if (fator < 0.3) fator = 0.3;
-        if (fator > 1.0) fator = 1.0;
-        
-        return fator;
+    bool ok = true;
+    for (size_t lin = 0; ok && lin < tamanho; lin += linhasPorFaixa) {
+        size_t fim = std::min(lin + linhasPorFaixa, tamanho);
+        renderizarRegiao(paleta, sombreamento, lin, fim, 0, tamanho, VistaImagem(faixa.data(), tamanho),
+                         multiplicador.empty() ? nullptr : multiplicador.data());
+        ok = destino.escreverLinhas(faixa.data(), fim - lin);
+    }
+    return destino.finalizar() && ok;
+}
+
+Imagem MapaAltitudes::gerarImagem(const Paleta& paleta, size_t largura, size_t altura,
+                                  const Sombreamento& sombreamento, FiltroReamostragem filtro,
+                                  LayoutImagem layout) const {
+    // Um único return: Imagem não tem construtor de cópia, e o retorno depende da elisão
+    Imagem img(largura, altura, layout);
+    if (tamanho > 0 && largura > 0 && altura > 0) {
+        vector<float> multiplicador = calcularMultiplicador(sombreamento);
+        const float* fatores = multiplicador.empty() ? nullptr : multiplicador.data();
+        if (largura == tamanho && altura == tamanho) {
+            renderizarRegiao(paleta, sombreamento, 0, tamanho, 0, tamanho, img.obterVista(), fatores);
+        } else {
+            PesosReamostragem horizontal(tamanho, largura, filtro), vertical(tamanho, altura, filtro);
+            renderizarReamostrado(paleta, sombreamento, horizontal, vertical, 0, altura, img.obterVista(), fatores);
+        }
+    }
+    return img;
+}
+
+bool MapaAltitudes::gerarImagem(EscritorImagem& destino, const Paleta& paleta, size_t largura, size_t altura,
+                                const Sombreamento& sombreamento, FiltroReamostragem filtro) const {
+    if (largura == tamanho && altura == tamanho) {
+        return gerarImagem(destino, paleta, sombreamento);
     }
+    if (!destino.aberto() || tamanho == 0 || largura == 0 || altura == 0) {
+        return false;
+    }
+    PesosReamostragem horizontal(tamanho, largura, filtro), vertical(tamanho, altura, filtro);
+    vector<float> multiplicador = calcularMultiplicador(sombreamento);
+    
+    // Mesma faixa de ~1 MB de pixels da versão sem reamostragem
+    size_t linhasPorFaixa = std::max<size_t>(1, BYTES_POR_FAIXA_IMAGEM / (largura * sizeof(Pixel)));
+    vector<Pixel> faixa(std::min(linhasPorFaixa, altura) * largura);
+    bool ok = true;
+    for (size_t lin = 0; ok && lin < altura; lin += linhasPorFaixa) {
+        size_t fim = std::min(lin + linhasPorFaixa, altura);
+        renderizarReamostrado(paleta, sombreamento, horizontal, vertical, lin, fim, VistaImagem(faixa.data(), largura),
+                              multiplicador.empty() ? nullptr : multiplicador.data());
+        ok = destino.escreverLinhas(faixa.data(), fim - lin);
+    }
+    return destino.finalizar() && ok;
+}
+
+bool MapaAltitudes::gerarImagemDireto(EscritorImagem& destino, int N, double rugosidade, unsigned int semente,
+                                      const Paleta& paleta, const Sombreamento& sombreamento) {
+    if (sombreamento.sombrasProjetadas || sombreamento.direcoesOclusao > 0) {
+        cerr << "Erro: sombras projetadas e oclusao ambiente precisam do mapa inteiro\n";
+        return false;
+    }
+    if (!destino.aberto()) {
+        return false;
+    }
+    
+    GeradorLinhas gerador(N, rugosidade, semente);
+    size_t tam = gerador.obterTamanho();
+    PaletaCompilada cores(paleta);
+    IluminacaoRelevo luz(sombreamento, tam);
     
-    // Sem sombra (ou iluminado)
-    return 1.0;
+    // Mesma faixa de ~1 MB de pixels de gerarImagem, com uma linha de margem de cada lado para
+    // o sombreamento: linhas[0] é a última da faixa anterior e linhas[n + 1] a primeira da seguinte
+    size_t linhasPorFaixa = std::min(tam, std::max<size_t>(1, BYTES_POR_FAIXA_IMAGEM / (tam * sizeof(Pixel))));
+    vector<double> linhas((linhasPorFaixa + 2) * tam);
+    vector<Pixel> faixa(linhasPorFaixa * tam);
+    gerador.proximaLinha(&linhas[tam]);
+    
+    bool ok = true;
+    for (size_t lin = 0; ok && lin < tam; lin += linhasPorFaixa) {
+        size_t fim = std::min(lin + linhasPorFaixa, tam);
+        size_t n = fim - lin;
+        // A primeira linha da faixa já veio como margem da anterior
+        for (size_t k = 2; k <= n + (fim < tam ? 1 : 0); k++) {
+            gerador.proximaLinha(&linhas[k * tam]);
+        }
+        renderizarLinhas(cores, sombreamento, luz, &linhas[tam], tam, n, lin > 0, fim < tam, 0, tam, nullptr,
+                         VistaImagem(faixa.data(), tam));
+        ok = destino.escreverLinhas(faixa.data(), n);
+        std::copy(&linhas[n * tam], &linhas[(n + 2) * tam], &linhas[0]);
+    }
+    return destino.finalizar() && ok;
 }
 
+bool MapaAltitudes::gerarImagemEmEsteira(EscritorImagem& destino, const Paleta& paleta, const Sombreamento& sombreamento,
+                                         EstatisticasEsteira* estatisticas) const {
+    if (!destino.aberto()) {
+        return false;
+    }
+    auto inicioTotal = std::chrono::steady_clock::now();
+    
+    // Faixas reaproveitadas: circulam livres → renderizadas → codificadas → livres,
+    // e as filas carregam só os índices delas
+    struct FaixaEsteira {
+        vector<Pixel> pixels;
+        size_t numLinhas;
+        vector<unsigned char> bytes;
+    };
+    size_t linhasPorFaixa = tamanho > 0 ? std::max<size_t>(1, BYTES_POR_FAIXA_IMAGEM / (tamanho * sizeof(Pixel))) : 1;
+    vector<FaixaEsteira> faixas(FAIXAS_NA_ESTEIRA);
+    FilaCircular<size_t> livres(FAIXAS_NA_ESTEIRA), renderizadas(FAIXAS_NA_ESTEIRA), codificadas(FAIXAS_NA_ESTEIRA);
+    for (size_t k = 0; k < FAIXAS_NA_ESTEIRA; k++) {
+        faixas[k].pixels.resize(std::min(linhasPorFaixa, tamanho) * tamanho);
+        livres.inserir(k);
+    }
+    
+    // Depois de um erro as faixas continuam circulando (sem trabalho) até o fim,
+    // para nenhuma etapa ficar esperando para sempre
+    std::atomic<bool> falhou(false);
+    double segundosCodificando = 0.0, segundosGravando = 0.0;
+    vector<unsigned char> final;
+    bool finalOk = false;
+    
+    std::thread codificador([&]() {
+        size_t k;
+        while (renderizadas.retirar(k)) {
+            auto inicio = std::chrono::steady_clock::now();
+            faixas[k].bytes.clear();
+            if (!falhou && !destino.codificarLinhas(faixas[k].pixels.data(), faixas[k].numLinhas, faixas[k].bytes)) {
+                falhou = true;
+            }
+            segundosCodificando += segundosDesde(inicio);
+            codificadas.inserir(k);
+        }
+        finalOk = destino.codificarFinal(final);
+        codificadas.fechar();
+    });
+    
+    std::thread gravador([&]() {
+        size_t k;
+        while (codificadas.retirar(k)) {
+            auto inicio = std::chrono::steady_clock::now();
+            if (!falhou && !destino.gravar(faixas[k].bytes.data(), faixas[k].bytes.size())) {
+                falhou = true;
+            }
+            segundosGravando += segundosDesde(inicio);
+            livres.inserir(k);
+        }
+    });
+    
+    // Renderização na thread chamadora (a sombra de um ponto depende do mapa inteiro,
+    // então os fatores de horizonte são calculados antes da primeira faixa)
+    double segundosRenderizando = 0.0;
+    auto inicioMultiplicador = std::chrono::steady_clock::now();
+    vector<float> multiplicador = calcularMultiplicador(sombreamento);
+    segundosRenderizando += segundosDesde(inicioMultiplicador);
+    size_t numFaixas = 0;
+    for (size_t lin = 0; lin < tamanho; lin += linhasPorFaixa) {
+        size_t k;
+        livres.retirar(k);  // Nunca é fechada: sempre devolve uma faixa
+        auto inicio = std::chrono::steady_clock::now();
+        faixas[k].numLinhas = std::min(lin + linhasPorFaixa, tamanho) - lin;
+        if (!falhou) {
+            renderizarRegiao(paleta, sombreamento, lin, lin + faixas[k].numLinhas, 0, tamanho,
+                             VistaImagem(faixas[k].pixels.data(), tamanho),
+                             multiplicador.empty() ? nullptr : multiplicador.data());
+        }
+        segundosRenderizando += segundosDesde(inicio);
+        renderizadas.inserir(k);
+        numFaixas++;
+    }
+    renderizadas.fechar();
+    codificador.join();
+    gravador.join();
+    
+    bool ok = !falhou && finalOk && destino.gravar(final.data(), final.size());
+    ok = destino.fechar() && ok;
+    
+    if (estatisticas) {
+        estatisticas->segundosTotal = segundosDesde(inicioTotal);
+        estatisticas->segundosRenderizando = segundosRenderizando;
+        estatisticas->segundosCodificando = segundosCodificando;
+        estatisticas->segundosGravando = segundosGravando;
+        estatisticas->numFaixas = numFaixas;
+    }
+    return ok;
+}
 // ═══════════════════════════════════════════════════════════
-// MÉTODO PRINCIPAL: Gerar imagem a partir do mapa
+// PIRÂMIDE DE TILES (z/x/y)
 // ═══════════════════════════════════════════════════════════
 
-Imagem MapaAltitudes::gerarImagem(const Paleta& paleta, bool aplicarSombreamento) const {
-    // Cria imagem com mesmas dimensões do mapa
-    Imagem img(tamanho, tamanho);
+// Lado dos tiles da pirâmide, em pixels (padrão dos mapas web)
+static const size_t LADO_TILE_WEB = 256;
+
+// Verdadeiro se todos os pixels do tile têm a mesma cor
+static bool tileUniforme(const vector<Pixel>& tile) {
+    for (const Pixel& p : tile) {
+        if (p.r != tile[0].r || p.g != tile[0].g || p.b != tile[0].b) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Monta o tile pai a partir dos quatro filhos (NO, NE, SO, SE), com média 2×2 arredondada
+static void reduzirTiles(const vector<Pixel>* filhos[4], vector<Pixel>& pai) {
+    const size_t L = LADO_TILE_WEB, M = LADO_TILE_WEB / 2;
+    pai.resize(L * L);
+    for (size_t q = 0; q < 4; q++) {
+        const Pixel* origem = filhos[q]->data();
+        Pixel* destino = pai.data() + (q / 2) * M * L + (q % 2) * M;
+        for (size_t y = 0; y < M; y++) {
+            const Pixel* cima = origem + 2 * y * L;
+            const Pixel* baixo = cima + L;
+            for (size_t x = 0; x < M; x++) {
+                const Pixel &a = cima[2 * x], &b = cima[2 * x + 1], &c = baixo[2 * x], &d = baixo[2 * x + 1];
+                destino[y * L + x] = Pixel((a.r + b.r + c.r + d.r + 2) / 4,
+                                           (a.g + b.g + c.g + d.g + 2) / 4,
+                                           (a.b + b.b + c.b + d.b + 2) / 4);
+            }
+        }
+    }
+}
+
+bool MapaAltitudes::salvarPiramideTiles(const char* diretorio, const Paleta& paleta, const Sombreamento& sombreamento,
+                                        int nivelCompressao, EstatisticasPiramide* estatisticas) const {
+    // Lado da imagem = 2^k pixels, com 2^k >= um tile
+    size_t ladoImagem = tamanho > 0 ? tamanho - 1 : 0;
+    if (ladoImagem < LADO_TILE_WEB || (ladoImagem & (ladoImagem - 1)) != 0) {
+        cerr << "Erro: pirâmide de tiles precisa de um mapa com 2^k + 1 pontos por lado (k >= 8)" << endl;
+        return false;
+    }
+    int zoomMaximo = 0;
+    while ((LADO_TILE_WEB << zoomMaximo) < ladoImagem) {
+        zoomMaximo++;
+    }
     
-    // Para cada ponto do mapa
-    for (size_t lin = 0; lin < tamanho; lin++) {
-        for (size_t col = 0; col < tamanho; col++) {
-            // PASSO 1: Obter altitude do ponto
-            double altitude = obterAltitude(lin, col);
-            
-            // PASSO 2: Mapear altitude para cor base
-            Cor corBase = mapearAltitudeCor(altitude, paleta);
-            
-            // PASSO 3: Aplicar sombreamento (se solicitado)
-            if (aplicarSombreamento) {
-                double fatorSombra = calcularSombreamento(lin, col);
-                
-                // Escurece a cor multiplicando componentes RGB pelo fator
-                corBase.r = static_cast<unsigned char>(corBase.r * fatorSombra);
-                corBase.g = static_cast<unsigned char>(corBase.g * fatorSombra);
-                corBase.b = static_cast<unsigned char>(corBase.b * fatorSombra);
+    // Diretórios raiz/z/x (poucos: no máximo 2^zoomMaximo por nível)
+    string raiz(diretorio);
+    bool ok = criarDiretorio(raiz.c_str());
+    for (int z = 0; ok && z <= zoomMaximo; z++) {
+        string nivel = raiz + "/" + to_string(z);
+        ok = criarDiretorio(nivel.c_str());
+        for (size_t x = 0; ok && x < (size_t(1) << z); x++) {
+            ok = criarDiretorio((nivel + "/" + to_string(x)).c_str());
+        }
+    }
+    if (!ok) {
+        cerr << "Erro ao criar diretórios da pirâmide em: " << diretorio << endl;
+        return false;
+    }
+    
+    std::atomic<size_t> gravados(0), uniformes(0);
+    std::atomic<bool> falhou(false);
+    vector<float> multiplicador = calcularMultiplicador(sombreamento);
+    
+    // Grava um tile pronto (ou só o conta, se for de uma cor só). Depois da primeira falha
+    // de gravação, os tiles seguintes nem são tentados: a pirâmide já está incompleta
+    auto finalizarTile = [&](int z, size_t x, size_t y, const vector<Pixel>& tile) {
+        if (tileUniforme(tile)) {
+            uniformes++;
+            return;
+        }
+        if (falhou) return;
+        string nome = raiz + "/" + to_string(z) + "/" + to_string(x) + "/" + to_string(y) + ".png";
+        EscritorPNG escritor(nome.c_str(), LADO_TILE_WEB, LADO_TILE_WEB, nivelCompressao);
+        if (!escritor.aberto() || !escritor.escreverLinhas(tile.data(), LADO_TILE_WEB) || !escritor.finalizar()) {
+            falhou = true;
+            return;
+        }
+        gravados++;
+    };
+    
+    // Constrói (em profundidade) a subárvore com raiz no tile (z, x, y): renderiza as folhas,
+    // reduz os filhos e grava cada tile; só 4 tiles por nível ficam em memória
+    std::function<void(int, size_t, size_t, vector<Pixel>&)> construir =
+        [&](int z, size_t x, size_t y, vector<Pixel>& tile) {
+        if (z == zoomMaximo) {
+            tile.resize(LADO_TILE_WEB * LADO_TILE_WEB);
+            renderizarRegiao(paleta, sombreamento, y * LADO_TILE_WEB, (y + 1) * LADO_TILE_WEB,
+                             x * LADO_TILE_WEB, (x + 1) * LADO_TILE_WEB, VistaImagem(tile.data(), LADO_TILE_WEB),
+                             multiplicador.empty() ? nullptr : multiplicador.data());
+        } else {
+            vector<Pixel> filhos[4];
+            for (size_t q = 0; q < 4; q++) {
+                construir(z + 1, 2 * x + q % 2, 2 * y + q / 2, filhos[q]);
             }
-            
-            // PASSO 4: Definir pixel na imagem
-            // Converte Cor para Pixel
-            Pixel p;
-            p.r = corBase.r;
-            p.g = corBase.g;
-            p.b = corBase.b;
-            
-            img(col, lin) = p;
+            const vector<Pixel>* ponteiros[4] = {&filhos[0], &filhos[1], &filhos[2], &filhos[3]};
+            reduzirTiles(ponteiros, tile);
         }
+        finalizarTile(z, x, y, tile);
+    };
+    
+    // Nível a partir do qual as subárvores são divididas entre as threads
+    // (ao menos 4 subárvores por thread, para equilibrar a carga)
+    int zoomParalelo = 0;
+    while (zoomParalelo < zoomMaximo && (size_t(1) << (2 * zoomParalelo)) < 4 * obterNumThreads()) {
+        zoomParalelo++;
     }
+    size_t porLado = size_t(1) << zoomParalelo;
+    vector<vector<Pixel>> nivel(porLado * porLado);
+    executarEmFaixas(nivel.size(), nivel.size(), [&](size_t i, size_t, size_t) {
+        construir(zoomParalelo, i % porLado, i / porLado, nivel[i]);
+    });
     
+    // Níveis acima: poucos tiles, reduzidos nível a nível
+    for (int z = zoomParalelo - 1; z >= 0; z--) {
+        size_t lado = size_t(1) << z;
+        vector<vector<Pixel>> acima(lado * lado);
+        executarEmFaixas(acima.size(), acima.size(), [&](size_t i, size_t, size_t) {
+            size_t x = i % lado, y = i / lado;
+            const vector<Pixel>* filhos[4];
+            for (size_t q = 0; q < 4; q++) {
+                filhos[q] = &nivel[(2 * y + q / 2) * (2 * lado) + 2 * x + q % 2];
+            }
+            reduzirTiles(filhos, acima[i]);
+            finalizarTile(z, x, y, acima[i]);
+        });
+        nivel.swap(acima);
+    }
+    
+    if (estatisticas) {
+        estatisticas->zoomMaximo = zoomMaximo;
+        estatisticas->tilesGravados = gravados;
+        estatisticas->tilesUniformes = uniformes;
+    }
+    if (falhou) {
+        cerr << "Erro ao gravar tiles em: " << diretorio << endl;
+        return false;
+    }
+    return true;
+}
+
+vector<double> MapaAltitudes::niveisCurvas(double intervalo) const {
+    return calcularNiveis(altitudes, tamanho * tamanho, intervalo);
+}
+
+vector<CurvaNivel> MapaAltitudes::extrairCurvasNivel(const vector<double>& niveis) const {
+    return ::extrairCurvasNivel(altitudes, tamanho, niveis);
+}
+
+bool MapaAltitudes::desenharCurvasNivel(Imagem& img, const vector<double>& niveis, Pixel cor, double opacidade) const {
+    if (img.obterLargura() != tamanho || img.obterAltura() != tamanho) {
+        cerr << "Erro: a imagem não tem o tamanho do mapa" << endl;
+        return false;
+    }
+    if (tamanho > 0) {
+        ::desenharCurvasNivel(altitudes, tamanho, niveis, cor, opacidade, 0, tamanho, img.obterVista());
+    }
+    return true;
+}
+
+bool MapaAltitudes::gerarPerspectiva(Imagem& tela, const Imagem& cores, const Camera& camera) const {
+    if (cores.obterLargura() != tamanho || cores.obterAltura() != tamanho) {
+        cerr << "Erro: a imagem de cores não tem o tamanho do mapa" << endl;
+        return false;
+    }
+    // As cores só são lidas; a vista é a mesma para escrita e leitura
+    VistaImagem vistaCores = const_cast<Imagem&>(cores).obterVista();
+    renderizarPerspectiva(altitudes, tamanho, vistaCores, camera, tela.obterLargura(), tela.obterAltura(),
+                          tela.obterVista());
+    return true;
+}
+
+bool MapaAltitudes::gerarPerspectiva(Imagem& tela, const Paleta& paleta, const Sombreamento& sombreamento,
+                                     const Camera& camera) const {
+    Imagem cores = gerarImagem(paleta, sombreamento);
+    return gerarPerspectiva(tela, cores, camera);
+}
+
+// Chama tarefa(lin, acima, linha, abaixo) para as linhas [linInicio, linFim) do mapa, em faixas
+// paralelas; nas bordas, a linha que falta é a própria linha
+template <typename Tarefa>
+static void percorrerLinhasVizinhas(const double* altitudes, size_t tamanho, size_t linInicio, size_t linFim,
+                                    const Tarefa& tarefa) {
+    size_t numLinhas = linFim - linInicio;
+    size_t numFaixas = std::min<size_t>(obterNumThreads(), numLinhas * tamanho / PIXELS_MINIMOS_POR_THREAD);
+    executarEmFaixas(numLinhas, std::max<size_t>(1, numFaixas), [&](size_t, size_t inicio, size_t fim) {
+        for (size_t lin = linInicio + inicio; lin < linInicio + fim; lin++) {
+            const double* linha = altitudes + lin * tamanho;
+            tarefa(lin, lin > 0 ? linha - tamanho : linha, linha, lin + 1 < tamanho ? linha + tamanho : linha);
+        }
+    });
+}
+
+Imagem MapaAltitudes::gerarMapaNormais(double exagero, LayoutImagem layout) const {
+    Imagem img(tamanho, tamanho, layout);
+    if (tamanho > 0) {
+        VistaImagem destino = img.obterVista();
+        double escala = exagero * (tamanho - 1) / LADO_POR_ALTURA;
+        percorrerLinhasVizinhas(altitudes, tamanho, 0, tamanho, [&](size_t lin, const double* acima,
+                                                                    const double* linha, const double* abaixo) {
+            renderizarNormaisLinha(escala, acima, linha, abaixo, tamanho, 0, tamanho, destino.deslocada(0, lin));
+        });
+    }
     return img;
-}
\ No newline at end of file
+}
+
+bool MapaAltitudes::gerarMapaNormais(EscritorImagem& destino, double exagero) const {
+    if (!destino.aberto()) {
+        return false;
+    }
+    
+    // Uma faixa de ~1 MB de pixels, reaproveitada do começo ao fim
+    size_t linhasPorFaixa = tamanho > 0 ? std::max<size_t>(1, BYTES_POR_FAIXA_IMAGEM / (tamanho * sizeof(Pixel))) : 1;
+    vector<Pixel> faixa(std::min(linhasPorFaixa, tamanho) * tamanho);
+    double escala = exagero * (tamanho > 0 ? tamanho - 1 : 0) / LADO_POR_ALTURA;
+    
+    bool ok = true;
+    for (size_t inicio = 0; ok && inicio < tamanho; inicio += linhasPorFaixa) {
+        size_t fim = std::min(inicio + linhasPorFaixa, tamanho);
+        percorrerLinhasVizinhas(altitudes, tamanho, inicio, fim, [&](size_t lin, const double* acima,
+                                                                     const double* linha, const double* abaixo) {
+            renderizarNormaisLinha(escala, acima, linha, abaixo, tamanho, 0, tamanho, &faixa[(lin - inicio) * tamanho]);
+        });
+        ok = destino.escreverLinhas(faixa.data(), fim - inicio);
+    }
+    return destino.finalizar() && ok;
+}
+
+vector<float> MapaAltitudes::calcularNormais(double exagero) const {
+    vector<float> normais(3 * tamanho * tamanho);
+    if (tamanho > 0) {
+        double escala = exagero * (tamanho - 1) / LADO_POR_ALTURA;
+        percorrerLinhasVizinhas(altitudes, tamanho, 0, tamanho, [&](size_t lin, const double* acima,
+                                                                    const double* linha, const double* abaixo) {
+            calcularNormaisLinha(escala, acima, linha, abaixo, tamanho, 0, tamanho, &normais[3 * lin * tamanho]);
+        });
+    }
+    return normais;
+}
+
+AnaliseTerreno MapaAltitudes::analisarTerreno(double exagero, const QuantizacaoAnalise& quantizacao) const {
+    AnaliseTerreno analise;
+    analise.lado = tamanho;
+    analise.declividade.resize(tamanho * tamanho);
+    analise.orientacao.resize(tamanho * tamanho);
+    analise.curvatura.resize(tamanho * tamanho);
+    if (tamanho > 0) {
+        ::analisarTerreno(altitudes, tamanho, ParametrosAnalise(exagero, tamanho, quantizacao),
+                          analise.declividade.data(), analise.orientacao.data(), analise.curvatura.data());
+    }
+    return analise;
+}
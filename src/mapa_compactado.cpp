@@ -0,0 +1,366 @@
+#include "mapa_compactado.h"
+#include "paralelo.h"
+#include "fluxo_bits.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+static const char ASSINATURA[4] = {'M', 'A', 'P', 'C'};
+static const uint32_t VERSAO = 1;
+static const size_t TAMANHO_CABECALHO = 4 + 4 + 8 + 4 + 8;
+
+// Código de Rice: quocientes a partir deste valor são gravados como escape (64 bits crus)
+static const unsigned int LIMITE_UNARIO = 24;
+// A estatística adaptativa é reduzida à metade quando o contador atinge este valor
+static const uint32_t LIMITE_CONTADOR = 64;
+
+// ═══════════════════════════════════════════════════════════
+// INTEIROS LITTLE-ENDIAN
+// ═══════════════════════════════════════════════════════════
+
+static void anexarU32(std::vector<unsigned char>& saida, uint32_t valor) {
+    for (int i = 0; i < 4; i++) saida.push_back(static_cast<unsigned char>(valor >> (8 * i)));
+}
+
+static void anexarU64(std::vector<unsigned char>& saida, uint64_t valor) {
+    for (int i = 0; i < 8; i++) saida.push_back(static_cast<unsigned char>(valor >> (8 * i)));
+}
+
+static uint64_t lerU64(const unsigned char* p) {
+    uint64_t valor = 0;
+    for (int i = 7; i >= 0; i--) valor = (valor << 8) | p[i];
+    return valor;
+}
+
+static uint32_t lerU32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// ═══════════════════════════════════════════════════════════
+// PREDIÇÃO E CÓDIGO DE RICE ADAPTATIVO
+// ═══════════════════════════════════════════════════════════
+
+// Preditor MED (LOCO-I / JPEG-LS): escolhe entre esquerda, cima e o plano a + b - c
+static inline int64_t preverMED(int64_t esquerda, int64_t cima, int64_t cimaEsquerda) {
+    int64_t menor = esquerda < cima ? esquerda : cima;
+    int64_t maior = esquerda < cima ? cima : esquerda;
+    if (cimaEsquerda >= maior) return menor;
+    if (cimaEsquerda <= menor) return maior;
+    return esquerda + cima - cimaEsquerda;
+}
+
+// Previsão do valor na coluna col, usando apenas valores já (de)codificados do próprio tile
+// (linhaAnterior = nullptr na primeira linha do tile)
+static inline int64_t prever(const int64_t* linhaAtual, const int64_t* linhaAnterior, size_t col) {
+    if (linhaAnterior == nullptr) {
+        return col > 0 ? linhaAtual[col - 1] : 0;
+    }
+    if (col == 0) {
+        return linhaAnterior[0];
+    }
+    return preverMED(linhaAtual[col - 1], linhaAnterior[col], linhaAnterior[col - 1]);
+}
+
+// Zigzag: 0, -1, 1, -2, 2, ... -> 0, 1, 2, 3, 4, ...
+static inline uint64_t paraSemSinal(int64_t r) {
+    return (static_cast<uint64_t>(r) << 1) ^ static_cast<uint64_t>(r >> 63);
+}
+
+static inline int64_t paraComSinal(uint64_t u) {
+    return static_cast<int64_t>(u >> 1) ^ -static_cast<int64_t>(u & 1);
+}
+
+// Estado do parâmetro de Rice: k é o menor valor com contador·2^k >= soma
+struct EstadoRice {
+    uint64_t soma;
+    uint32_t contador;
+
+    EstadoRice() : soma(4), contador(1) {}
+
+    int parametro() const {
+        int k = 0;
+        while ((static_cast<uint64_t>(contador) << k) < soma && k < 60) k++;
+        return k;
+    }
+
+    void atualizar(uint64_t u) {
+        soma += u;
+        contador++;
+        if (contador >= LIMITE_CONTADOR) {
+            soma >>= 1;
+            contador >>= 1;
+        }
+    }
+};
+
+static void codificarRice(EscritorBits& escritor, EstadoRice& estado, uint64_t u) {
+    int k = estado.parametro();
+    uint64_t q = u >> k;
+    if (q < LIMITE_UNARIO) {
+        escritor.escreverUnario(static_cast<unsigned int>(q));
+        while (k > 32) {  // Só acontece com resíduos enormes; mantém escrever() em até 32 bits
+            escritor.escrever(u, 32);
+            u >>= 32;
+            k -= 32;
+        }
+        escritor.escrever(u, k);
+    } else {
+        // Escape: LIMITE_UNARIO uns (sem o zero final) + valor cru de 64 bits
+        escritor.escrever((uint64_t(1) << LIMITE_UNARIO) - 1, LIMITE_UNARIO);
+        escritor.escrever(u, 32);
+        escritor.escrever(u >> 32, 32);
+    }
+    estado.atualizar(u);
+}
+
+static uint64_t decodificarRice(LeitorBits& leitor, EstadoRice& estado) {
+    int k = estado.parametro();
+    uint64_t q = leitor.lerUnario(LIMITE_UNARIO);
+    uint64_t u;
+    if (q < LIMITE_UNARIO) {
+        u = 0;
+        int lidos = 0;
+        while (k - lidos > 32) {
+            u |= leitor.ler(32) << lidos;
+            lidos += 32;
+        }
+        u |= leitor.ler(k - lidos) << lidos;
+        u |= q << k;
+    } else {
+        u = leitor.ler(32);
+        u |= leitor.ler(32) << 32;
+    }
+    estado.atualizar(u);
+    return u;
+}
+
+// ═══════════════════════════════════════════════════════════
+// COMPRESSÃO
+// ═══════════════════════════════════════════════════════════
+
+static bool comprimirTile(const double* altitudes, size_t tamanho, size_t lin0, size_t col0,
+                          size_t linhas, size_t colunas, double passo,
+                          std::vector<unsigned char>& saida) {
+    std::vector<int64_t> anterior(colunas), atual(colunas);
+    EscritorBits escritor(saida);
+    EstadoRice estado;
+    // Limite para que k caiba com folga em int64 (e os resíduos não transbordem)
+    const double LIMITE_K = 1.0e18;
+
+    for (size_t i = 0; i < linhas; i++) {
+        const double* linha = altitudes + (lin0 + i) * tamanho + col0;
+        for (size_t j = 0; j < colunas; j++) {
+            double escalado = linha[j] / passo;
+            if (!(std::fabs(escalado) < LIMITE_K)) return false;  // NaN, infinito ou passo pequeno demais
+            atual[j] = std::llround(escalado);
+            int64_t previsao = prever(atual.data(), i > 0 ? anterior.data() : nullptr, j);
+            codificarRice(escritor, estado, paraSemSinal(atual[j] - previsao));
+        }
+        anterior.swap(atual);
+    }
+    escritor.finalizar();
+    return true;
+}
+
+bool comprimirMapa(const double* altitudes, size_t tamanho, const char* nomeArquivo,
+                   double erroMaximo, size_t ladoTile) {
+    if (!(erroMaximo > 0.0) || ladoTile == 0) {
+        std::cerr << "Erro: erro máximo e lado do tile devem ser positivos\n";
+        return false;
+    }
+    // Tiles maiores que o mapa dão o mesmo arquivo que um tile do tamanho do mapa
+    // (e o lado do tile precisa caber no campo de 32 bits do cabeçalho)
+    ladoTile = std::min({ladoTile, std::max<size_t>(tamanho, 1), size_t(UINT32_MAX)});
+    double passo = 2.0 * erroMaximo;
+    size_t tilesPorLado = (tamanho + ladoTile - 1) / ladoTile;
+    size_t numTiles = tilesPorLado * tilesPorLado;
+
+    // Cada tile é comprimido em paralelo no seu próprio buffer
+    std::vector<std::vector<unsigned char>> tiles(numTiles);
+    std::vector<char> sucesso(numTiles, 0);
+    executarEmFaixas(numTiles, numTiles, [&](size_t tile, size_t, size_t) {
+        size_t lin0 = (tile / tilesPorLado) * ladoTile;
+        size_t col0 = (tile % tilesPorLado) * ladoTile;
+        size_t linhas = std::min(ladoTile, tamanho - lin0);
+        size_t colunas = std::min(ladoTile, tamanho - col0);
+        sucesso[tile] = comprimirTile(altitudes, tamanho, lin0, col0, linhas, colunas,
+                                      passo, tiles[tile]);
+    });
+    for (size_t t = 0; t < numTiles; t++) {
+        if (!sucesso[t]) {
+            std::cerr << "Erro: altitude inválida ou erro máximo pequeno demais para o mapa\n";
+            return false;
+        }
+    }
+
+    // Cabeçalho + tabela de deslocamentos
+    std::vector<unsigned char> cabecalho(ASSINATURA, ASSINATURA + 4);
+    anexarU32(cabecalho, VERSAO);
+    anexarU64(cabecalho, tamanho);
+    anexarU32(cabecalho, static_cast<uint32_t>(ladoTile));
+    uint64_t bitsPasso;
+    std::memcpy(&bitsPasso, &passo, sizeof(passo));
+    anexarU64(cabecalho, bitsPasso);
+
+    uint64_t deslocamento = TAMANHO_CABECALHO + 8 * (numTiles + 1);
+    for (size_t t = 0; t < numTiles; t++) {
+        anexarU64(cabecalho, deslocamento);
+        deslocamento += tiles[t].size();
+    }
+    anexarU64(cabecalho, deslocamento);
+
+    ArquivoSaida arquivo(nomeArquivo);
+    if (!arquivo.aberto()) {
+        std::cerr << "Erro ao criar arquivo: " << nomeArquivo << "\n";
+        return false;
+    }
+    bool ok = arquivo.escrever(cabecalho.data(), cabecalho.size());
+    for (size_t t = 0; ok && t < numTiles; t++) {
+        ok = arquivo.escrever(tiles[t].data(), tiles[t].size());
+    }
+    if (!ok || !arquivo.fechar()) {
+        std::cerr << "Erro ao gravar arquivo: " << nomeArquivo << "\n";
+        return false;
+    }
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════
+// LEITURA / DESCOMPRESSÃO
+// ═══════════════════════════════════════════════════════════
+
+MapaCompactado::MapaCompactado(const char* nomeArquivo)
+    : arquivo(nomeArquivo), valido(false), tamanho(0), ladoTile(0), tilesPorLado(0), passo(0.0) {
+    unsigned char cabecalho[TAMANHO_CABECALHO];
+    size_t bytes = arquivo.obterTamanho();
+    if (!arquivo.aberto() || bytes < TAMANHO_CABECALHO || !arquivo.lerEm(cabecalho, TAMANHO_CABECALHO, 0) ||
+        std::memcmp(cabecalho, ASSINATURA, 4) != 0 || lerU32(cabecalho + 4) != VERSAO) {
+        return;
+    }
+
+    // Tudo que dimensiona buffers é validado antes de qualquer alocação
+    uint64_t tamanhoLido = lerU64(cabecalho + 8);
+    uint32_t ladoTileLido = lerU32(cabecalho + 16);
+    uint64_t bitsPasso = lerU64(cabecalho + 20);
+    std::memcpy(&passo, &bitsPasso, sizeof(passo));
+    if (tamanhoLido != static_cast<size_t>(tamanhoLido) || ladoTileLido == 0 ||
+        ladoTileLido > std::max<uint64_t>(tamanhoLido, 1) || !(passo > 0.0)) {
+        return;
+    }
+    tamanho = static_cast<size_t>(tamanhoLido);
+    ladoTile = ladoTileLido;
+
+    tilesPorLado = tamanho / ladoTile + (tamanho % ladoTile != 0);
+    size_t numTiles, bytesTabela;
+    if (__builtin_mul_overflow(tilesPorLado, tilesPorLado, &numTiles) ||
+        __builtin_mul_overflow(numTiles + 1, size_t(8), &bytesTabela) ||
+        bytes < TAMANHO_CABECALHO || bytes - TAMANHO_CABECALHO < bytesTabela) {
+        return;
+    }
+
+    // Tabela de deslocamentos inteira em uma leitura; deve ser crescente, começar depois
+    // da própria tabela e caber no arquivo
+    std::vector<unsigned char> tabela(bytesTabela);
+    if (!arquivo.lerEm(tabela.data(), tabela.size(), TAMANHO_CABECALHO)) return;
+    deslocamentos.resize(numTiles + 1);
+    for (size_t t = 0; t <= numTiles; t++) {
+        deslocamentos[t] = lerU64(tabela.data() + 8 * t);
+        uint64_t minimo = t > 0 ? deslocamentos[t - 1] : TAMANHO_CABECALHO + bytesTabela;
+        if (deslocamentos[t] > bytes || deslocamentos[t] < minimo) return;
+    }
+
+    // Cada altitude ocupa ao menos 1 bit (o zero que fecha o código unário): o mapa não pode
+    // ter mais altitudes que os bits dos tiles, o que também limita os buffers da decodificação
+    size_t altitudes;
+    if (__builtin_mul_overflow(tamanho, tamanho, &altitudes) ||
+        altitudes / 8 > deslocamentos[numTiles] - deslocamentos[0]) {
+        return;
+    }
+    valido = true;
+}
+
+bool MapaCompactado::ehValido() const {
+    return valido;
+}
+
+size_t MapaCompactado::obterTamanho() const {
+    return tamanho;
+}
+
+size_t MapaCompactado::obterLadoTile() const {
+    return ladoTile;
+}
+
+size_t MapaCompactado::obterTilesPorLado() const {
+    return tilesPorLado;
+}
+
+bool MapaCompactado::decodificarTile(size_t tileLin, size_t tileCol, double* destino,
+                                     size_t passoLinha) const {
+    return decodificarTile(tileLin, tileCol, destino, passoLinha, 0, ladoTile, 0, ladoTile);
+}
+
+bool MapaCompactado::decodificarTile(size_t tileLin, size_t tileCol, double* destino, size_t passoLinha,
+                                     size_t linInicio, size_t linFim, size_t colInicio, size_t colFim) const {
+    if (!valido || tileLin >= tilesPorLado || tileCol >= tilesPorLado) return false;
+
+    size_t tile = tileLin * tilesPorLado + tileCol;
+    size_t linhas = std::min(std::min(ladoTile, tamanho - tileLin * ladoTile), linFim);
+    size_t colunas = std::min(ladoTile, tamanho - tileCol * ladoTile);
+    colFim = std::min(colFim, colunas);
+
+    // Só os bytes deste tile saem do disco
+    std::vector<unsigned char> dados(deslocamentos[tile + 1] - deslocamentos[tile]);
+    if (!arquivo.lerEm(dados.data(), dados.size(), deslocamentos[tile])) return false;
+    LeitorBits leitor(dados.data(), dados.data() + dados.size());
+    EstadoRice estado;
+    std::vector<int64_t> anterior(colunas), atual(colunas);
+
+    for (size_t i = 0; i < linhas; i++) {
+        // Toda a linha passa pelo decodificador (os códigos são sequenciais), mas só a janela é gravada
+        for (size_t j = 0; j < colunas; j++) {
+            int64_t previsao = prever(atual.data(), i > 0 ? anterior.data() : nullptr, j);
+            atual[j] = previsao + paraComSinal(decodificarRice(leitor, estado));
+        }
+        if (i >= linInicio) {
+            double* linha = destino + (i - linInicio) * passoLinha;
+            for (size_t j = colInicio; j < colFim; j++) {
+                linha[j - colInicio] = atual[j] * passo;
+            }
+        }
+        anterior.swap(atual);
+    }
+    return true;
+}
+
+bool MapaCompactado::lerRegiao(size_t lin, size_t col, size_t altura, size_t largura,
+                               double* destino, size_t passoLinha) const {
+    if (!valido || lin > tamanho || col > tamanho || altura > tamanho - lin || largura > tamanho - col) {
+        return false;
+    }
+    if (altura == 0 || largura == 0) return true;
+
+    // Tiles que a região toca
+    size_t tileLin0 = lin / ladoTile, tileLin1 = (lin + altura - 1) / ladoTile;
+    size_t tileCol0 = col / ladoTile, tileCol1 = (col + largura - 1) / ladoTile;
+    size_t tilesPorLinha = tileCol1 - tileCol0 + 1;
+    size_t numTiles = (tileLin1 - tileLin0 + 1) * tilesPorLinha;
+
+    // Cada tile grava só a sua interseção com a região, direto no destino
+    std::vector<char> sucesso(numTiles, 0);
+    executarEmFaixas(numTiles, numTiles, [&](size_t t, size_t, size_t) {
+        size_t tileLin = tileLin0 + t / tilesPorLinha;
+        size_t tileCol = tileCol0 + t % tilesPorLinha;
+        size_t linTile = tileLin * ladoTile, colTile = tileCol * ladoTile;
+
+        size_t linInicio = std::max(lin, linTile), linFim = std::min(lin + altura, linTile + ladoTile);
+        size_t colInicio = std::max(col, colTile), colFim = std::min(col + largura, colTile + ladoTile);
+
+        sucesso[t] = decodificarTile(tileLin, tileCol, destino + (linInicio - lin) * passoLinha + (colInicio - col),
+                                     passoLinha, linInicio - linTile, linFim - linTile, colInicio - colTile,
+                                     colFim - colTile);
+    });
+    return std::find(sucesso.begin(), sucesso.end(), 0) == sucesso.end();
+}
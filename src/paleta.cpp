@@ -4,14 +4,15 @@
 #include <cctype>
 #include <iostream>
 #include <sstream>
+#include <cstdlib>
 
 // Construtor padrão
-Paleta::Paleta() {
+Paleta::Paleta() : posicoesValidas(false), interpolacao(PALETA_FAIXAS) {
     // Sequencia já é inicializada vazia automaticamente
 }
 
 // Construtor que carrega de arquivo
-Paleta::Paleta(const char* nomeArquivo) {
+Paleta::Paleta(const char* nomeArquivo) : posicoesValidas(false), interpolacao(PALETA_FAIXAS) {
     std::ifstream arquivo(nomeArquivo);
     
     if (!arquivo.is_open()) {
@@ -33,23 +34,51 @@ Paleta::Paleta(const char* nomeArquivo) {
             continue;
         }
 
+        // Separa a posição opcional depois do código ("#RRGGBB 0.35")
+        size_t espaco = linha.find_first_of(" \t");
+        std::string resto = espaco == std::string::npos ? "" : linha.substr(espaco);
+        linha = linha.substr(0, espaco);
+
         // Remove o '#' e verifica comprimento
         std::string hex = linha.substr(1);
         if (hex.length() != 6) {
             continue;
         }
 
+        // Posição: número em [0, 1]; ausente ou inválida vira -1 (cores igualmente espaçadas)
+        double posicao = -1.0;
+        size_t inicioPosicao = resto.find_first_not_of(" \t");
+        if (inicioPosicao != std::string::npos) {
+            const char* texto = resto.c_str() + inicioPosicao;
+            char* fimNumero;
+            posicao = std::strtod(texto, &fimNumero);
+            if (fimNumero == texto || posicao < 0.0 || posicao > 1.0) {
+                std::cerr << "Aviso: posição inválida ignorada em '" << nomeArquivo << "': " << texto << std::endl;
+                posicao = -1.0;
+            }
+        }
+
         // Converte hexadecimal para Cor
         Cor novaCor;
         if (lerCorDoHex(hex, novaCor)) {
-            adicionarCor(novaCor);
+            adicionarCor(novaCor, posicao);
         }
     }
 }
 
 // Adiciona uma cor à paleta
 void Paleta::adicionarCor(Cor cor) {
+    adicionarCor(cor, -1.0);
+}
+
+// Adiciona uma cor com posição no gradiente
+void Paleta::adicionarCor(Cor cor, double posicao) {
+    // Posições só valem se todas as cores têm uma e elas não diminuem
+    size_t anteriores = posicoes.obterTamanho();
+    posicoesValidas = posicao >= 0.0
+        && (anteriores == 0 || (posicoesValidas && posicao >= posicoes[anteriores - 1]));
     cores.adicionar(cor);
+    posicoes.adicionar(posicao);
 }
 
 // Retorna o número de cores na paleta
@@ -97,4 +126,27 @@ bool Paleta::lerCorDoHex(const std::string& hex, Cor& cor) const {
               static_cast<unsigned char>(b));
     
     return true;
-}
\ No newline at end of file
+}
+
+bool Paleta::temPosicoes() const {
+    return posicoesValidas;
+}
+
+double Paleta::obterPosicao(int indice) const {
+    int numCores = obterTamanho();
+    if (indice < 0 || indice >= numCores) {
+        return 0.0;
+    }
+    if (temPosicoes()) {
+        return posicoes[indice];
+    }
+    return numCores > 1 ? static_cast<double>(indice) / (numCores - 1) : 0.0;
+}
+
+void Paleta::definirInterpolacao(InterpolacaoPaleta modo) {
+    interpolacao = modo;
+}
+
+InterpolacaoPaleta Paleta::obterInterpolacao() const {
+    return interpolacao;
+}
@@ -0,0 +1,176 @@
+#include "paralelo.h"
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+// Configuração global (0 = detectar automaticamente)
+static unsigned int numThreadsConfigurado = 0;
+
+void definirNumThreads(unsigned int num) {
+    numThreadsConfigurado = num;
+}
+
+unsigned int obterNumThreads() {
+    if (numThreadsConfigurado > 0) {
+        return numThreadsConfigurado;
+    }
+    unsigned int detectado = std::thread::hardware_concurrency();
+    return detectado > 0 ? detectado : 1;  // hardware_concurrency pode retornar 0
+}
+
+void limitesFaixa(size_t total, size_t numFaixas, size_t faixa, size_t& inicio, size_t& fim) {
+    // Distribui o resto da divisão entre as primeiras faixas
+    size_t base = total / numFaixas;
+    size_t resto = total % numFaixas;
+    inicio = faixa * base + (faixa < resto ? faixa : resto);
+    fim = inicio + base + (faixa < resto ? 1 : 0);
+}
+
+// ═══════════════════════════════════════════════════════════
+// POOL DE TRABALHADORES
+// ═══════════════════════════════════════════════════════════
+
+// Um laço em andamento: as faixas são pegas por um contador atômico, por quem chamou
+// executarEmFaixas e pelos trabalhadores do pool que estiverem livres
+struct Trabalho {
+    const std::function<void(size_t, size_t, size_t)>* tarefa;
+    size_t total;
+    size_t numFaixas;
+    std::atomic<size_t> proximaFaixa;
+    size_t vagas;    // Quantos trabalhadores ainda podem entrar (protegido pelo mutex do pool)
+    size_t ativos;   // Trabalhadores do pool dentro deste trabalho (idem)
+    std::atomic<bool> falhou;
+    std::exception_ptr erro;  // Primeira exceção de uma tarefa (escrita só por quem trocou falhou)
+
+    // Processa faixas até não sobrar nenhuma livre. Uma exceção nunca sai daqui: ela é
+    // guardada para quem chamou executarEmFaixas e as faixas que ninguém pegou são abandonadas
+    void executar() {
+        try {
+            for (size_t faixa = proximaFaixa++; faixa < numFaixas; faixa = proximaFaixa++) {
+                size_t inicio, fim;
+                limitesFaixa(total, numFaixas, faixa, inicio, fim);
+                (*tarefa)(faixa, inicio, fim);
+            }
+        } catch (...) {
+            if (!falhou.exchange(true)) {
+                erro = std::current_exception();
+            }
+            proximaFaixa = numFaixas;
+        }
+    }
+
+    // Relança a exceção guardada; só depois que nenhuma thread está mais no trabalho
+    void relancarErro() {
+        if (erro) {
+            std::rethrow_exception(erro);
+        }
+    }
+};
+
+// Threads criadas uma vez e reaproveitadas por todos os laços paralelos. Quem chama
+// executarEmFaixas sempre trabalha também e nunca espera por uma faixa que ninguém pegou,
+// então chamadas aninhadas (uma tarefa que chama executarEmFaixas) não travam: no pior
+// caso, a chamada interna roda inteira na thread que a fez.
+class PoolTrabalhadores {
+private:
+    std::mutex mutex;
+    std::condition_variable temTrabalho;
+    std::condition_variable trabalhoLiberado;
+    std::vector<Trabalho*> trabalhos;
+    std::vector<std::thread> threads;
+    bool encerrando = false;
+
+    void trabalhador() {
+        std::unique_lock<std::mutex> trava(mutex);
+        while (true) {
+            temTrabalho.wait(trava, [&] { return encerrando || !trabalhos.empty(); });
+            if (encerrando) return;
+
+            Trabalho* trabalho = trabalhos.back();
+            if (--trabalho->vagas == 0) {
+                trabalhos.pop_back();  // Lotado: os próximos trabalhadores vão para outro
+            }
+            trabalho->ativos++;
+            trava.unlock();
+            trabalho->executar();
+            trava.lock();
+            if (--trabalho->ativos == 0) {
+                trabalhoLiberado.notify_all();
+            }
+        }
+    }
+
+public:
+    ~PoolTrabalhadores() {
+        {
+            std::lock_guard<std::mutex> trava(mutex);
+            encerrando = true;
+        }
+        temTrabalho.notify_all();
+        for (std::thread& t : threads) {
+            t.join();
+        }
+    }
+
+    void executar(Trabalho& trabalho, size_t ajudantes) {
+        {
+            std::lock_guard<std::mutex> trava(mutex);
+            while (threads.size() < ajudantes) {
+                threads.emplace_back(&PoolTrabalhadores::trabalhador, this);
+            }
+            trabalho.vagas = ajudantes;
+            trabalho.ativos = 0;
+            trabalhos.push_back(&trabalho);
+        }
+        if (ajudantes == 1) {
+            temTrabalho.notify_one();
+        } else {
+            temTrabalho.notify_all();
+        }
+
+        trabalho.executar();
+
+        // Todas as faixas já foram pegas: fecha a entrada e espera quem ainda está nelas
+        std::unique_lock<std::mutex> trava(mutex);
+        for (size_t i = 0; i < trabalhos.size(); i++) {
+            if (trabalhos[i] == &trabalho) {
+                trabalhos.erase(trabalhos.begin() + i);
+                break;
+            }
+        }
+        trabalhoLiberado.wait(trava, [&] { return trabalho.ativos == 0; });
+        trava.unlock();
+        trabalho.relancarErro();
+    }
+};
+
+void executarEmFaixas(size_t total, size_t numFaixas,
+                      const std::function<void(size_t, size_t, size_t)>& tarefa) {
+    if (total == 0) return;
+    if (numFaixas == 0) numFaixas = 1;
+    if (numFaixas > total) numFaixas = total;
+
+    size_t numTrabalhadores = obterNumThreads();
+    if (numTrabalhadores > numFaixas) numTrabalhadores = numFaixas;
+
+    Trabalho trabalho;
+    trabalho.tarefa = &tarefa;
+    trabalho.total = total;
+    trabalho.numFaixas = numFaixas;
+    trabalho.proximaFaixa = 0;
+    trabalho.falhou = false;
+
+    // Uma faixa ou uma thread: roda aqui mesmo, sem acordar ninguém
+    if (numTrabalhadores <= 1) {
+        trabalho.executar();
+        trabalho.relancarErro();
+        return;
+    }
+
+    // A thread chamadora também trabalha, com até numTrabalhadores - 1 ajudantes do pool
+    static PoolTrabalhadores pool;
+    pool.executar(trabalho, numTrabalhadores - 1);
+}
@@ -0,0 +1,121 @@
+#include "perspectiva.h"
+#include "paralelo.h"
+#include "renderizacao.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Colunas de tela por faixa: vizinhas na tela leem pontos vizinhos do mapa e escrevem
+// nas mesmas linhas de cache da imagem, então andam juntas
+static const size_t COLUNAS_POR_FAIXA = 32;
+
+// Até esta distância (em pontos) o raio anda um ponto por vez; depois, o passo cresce com
+// a distância (nível de detalhe): cada passo vale o mesmo ângulo visto da câmera
+static const double DISTANCIA_PASSO_UNITARIO = 200.0;
+
+// Pinta as linhas [topo, fim) de uma coluna da tela
+static inline void pintarColuna(const VistaImagem& coluna, size_t topo, size_t fim, const Pixel& cor) {
+    unsigned char* r = coluna.canais[0] + topo * coluna.passoLinha;
+    unsigned char* g = coluna.canais[1] + topo * coluna.passoLinha;
+    unsigned char* b = coluna.canais[2] + topo * coluna.passoLinha;
+    for (size_t lin = topo; lin < fim; lin++) {
+        *r = cor.r;
+        *g = cor.g;
+        *b = cor.b;
+        r += coluna.passoLinha;
+        g += coluna.passoLinha;
+        b += coluna.passoLinha;
+    }
+}
+
+// Câmera já convertida para pontos do mapa e pixels da tela
+struct Projecao {
+    double alturaOlho;    // Na escala das altitudes
+    double focal;         // Distância focal em pixels (a mesma na horizontal e na vertical)
+    double horizonte;     // Linha da tela onde fica o horizonte
+    double escalaAltura;  // Pixels por (unidade de altitude / distância em pontos)
+    double camX, camY;    // Posição da câmera, em pontos
+    double frenteX, frenteY, direitaX, direitaY;
+    double alcance;       // Em pontos
+};
+
+// Renderiza as colunas [colInicio, colFim) da tela
+static void renderizarColunas(const double* altitudes, size_t lado, const VistaImagem& cores, const Camera& camera,
+                              const Projecao& p, size_t largura, size_t altura, size_t colInicio, size_t colFim,
+                              const VistaImagem& destino) {
+    size_t n = colFim - colInicio;
+    // Primeira linha da tela já pintada em cada coluna (altura = nada pintado ainda)
+    std::vector<size_t> yBuffer(n, altura);
+    size_t abertas = n;  // Colunas que ainda têm pixels a pintar
+    double limite = static_cast<double>(lado) - 0.5;  // Arredonda para dentro do mapa até aqui
+
+    // Deslocamento lateral (por unidade de distância) da primeira coluna
+    double lateral = (colInicio + 0.5 - largura / 2.0) / p.focal;
+    double z = 1.0;
+    while (z <= p.alcance && abertas > 0) {
+        // Pontos do mapa a esta distância: uma reta perpendicular à frente, que anda
+        // z / focal pontos por coluna da tela
+        double px = p.camX + p.frenteX * z + p.direitaX * z * lateral;
+        double py = p.camY + p.frenteY * z + p.direitaY * z * lateral;
+        double passoX = p.direitaX * z / p.focal, passoY = p.direitaY * z / p.focal;
+        double escala = p.escalaAltura / z;
+        for (size_t i = 0; i < n; i++, px += passoX, py += passoY) {
+            if (yBuffer[i] == 0 || px < -0.5 || py < -0.5 || px >= limite || py >= limite) continue;
+            size_t ix = static_cast<size_t>(px + 0.5), iy = static_cast<size_t>(py + 0.5);
+            double yTela = p.horizonte + (p.alturaOlho - altitudes[iy * lado + ix]) * escala;
+            if (yTela >= static_cast<double>(yBuffer[i])) continue;
+            size_t topo = yTela <= 0.0 ? 0 : static_cast<size_t>(yTela);
+            pintarColuna(destino.deslocada(colInicio + i, 0), topo, yBuffer[i], cores.obter(ix, iy));
+            yBuffer[i] = topo;
+            if (topo == 0) abertas--;
+        }
+        z += std::max(1.0, z / DISTANCIA_PASSO_UNITARIO);
+    }
+
+    // O que sobrou acima do terreno é céu
+    for (size_t i = 0; i < n; i++) {
+        pintarColuna(destino.deslocada(colInicio + i, 0), 0, yBuffer[i], camera.ceu);
+    }
+}
+
+void renderizarPerspectiva(const double* altitudes, size_t lado, const VistaImagem& cores, const Camera& camera,
+                           size_t largura, size_t altura, const VistaImagem& destino) {
+    if (largura == 0 || altura == 0) return;
+    if (lado < 2) {
+        for (size_t col = 0; col < largura; col++) {
+            pintarColuna(destino.deslocada(col, 0), 0, altura, camera.ceu);
+        }
+        return;
+    }
+
+    const double graus = 3.14159265358979323846 / 180.0;
+    double passos = static_cast<double>(lado - 1);
+    Projecao p;
+    p.focal = largura / 2.0 / std::tan(std::min(179.0, std::max(1.0, camera.campoVisao)) * graus / 2.0);
+    p.horizonte = altura / 2.0 - p.focal * std::tan(camera.inclinacao * graus);
+    // Com exagero 1, o lado do mapa mede 4× a faixa de altitudes (como no relevo)
+    p.escalaAltura = p.focal * passos * camera.exagero / LADO_POR_ALTURA;
+    p.camX = camera.x * passos;
+    p.camY = camera.y * passos;
+    // Norte é o topo do mapa (linha 0): a frente é (sen, -cos) e a direita (cos, sen)
+    p.frenteX = std::sin(camera.direcao * graus);
+    p.frenteY = -std::cos(camera.direcao * graus);
+    p.direitaX = -p.frenteY;
+    p.direitaY = p.frenteX;
+    p.alcance = camera.alcance * passos;
+    // A altura é contada a partir do terreno sob a câmera (fora do mapa, a partir do zero),
+    // então a mesma câmera não fica enterrada em mapas com outra faixa de altitudes
+    double terreno = 0.0;
+    if (p.camX > -0.5 && p.camY > -0.5 && p.camX < lado - 0.5 && p.camY < lado - 0.5) {
+        terreno = altitudes[static_cast<size_t>(p.camY + 0.5) * lado + static_cast<size_t>(p.camX + 0.5)];
+    }
+    p.alturaOlho = terreno + camera.altura;
+
+    size_t numFaixas = (largura + COLUNAS_POR_FAIXA - 1) / COLUNAS_POR_FAIXA;
+    executarEmFaixas(numFaixas, numFaixas, [&](size_t, size_t inicio, size_t fim) {
+        for (size_t faixa = inicio; faixa < fim; faixa++) {
+            renderizarColunas(altitudes, lado, cores, camera, p, largura, altura, faixa * COLUNAS_POR_FAIXA,
+                              std::min(largura, (faixa + 1) * COLUNAS_POR_FAIXA), destino);
+        }
+    });
+}
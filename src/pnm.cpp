@@ -0,0 +1,66 @@
+#include "pnm.h"
+
+static bool ehEspaco(unsigned char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// Pula espaços em branco e comentários ('#' até o fim da linha)
+static void pularEspacosEComentarios(const unsigned char* dados, size_t tamanho, size_t& pos) {
+    while (pos < tamanho) {
+        if (ehEspaco(dados[pos])) {
+            pos++;
+        } else if (dados[pos] == '#') {
+            while (pos < tamanho && dados[pos] != '\n') pos++;
+        } else {
+            break;
+        }
+    }
+}
+
+// Lê um inteiro decimal sem sinal do cabeçalho
+static bool lerNumero(const unsigned char* dados, size_t tamanho, size_t& pos, size_t& valor) {
+    pularEspacosEComentarios(dados, tamanho, pos);
+    if (pos >= tamanho || dados[pos] < '0' || dados[pos] > '9') return false;
+
+    valor = 0;
+    while (pos < tamanho && dados[pos] >= '0' && dados[pos] <= '9') {
+        valor = valor * 10 + (dados[pos] - '0');
+        if (valor > (static_cast<size_t>(1) << 40)) return false;  // Evita overflow com lixo
+        pos++;
+    }
+    return true;
+}
+
+bool lerCabecalhoPNM(const unsigned char* dados, size_t tamanho, CabecalhoPNM& cabecalho) {
+    // Apenas os formatos com valorMaximo (P2/P3 texto, P5/P6 binário)
+    if (tamanho < 2 || dados[0] != 'P' ||
+        (dados[1] != '2' && dados[1] != '3' && dados[1] != '5' && dados[1] != '6')) {
+        return false;
+    }
+    cabecalho.tipo = dados[1] - '0';
+
+    size_t pos = 2;
+    size_t largura, altura, valorMaximo;
+    if (!lerNumero(dados, tamanho, pos, largura) ||
+        !lerNumero(dados, tamanho, pos, altura) ||
+        !lerNumero(dados, tamanho, pos, valorMaximo)) {
+        return false;
+    }
+    if (valorMaximo < 1 || valorMaximo > 65535) return false;
+
+    // Exatamente um espaço em branco separa o cabeçalho dos dados
+    if (pos >= tamanho || !ehEspaco(dados[pos])) return false;
+    pos++;
+
+    cabecalho.largura = largura;
+    cabecalho.altura = altura;
+    cabecalho.valorMaximo = static_cast<unsigned int>(valorMaximo);
+    cabecalho.inicioDados = pos;
+    return true;
+}
+
+std::string montarCabecalhoPNM(int tipo, size_t largura, size_t altura, unsigned int valorMaximo) {
+    return "P" + std::to_string(tipo) + "\n" +
+           std::to_string(largura) + " " + std::to_string(altura) + "\n" +
+           std::to_string(valorMaximo) + "\n";
+}
@@ -0,0 +1,103 @@
+#include "quantizacao.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+static const double MAXIMO_U16 = 65535.0;
+
+// Versão escalar de um valor (também usada para o resto que não completa 8 valores)
+static inline unsigned int quantizarUm(double valor, double minimo, double escala) {
+    double t = (valor - minimo) * escala + 0.5;  // +0.5 -> arredonda ao truncar
+    if (!(t >= 0.0)) t = 0.0;                    // Também trata NaN (vira 0)
+    if (t > MAXIMO_U16) t = MAXIMO_U16;
+    return static_cast<unsigned int>(t);
+}
+
+void quantizarU16BE(const double* origem, unsigned char* destino, size_t n,
+                    double minimo, double maximo) {
+    double escala = (maximo > minimo) ? MAXIMO_U16 / (maximo - minimo) : 0.0;
+    size_t i = 0;
+
+#ifdef __SSE2__
+    const __m128d vMinimo = _mm_set1_pd(minimo);
+    const __m128d vEscala = _mm_set1_pd(escala);
+    const __m128d vMeio = _mm_set1_pd(0.5);
+    const __m128d vZero = _mm_setzero_pd();
+    const __m128d vMaximo = _mm_set1_pd(MAXIMO_U16);
+    const __m128i vDesloca = _mm_set1_epi32(32768);
+    const __m128i vSinal = _mm_set1_epi16(static_cast<short>(0x8000));
+
+    for (; i + 8 <= n; i += 8) {
+        __m128i q[4];
+        for (int k = 0; k < 4; k++) {
+            __m128d t = _mm_loadu_pd(origem + i + 2 * k);
+            t = _mm_add_pd(_mm_mul_pd(_mm_sub_pd(t, vMinimo), vEscala), vMeio);
+            t = _mm_max_pd(t, vZero);     // max(NaN, 0) devolve 0, como na versão escalar
+            t = _mm_min_pd(t, vMaximo);
+            q[k] = _mm_cvttpd_epi32(t);   // 2 inteiros de 32 bits na metade baixa
+        }
+        __m128i a = _mm_unpacklo_epi64(q[0], q[1]);
+        __m128i b = _mm_unpacklo_epi64(q[2], q[3]);
+
+        // SSE2 só tem empacotamento com sinal: desloca para [-32768, 32767],
+        // empacota e desfaz o deslocamento invertendo o bit de sinal
+        a = _mm_sub_epi32(a, vDesloca);
+        b = _mm_sub_epi32(b, vDesloca);
+        __m128i u16 = _mm_xor_si128(_mm_packs_epi32(a, b), vSinal);
+
+        // Troca os bytes de cada amostra (little-endian -> big-endian)
+        u16 = _mm_or_si128(_mm_slli_epi16(u16, 8), _mm_srli_epi16(u16, 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destino + 2 * i), u16);
+    }
+#endif
+
+    for (; i < n; i++) {
+        unsigned int q = quantizarUm(origem[i], minimo, escala);
+        destino[2 * i] = static_cast<unsigned char>(q >> 8);
+        destino[2 * i + 1] = static_cast<unsigned char>(q & 0xFF);
+    }
+}
+
+void desquantizarU16BE(const unsigned char* origem, double* destino, size_t n,
+                       double minimo, double maximo, unsigned int valorMaximo) {
+    double passo = (maximo - minimo) / valorMaximo;
+    size_t i = 0;
+
+#ifdef __SSE2__
+    const __m128d vMinimo = _mm_set1_pd(minimo);
+    const __m128d vPasso = _mm_set1_pd(passo);
+    const __m128i vZero = _mm_setzero_si128();
+
+    for (; i + 8 <= n; i += 8) {
+        __m128i u16 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(origem + 2 * i));
+        u16 = _mm_or_si128(_mm_slli_epi16(u16, 8), _mm_srli_epi16(u16, 8));  // big -> little
+
+        __m128i baixo = _mm_unpacklo_epi16(u16, vZero);  // amostras 0-3 em 32 bits
+        __m128i alto = _mm_unpackhi_epi16(u16, vZero);   // amostras 4-7
+
+        __m128d d0 = _mm_cvtepi32_pd(baixo);
+        __m128d d1 = _mm_cvtepi32_pd(_mm_srli_si128(baixo, 8));
+        __m128d d2 = _mm_cvtepi32_pd(alto);
+        __m128d d3 = _mm_cvtepi32_pd(_mm_srli_si128(alto, 8));
+
+        _mm_storeu_pd(destino + i,     _mm_add_pd(vMinimo, _mm_mul_pd(d0, vPasso)));
+        _mm_storeu_pd(destino + i + 2, _mm_add_pd(vMinimo, _mm_mul_pd(d1, vPasso)));
+        _mm_storeu_pd(destino + i + 4, _mm_add_pd(vMinimo, _mm_mul_pd(d2, vPasso)));
+        _mm_storeu_pd(destino + i + 6, _mm_add_pd(vMinimo, _mm_mul_pd(d3, vPasso)));
+    }
+#endif
+
+    for (; i < n; i++) {
+        unsigned int q = (static_cast<unsigned int>(origem[2 * i]) << 8) | origem[2 * i + 1];
+        destino[i] = minimo + q * passo;
+    }
+}
+
+void desquantizarU8(const unsigned char* origem, double* destino, size_t n,
+                    double minimo, double maximo, unsigned int valorMaximo) {
+    double passo = (maximo - minimo) / valorMaximo;
+    for (size_t i = 0; i < n; i++) {
+        destino[i] = minimo + origem[i] * passo;
+    }
+}
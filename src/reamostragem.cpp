@@ -0,0 +1,220 @@
+#include "reamostragem.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define REAMOSTRAGEM_X86 1
+#endif
+
+// ═══════════════════════════════════════════════════════════
+// PESOS
+// ═══════════════════════════════════════════════════════════
+
+// Pesos de Catmull-Rom dos pontos -1, 0, 1 e 2 para a posição t ∈ [0, 1) entre 0 e 1
+static void pesosCatmullRom(double t, double pesos[4]) {
+    double t2 = t * t, t3 = t2 * t;
+    pesos[0] = 0.5 * (-t3 + 2.0 * t2 - t);
+    pesos[1] = 0.5 * (3.0 * t3 - 5.0 * t2 + 2.0);
+    pesos[2] = 0.5 * (-3.0 * t3 + 4.0 * t2 + t);
+    pesos[3] = 0.5 * (t3 - t2);
+}
+
+PesosReamostragem::PesosReamostragem(size_t origem, size_t destino, FiltroReamostragem filtro)
+    : numSaidas(destino) {
+    if (filtro == FILTRO_AUTOMATICO) {
+        filtro = destino < origem ? FILTRO_CAIXA : FILTRO_BICUBICO;
+    }
+    double escala = static_cast<double>(origem) / static_cast<double>(destino);
+    size_t pontosFiltro = filtro == FILTRO_BILINEAR ? 2
+                        : filtro == FILTRO_BICUBICO ? 4
+                        : static_cast<size_t>(std::ceil(escala)) + 1;
+    pontosPorSaida = std::min(pontosFiltro, origem);
+    inicio.resize(destino);
+    pesos.assign(pontosPorSaida * destino, 0.0);
+
+    std::ptrdiff_t ultimo = static_cast<std::ptrdiff_t>(origem) - 1;
+    std::vector<double> pesosFiltro(pontosFiltro);
+    for (size_t i = 0; i < destino; i++) {
+        // Primeiro ponto de origem do filtro (pode cair fora da grade) e seus pesos
+        std::ptrdiff_t primeiro;
+        if (filtro == FILTRO_CAIXA) {
+            // A saída i cobre [i, i + 1) × escala da origem; cada ponto pesa a área em comum
+            double a = i * escala, b = (i + 1) * escala;
+            primeiro = static_cast<std::ptrdiff_t>(std::floor(a));
+            for (size_t p = 0; p < pontosFiltro; p++) {
+                double k = static_cast<double>(primeiro + static_cast<std::ptrdiff_t>(p));
+                pesosFiltro[p] = std::max(0.0, std::min(b, k + 1.0) - std::max(a, k)) / escala;
+            }
+        } else {
+            double x = (i + 0.5) * escala - 0.5;
+            double base = std::floor(x);
+            double t = x - base;
+            primeiro = static_cast<std::ptrdiff_t>(base);
+            if (filtro == FILTRO_BILINEAR) {
+                pesosFiltro[0] = 1.0 - t;
+                pesosFiltro[1] = t;
+            } else {
+                primeiro -= 1;
+                pesosCatmullRom(t, pesosFiltro.data());
+            }
+        }
+        // Pontos fora da grade somam seu peso ao da borda
+        std::ptrdiff_t janela = std::min<std::ptrdiff_t>(std::max<std::ptrdiff_t>(primeiro, 0),
+                                                         static_cast<std::ptrdiff_t>(origem - pontosPorSaida));
+        inicio[i] = static_cast<int32_t>(janela);
+        for (size_t p = 0; p < pontosFiltro; p++) {
+            std::ptrdiff_t k = std::min(std::max<std::ptrdiff_t>(primeiro + static_cast<std::ptrdiff_t>(p), 0), ultimo);
+            pesos[(k - janela) * destino + i] += pesosFiltro[p];
+        }
+    }
+}
+
+// ═══════════════════════════════════════════════════════════
+// NÚCLEOS: soma na ordem dos pontos, multiplicação e soma separadas (sem FMA),
+// para as três versões darem os mesmos bits
+// ═══════════════════════════════════════════════════════════
+
+static size_t horizontalEscalar(const double* origem, const PesosReamostragem& pesos, size_t i, double* destino) {
+    for (; i < pesos.numSaidas; i++) {
+        const double* pontos = origem + pesos.inicio[i];
+        double soma = 0.0;
+        for (size_t p = 0; p < pesos.pontosPorSaida; p++) {
+            soma += pontos[p] * pesos.pesos[p * pesos.numSaidas + i];
+        }
+        destino[i] = soma;
+    }
+    return i;
+}
+
+static size_t verticalEscalar(const double* const* linhas, const double* pesos, size_t numLinhas, size_t largura,
+                              size_t col, double* destino) {
+    for (; col < largura; col++) {
+        double soma = 0.0;
+        for (size_t l = 0; l < numLinhas; l++) {
+            soma += linhas[l][col] * pesos[l];
+        }
+        destino[col] = soma;
+    }
+    return col;
+}
+
+#ifdef REAMOSTRAGEM_X86
+
+// SSE4.1: 2 saídas por iteração (sem gather: os dois pontos são carregados à parte)
+__attribute__((target("sse4.1")))
+static size_t horizontalSSE41(const double* origem, const PesosReamostragem& pesos, size_t i, double* destino) {
+    for (; i + 2 <= pesos.numSaidas; i += 2) {
+        const double* a = origem + pesos.inicio[i];
+        const double* b = origem + pesos.inicio[i + 1];
+        __m128d soma = _mm_setzero_pd();
+        for (size_t p = 0; p < pesos.pontosPorSaida; p++) {
+            __m128d pontos = _mm_set_pd(b[p], a[p]);
+            soma = _mm_add_pd(soma, _mm_mul_pd(pontos, _mm_loadu_pd(&pesos.pesos[p * pesos.numSaidas + i])));
+        }
+        _mm_storeu_pd(destino + i, soma);
+    }
+    return i;
+}
+
+__attribute__((target("sse4.1")))
+static size_t verticalSSE41(const double* const* linhas, const double* pesos, size_t numLinhas, size_t largura,
+                            size_t col, double* destino) {
+    for (; col + 2 <= largura; col += 2) {
+        __m128d soma = _mm_setzero_pd();
+        for (size_t l = 0; l < numLinhas; l++) {
+            soma = _mm_add_pd(soma, _mm_mul_pd(_mm_loadu_pd(linhas[l] + col), _mm_set1_pd(pesos[l])));
+        }
+        _mm_storeu_pd(destino + col, soma);
+    }
+    return col;
+}
+
+// AVX2: 4 saídas por iteração, com gather dos pontos de origem
+__attribute__((target("avx2")))
+static size_t horizontalAVX2(const double* origem, const PesosReamostragem& pesos, size_t i, double* destino) {
+    for (; i + 4 <= pesos.numSaidas; i += 4) {
+        __m128i indices = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&pesos.inicio[i]));
+        __m256d soma = _mm256_setzero_pd();
+        for (size_t p = 0; p < pesos.pontosPorSaida; p++) {
+            // Gather com máscara cheia e origem zerada (a forma sem máscara deixa o
+            // registrador de origem sem valor inicial)
+            __m256d pontos = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), origem + p, indices,
+                                                      _mm256_castsi256_pd(_mm256_set1_epi64x(-1)), 8);
+            soma = _mm256_add_pd(soma, _mm256_mul_pd(pontos, _mm256_loadu_pd(&pesos.pesos[p * pesos.numSaidas + i])));
+        }
+        _mm256_storeu_pd(destino + i, soma);
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static size_t verticalAVX2(const double* const* linhas, const double* pesos, size_t numLinhas, size_t largura,
+                           size_t col, double* destino) {
+    for (; col + 4 <= largura; col += 4) {
+        __m256d soma = _mm256_setzero_pd();
+        for (size_t l = 0; l < numLinhas; l++) {
+            soma = _mm256_add_pd(soma, _mm256_mul_pd(_mm256_loadu_pd(linhas[l] + col), _mm256_set1_pd(pesos[l])));
+        }
+        _mm256_storeu_pd(destino + col, soma);
+    }
+    return col;
+}
+
+#endif
+
+void reamostrarLinha(const double* origem, const PesosReamostragem& pesos, double* destino, NivelSimd nivel) {
+    size_t i = 0;
+#ifdef REAMOSTRAGEM_X86
+    if (nivel == SIMD_AVX2) {
+        i = horizontalAVX2(origem, pesos, i, destino);
+    } else if (nivel == SIMD_SSE41) {
+        i = horizontalSSE41(origem, pesos, i, destino);
+    }
+#else
+    (void)nivel;
+#endif
+    horizontalEscalar(origem, pesos, i, destino);
+}
+
+void combinarLinhas(const double* const* linhas, const double* pesos, size_t numLinhas, size_t largura,
+                    double* destino, NivelSimd nivel) {
+    size_t col = 0;
+#ifdef REAMOSTRAGEM_X86
+    if (nivel == SIMD_AVX2) {
+        col = verticalAVX2(linhas, pesos, numLinhas, largura, col, destino);
+    } else if (nivel == SIMD_SSE41) {
+        col = verticalSSE41(linhas, pesos, numLinhas, largura, col, destino);
+    }
+#else
+    (void)nivel;
+#endif
+    verticalEscalar(linhas, pesos, numLinhas, largura, col, destino);
+}
+
+// ═══════════════════════════════════════════════════════════
+// JANELA DE LINHAS
+// ═══════════════════════════════════════════════════════════
+
+JanelaReamostragem::JanelaReamostragem(const PesosReamostragem& horizontal, const PesosReamostragem& vertical,
+                                       LeitorLinha lerLinha)
+    : horizontal(horizontal), vertical(vertical), lerLinha(lerLinha),
+      linhas(vertical.pontosPorSaida * horizontal.numSaidas), origemDaVaga(vertical.pontosPorSaida, -1),
+      ponteiros(vertical.pontosPorSaida), pesosDaLinha(vertical.pontosPorSaida) {}
+
+void JanelaReamostragem::calcularLinha(size_t linha, double* destino) {
+    size_t vagas = vertical.pontosPorSaida;
+    size_t largura = horizontal.numSaidas;
+    for (size_t p = 0; p < vagas; p++) {
+        // As linhas de uma saída são consecutivas, então origem % vagas nunca colide
+        std::ptrdiff_t origem = vertical.inicio[linha] + static_cast<std::ptrdiff_t>(p);
+        size_t vaga = static_cast<size_t>(origem) % vagas;
+        if (origemDaVaga[vaga] != origem) {
+            reamostrarLinha(lerLinha(static_cast<size_t>(origem)), horizontal, &linhas[vaga * largura]);
+            origemDaVaga[vaga] = origem;
+        }
+        ponteiros[p] = &linhas[vaga * largura];
+        pesosDaLinha[p] = vertical.pesos[p * vertical.numSaidas + linha];
+    }
+    combinarLinhas(ponteiros.data(), pesosDaLinha.data(), vagas, largura, destino);
+}
@@ -0,0 +1,844 @@
+#include "renderizacao.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define RENDERIZACAO_X86 1
+#endif
+
+// No LAYOUT_RGB24 a saída é escrita como bytes RGB contíguos
+static_assert(sizeof(Pixel) == 3, "Pixel deve ter exatamente 3 bytes (RGB intercalado)");
+
+// Entradas da tabela de gradiente: com 4096 cores (16 KB, cabe na cache L1) cada degrau
+// fica bem abaixo de um nível de 8 bits entre duas cores vizinhas de uma paleta típica
+static const size_t TAMANHO_TABELA_GRADIENTE = 4096;
+
+// Pesos de mistura em ponto fixo 16.16
+static const uint32_t UM_PONTO_FIXO = 65536;
+
+static uint32_t empacotar(unsigned r, unsigned g, unsigned b) {
+    return r | (g << 8) | (b << 16);
+}
+
+// ═══════════════════════════════════════════════════════════
+// PALETA COMPILADA
+// ═══════════════════════════════════════════════════════════
+
+// Conversões sRGB ↔ luz linear, montadas uma vez por processo
+struct TabelasLuzLinear {
+    uint16_t paraLinear[256];      // Canal sRGB de 8 bits → luz linear em 16 bits
+    unsigned char paraSrgb[65536]; // Luz linear em 16 bits → canal sRGB de 8 bits
+
+    TabelasLuzLinear() {
+        for (int i = 0; i < 256; i++) {
+            double c = i / 255.0;
+            double linear = c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+            paraLinear[i] = static_cast<uint16_t>(std::lround(linear * 65535.0));
+        }
+        for (int i = 0; i < 65536; i++) {
+            double linear = i / 65535.0;
+            double c = linear <= 0.0031308 ? linear * 12.92 : 1.055 * std::pow(linear, 1.0 / 2.4) - 0.055;
+            paraSrgb[i] = static_cast<unsigned char>(std::lround(std::min(1.0, std::max(0.0, c)) * 255.0));
+        }
+    }
+};
+
+static const TabelasLuzLinear& tabelasLuzLinear() {
+    static const TabelasLuzLinear tabelas;  // Inicialização thread-safe (C++11)
+    return tabelas;
+}
+
+// Mistura dois canais com peso (0 = só a, UM_PONTO_FIXO = só b), em sRGB ou em luz linear
+static unsigned misturarCanal(unsigned a, unsigned b, uint32_t peso, const TabelasLuzLinear* linear) {
+    if (!linear) {
+        return (a * (UM_PONTO_FIXO - peso) + b * peso + UM_PONTO_FIXO / 2) >> 16;
+    }
+    uint64_t la = linear->paraLinear[a], lb = linear->paraLinear[b];
+    uint64_t l = (la * (UM_PONTO_FIXO - peso) + lb * peso + UM_PONTO_FIXO / 2) >> 16;
+    return linear->paraSrgb[l];
+}
+
+PaletaCompilada::PaletaCompilada(const Paleta& paleta) {
+    int numCores = paleta.obterTamanho();
+    InterpolacaoPaleta modo = paleta.obterInterpolacao();
+
+    // Faixas igualmente espaçadas: as próprias cores, com o índice exato de corDaAltitude
+    if (numCores < 2 || (modo == PALETA_FAIXAS && !paleta.temPosicoes())) {
+        for (int i = 0; i < numCores; i++) {
+            Cor c = paleta.obterCor(i);
+            cores.push_back(empacotar(c.r, c.g, c.b));
+        }
+        if (cores.empty()) {
+            cores.push_back(0);
+        }
+        escala = static_cast<double>(cores.size() - 1);
+        return;
+    }
+
+    // Gradiente ou posições personalizadas: tabela de alta resolução, então o custo por
+    // pixel continua o mesmo (índice truncado + uma leitura). A entrada k atende as
+    // altitudes em [k, k + 1) / (TAMANHO - 1) e é calculada no meio desse intervalo.
+    const TabelasLuzLinear* linear = modo == PALETA_GRADIENTE_LINEAR ? &tabelasLuzLinear() : nullptr;
+    std::vector<double> posicoes(numCores);
+    for (int i = 0; i < numCores; i++) {
+        posicoes[i] = paleta.obterPosicao(i);
+    }
+    cores.resize(TAMANHO_TABELA_GRADIENTE);
+    escala = static_cast<double>(TAMANHO_TABELA_GRADIENTE - 1);
+    int trecho = 0;  // Última cor com posição <= t
+    for (size_t k = 0; k < TAMANHO_TABELA_GRADIENTE; k++) {
+        double t = std::min(1.0, (k + 0.5) / escala);
+        while (trecho + 1 < numCores && posicoes[trecho + 1] <= t) {
+            trecho++;
+        }
+
+        Cor a = paleta.obterCor(trecho);
+        double inicio = posicoes[trecho];
+        if (modo == PALETA_FAIXAS || trecho + 1 == numCores || t < inicio) {
+            // Faixa da cor de baixo (ou antes da primeira / depois da última posição)
+            cores[k] = empacotar(a.r, a.g, a.b);
+            continue;
+        }
+        Cor b = paleta.obterCor(trecho + 1);
+        double fim = posicoes[trecho + 1];  // fim > t >= inicio
+        uint32_t peso = static_cast<uint32_t>(std::lround((t - inicio) / (fim - inicio) * UM_PONTO_FIXO));
+        cores[k] = empacotar(misturarCanal(a.r, b.r, peso, linear), misturarCanal(a.g, b.g, peso, linear),
+                             misturarCanal(a.b, b.b, peso, linear));
+    }
+}
+
+// ═══════════════════════════════════════════════════════════
+// VERSÃO ESCALAR (referência)
+// ═══════════════════════════════════════════════════════════
+
+// Índice da cor: trunca altitude × (numCores - 1) e limita
+static inline uint32_t corDaAltitude(const PaletaCompilada& paleta, double altitude) {
+    int indice = static_cast<int>(altitude * paleta.escala);
+    int ultimo = static_cast<int>(paleta.cores.size()) - 1;
+    if (indice < 0) indice = 0;
+    if (indice > ultimo) indice = ultimo;
+    return paleta.cores[indice];
+}
+
+// Cada núcleo processa colunas a partir de col e retorna onde parou (o resto fica para o
+// escalar). Com linhaAcima != nullptr aplica a sombra Noroeste, e então col >= 1; senão,
+// com fatores != nullptr, multiplica pelos fatores prontos (fatores[0] é o da coluna col).
+// A saída começa no pixel da coluna col; os vetoriais são instanciados por layout.
+static size_t linhaEscalar(const PaletaCompilada& paleta, const double* linha, const double* linhaAcima,
+                           const double* fatores, size_t col, size_t colFim, const VistaImagem& saida) {
+    for (size_t i = 0; col < colFim; col++, i++) {
+        double altitude = linha[col];
+        uint32_t cor = corDaAltitude(paleta, altitude);
+        unsigned char r = cor & 0xFF, g = (cor >> 8) & 0xFF, b = (cor >> 16) & 0xFF;
+        if (linhaAcima || fatores) {
+            // Escurece a cor multiplicando componentes RGB pelo fator
+            double fatorSombra = linhaAcima ? fatorSombreamento(altitude, linhaAcima[col - 1]) : *fatores++;
+            r = static_cast<unsigned char>(r * fatorSombra);
+            g = static_cast<unsigned char>(g * fatorSombra);
+            b = static_cast<unsigned char>(b * fatorSombra);
+        }
+        saida.definir(i, 0, Pixel(r, g, b));
+    }
+    return col;
+}
+
+#ifdef RENDERIZACAO_X86
+
+// ═══════════════════════════════════════════════════════════
+// SSE4.1: 4 PIXELS POR ITERAÇÃO
+// ═══════════════════════════════════════════════════════════
+
+// fatorSombreamento para 2 pixels: mesma ordem de operações, sem desvios
+__attribute__((target("sse4.1")))
+static inline __m128d fatorSombreamentoSSE(__m128d atual, __m128d noroeste) {
+    __m128d diferenca = _mm_sub_pd(noroeste, atual);
+    __m128d fator = _mm_sub_pd(_mm_set1_pd(1.0), _mm_mul_pd(diferenca, _mm_set1_pd(5.0)));
+    fator = _mm_min_pd(_mm_max_pd(fator, _mm_set1_pd(0.3)), _mm_set1_pd(1.0));
+    __m128d naSombra = _mm_cmpgt_pd(diferenca, _mm_setzero_pd());
+    return _mm_blendv_pd(_mm_set1_pd(1.0), fator, naSombra);
+}
+
+// Um canal (4 valores de 0 a 255) × fator, truncado como no static_cast<unsigned char>
+__attribute__((target("sse4.1")))
+static inline __m128i escurecerCanalSSE(__m128i canal, __m128d fatorBaixo, __m128d fatorAlto) {
+    __m128i baixo = _mm_cvttpd_epi32(_mm_mul_pd(_mm_cvtepi32_pd(canal), fatorBaixo));
+    __m128i alto = _mm_cvttpd_epi32(_mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(canal, 8)), fatorAlto));
+    return _mm_unpacklo_epi64(baixo, alto);
+}
+
+// Grava 4 cores RGB0 a partir do pixel i da saída, no formato do layout
+template <LayoutImagem L>
+__attribute__((target("sse4.1")))
+static inline void gravarSSE(__m128i cor, const VistaImagem& saida, size_t i) {
+    if constexpr (L == LAYOUT_RGBA32) {
+        // A cor já está na ordem dos bytes: só falta o alfa
+        __m128i opaco = _mm_or_si128(cor, _mm_set1_epi32(static_cast<int>(0xFF000000)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(saida.canais[0] + 4 * i), opaco);
+    } else if constexpr (L == LAYOUT_PLANAR) {
+        // 4 × RGB0 → R0..R3 G0..G3 B0..B3: 4 bytes seguidos em cada plano
+        const __m128i separar = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, -1, -1, -1, -1);
+        __m128i planos = _mm_shuffle_epi8(cor, separar);
+        int r = _mm_cvtsi128_si32(planos), g = _mm_extract_epi32(planos, 1), b = _mm_extract_epi32(planos, 2);
+        std::memcpy(saida.canais[0] + i, &r, 4);
+        std::memcpy(saida.canais[1] + i, &g, 4);
+        std::memcpy(saida.canais[2] + i, &b, 4);
+    } else {
+        // Remove o 4º byte de cada cor: 4 × RGB0 → 12 bytes RGB
+        const __m128i compactar = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+        alignas(16) unsigned char bytes[16];
+        _mm_store_si128(reinterpret_cast<__m128i*>(bytes), _mm_shuffle_epi8(cor, compactar));
+        std::memcpy(saida.canais[0] + 3 * i, bytes, 12);
+    }
+}
+
+template <LayoutImagem L>
+__attribute__((target("sse4.1")))
+static size_t linhaSSE41(const PaletaCompilada& paleta, const double* linha, const double* linhaAcima,
+                         const double* fatores, size_t col, size_t colFim, const VistaImagem& saida) {
+    const uint32_t* cores = paleta.cores.data();
+    const __m128d escala = _mm_set1_pd(paleta.escala);
+    const __m128i ultimo = _mm_set1_epi32(static_cast<int>(paleta.cores.size()) - 1);
+    const __m128i byte = _mm_set1_epi32(0xFF);
+
+    for (size_t i = 0; col + 4 <= colFim; col += 4, i += 4) {
+        __m128d altBaixo = _mm_loadu_pd(linha + col);
+        __m128d altAlto = _mm_loadu_pd(linha + col + 2);
+
+        // Índice: truncamento e limites iguais aos do escalar
+        __m128i indice = _mm_unpacklo_epi64(_mm_cvttpd_epi32(_mm_mul_pd(altBaixo, escala)),
+                                            _mm_cvttpd_epi32(_mm_mul_pd(altAlto, escala)));
+        indice = _mm_min_epi32(_mm_max_epi32(indice, _mm_setzero_si128()), ultimo);
+        __m128i cor = _mm_setr_epi32(static_cast<int>(cores[_mm_cvtsi128_si32(indice)]),
+                                     static_cast<int>(cores[_mm_extract_epi32(indice, 1)]),
+                                     static_cast<int>(cores[_mm_extract_epi32(indice, 2)]),
+                                     static_cast<int>(cores[_mm_extract_epi32(indice, 3)]));
+
+        if (linhaAcima || fatores) {
+            __m128d fatorBaixo, fatorAlto;
+            if (linhaAcima) {
+                fatorBaixo = fatorSombreamentoSSE(altBaixo, _mm_loadu_pd(linhaAcima + col - 1));
+                fatorAlto = fatorSombreamentoSSE(altAlto, _mm_loadu_pd(linhaAcima + col + 1));
+            } else {
+                fatorBaixo = _mm_loadu_pd(fatores);
+                fatorAlto = _mm_loadu_pd(fatores + 2);
+                fatores += 4;
+            }
+            __m128i r = escurecerCanalSSE(_mm_and_si128(cor, byte), fatorBaixo, fatorAlto);
+            __m128i g = escurecerCanalSSE(_mm_and_si128(_mm_srli_epi32(cor, 8), byte), fatorBaixo, fatorAlto);
+            __m128i b = escurecerCanalSSE(_mm_and_si128(_mm_srli_epi32(cor, 16), byte), fatorBaixo, fatorAlto);
+            cor = _mm_or_si128(r, _mm_or_si128(_mm_slli_epi32(g, 8), _mm_slli_epi32(b, 16)));
+        }
+
+        gravarSSE<L>(cor, saida, i);
+    }
+    return col;
+}
+
+// ═══════════════════════════════════════════════════════════
+// AVX2: 8 PIXELS POR ITERAÇÃO
+// ═══════════════════════════════════════════════════════════
+
+__attribute__((target("avx2")))
+static inline __m256d fatorSombreamentoAVX(__m256d atual, __m256d noroeste) {
+    __m256d diferenca = _mm256_sub_pd(noroeste, atual);
+    __m256d fator = _mm256_sub_pd(_mm256_set1_pd(1.0), _mm256_mul_pd(diferenca, _mm256_set1_pd(5.0)));
+    fator = _mm256_min_pd(_mm256_max_pd(fator, _mm256_set1_pd(0.3)), _mm256_set1_pd(1.0));
+    __m256d naSombra = _mm256_cmp_pd(diferenca, _mm256_setzero_pd(), _CMP_GT_OQ);
+    return _mm256_blendv_pd(_mm256_set1_pd(1.0), fator, naSombra);
+}
+
+// Um canal (8 valores de 0 a 255) × fator, truncado como no static_cast<unsigned char>
+__attribute__((target("avx2")))
+static inline __m256i escurecerCanalAVX(__m256i canal, __m256d fatorBaixo, __m256d fatorAlto) {
+    __m128i baixo = _mm256_cvttpd_epi32(_mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(canal)), fatorBaixo));
+    __m128i alto = _mm256_cvttpd_epi32(_mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(canal, 1)), fatorAlto));
+    return _mm256_set_m128i(alto, baixo);
+}
+
+// Grava 8 cores RGB0 a partir do pixel i da saída, no formato do layout
+template <LayoutImagem L>
+__attribute__((target("avx2")))
+static inline void gravarAVX(__m256i cor, const VistaImagem& saida, size_t i) {
+    if constexpr (L == LAYOUT_RGBA32) {
+        __m256i opaco = _mm256_or_si256(cor, _mm256_set1_epi32(static_cast<int>(0xFF000000)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(saida.canais[0] + 4 * i), opaco);
+    } else if constexpr (L == LAYOUT_PLANAR) {
+        // Em cada metade: R R R R G G G G B B B B; depois junta as metades de cada canal,
+        // ficando 8 bytes de R, 8 de G e 8 de B
+        const __m256i separar = _mm256_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, -1, -1, -1, -1,
+                                                 0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, -1, -1, -1, -1);
+        __m256i planos = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(cor, separar),
+                                                     _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+        alignas(32) unsigned char bytes[32];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(bytes), planos);
+        std::memcpy(saida.canais[0] + i, bytes, 8);
+        std::memcpy(saida.canais[1] + i, bytes + 8, 8);
+        std::memcpy(saida.canais[2] + i, bytes + 16, 8);
+    } else {
+        // Em cada metade de 128 bits: 4 × RGB0 → 12 bytes RGB
+        const __m256i compactar = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                                                   0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+        alignas(32) unsigned char bytes[32];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(bytes), _mm256_shuffle_epi8(cor, compactar));
+        std::memcpy(saida.canais[0] + 3 * i, bytes, 12);
+        std::memcpy(saida.canais[0] + 3 * i + 12, bytes + 16, 12);
+    }
+}
+
+template <LayoutImagem L>
+__attribute__((target("avx2")))
+static size_t linhaAVX2(const PaletaCompilada& paleta, const double* linha, const double* linhaAcima,
+                        const double* fatores, size_t col, size_t colFim, const VistaImagem& saida) {
+    const int* cores = reinterpret_cast<const int*>(paleta.cores.data());
+    const __m256d escala = _mm256_set1_pd(paleta.escala);
+    const __m256i ultimo = _mm256_set1_epi32(static_cast<int>(paleta.cores.size()) - 1);
+    const __m256i byte = _mm256_set1_epi32(0xFF);
+
+    for (size_t i = 0; col + 8 <= colFim; col += 8, i += 8) {
+        __m256d altBaixo = _mm256_loadu_pd(linha + col);
+        __m256d altAlto = _mm256_loadu_pd(linha + col + 4);
+
+        // Índice: truncamento e limites iguais aos do escalar; depois, gather das cores
+        __m256i indice = _mm256_set_m128i(_mm256_cvttpd_epi32(_mm256_mul_pd(altAlto, escala)),
+                                          _mm256_cvttpd_epi32(_mm256_mul_pd(altBaixo, escala)));
+        indice = _mm256_min_epi32(_mm256_max_epi32(indice, _mm256_setzero_si256()), ultimo);
+        __m256i cor = _mm256_i32gather_epi32(cores, indice, 4);
+
+        if (linhaAcima || fatores) {
+            __m256d fatorBaixo, fatorAlto;
+            if (linhaAcima) {
+                fatorBaixo = fatorSombreamentoAVX(altBaixo, _mm256_loadu_pd(linhaAcima + col - 1));
+                fatorAlto = fatorSombreamentoAVX(altAlto, _mm256_loadu_pd(linhaAcima + col + 3));
+            } else {
+                fatorBaixo = _mm256_loadu_pd(fatores);
+                fatorAlto = _mm256_loadu_pd(fatores + 4);
+                fatores += 8;
+            }
+            __m256i r = escurecerCanalAVX(_mm256_and_si256(cor, byte), fatorBaixo, fatorAlto);
+            __m256i g = escurecerCanalAVX(_mm256_and_si256(_mm256_srli_epi32(cor, 8), byte), fatorBaixo, fatorAlto);
+            __m256i b = escurecerCanalAVX(_mm256_and_si256(_mm256_srli_epi32(cor, 16), byte), fatorBaixo, fatorAlto);
+            cor = _mm256_or_si256(r, _mm256_or_si256(_mm256_slli_epi32(g, 8), _mm256_slli_epi32(b, 16)));
+        }
+
+        gravarAVX<L>(cor, saida, i);
+    }
+    return col;
+}
+
+// ═══════════════════════════════════════════════════════════
+// CONVERSÃO PARA RGB24 (NA HORA DE CODIFICAR)
+// ═══════════════════════════════════════════════════════════
+
+// RGBA32 → RGB24, 4 pixels por vez; planar → RGB24, 16 pixels por vez
+__attribute__((target("sse4.1")))
+static size_t converterSSE41(const VistaImagem& origem, size_t largura, unsigned char* saida) {
+    const __m128i compactar = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    alignas(16) unsigned char bytes[16];
+    size_t x = 0;
+    if (origem.layout == LAYOUT_RGBA32) {
+        for (; x + 4 <= largura; x += 4) {
+            __m128i cor = _mm_loadu_si128(reinterpret_cast<const __m128i*>(origem.canais[0] + 4 * x));
+            _mm_store_si128(reinterpret_cast<__m128i*>(bytes), _mm_shuffle_epi8(cor, compactar));
+            std::memcpy(saida + 3 * x, bytes, 12);
+        }
+    } else if (origem.layout == LAYOUT_PLANAR) {
+        const __m128i zero = _mm_setzero_si128();
+        for (; x + 16 <= largura; x += 16) {
+            __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(origem.canais[0] + x));
+            __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i*>(origem.canais[1] + x));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(origem.canais[2] + x));
+            // Intercala R com G e B com zero, depois os pares: 4 vetores de 4 × RGB0
+            __m128i rgBaixo = _mm_unpacklo_epi8(r, g), rgAlto = _mm_unpackhi_epi8(r, g);
+            __m128i b0Baixo = _mm_unpacklo_epi8(b, zero), b0Alto = _mm_unpackhi_epi8(b, zero);
+            __m128i cores[4] = {_mm_unpacklo_epi16(rgBaixo, b0Baixo), _mm_unpackhi_epi16(rgBaixo, b0Baixo),
+                                _mm_unpacklo_epi16(rgAlto, b0Alto), _mm_unpackhi_epi16(rgAlto, b0Alto)};
+            for (size_t k = 0; k < 4; k++) {
+                _mm_store_si128(reinterpret_cast<__m128i*>(bytes), _mm_shuffle_epi8(cores[k], compactar));
+                std::memcpy(saida + 3 * (x + 4 * k), bytes, 12);
+            }
+        }
+    }
+    return x;
+}
+
+// RGBA32 → RGB24, 8 pixels por vez (o planar fica com a versão SSE4.1)
+__attribute__((target("avx2")))
+static size_t converterAVX2(const VistaImagem& origem, size_t largura, unsigned char* saida) {
+    if (origem.layout != LAYOUT_RGBA32) {
+        return converterSSE41(origem, largura, saida);
+    }
+    const __m256i compactar = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                                               0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    alignas(32) unsigned char bytes[32];
+    size_t x = 0;
+    for (; x + 8 <= largura; x += 8) {
+        __m256i cor = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(origem.canais[0] + 4 * x));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(bytes), _mm256_shuffle_epi8(cor, compactar));
+        std::memcpy(saida + 3 * x, bytes, 12);
+        std::memcpy(saida + 3 * x + 12, bytes + 16, 12);
+    }
+    return x;
+}
+
+#endif
+
+// ═══════════════════════════════════════════════════════════
+// RELEVO (LAMBERT SOBRE NORMAIS DE SOBEL)
+// ═══════════════════════════════════════════════════════════
+
+// Menor fator do relevo: encostas de costas para a luz não ficam pretas
+// (o mesmo limite do sombreamento Noroeste)
+static const double AMBIENTE_RELEVO = 0.3;
+
+IluminacaoRelevo::IluminacaoRelevo(const Sombreamento& sombreamento, size_t ladoMapa) {
+    const double graus = 3.14159265358979323846 / 180.0;
+    double azimute = sombreamento.azimute * graus;
+    double elevacao = sombreamento.elevacao * graus;
+    luzX = std::sin(azimute) * std::cos(elevacao);
+    luzY = std::cos(azimute) * std::cos(elevacao);
+    luzZ = std::sin(elevacao);
+    // Sobel soma 8 vezes a diferença entre vizinhos; distância entre pontos = 1 / (lado - 1)
+    double passos = ladoMapa > 1 ? static_cast<double>(ladoMapa - 1) : 0.0;
+    escalaGradiente = sombreamento.exagero * passos / LADO_POR_ALTURA / 8.0;
+    difusa = 1.0 - AMBIENTE_RELEVO;
+}
+
+// Fator de um ponto a partir da vizinhança 3×3:  a b c / d · f / g h i
+static inline double fatorRelevo(const IluminacaoRelevo& luz, double a, double b, double c, double d, double f,
+                                 double g, double h, double i) {
+    double gx = ((c + 2.0 * f + i) - (a + 2.0 * d + g)) * luz.escalaGradiente;  // Sobe para o leste
+    double gy = ((g + 2.0 * h + i) - (a + 2.0 * b + c)) * luz.escalaGradiente;  // Sobe para o sul
+    // Normal (-gx, gy, 1) em (leste, norte, cima), produto escalar com a luz
+    double lambert = (luz.luzZ - gx * luz.luzX + gy * luz.luzY) / std::sqrt(1.0 + gx * gx + gy * gy);
+    if (lambert < 0.0) lambert = 0.0;
+    if (lambert > 1.0) lambert = 1.0;
+    return AMBIENTE_RELEVO + luz.difusa * lambert;
+}
+
+// Um ponto qualquer da linha, repetindo a borda fora do mapa
+static inline double fatorRelevoEm(const IluminacaoRelevo& luz, const double* acima, const double* linha,
+                                   const double* abaixo, size_t largura, size_t col) {
+    size_t e = col > 0 ? col - 1 : col;
+    size_t d = col + 1 < largura ? col + 1 : col;
+    return fatorRelevo(luz, acima[e], acima[col], acima[d], linha[e], linha[d], abaixo[e], abaixo[col], abaixo[d]);
+}
+
+#ifdef RENDERIZACAO_X86
+
+// Mesmas operações de fatorRelevo, na mesma ordem, 2 pontos por vez (só colunas internas)
+__attribute__((target("sse4.1")))
+static size_t relevoSSE41(const IluminacaoRelevo& luz, const double* acima, const double* linha,
+                          const double* abaixo, size_t col, size_t colFim, double* fatores) {
+    const __m128d dois = _mm_set1_pd(2.0), um = _mm_set1_pd(1.0), zero = _mm_setzero_pd();
+    const __m128d escala = _mm_set1_pd(luz.escalaGradiente);
+    const __m128d lx = _mm_set1_pd(luz.luzX), ly = _mm_set1_pd(luz.luzY), lz = _mm_set1_pd(luz.luzZ);
+    const __m128d ambiente = _mm_set1_pd(AMBIENTE_RELEVO), difusa = _mm_set1_pd(luz.difusa);
+    for (; col + 2 <= colFim; col += 2, fatores += 2) {
+        __m128d a = _mm_loadu_pd(acima + col - 1), b = _mm_loadu_pd(acima + col), c = _mm_loadu_pd(acima + col + 1);
+        __m128d d = _mm_loadu_pd(linha + col - 1), f = _mm_loadu_pd(linha + col + 1);
+        __m128d g = _mm_loadu_pd(abaixo + col - 1), h = _mm_loadu_pd(abaixo + col), i = _mm_loadu_pd(abaixo + col + 1);
+        __m128d gx = _mm_mul_pd(_mm_sub_pd(_mm_add_pd(_mm_add_pd(c, _mm_mul_pd(dois, f)), i),
+                                           _mm_add_pd(_mm_add_pd(a, _mm_mul_pd(dois, d)), g)), escala);
+        __m128d gy = _mm_mul_pd(_mm_sub_pd(_mm_add_pd(_mm_add_pd(g, _mm_mul_pd(dois, h)), i),
+                                           _mm_add_pd(_mm_add_pd(a, _mm_mul_pd(dois, b)), c)), escala);
+        __m128d numerador = _mm_add_pd(_mm_sub_pd(lz, _mm_mul_pd(gx, lx)), _mm_mul_pd(gy, ly));
+        __m128d norma = _mm_sqrt_pd(_mm_add_pd(_mm_add_pd(um, _mm_mul_pd(gx, gx)), _mm_mul_pd(gy, gy)));
+        __m128d lambert = _mm_min_pd(_mm_max_pd(_mm_div_pd(numerador, norma), zero), um);
+        _mm_storeu_pd(fatores, _mm_add_pd(ambiente, _mm_mul_pd(difusa, lambert)));
+    }
+    return col;
+}
+
+// Idem, 4 pontos por vez
+__attribute__((target("avx2")))
+static size_t relevoAVX2(const IluminacaoRelevo& luz, const double* acima, const double* linha,
+                         const double* abaixo, size_t col, size_t colFim, double* fatores) {
+    const __m256d dois = _mm256_set1_pd(2.0), um = _mm256_set1_pd(1.0), zero = _mm256_setzero_pd();
+    const __m256d escala = _mm256_set1_pd(luz.escalaGradiente);
+    const __m256d lx = _mm256_set1_pd(luz.luzX), ly = _mm256_set1_pd(luz.luzY), lz = _mm256_set1_pd(luz.luzZ);
+    const __m256d ambiente = _mm256_set1_pd(AMBIENTE_RELEVO), difusa = _mm256_set1_pd(luz.difusa);
+    for (; col + 4 <= colFim; col += 4, fatores += 4) {
+        __m256d a = _mm256_loadu_pd(acima + col - 1), b = _mm256_loadu_pd(acima + col);
+        __m256d c = _mm256_loadu_pd(acima + col + 1);
+        __m256d d = _mm256_loadu_pd(linha + col - 1), f = _mm256_loadu_pd(linha + col + 1);
+        __m256d g = _mm256_loadu_pd(abaixo + col - 1), h = _mm256_loadu_pd(abaixo + col);
+        __m256d i = _mm256_loadu_pd(abaixo + col + 1);
+        __m256d gx = _mm256_mul_pd(_mm256_sub_pd(_mm256_add_pd(_mm256_add_pd(c, _mm256_mul_pd(dois, f)), i),
+                                                 _mm256_add_pd(_mm256_add_pd(a, _mm256_mul_pd(dois, d)), g)), escala);
+        __m256d gy = _mm256_mul_pd(_mm256_sub_pd(_mm256_add_pd(_mm256_add_pd(g, _mm256_mul_pd(dois, h)), i),
+                                                 _mm256_add_pd(_mm256_add_pd(a, _mm256_mul_pd(dois, b)), c)), escala);
+        __m256d numerador = _mm256_add_pd(_mm256_sub_pd(lz, _mm256_mul_pd(gx, lx)), _mm256_mul_pd(gy, ly));
+        __m256d norma = _mm256_sqrt_pd(_mm256_add_pd(_mm256_add_pd(um, _mm256_mul_pd(gx, gx)), _mm256_mul_pd(gy, gy)));
+        __m256d lambert = _mm256_min_pd(_mm256_max_pd(_mm256_div_pd(numerador, norma), zero), um);
+        _mm256_storeu_pd(fatores, _mm256_add_pd(ambiente, _mm256_mul_pd(difusa, lambert)));
+    }
+    return col;
+}
+
+#endif
+
+void calcularRelevoLinha(const IluminacaoRelevo& luz, const double* linhaAcima, const double* linha,
+                         const double* linhaAbaixo, size_t largura, size_t colInicio, size_t colFim,
+                         double* fatores, NivelSimd nivel) {
+    // Colunas internas (com vizinhos dos dois lados) vão para o núcleo vetorial
+    size_t internoInicio = std::max<size_t>(colInicio, 1);
+    size_t internoFim = std::max(internoInicio, std::min(colFim, largura - 1));
+    size_t col = colInicio;
+    for (; col < internoInicio && col < colFim; col++) {
+        fatores[col - colInicio] = fatorRelevoEm(luz, linhaAcima, linha, linhaAbaixo, largura, col);
+    }
+#ifdef RENDERIZACAO_X86
+    if (nivel == SIMD_AVX2) {
+        col = relevoAVX2(luz, linhaAcima, linha, linhaAbaixo, col, internoFim, fatores + (col - colInicio));
+    } else if (nivel == SIMD_SSE41) {
+        col = relevoSSE41(luz, linhaAcima, linha, linhaAbaixo, col, internoFim, fatores + (col - colInicio));
+    }
+#else
+    (void)nivel;
+#endif
+    for (; col < colFim; col++) {
+        fatores[col - colInicio] = fatorRelevoEm(luz, linhaAcima, linha, linhaAbaixo, largura, col);
+    }
+}
+
+// ═══════════════════════════════════════════════════════════
+// NORMAIS
+// ═══════════════════════════════════════════════════════════
+
+// As diferenças de altitude são feitas em double (as altitudes vizinhas são quase iguais) e a
+// normalização em float, precisão de sobra para 8 bits ou float3 e o dobro de pontos por vetor
+
+// 1/√q por raiz e divisão corretamente arredondadas (IEEE), nunca pela estimativa do rsqrt,
+// que muda de um fabricante de CPU para outro: o mesmo terreno dá os mesmos bytes em qualquer
+// máquina, e as três versões dão os mesmos bits
+static inline float inversoRaiz(float q) {
+    return 1.0f / std::sqrt(q);
+}
+
+// Normal (-gx, gy, 1) normalizada, com um só inverso para os três componentes
+static inline void normalDoGradiente(float gx, float gy, float& nx, float& ny, float& nz) {
+    float inverso = inversoRaiz(1.0f + gx * gx + gy * gy);
+    nx = -(gx * inverso);
+    ny = gy * inverso;
+    nz = inverso;
+}
+
+// Um ponto qualquer da linha; na borda, a diferença vai do ponto ao único vizinho
+static inline void normalEm(double escala, double escalaVertical, const double* acima, const double* linha,
+                            const double* abaixo, size_t largura, size_t col, float& nx, float& ny, float& nz) {
+    size_t e = col > 0 ? col - 1 : col;
+    size_t d = col + 1 < largura ? col + 1 : col;
+    double escalaHorizontal = d - e == 2 ? escala * 0.5 : escala;
+    normalDoGradiente(static_cast<float>((linha[d] - linha[e]) * escalaHorizontal),
+                      static_cast<float>((abaixo[col] - acima[col]) * escalaVertical), nx, ny, nz);
+}
+
+// Componente em [-1, 1] → byte, truncado como no _mm_cvttps_epi32
+static inline unsigned char byteNormal(float n) {
+    return static_cast<unsigned char>(static_cast<int>(n * 127.5f + 128.0f));
+}
+
+#ifdef RENDERIZACAO_X86
+
+// Normais de 4 pontos internos a partir de col, com as operações de normalEm na mesma ordem
+__attribute__((target("sse4.1")))
+static inline void normalSSE(const double* acima, const double* linha, const double* abaixo, size_t col,
+                             __m128d escalaHorizontal, __m128d escalaVertical, __m128& nx, __m128& ny, __m128& nz) {
+    __m128d gxBaixo = _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(linha + col + 1), _mm_loadu_pd(linha + col - 1)),
+                                 escalaHorizontal);
+    __m128d gxAlto = _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(linha + col + 3), _mm_loadu_pd(linha + col + 1)),
+                                escalaHorizontal);
+    __m128d gyBaixo = _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(abaixo + col), _mm_loadu_pd(acima + col)), escalaVertical);
+    __m128d gyAlto = _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(abaixo + col + 2), _mm_loadu_pd(acima + col + 2)),
+                                escalaVertical);
+    __m128 gx = _mm_movelh_ps(_mm_cvtpd_ps(gxBaixo), _mm_cvtpd_ps(gxAlto));
+    __m128 gy = _mm_movelh_ps(_mm_cvtpd_ps(gyBaixo), _mm_cvtpd_ps(gyAlto));
+    __m128 q = _mm_add_ps(_mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(gx, gx)), _mm_mul_ps(gy, gy));
+    nz = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(q));
+    nx = _mm_xor_ps(_mm_mul_ps(gx, nz), _mm_set1_ps(-0.0f));
+    ny = _mm_mul_ps(gy, nz);
+}
+
+// byteNormal de 4 componentes, um em cada posição de 32 bits
+__attribute__((target("sse4.1")))
+static inline __m128i bytesNormalSSE(__m128 n) {
+    return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(n, _mm_set1_ps(127.5f)), _mm_set1_ps(128.0f)));
+}
+
+// x, y e z de 4 pontos → x0 y0 z0 x1 y1 z1 x2 y2 z2 x3 y3 z3
+__attribute__((target("sse4.1")))
+static inline void gravarNormaisSSE(float* normais, __m128 x, __m128 y, __m128 z) {
+    __m128 xy01 = _mm_unpacklo_ps(x, y);                          // x0 y0 x1 y1
+    __m128 xy23 = _mm_unpackhi_ps(x, y);                          // x2 y2 x3 y3
+    __m128 zx01 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0));  // z0 z0 x1 x1
+    __m128 yz1 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1));   // y1 y1 z1 z1
+    __m128 zx23 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2));  // z2 z2 x3 x3
+    __m128 yz3 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3));   // y3 y3 z3 z3
+    _mm_storeu_ps(normais, _mm_shuffle_ps(xy01, zx01, _MM_SHUFFLE(2, 0, 1, 0)));     // x0 y0 z0 x1
+    _mm_storeu_ps(normais + 4, _mm_shuffle_ps(yz1, xy23, _MM_SHUFFLE(1, 0, 2, 0)));  // y1 z1 x2 y2
+    _mm_storeu_ps(normais + 8, _mm_shuffle_ps(zx23, yz3, _MM_SHUFFLE(2, 0, 2, 0)));  // z2 x3 y3 z3
+}
+
+__attribute__((target("sse4.1")))
+static size_t normaisSSE41(double escala, double escalaVertical, const double* acima, const double* linha,
+                           const double* abaixo, size_t col, size_t colFim, float* normais) {
+    const __m128d horizontal = _mm_set1_pd(escala * 0.5), vertical = _mm_set1_pd(escalaVertical);
+    for (; col + 4 <= colFim; col += 4, normais += 12) {
+        __m128 nx, ny, nz;
+        normalSSE(acima, linha, abaixo, col, horizontal, vertical, nx, ny, nz);
+        gravarNormaisSSE(normais, nx, ny, nz);
+    }
+    return col;
+}
+
+template <LayoutImagem L>
+__attribute__((target("sse4.1")))
+static size_t normaisPixelSSE41(double escala, double escalaVertical, const double* acima, const double* linha,
+                                const double* abaixo, size_t col, size_t colFim, const VistaImagem& saida) {
+    const __m128d horizontal = _mm_set1_pd(escala * 0.5), vertical = _mm_set1_pd(escalaVertical);
+    for (size_t i = 0; col + 4 <= colFim; col += 4, i += 4) {
+        __m128 nx, ny, nz;
+        normalSSE(acima, linha, abaixo, col, horizontal, vertical, nx, ny, nz);
+        __m128i r = bytesNormalSSE(nx), g = bytesNormalSSE(ny), b = bytesNormalSSE(nz);
+        gravarSSE<L>(_mm_or_si128(r, _mm_or_si128(_mm_slli_epi32(g, 8), _mm_slli_epi32(b, 16))), saida, i);
+    }
+    return col;
+}
+
+// Idem, 8 pontos por vez
+__attribute__((target("avx2")))
+static inline void normalAVX(const double* acima, const double* linha, const double* abaixo, size_t col,
+                             __m256d escalaHorizontal, __m256d escalaVertical, __m256& nx, __m256& ny, __m256& nz) {
+    __m256d gxBaixo = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(linha + col + 1), _mm256_loadu_pd(linha + col - 1)),
+                                    escalaHorizontal);
+    __m256d gxAlto = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(linha + col + 5), _mm256_loadu_pd(linha + col + 3)),
+                                   escalaHorizontal);
+    __m256d gyBaixo = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(abaixo + col), _mm256_loadu_pd(acima + col)),
+                                    escalaVertical);
+    __m256d gyAlto = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(abaixo + col + 4), _mm256_loadu_pd(acima + col + 4)),
+                                   escalaVertical);
+    __m256 gx = _mm256_set_m128(_mm256_cvtpd_ps(gxAlto), _mm256_cvtpd_ps(gxBaixo));
+    __m256 gy = _mm256_set_m128(_mm256_cvtpd_ps(gyAlto), _mm256_cvtpd_ps(gyBaixo));
+    __m256 q = _mm256_add_ps(_mm256_add_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(gx, gx)), _mm256_mul_ps(gy, gy));
+    nz = _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(q));
+    nx = _mm256_xor_ps(_mm256_mul_ps(gx, nz), _mm256_set1_ps(-0.0f));
+    ny = _mm256_mul_ps(gy, nz);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i bytesNormalAVX(__m256 n) {
+    return _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(n, _mm256_set1_ps(127.5f)), _mm256_set1_ps(128.0f)));
+}
+
+__attribute__((target("avx2")))
+static size_t normaisAVX2(double escala, double escalaVertical, const double* acima, const double* linha,
+                          const double* abaixo, size_t col, size_t colFim, float* normais) {
+    const __m256d horizontal = _mm256_set1_pd(escala * 0.5), vertical = _mm256_set1_pd(escalaVertical);
+    for (; col + 8 <= colFim; col += 8, normais += 24) {
+        __m256 nx, ny, nz;
+        normalAVX(acima, linha, abaixo, col, horizontal, vertical, nx, ny, nz);
+        gravarNormaisSSE(normais, _mm256_castps256_ps128(nx), _mm256_castps256_ps128(ny),
+                         _mm256_castps256_ps128(nz));
+        gravarNormaisSSE(normais + 12, _mm256_extractf128_ps(nx, 1), _mm256_extractf128_ps(ny, 1),
+                         _mm256_extractf128_ps(nz, 1));
+    }
+    return col;
+}
+
+template <LayoutImagem L>
+__attribute__((target("avx2")))
+static size_t normaisPixelAVX2(double escala, double escalaVertical, const double* acima, const double* linha,
+                               const double* abaixo, size_t col, size_t colFim, const VistaImagem& saida) {
+    const __m256d horizontal = _mm256_set1_pd(escala * 0.5), vertical = _mm256_set1_pd(escalaVertical);
+    for (size_t i = 0; col + 8 <= colFim; col += 8, i += 8) {
+        __m256 nx, ny, nz;
+        normalAVX(acima, linha, abaixo, col, horizontal, vertical, nx, ny, nz);
+        __m256i r = bytesNormalAVX(nx), g = bytesNormalAVX(ny), b = bytesNormalAVX(nz);
+        gravarAVX<L>(_mm256_or_si256(r, _mm256_or_si256(_mm256_slli_epi32(g, 8), _mm256_slli_epi32(b, 16))),
+                     saida, i);
+    }
+    return col;
+}
+
+#endif
+
+// Entre duas linhas diferentes a diferença vertical também é central; na borda, de um lado só
+static double escalaVerticalNormais(double escala, const double* acima, const double* linha, const double* abaixo) {
+    return acima != linha && abaixo != linha ? escala * 0.5 : escala;
+}
+
+void calcularNormaisLinha(double escala, const double* linhaAcima, const double* linha, const double* linhaAbaixo,
+                          size_t largura, size_t colInicio, size_t colFim, float* normais, NivelSimd nivel) {
+    double escalaVertical = escalaVerticalNormais(escala, linhaAcima, linha, linhaAbaixo);
+    size_t internoInicio = std::max<size_t>(colInicio, 1);
+    size_t internoFim = std::max(internoInicio, std::min(colFim, largura - 1));
+    size_t col = colInicio;
+    for (; col < internoInicio && col < colFim; col++) {
+        float* n = normais + 3 * (col - colInicio);
+        normalEm(escala, escalaVertical, linhaAcima, linha, linhaAbaixo, largura, col, n[0], n[1], n[2]);
+    }
+#ifdef RENDERIZACAO_X86
+    if (nivel == SIMD_AVX2) {
+        col = normaisAVX2(escala, escalaVertical, linhaAcima, linha, linhaAbaixo, col, internoFim,
+                          normais + 3 * (col - colInicio));
+    } else if (nivel == SIMD_SSE41) {
+        col = normaisSSE41(escala, escalaVertical, linhaAcima, linha, linhaAbaixo, col, internoFim,
+                           normais + 3 * (col - colInicio));
+    }
+#else
+    (void)nivel;
+#endif
+    for (; col < colFim; col++) {
+        float* n = normais + 3 * (col - colInicio);
+        normalEm(escala, escalaVertical, linhaAcima, linha, linhaAbaixo, largura, col, n[0], n[1], n[2]);
+    }
+}
+
+template <LayoutImagem L>
+static void normaisPixelLayout(double escala, const double* acima, const double* linha, const double* abaixo,
+                               size_t largura, size_t colInicio, size_t colFim, const VistaImagem& destino,
+                               NivelSimd nivel) {
+    double escalaVertical = escalaVerticalNormais(escala, acima, linha, abaixo);
+    size_t internoInicio = std::max<size_t>(colInicio, 1);
+    size_t internoFim = std::max(internoInicio, std::min(colFim, largura - 1));
+    auto pixelEm = [&](size_t col) {
+        float nx, ny, nz;
+        normalEm(escala, escalaVertical, acima, linha, abaixo, largura, col, nx, ny, nz);
+        destino.definir(col - colInicio, 0, Pixel(byteNormal(nx), byteNormal(ny), byteNormal(nz)));
+    };
+    size_t col = colInicio;
+    for (; col < internoInicio && col < colFim; col++) {
+        pixelEm(col);
+    }
+#ifdef RENDERIZACAO_X86
+    if (nivel == SIMD_AVX2) {
+        col = normaisPixelAVX2<L>(escala, escalaVertical, acima, linha, abaixo, col, internoFim,
+                                  destino.deslocada(col - colInicio, 0));
+    } else if (nivel == SIMD_SSE41) {
+        col = normaisPixelSSE41<L>(escala, escalaVertical, acima, linha, abaixo, col, internoFim,
+                                   destino.deslocada(col - colInicio, 0));
+    }
+#else
+    (void)nivel;
+#endif
+    for (; col < colFim; col++) {
+        pixelEm(col);
+    }
+}
+
+void renderizarNormaisLinha(double escala, const double* linhaAcima, const double* linha, const double* linhaAbaixo,
+                            size_t largura, size_t colInicio, size_t colFim, const VistaImagem& destino,
+                            NivelSimd nivel) {
+    switch (destino.layout) {
+        case LAYOUT_RGBA32:
+            normaisPixelLayout<LAYOUT_RGBA32>(escala, linhaAcima, linha, linhaAbaixo, largura, colInicio, colFim,
+                                              destino, nivel);
+            break;
+        case LAYOUT_PLANAR:
+            normaisPixelLayout<LAYOUT_PLANAR>(escala, linhaAcima, linha, linhaAbaixo, largura, colInicio, colFim,
+                                              destino, nivel);
+            break;
+        default:
+            normaisPixelLayout<LAYOUT_RGB24>(escala, linhaAcima, linha, linhaAbaixo, largura, colInicio, colFim,
+                                             destino, nivel);
+            break;
+    }
+}
+
+// ═══════════════════════════════════════════════════════════
+// DESPACHO
+// ═══════════════════════════════════════════════════════════
+
+static NivelSimd detectarNivelSimd() {
+#ifdef RENDERIZACAO_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return SIMD_AVX2;
+    if (__builtin_cpu_supports("sse4.1")) return SIMD_SSE41;
+#endif
+    return SIMD_ESCALAR;
+}
+
+NivelSimd obterNivelSimd() {
+    static const NivelSimd nivel = detectarNivelSimd();
+    return nivel;
+}
+
+// Laço de cor comum às duas entradas públicas, para um layout de saída
+template <LayoutImagem L>
+static void despacharLinhaLayout(const PaletaCompilada& paleta, const double* linha, const double* linhaAcima,
+                                 const double* fatores, size_t colInicio, size_t colFim,
+                                 const VistaImagem& destino, NivelSimd nivel) {
+    VistaImagem saida = destino;
+    size_t col = colInicio;
+
+    if (linhaAcima && col == 0 && col < colFim) {
+        // Primeira coluna não tem vizinho NO: sem sombra
+        col = linhaEscalar(paleta, linha, nullptr, nullptr, col, col + 1, saida);
+        saida = saida.deslocada(1, 0);
+    }
+
+    size_t feito = col;
+#ifdef RENDERIZACAO_X86
+    if (nivel == SIMD_AVX2) {
+        feito = linhaAVX2<L>(paleta, linha, linhaAcima, fatores, col, colFim, saida);
+    } else if (nivel == SIMD_SSE41) {
+        feito = linhaSSE41<L>(paleta, linha, linhaAcima, fatores, col, colFim, saida);
+    }
+#else
+    (void)nivel;
+#endif
+    // Colunas que sobraram (menos que um vetor)
+    linhaEscalar(paleta, linha, linhaAcima, fatores ? fatores + (feito - col) : nullptr, feito, colFim,
+                 saida.deslocada(feito - col, 0));
+}
+
+static void despacharLinha(const PaletaCompilada& paleta, const double* linha, const double* linhaAcima,
+                           const double* fatores, size_t colInicio, size_t colFim, const VistaImagem& destino,
+                           NivelSimd nivel) {
+    switch (destino.layout) {
+        case LAYOUT_RGBA32:
+            despacharLinhaLayout<LAYOUT_RGBA32>(paleta, linha, linhaAcima, fatores, colInicio, colFim, destino, nivel);
+            break;
+        case LAYOUT_PLANAR:
+            despacharLinhaLayout<LAYOUT_PLANAR>(paleta, linha, linhaAcima, fatores, colInicio, colFim, destino, nivel);
+            break;
+        default:
+            despacharLinhaLayout<LAYOUT_RGB24>(paleta, linha, linhaAcima, fatores, colInicio, colFim, destino, nivel);
+            break;
+    }
+}
+
+void renderizarLinha(const PaletaCompilada& paleta, const double* linha, const double* linhaAcima,
+                     size_t colInicio, size_t colFim, bool aplicarSombreamento, const VistaImagem& destino,
+                     NivelSimd nivel) {
+    despacharLinha(paleta, linha, aplicarSombreamento ? linhaAcima : nullptr, nullptr, colInicio, colFim,
+                   destino, nivel);
+}
+
+void renderizarLinhaComFatores(const PaletaCompilada& paleta, const double* linha, const double* fatores,
+                               size_t colInicio, size_t colFim, const VistaImagem& destino, NivelSimd nivel) {
+    despacharLinha(paleta, linha, nullptr, fatores, colInicio, colFim, destino, nivel);
+}
+
+void converterLinhaRGB24(const VistaImagem& origem, size_t largura, Pixel* destino, NivelSimd nivel) {
+    if (origem.layout == LAYOUT_RGB24) {
+        std::memcpy(destino, origem.canais[0], largura * sizeof(Pixel));
+        return;
+    }
+    size_t x = 0;
+#ifdef RENDERIZACAO_X86
+    unsigned char* saida = reinterpret_cast<unsigned char*>(destino);
+    if (nivel == SIMD_AVX2) {
+        x = converterAVX2(origem, largura, saida);
+    } else if (nivel == SIMD_SSE41) {
+        x = converterSSE41(origem, largura, saida);
+    }
+#else
+    (void)nivel;
+#endif
+    for (; x < largura; x++) {
+        destino[x] = origem.obter(x, 0);
+    }
+}
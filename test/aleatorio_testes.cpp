@@ -0,0 +1,56 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "aleatorio.h"
+#include <cstdlib>
+
+TEST_CASE("Testa que o gerador reproduz srand/rand da glibc") {
+#ifdef __GLIBC__
+    const uint32_t sementes[] = {0, 1, 42, 123456789, 2147483653u, 4294967295u};
+    for (uint32_t semente : sementes) {
+        CAPTURE(semente);
+        GeradorAleatorio aleatorio(semente);
+        std::srand(semente);
+        bool iguais = true;
+        for (int i = 0; i < 10000; i++) {
+            iguais = iguais && aleatorio.proximo() == std::rand();
+        }
+        CHECK(iguais);
+    }
+    CHECK(GeradorAleatorio::MAXIMO == RAND_MAX);
+#endif
+}
+
+TEST_CASE("Testa que a semente 0 equivale à semente 1") {
+    GeradorAleatorio zero(0), um(1);
+    for (int i = 0; i < 100; i++) {
+        CHECK(zero.proximo() == um.proximo());
+    }
+}
+
+TEST_CASE("Testa que avançar pula exatamente n valores") {
+    const uint64_t saltos[] = {0, 1, 30, 31, 123, 124, 1000, 1234567};
+    for (uint64_t n : saltos) {
+        CAPTURE(n);
+        GeradorAleatorio saltando(7), passo(7);
+        // Começa fora do alinhamento inicial do estado circular
+        saltando.proximo();
+        passo.proximo();
+        saltando.avancar(n);
+        for (uint64_t i = 0; i < n; i++) {
+            passo.proximo();
+        }
+        for (int i = 0; i < 64; i++) {
+            CHECK(saltando.proximo() == passo.proximo());
+        }
+    }
+}
+
+TEST_CASE("Testa saltos encadeados") {
+    GeradorAleatorio umSalto(99), doisSaltos(99);
+    umSalto.avancar(5000000);
+    doisSaltos.avancar(1234567);
+    doisSaltos.avancar(5000000 - 1234567);
+    for (int i = 0; i < 64; i++) {
+        CHECK(umSalto.proximo() == doisSaltos.proximo());
+    }
+}
@@ -0,0 +1,212 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "analise_terreno.h"
+#include "mapa_altitudes.h"
+#include "paralelo.h"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// Mapa lado × lado com a altitude dada por f(col, lin)
+template <typename F>
+static std::vector<double> montarMapa(size_t lado, F f) {
+    std::vector<double> altitudes(lado * lado);
+    for (size_t lin = 0; lin < lado; lin++) {
+        for (size_t col = 0; col < lado; col++) {
+            altitudes[lin * lado + col] = f(static_cast<double>(col), static_cast<double>(lin));
+        }
+    }
+    return altitudes;
+}
+
+static AnaliseTerreno analisar(const std::vector<double>& altitudes, size_t lado, const ParametrosAnalise& p) {
+    AnaliseTerreno a;
+    a.lado = lado;
+    a.declividade.resize(lado * lado);
+    a.orientacao.resize(lado * lado);
+    a.curvatura.resize(lado * lado);
+    analisarTerreno(altitudes.data(), lado, p, a.declividade.data(), a.orientacao.data(), a.curvatura.data());
+    return a;
+}
+
+TEST_CASE("Testa declividade e orientacao de rampas") {
+    const size_t lado = 33;
+    ParametrosAnalise p(1.0, lado);
+    // Rampa que sobe 1 de altitude por lado do mapa (com exagero 1, 1/4 de lado): 14.04 graus
+    double graus = std::atan(0.25) * 180.0 / 3.14159265358979323846;
+
+    SUBCASE("Subindo para o leste, a encosta desce para o oeste") {
+        AnaliseTerreno a = analisar(montarMapa(lado, [](double col, double) { return col / 32.0; }), lado, p);
+        size_t centro = 16 * lado + 16;
+        CHECK(a.declividade[centro] == doctest::Approx(graus).epsilon(1e-5));
+        CHECK(a.orientacao[centro] == doctest::Approx(270.0).epsilon(1e-5));
+        CHECK(std::fabs(a.curvatura[centro]) < 1e-3f);
+    }
+    SUBCASE("Subindo para o norte (linha 0), a encosta desce para o sul") {
+        AnaliseTerreno a = analisar(montarMapa(lado, [](double, double lin) { return 1.0 - lin / 32.0; }), lado, p);
+        CHECK(a.declividade[16 * lado + 16] == doctest::Approx(graus).epsilon(1e-5));
+        CHECK(a.orientacao[16 * lado + 16] == doctest::Approx(180.0).epsilon(1e-5));
+    }
+    SUBCASE("Subindo para o sudoeste, a encosta desce para o nordeste") {
+        AnaliseTerreno a = analisar(montarMapa(lado, [](double col, double lin) { return (lin - col) / 64.0; }),
+                                    lado, p);
+        CHECK(a.orientacao[16 * lado + 16] == doctest::Approx(45.0).epsilon(1e-5));
+    }
+    SUBCASE("O terreno plano nao tem orientacao") {
+        AnaliseTerreno a = analisar(std::vector<double>(lado * lado, 0.4), lado, p);
+        for (size_t i = 0; i < lado * lado; i++) {
+            CHECK(a.declividade[i] == 0.0f);
+            CHECK(a.orientacao[i] == ORIENTACAO_PLANO);
+            CHECK(a.curvatura[i] == 0.0f);
+        }
+    }
+}
+
+TEST_CASE("Testa o sinal da curvatura") {
+    const size_t lado = 65;
+    ParametrosAnalise p(1.0, lado);
+    // Paraboloide de altitude ±(x² + y²) / 2, com x e y em lados do mapa: com exagero 1 a altura
+    // em lados é 1/4 disso, ±(x² + y²) / 8, de laplaciano ±0.5 (curvatura ∓0.5)
+    auto paraboloide = [](double sinal) {
+        return [sinal](double col, double lin) {
+            double x = (col - 32.0) / 64.0, y = (lin - 32.0) / 64.0;
+            return sinal * 0.5 * (x * x + y * y);
+        };
+    };
+    AnaliseTerreno pico = analisar(montarMapa(lado, paraboloide(-1.0)), lado, p);
+    AnaliseTerreno vale = analisar(montarMapa(lado, paraboloide(1.0)), lado, p);
+    size_t centro = 32 * lado + 32;
+    CHECK(pico.curvatura[centro] == doctest::Approx(0.5).epsilon(1e-4));
+    CHECK(vale.curvatura[centro] == doctest::Approx(-0.5).epsilon(1e-4));
+    // O fundo do vale é plano; logo ao lado, a encosta desce para o centro
+    CHECK(vale.orientacao[centro] == ORIENTACAO_PLANO);
+    CHECK(vale.orientacao[32 * lado + 40] == doctest::Approx(270.0).epsilon(1e-5));
+}
+
+TEST_CASE("Testa a quantizacao das saidas") {
+    MapaAltitudes mapa;
+    mapa.gerar(6, 0.6, 3);
+    QuantizacaoAnalise q;
+    q.declividade = 5.0f;
+    q.orientacao = 45.0f;
+    q.curvatura = 0.5f;
+    AnaliseTerreno continua = mapa.analisarTerreno(2.0);
+    AnaliseTerreno classes = mapa.analisarTerreno(2.0, q);
+    REQUIRE(classes.lado == mapa.obterLinhas());
+    for (size_t i = 0; i < classes.declividade.size(); i++) {
+        CHECK(classes.declividade[i] == std::floor(continua.declividade[i] / 5.0f) * 5.0f);
+        CHECK(std::fmod(classes.declividade[i], 5.0f) == 0.0f);
+        CHECK(std::fmod(classes.curvatura[i], 0.5f) == 0.0f);
+        if (continua.orientacao[i] == ORIENTACAO_PLANO) {
+            CHECK(classes.orientacao[i] == ORIENTACAO_PLANO);
+        } else {
+            CHECK(std::fmod(classes.orientacao[i], 45.0f) == 0.0f);
+            CHECK(classes.orientacao[i] <= continua.orientacao[i]);
+        }
+    }
+}
+
+TEST_CASE("Testa que todos os niveis SIMD produzem os mesmos bits") {
+    MapaAltitudes mapa;
+    mapa.gerar(7, 0.7, 11);
+    const size_t lado = mapa.obterLinhas();
+    std::vector<double> altitudes(lado * lado);
+    for (size_t lin = 0; lin < lado; lin++) {
+        for (size_t col = 0; col < lado; col++) {
+            altitudes[lin * lado + col] = mapa.obterAltitude(lin, col);
+        }
+    }
+    QuantizacaoAnalise q;
+    q.declividade = 2.5f;
+    q.orientacao = 22.5f;
+    q.curvatura = 0.25f;
+    for (const ParametrosAnalise& p : {ParametrosAnalise(1.0, lado), ParametrosAnalise(3.0, lado, q)}) {
+        std::vector<float> declividade(lado), orientacao(lado), curvatura(lado);
+        std::vector<float> declividadeSimd(lado), orientacaoSimd(lado), curvaturaSimd(lado);
+        for (int nivel = SIMD_SSE41; nivel <= obterNivelSimd(); nivel++) {
+            bool iguais = true;
+            for (size_t lin = 0; lin < lado; lin++) {
+                const double* linha = &altitudes[lin * lado];
+                const double* acima = lin > 0 ? linha - lado : linha;
+                const double* abaixo = lin + 1 < lado ? linha + lado : linha;
+                // Começo e fim fora do alinhamento, para passar pelas bordas e pela cauda escalar
+                analisarLinha(p, acima, linha, abaixo, lado, 0, lado, declividade.data(), orientacao.data(),
+                              curvatura.data(), SIMD_ESCALAR);
+                analisarLinha(p, acima, linha, abaixo, lado, 0, lado, declividadeSimd.data(), orientacaoSimd.data(),
+                              curvaturaSimd.data(), static_cast<NivelSimd>(nivel));
+                iguais = iguais && declividade == declividadeSimd && orientacao == orientacaoSimd
+                    && curvatura == curvaturaSimd;
+                analisarLinha(p, acima, linha, abaixo, lado, 3, lado - 2, declividadeSimd.data(),
+                              orientacaoSimd.data(), curvaturaSimd.data(), static_cast<NivelSimd>(nivel));
+                for (size_t col = 3; col < lado - 2; col++) {
+                    iguais = iguais && declividadeSimd[col - 3] == declividade[col]
+                        && orientacaoSimd[col - 3] == orientacao[col] && curvaturaSimd[col - 3] == curvatura[col];
+                }
+            }
+            CHECK(iguais);
+        }
+    }
+}
+
+TEST_CASE("Testa que a analise nao depende do numero de threads") {
+    MapaAltitudes mapa;
+    mapa.gerar(9, 0.6, 5);
+    definirNumThreads(1);
+    AnaliseTerreno serial = mapa.analisarTerreno(1.5);
+    definirNumThreads(4);
+    AnaliseTerreno paralela = mapa.analisarTerreno(1.5);
+    definirNumThreads(0);
+    CHECK(serial.declividade == paralela.declividade);
+    CHECK(serial.orientacao == paralela.orientacao);
+    CHECK(serial.curvatura == paralela.curvatura);
+}
+
+TEST_CASE("Testa a exportacao dos rasters") {
+    const size_t lado = 5;
+    std::vector<float> valores(lado * lado);
+    for (size_t i = 0; i < valores.size(); i++) {
+        valores[i] = static_cast<float>(i) * 5.0f;  // De 0 a 120
+    }
+
+    SUBCASE("PGM de 16 bits com saturacao") {
+        const char* nome = "teste_analise.pgm";
+        REQUIRE(salvarRasterPGM(nome, valores.data(), lado, 0.0, 90.0));
+        std::ifstream arquivo(nome, std::ios::binary);
+        std::string conteudo((std::istreambuf_iterator<char>(arquivo)), std::istreambuf_iterator<char>());
+        std::string cabecalho = "P5\n5 5\n65535\n";
+        REQUIRE(conteudo.size() == cabecalho.size() + 2 * lado * lado);
+        CHECK(conteudo.compare(0, cabecalho.size(), cabecalho) == 0);
+        auto amostra = [&](size_t i) {
+            const unsigned char* b = reinterpret_cast<const unsigned char*>(conteudo.data() + cabecalho.size());
+            return (b[2 * i] << 8) | b[2 * i + 1];
+        };
+        CHECK(amostra(0) == 0);
+        CHECK(amostra(9) == 32768);  // 45 de 90: metade, arredondada como em salvarPGM
+        CHECK(amostra(18) == 65535);
+        CHECK(amostra(24) == 65535);
+        std::remove(nome);
+        CHECK_FALSE(salvarRasterPGM("diretorio_inexistente/x.pgm", valores.data(), lado, 0.0, 90.0));
+    }
+    SUBCASE("Imagem colorida pela paleta") {
+        Paleta paleta;
+        paleta.adicionarCor(Cor {0, 0, 255});
+        paleta.adicionarCor(Cor {255, 0, 0});
+        Imagem rgb = colorirRaster(valores.data(), lado, 0.0, 120.0, paleta);
+        Imagem planar = colorirRaster(valores.data(), lado, 0.0, 120.0, paleta, LAYOUT_PLANAR);
+        CHECK(rgb(0, 0).b == 255);
+        CHECK(rgb(0, 0).r == 0);
+        CHECK(rgb(4, 4).r == 255);
+        CHECK(rgb(4, 4).b == 0);
+        bool iguais = true;
+        for (size_t lin = 0; lin < lado; lin++) {
+            for (size_t col = 0; col < lado; col++) {
+                Pixel a = rgb(col, lin), b = planar.obterPixel(col, lin);
+                iguais = iguais && a.r == b.r && a.g == b.g && a.b == b.b;
+            }
+        }
+        CHECK(iguais);
+    }
+}
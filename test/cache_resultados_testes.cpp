@@ -0,0 +1,90 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "cache_resultados.h"
+#include "arquivo_io.h"
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <cstdio>
+#include <unistd.h>
+
+// Grava um arquivo com o texto dado
+static void gravarTexto(const char* nome, const std::string& texto) {
+    std::ofstream arquivo(nome, std::ios::binary);
+    arquivo << texto;
+}
+
+static std::string lerTexto(const char* nome) {
+    std::ifstream arquivo(nome, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(arquivo)), std::istreambuf_iterator<char>());
+}
+
+// Apaga as entradas e os contadores de um diretório de cache de teste
+static void limparCache(const std::string& diretorio, const char* const* nomes, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        std::remove((diretorio + "/" + nomes[i]).c_str());
+    }
+    std::remove((diretorio + "/contadores").c_str());
+}
+
+TEST_CASE("Testa que a chave depende dos parâmetros e do conteúdo da paleta") {
+    gravarTexto("teste_paleta_cache.hex", "#000000\n#ffffff\n");
+    std::string chave = calcularChaveTerreno(5, 0.5, 42, "teste_paleta_cache.hex", true, "png");
+    CHECK(chave.size() == 16);
+    CHECK(chave == calcularChaveTerreno(5, 0.5, 42, "teste_paleta_cache.hex", true, "png"));
+    CHECK(chave != calcularChaveTerreno(6, 0.5, 42, "teste_paleta_cache.hex", true, "png"));
+    CHECK(chave != calcularChaveTerreno(5, 0.50001, 42, "teste_paleta_cache.hex", true, "png"));
+    CHECK(chave != calcularChaveTerreno(5, 0.5, 43, "teste_paleta_cache.hex", true, "png"));
+    CHECK(chave != calcularChaveTerreno(5, 0.5, 42, "teste_paleta_cache.hex", false, "png"));
+    CHECK(chave != calcularChaveTerreno(5, 0.5, 42, "teste_paleta_cache.hex", true, "ppm-binario"));
+    
+    // Mesmo nome de arquivo, conteúdo diferente
+    gravarTexto("teste_paleta_cache.hex", "#000000\n#fffffe\n");
+    CHECK(chave != calcularChaveTerreno(5, 0.5, 42, "teste_paleta_cache.hex", true, "png"));
+    
+    CHECK(calcularChaveTerreno(5, 0.5, 42, "paleta_inexistente.hex", true, "png").empty());
+}
+
+TEST_CASE("Testa falha, gravação e acerto no cache") {
+    const char* nomes[] = {"0000000000000001.ppm"};
+    limparCache("teste_cache", nomes, 1);
+    CacheResultados cache("teste_cache", 1024 * 1024);
+    REQUIRE(cache.aberto());
+    
+    CHECK_FALSE(cache.buscar("0000000000000001", ".ppm", "teste_cache_saida.ppm"));
+    CHECK(cache.obterFalhas() == 1);
+    
+    gravarTexto("teste_cache_origem.ppm", "P3\n1 1\n255\n1 2 3\n");
+    CHECK(cache.guardar("0000000000000001", ".ppm", "teste_cache_origem.ppm"));
+    
+    CHECK(cache.buscar("0000000000000001", ".ppm", "teste_cache_saida.ppm"));
+    CHECK(cache.obterAcertos() == 1);
+    CHECK(lerTexto("teste_cache_saida.ppm") == "P3\n1 1\n255\n1 2 3\n");
+    
+    // Reescrever a saída (hard link da entrada) não pode alterar a entrada do cache
+    {
+        ArquivoSaida saida("teste_cache_saida.ppm");
+        CHECK(saida.escrever("outro", 5));
+    }
+    CHECK(lerTexto("teste_cache_saida.ppm") == "outro");
+    CHECK(lerTexto("teste_cache/0000000000000001.ppm") == "P3\n1 1\n255\n1 2 3\n");
+}
+
+TEST_CASE("Testa que o cache descarta a entrada usada há mais tempo") {
+    const char* nomes[] = {"000000000000000a.txt", "000000000000000b.txt", "000000000000000c.txt"};
+    limparCache("teste_cache_lru", nomes, 3);
+    CacheResultados cache("teste_cache_lru", 250);  // Cabem duas entradas de 100 bytes
+    
+    gravarTexto("teste_cache_origem.txt", std::string(100, 'x'));
+    CHECK(cache.guardar("000000000000000a", ".txt", "teste_cache_origem.txt"));
+    usleep(20000);
+    CHECK(cache.guardar("000000000000000b", ".txt", "teste_cache_origem.txt"));
+    usleep(20000);
+    CHECK(cache.buscar("000000000000000a", ".txt", "teste_cache_saida.txt"));  // "a" fica mais recente
+    usleep(20000);
+    CHECK(cache.guardar("000000000000000c", ".txt", "teste_cache_origem.txt"));
+    
+    CHECK(cache.buscar("000000000000000a", ".txt", "teste_cache_saida.txt"));
+    CHECK_FALSE(cache.buscar("000000000000000b", ".txt", "teste_cache_saida.txt"));
+    CHECK(cache.buscar("000000000000000c", ".txt", "teste_cache_saida.txt"));
+}
@@ -0,0 +1,211 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "curvas_nivel.h"
+#include "mapa_altitudes.h"
+#include "paralelo.h"
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Cone invertido: a altitude é a distância ao centro do mapa
+static std::vector<double> mapaCone(size_t lado) {
+    std::vector<double> mapa(lado * lado);
+    double centro = (lado - 1) / 2.0;
+    for (size_t lin = 0; lin < lado; lin++) {
+        for (size_t col = 0; col < lado; col++) {
+            mapa[lin * lado + col] = std::hypot(lin - centro, col - centro);
+        }
+    }
+    return mapa;
+}
+
+// Rampa que sobe 0.01 por coluna
+static std::vector<double> mapaRampa(size_t lado) {
+    std::vector<double> mapa(lado * lado);
+    for (size_t i = 0; i < mapa.size(); i++) {
+        mapa[i] = (i % lado) * 0.01;
+    }
+    return mapa;
+}
+
+static bool mesmoPonto(const PontoCurva& a, const PontoCurva& b) {
+    return a.x == b.x && a.y == b.y;
+}
+
+TEST_CASE("Testa os níveis calculados") {
+    std::vector<double> altitudes = {0.12, 0.5, 0.37, 0.91};
+    std::vector<double> niveis = calcularNiveis(altitudes.data(), altitudes.size(), 0.25);
+    REQUIRE(niveis.size() == 3);
+    CHECK(niveis[0] == 0.25);
+    CHECK(niveis[1] == 0.5);
+    CHECK(niveis[2] == 0.75);
+    CHECK(calcularNiveis(altitudes.data(), altitudes.size(), 0.0).empty());
+}
+
+TEST_CASE("Testa curvas fechadas em volta de um vale") {
+    const size_t lado = 65;
+    std::vector<double> mapa = mapaCone(lado);
+    std::vector<CurvaNivel> curvas = extrairCurvasNivel(mapa.data(), lado, {5.0, 10.5, 20.0});
+    REQUIRE(curvas.size() == 3);
+    for (const CurvaNivel& curva : curvas) {
+        CHECK(curva.fechada);
+        REQUIRE(curva.pontos.size() > 8);
+        CHECK(mesmoPonto(curva.pontos.front(), curva.pontos.back()));
+        // Os pontos ficam no círculo (a menos da interpolação linear)
+        for (const PontoCurva& p : curva.pontos) {
+            CHECK(std::fabs(std::hypot(p.x - 32, p.y - 32) - curva.altitude) < 0.1);
+        }
+    }
+}
+
+TEST_CASE("Testa curvas abertas na borda do mapa") {
+    const size_t lado = 40;
+    std::vector<double> mapa = mapaRampa(lado);
+    std::vector<CurvaNivel> curvas = extrairCurvasNivel(mapa.data(), lado, {0.105});
+    REQUIRE(curvas.size() == 1);
+    CHECK_FALSE(curvas[0].fechada);
+    REQUIRE(curvas[0].pontos.size() == lado);
+    for (const PontoCurva& p : curvas[0].pontos) {
+        CHECK(p.x == doctest::Approx(10.5));
+    }
+    // Em ordem ao longo da curva, de uma borda à outra
+    double inicio = curvas[0].pontos.front().y, fim = curvas[0].pontos.back().y;
+    CHECK(std::min(inicio, fim) == 0.0);
+    CHECK(std::max(inicio, fim) == lado - 1.0);
+}
+
+TEST_CASE("Testa a emenda das curvas entre faixas") {
+    // Círculos que atravessam várias faixas de linhas viram uma curva só
+    const size_t lado = 401;
+    std::vector<double> mapa = mapaCone(lado);
+    std::vector<CurvaNivel> curvas = extrairCurvasNivel(mapa.data(), lado, {50.5, 150.5, 199.5});
+    REQUIRE(curvas.size() == 3);
+    for (const CurvaNivel& curva : curvas) {
+        CHECK(curva.fechada);
+        // Pontos consecutivos são de células vizinhas
+        for (size_t i = 1; i < curva.pontos.size(); i++) {
+            CHECK(std::fabs(curva.pontos[i].x - curva.pontos[i - 1].x) <= 1.0);
+            CHECK(std::fabs(curva.pontos[i].y - curva.pontos[i - 1].y) <= 1.0);
+        }
+    }
+}
+
+TEST_CASE("Testa curvas de um terreno gerado") {
+    MapaAltitudes mapa;
+    mapa.gerar(8, 0.6, 7);
+    std::vector<double> niveis = mapa.niveisCurvas(0.02);
+    REQUIRE(niveis.size() > 10);
+
+    definirNumThreads(1);
+    std::vector<CurvaNivel> curvas = mapa.extrairCurvasNivel(niveis);
+    definirNumThreads(4);
+    std::vector<CurvaNivel> curvasParalelo = mapa.extrairCurvasNivel(niveis);
+    definirNumThreads(0);
+
+    SUBCASE("O resultado não depende do número de threads") {
+        REQUIRE(curvas.size() == curvasParalelo.size());
+        for (size_t i = 0; i < curvas.size(); i++) {
+            CHECK(curvas[i].altitude == curvasParalelo[i].altitude);
+            CHECK(curvas[i].fechada == curvasParalelo[i].fechada);
+            REQUIRE(curvas[i].pontos.size() == curvasParalelo[i].pontos.size());
+            for (size_t j = 0; j < curvas[i].pontos.size(); j++) {
+                CHECK(mesmoPonto(curvas[i].pontos[j], curvasParalelo[i].pontos[j]));
+            }
+        }
+    }
+    SUBCASE("As curvas abertas só terminam na borda do mapa") {
+        double borda = mapa.obterLinhas() - 1.0;
+        auto naBorda = [&](const PontoCurva& p) {
+            return p.x == 0.0 || p.y == 0.0 || p.x == borda || p.y == borda;
+        };
+        for (const CurvaNivel& curva : curvas) {
+            if (curva.fechada) {
+                CHECK(mesmoPonto(curva.pontos.front(), curva.pontos.back()));
+            } else {
+                CHECK(naBorda(curva.pontos.front()));
+                CHECK(naBorda(curva.pontos.back()));
+            }
+        }
+    }
+}
+
+TEST_CASE("Testa o desenho das curvas sobre a imagem") {
+    const size_t lado = 40;
+    std::vector<double> mapa = mapaRampa(lado);
+    std::vector<Pixel> pixels(lado * lado, Pixel(255, 255, 255));
+    desenharCurvasNivel(mapa.data(), lado, {0.105}, Pixel(0, 0, 0), 1.0, 0, lado, VistaImagem(pixels.data(), lado));
+    for (size_t lin = 0; lin < lado; lin++) {
+        const Pixel* linha = &pixels[lin * lado];
+        CHECK(linha[9].r == 255);
+        CHECK(linha[10].r == 128);  // A meio pixel da curva: cobertura 0.5
+        CHECK(linha[11].g == 128);
+        CHECK(linha[12].b == 255);
+    }
+
+    SUBCASE("Faixas e threads dão a mesma imagem") {
+        MapaAltitudes terreno;
+        terreno.gerar(7, 0.6, 3);
+        std::vector<double> niveis = terreno.niveisCurvas(0.01);
+        Imagem img1(129, 129), img2(129, 129);
+        definirNumThreads(1);
+        CHECK(terreno.desenharCurvasNivel(img1, niveis, Pixel(200, 10, 10), 0.7));
+        definirNumThreads(3);
+        CHECK(terreno.desenharCurvasNivel(img2, niveis, Pixel(200, 10, 10), 0.7));
+        definirNumThreads(0);
+        bool iguais = true;
+        for (size_t lin = 0; lin < 129; lin++) {
+            for (size_t col = 0; col < 129; col++) {
+                const Pixel& a = img1(col, lin);
+                const Pixel& b = img2(col, lin);
+                iguais = iguais && a.r == b.r && a.g == b.g && a.b == b.b;
+            }
+        }
+        CHECK(iguais);
+        // A mistura é feita direto no layout da imagem
+        Imagem rgba(129, 129, LAYOUT_RGBA32);
+        CHECK(terreno.desenharCurvasNivel(rgba, niveis, Pixel(200, 10, 10), 0.7));
+        for (size_t lin = 0; lin < 129; lin++) {
+            for (size_t col = 0; col < 129; col++) {
+                Pixel a = rgba.obterPixel(col, lin);
+                const Pixel& b = img1(col, lin);
+                iguais = iguais && a.r == b.r && a.g == b.g && a.b == b.b;
+            }
+        }
+        CHECK(iguais);
+        Imagem outra(100, 129);
+        CHECK_FALSE(terreno.desenharCurvasNivel(outra, niveis, Pixel(0, 0, 0)));
+    }
+}
+
+TEST_CASE("Testa a gravação das curvas em SVG e GeoJSON") {
+    const size_t lado = 65;
+    std::vector<double> mapa = mapaCone(lado);
+    std::vector<CurvaNivel> curvas = extrairCurvasNivel(mapa.data(), lado, {10.5, 40.0});
+    REQUIRE(curvas.size() >= 2);
+
+    REQUIRE(salvarCurvasSVG("teste_curvas.svg", curvas, lado));
+    std::ifstream svg("teste_curvas.svg");
+    std::stringstream textoSvg;
+    textoSvg << svg.rdbuf();
+    CHECK(textoSvg.str().find("viewBox=\"-0.5 -0.5 65 65\"") != std::string::npos);
+    CHECK(textoSvg.str().find("data-altitude=\"10.5\"") != std::string::npos);
+    CHECK(textoSvg.str().find(" Z\"/>") != std::string::npos);
+    CHECK(textoSvg.str().rfind("</svg>\n") == textoSvg.str().size() - 7);
+
+    REQUIRE(salvarCurvasGeoJSON("teste_curvas.geojson", curvas));
+    std::ifstream json("teste_curvas.geojson");
+    std::stringstream textoJson;
+    textoJson << json.rdbuf();
+    CHECK(textoJson.str().find("\"type\":\"FeatureCollection\"") == 1);
+    CHECK(textoJson.str().find("{\"altitude\":40}") != std::string::npos);
+    // Uma LineString por curva
+    size_t numLinhas = 0;
+    for (size_t pos = 0; (pos = textoJson.str().find("LineString", pos)) != std::string::npos; pos++) {
+        numLinhas++;
+    }
+    CHECK(numLinhas == curvas.size());
+
+    CHECK_FALSE(salvarCurvasSVG("/diretorio_inexistente/x.svg", curvas, lado));
+}
@@ -0,0 +1,50 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "deflate.h"
+#include <cstring>
+#include <vector>
+
+TEST_CASE("Testa o CRC-32 com o valor de referência") {
+    const char* texto = "123456789";
+    const unsigned char* dados = reinterpret_cast<const unsigned char*>(texto);
+    CHECK(calcularCRC32(dados, 9) == 0xCBF43926u);
+
+    // Calcular em partes deve dar o mesmo resultado
+    uint32_t parcial = calcularCRC32(dados, 4);
+    CHECK(calcularCRC32(dados + 4, 5, parcial) == 0xCBF43926u);
+}
+
+TEST_CASE("Testa o Adler-32 e a combinação de pedaços") {
+    const char* texto = "Wikipedia";
+    const unsigned char* dados = reinterpret_cast<const unsigned char*>(texto);
+    CHECK(calcularAdler32(dados, 9) == 0x11E60398u);
+
+    uint32_t primeiro = calcularAdler32(dados, 3);
+    uint32_t segundo = calcularAdler32(dados + 3, 6);
+    CHECK(combinarAdler32(primeiro, segundo, 6) == 0x11E60398u);
+}
+
+TEST_CASE("Testa o nível 0 (blocos stored) do deflate") {
+    std::vector<unsigned char> dados(70000);
+    for (size_t i = 0; i < dados.size(); i++) dados[i] = static_cast<unsigned char>(i * 7);
+
+    std::vector<unsigned char> saida;
+    comprimirDeflate(dados.data(), dados.size(), 0, true, saida);
+
+    // Dois blocos stored (65535 + 4465 bytes), cada um com 5 bytes de cabeçalho,
+    // mais o bloco final vazio de 2 bytes
+    REQUIRE(saida.size() == dados.size() + 5 + 5 + 2);
+    CHECK(saida[0] == 0x00);  // Não final, tipo stored
+    CHECK(saida[1] == 0xFF);  // LEN = 65535
+    CHECK(saida[2] == 0xFF);
+    CHECK(std::memcmp(saida.data() + 5, dados.data(), 65535) == 0);
+}
+
+TEST_CASE("Testa que o deflate comprime dados repetitivos") {
+    std::vector<unsigned char> dados(100000);
+    for (size_t i = 0; i < dados.size(); i++) dados[i] = static_cast<unsigned char>("terreno"[i % 7]);
+
+    std::vector<unsigned char> saida;
+    comprimirDeflate(dados.data(), dados.size(), 1, true, saida);
+    CHECK(saida.size() < dados.size() / 50);
+}
@@ -0,0 +1,50 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "gerador_linhas.h"
+#include "mapa_altitudes.h"
+#include <vector>
+
+// Compara as linhas do gerador com o mapa de MapaAltitudes::gerar, ponto a ponto
+static bool mesmasAltitudes(int N, double rugosidade, unsigned int semente) {
+    MapaAltitudes mapa;
+    mapa.gerar(N, rugosidade, semente);
+    GeradorLinhas gerador(N, rugosidade, semente);
+    if (gerador.obterTamanho() != mapa.obterLinhas()) {
+        return false;
+    }
+    std::vector<double> linha(gerador.obterTamanho());
+    for (size_t lin = 0; lin < gerador.obterTamanho(); lin++) {
+        gerador.proximaLinha(linha.data());
+        for (size_t col = 0; col < linha.size(); col++) {
+            if (linha[col] != mapa.obterAltitude(lin, col)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+TEST_CASE("Testa que as linhas são as mesmas de gerar()") {
+    const double rugosidades[] = {0.0, 0.5, 1.0};
+    const unsigned int sementes[] = {0, 1, 99, 4000000000u};
+    for (int N = 0; N <= 8; N++) {
+        for (double rugosidade : rugosidades) {
+            for (unsigned int semente : sementes) {
+                CAPTURE(N);
+                CAPTURE(rugosidade);
+                CAPTURE(semente);
+                CHECK(mesmasAltitudes(N, rugosidade, semente));
+            }
+        }
+    }
+}
+
+TEST_CASE("Testa um mapa grande") {
+    // 2049×2049: onze níveis encadeados, com trechos longos da sequência pulados
+    CHECK(mesmasAltitudes(11, 0.6, 2024));
+}
+
+TEST_CASE("Testa o tamanho") {
+    CHECK(GeradorLinhas(0, 0.5, 1).obterTamanho() == 2);
+    CHECK(GeradorLinhas(5, 0.5, 1).obterTamanho() == 33);
+}
@@ -0,0 +1,154 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "horizonte.h"
+#include "paralelo.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+// Mapa plano com um muro de altitude 1 na coluna dada
+static std::vector<double> mapaComMuro(size_t lado, size_t colunaMuro) {
+    std::vector<double> mapa(lado * lado, 0.0);
+    for (size_t lin = 0; lin < lado; lin++) {
+        mapa[lin * lado + colunaMuro] = 1.0;
+    }
+    return mapa;
+}
+
+TEST_CASE("Testa a sombra de um muro") {
+    // Lado 33: o muro mede (33 - 1) / 4 = 8 pontos de altura
+    const size_t lado = 33;
+    std::vector<double> mapa = mapaComMuro(lado, 10);
+    std::vector<float> mascara(lado * lado);
+
+    SUBCASE("Luz do oeste a 45°: sombra de 8 pontos a leste") {
+        calcularSombrasProjetadas(mapa.data(), lado, 270.0, 45.0, 1.0, mascara.data());
+        for (size_t lin = 0; lin < lado; lin++) {
+            const float* linha = &mascara[lin * lado];
+            CHECK(linha[9] == 1.0f);
+            CHECK(linha[10] == 1.0f);  // O topo do muro é iluminado
+            CHECK(linha[11] == FATOR_SOMBRA_PROJETADA);
+            CHECK(linha[17] == FATOR_SOMBRA_PROJETADA);
+            CHECK(linha[19] == 1.0f);  // Na ponta (coluna 18) a conta empata
+        }
+    }
+    SUBCASE("Luz do leste: sombra a oeste") {
+        calcularSombrasProjetadas(mapa.data(), lado, 90.0, 45.0, 1.0, mascara.data());
+        CHECK(mascara[5 * lado + 9] == FATOR_SOMBRA_PROJETADA);
+        CHECK(mascara[5 * lado + 1] == 1.0f);
+        CHECK(mascara[5 * lado + 11] == 1.0f);
+    }
+    SUBCASE("Exagero 2 dobra a sombra") {
+        calcularSombrasProjetadas(mapa.data(), lado, 270.0, 45.0, 2.0, mascara.data());
+        CHECK(mascara[lado + 25] == FATOR_SOMBRA_PROJETADA);
+        CHECK(mascara[lado + 27] == 1.0f);
+    }
+    SUBCASE("Luz a pino: nenhuma sombra") {
+        calcularSombrasProjetadas(mapa.data(), lado, 270.0, 90.0, 1.0, mascara.data());
+        CHECK(std::vector<float>(lado * lado, 1.0f) == mascara);
+    }
+}
+
+TEST_CASE("Testa a sombra de um pico na diagonal") {
+    // Pico no centro; luz de noroeste: sombra para sudeste
+    const size_t lado = 65;
+    std::vector<double> mapa(lado * lado, 0.0);
+    mapa[32 * lado + 32] = 0.5;
+    std::vector<float> mascara(lado * lado);
+    calcularSombrasProjetadas(mapa.data(), lado, 315.0, 30.0, 1.0, mascara.data());
+    CHECK(mascara[36 * lado + 36] == FATOR_SOMBRA_PROJETADA);
+    CHECK(mascara[28 * lado + 28] == 1.0f);
+    CHECK(mascara[36 * lado + 28] == 1.0f);
+}
+
+TEST_CASE("Testa que a máscara não depende do número de threads") {
+    const size_t lado = 129;
+    std::vector<double> mapa(lado * lado);
+    std::srand(5);
+    for (double& a : mapa) {
+        a = std::rand() / static_cast<double>(RAND_MAX);
+    }
+    for (double azimute : {0.0, 30.0, 135.0, 200.0, 290.0}) {
+        definirNumThreads(1);
+        std::vector<float> serial(lado * lado), paralela(lado * lado);
+        calcularSombrasProjetadas(mapa.data(), lado, azimute, 10.0, 1.0, serial.data());
+        definirNumThreads(4);
+        calcularSombrasProjetadas(mapa.data(), lado, azimute, 10.0, 1.0, paralela.data());
+        CHECK(serial == paralela);
+    }
+    definirNumThreads(0);
+}
+
+TEST_CASE("Testa a oclusão ambiente em casos simples") {
+    const size_t lado = 33;
+    std::vector<float> visibilidade(lado * lado);
+
+    SUBCASE("Plano: céu inteiro visível") {
+        std::vector<double> plano(lado * lado, 0.3);
+        calcularOclusaoAmbiente(plano.data(), lado, 8, 1.0, visibilidade.data());
+        CHECK(std::vector<float>(lado * lado, 1.0f) == visibilidade);
+    }
+    SUBCASE("Fundo de um poço e topo de um pico") {
+        std::vector<double> mapa(lado * lado, 0.5);
+        mapa[16 * lado + 16] = 0.0;  // Poço estreito
+        mapa[5 * lado + 5] = 1.0;    // Pico isolado
+        calcularOclusaoAmbiente(mapa.data(), lado, 16, 1.0, visibilidade.data());
+        CHECK(visibilidade[16 * lado + 16] < 0.1f);
+        CHECK(visibilidade[5 * lado + 5] == 1.0f);
+        CHECK(visibilidade[5 * lado + 6] < 1.0f);  // Ao lado do pico, parte do céu some
+    }
+    SUBCASE("Sem direções: sem oclusão") {
+        std::vector<double> mapa(lado * lado, 0.0);
+        mapa[16 * lado + 16] = 1.0;
+        calcularOclusaoAmbiente(mapa.data(), lado, 0, 1.0, visibilidade.data());
+        CHECK(std::vector<float>(lado * lado, 1.0f) == visibilidade);
+    }
+}
+
+TEST_CASE("Testa que o fecho convexo acha o mesmo horizonte da busca exaustiva") {
+    // Altitude só muda de uma linha para outra; com 2 direções (norte e sul) cada coluna
+    // é uma reta, e o horizonte pode ser conferido olhando todos os pontos dela
+    const size_t lado = 65;
+    const double escala = (lado - 1) / 4.0;
+    std::vector<double> perfil(lado), mapa(lado * lado);
+    std::srand(11);
+    for (size_t lin = 0; lin < lado; lin++) {
+        perfil[lin] = std::rand() / static_cast<double>(RAND_MAX);
+        for (size_t col = 0; col < lado; col++) {
+            mapa[lin * lado + col] = perfil[lin];
+        }
+    }
+    std::vector<float> visibilidade(lado * lado);
+    calcularOclusaoAmbiente(mapa.data(), lado, 2, 1.0, visibilidade.data());
+
+    for (size_t lin = 0; lin < lado; lin++) {
+        double senoNorte = 0.0, senoSul = 0.0;
+        for (size_t outra = 0; outra < lado; outra++) {
+            if (outra == lin) continue;
+            double distancia = outra < lin ? double(lin - outra) : double(outra - lin);
+            double inclinacao = (perfil[outra] - perfil[lin]) * escala / distancia;
+            double seno = inclinacao > 0 ? inclinacao / std::sqrt(1.0 + inclinacao * inclinacao) : 0.0;
+            double& maior = outra < lin ? senoNorte : senoSul;
+            maior = std::max(maior, seno);
+        }
+        double esperado = 1.0 - (senoNorte + senoSul) / 2.0;
+        CHECK(visibilidade[lin * lado + 7] == doctest::Approx(esperado).epsilon(1e-5));
+    }
+}
+
+TEST_CASE("Testa que a oclusão ambiente não depende do número de threads") {
+    const size_t lado = 129;
+    std::vector<double> mapa(lado * lado);
+    std::srand(9);
+    for (double& a : mapa) {
+        a = std::rand() / static_cast<double>(RAND_MAX);
+    }
+    definirNumThreads(1);
+    std::vector<float> serial(lado * lado), paralela(lado * lado);
+    calcularOclusaoAmbiente(mapa.data(), lado, 16, 1.5, serial.data());
+    definirNumThreads(3);
+    calcularOclusaoAmbiente(mapa.data(), lado, 16, 1.5, paralela.data());
+    CHECK(serial == paralela);
+    definirNumThreads(0);
+}
@@ -1,6 +1,15 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 #include "imagem.h"
+#include "deflate.h"
+#include "escritor_imagem.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
 
 TEST_CASE("Testa a criação de uma imagem com largura e altura específicas") {
     Imagem img(100, 50);
@@ -20,8 +29,13 @@ TEST_CASE("Testa a modificação e acesso aos pixels da imagem") {
 }
 
 TEST_CASE("Testa a leitura de uma imagem em formato PPM") {
+    std::ofstream arquivo("imagem.ppm");
+    arquivo << "P3\n3 2\n255\n255 0 0\n0 255 0\n0 0 255\n255 255 0\n255 255 255\n0 0 0\n";
+    arquivo.close();
+
     Imagem img;
     bool sucesso = img.lerPPM("imagem.ppm");
+    std::remove("imagem.ppm");
     CHECK(sucesso);
     CHECK(img.obterLargura() == 3);
     CHECK(img.obterAltura() == 2);
@@ -79,4 +93,527 @@ TEST_CASE("Testa a salvamento da imagem em formato PPM") {
     CHECK(conteudo == "255 255 0");
 
     arquivo.close();
-}
\ No newline at end of file
+}
+
+TEST_CASE("Testa o salvamento da imagem em formato PPM binário (P6)") {
+    Imagem img(3, 1);
+    img(0, 0) = {255, 0, 0};
+    img(1, 0) = {0, 128, 0};
+    img(2, 0) = {1, 2, 3};
+
+    CHECK(img.salvarPPM("teste_p6.ppm", PPM_BINARIO));
+
+    std::ifstream arquivo("teste_p6.ppm", std::ios::binary);
+    std::string conteudo((std::istreambuf_iterator<char>(arquivo)), std::istreambuf_iterator<char>());
+    std::string esperado = "P6\n3 1\n255\n";
+    esperado += std::string("\xFF\x00\x00\x00\x80\x00\x01\x02\x03", 9);
+    CHECK(conteudo == esperado);
+    arquivo.close();
+    std::remove("teste_p6.ppm");
+}
+
+TEST_CASE("Testa a escolha automática do formato PPM pelo tamanho da imagem") {
+    Imagem pequena(4, 4);
+    CHECK(pequena.salvarPPM("teste_auto.ppm"));
+    std::ifstream arquivo1("teste_auto.ppm");
+    std::string tipo;
+    std::getline(arquivo1, tipo);
+    CHECK(tipo == "P3");
+    arquivo1.close();
+
+    Imagem grande(300, 300);  // Acima de LIMITE_PIXELS_TEXTO
+    CHECK(grande.salvarPPM("teste_auto.ppm"));
+    std::ifstream arquivo2("teste_auto.ppm");
+    std::getline(arquivo2, tipo);
+    CHECK(tipo == "P6");
+    arquivo2.close();
+
+    // Forçar texto continua possível em imagens grandes
+    CHECK(grande.salvarPPM("teste_auto.ppm", PPM_TEXTO));
+    std::ifstream arquivo3("teste_auto.ppm");
+    std::getline(arquivo3, tipo);
+    CHECK(tipo == "P3");
+    arquivo3.close();
+    std::remove("teste_auto.ppm");
+}
+
+TEST_CASE("Testa a leitura de PPM texto (P3) com comentários") {
+    std::ofstream arquivo("teste_comentarios.ppm");
+    arquivo << "P3\n# criado por um editor\n2 1 # largura e altura\n255\n";
+    arquivo << "# primeiro pixel\n10 20 30\n  40\t50 60 # fim\n";
+    arquivo.close();
+
+    Imagem img;
+    CHECK(img.lerPPM("teste_comentarios.ppm"));
+    REQUIRE(img.obterLargura() == 2);
+    CHECK(img(0, 0).r == 10);
+    CHECK(img(0, 0).b == 30);
+    CHECK(img(1, 0).g == 50);
+    CHECK(img(1, 0).b == 60);
+}
+
+TEST_CASE("Testa que P6 salvo e lido de volta reproduz a imagem") {
+    Imagem original(17, 5);
+    for (size_t y = 0; y < 5; y++) {
+        for (size_t x = 0; x < 17; x++) {
+            original(x, y) = Pixel(x * 15, y * 50, (x * y) % 256);
+        }
+    }
+    CHECK(original.salvarPPM("teste_ida_volta.ppm", PPM_BINARIO));
+
+    Imagem lida;
+    CHECK(lida.lerPPM("teste_ida_volta.ppm"));
+    REQUIRE(lida.obterLargura() == 17);
+    REQUIRE(lida.obterAltura() == 5);
+    bool iguais = true;
+    for (size_t y = 0; y < 5; y++) {
+        for (size_t x = 0; x < 17; x++) {
+            if (lida(x, y).r != original(x, y).r || lida(x, y).g != original(x, y).g ||
+                lida(x, y).b != original(x, y).b) {
+                iguais = false;
+            }
+        }
+    }
+    CHECK(iguais);
+    std::remove("teste_ida_volta.ppm");
+}
+
+TEST_CASE("Testa a leitura de PGM binário (P5) de 16 bits") {
+    std::ofstream arquivo("teste_cinza16.pgm", std::ios::binary);
+    arquivo << "P5\n2 1\n65535\n";
+    arquivo.write("\xFF\xFF\x80\x00", 4);  // 65535 e 32768 (big-endian)
+    arquivo.close();
+
+    Imagem img;
+    CHECK(img.lerPPM("teste_cinza16.pgm"));
+    REQUIRE(img.obterLargura() == 2);
+    CHECK(img(0, 0).r == 255);
+    CHECK(img(0, 0).g == 255);
+    CHECK(img(1, 0).r == 128);
+    CHECK(img(1, 0).b == 128);
+}
+
+TEST_CASE("Testa a rejeição de PPM truncado ou inválido") {
+    std::ofstream arquivo1("teste_truncado.ppm", std::ios::binary);
+    arquivo1 << "P6\n4 4\n255\n" << "abc";
+    arquivo1.close();
+    Imagem img;
+    CHECK_FALSE(img.lerPPM("teste_truncado.ppm"));
+
+    std::ofstream arquivo2("teste_invalido.ppm");
+    arquivo2 << "P3\n1 1\n255\n10 20 abc\n";
+    arquivo2.close();
+    CHECK_FALSE(img.lerPPM("teste_invalido.ppm"));
+    
+    // Dimensões absurdas são recusadas antes de alocar
+    std::ofstream arquivo3("teste_enorme.ppm", std::ios::binary);
+    arquivo3 << "P6\n4294967296 4294967296\n255\n";
+    arquivo3.close();
+    CHECK_FALSE(img.lerPPM("teste_enorme.ppm"));
+    
+    std::ofstream arquivo4("teste_enorme.ppm");
+    arquivo4 << "P3\n200000 200000\n255\n1 2 3";
+    arquivo4.close();
+    CHECK_FALSE(img.lerPPM("teste_enorme.ppm"));
+    std::remove("teste_enorme.ppm");
+    
+    // O último número sem separador depois dele continua aceito
+    std::ofstream arquivo5("teste_enorme.ppm");
+    arquivo5 << "P3\n1 1\n255\n1 2 3";
+    arquivo5.close();
+    CHECK(img.lerPPM("teste_enorme.ppm"));
+    CHECK(img(0, 0).b == 3);
+    std::remove("teste_enorme.ppm");
+}
+
+// Lê um inteiro de 32 bits big-endian
+static uint32_t lerU32BE(const std::string& s, size_t pos) {
+    return (static_cast<uint32_t>(static_cast<unsigned char>(s[pos])) << 24) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(s[pos + 1])) << 16) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(s[pos + 2])) << 8) |
+           static_cast<uint32_t>(static_cast<unsigned char>(s[pos + 3]));
+}
+
+TEST_CASE("Testa a estrutura e o conteúdo do PNG sem compressão") {
+    Imagem img(5, 4);
+    for (size_t y = 0; y < 4; y++) {
+        for (size_t x = 0; x < 5; x++) {
+            img(x, y) = Pixel(x * 50, y * 60, 7);
+        }
+    }
+    CHECK(img.salvarPNG("teste.png", 0));
+
+    std::ifstream arquivo("teste.png", std::ios::binary);
+    std::string png((std::istreambuf_iterator<char>(arquivo)), std::istreambuf_iterator<char>());
+    REQUIRE(png.size() > 8);
+    CHECK(png.compare(0, 8, "\x89PNG\r\n\x1a\n") == 0);
+
+    // Percorre os chunks conferindo os CRCs e juntando os dados dos IDAT
+    std::string zlib, primeiro;
+    size_t pos = 8;
+    bool crcsOk = true;
+    while (pos + 12 <= png.size()) {
+        uint32_t tamanho = lerU32BE(png, pos);
+        std::string tipo = png.substr(pos + 4, 4);
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(png.data() + pos + 4);
+        if (calcularCRC32(bytes, 4 + tamanho) != lerU32BE(png, pos + 8 + tamanho)) crcsOk = false;
+        if (primeiro.empty()) primeiro = tipo;
+        if (tipo == "IHDR") {
+            CHECK(lerU32BE(png, pos + 8) == 5);
+            CHECK(lerU32BE(png, pos + 12) == 4);
+            CHECK(png[pos + 16] == 8);  // bits por canal
+            CHECK(png[pos + 17] == 2);  // RGB
+        }
+        if (tipo == "IDAT") zlib += png.substr(pos + 8, tamanho);
+        pos += 12 + tamanho;
+    }
+    CHECK(crcsOk);
+    CHECK(primeiro == "IHDR");
+    CHECK(pos == png.size());
+
+    // Nível 0: após o cabeçalho zlib vêm blocos stored (1 + 4 bytes de cabeçalho cada)
+    // até o bloco final vazio; os dados são as linhas com filtro 0 na frente
+    std::string esperado;
+    for (size_t y = 0; y < 4; y++) {
+        esperado += '\0';
+        for (size_t x = 0; x < 5; x++) {
+            esperado += static_cast<char>(img(x, y).r);
+            esperado += static_cast<char>(img(x, y).g);
+            esperado += static_cast<char>(img(x, y).b);
+        }
+    }
+    std::string descomprimido;
+    size_t p = 2;
+    while (p < zlib.size() && (static_cast<unsigned char>(zlib[p]) & 0x06) == 0) {
+        size_t tamanho = static_cast<unsigned char>(zlib[p + 1]) | (static_cast<unsigned char>(zlib[p + 2]) << 8);
+        descomprimido += zlib.substr(p + 5, tamanho);
+        p += 5 + tamanho;
+    }
+    CHECK(descomprimido == esperado);
+
+    const unsigned char* bytesEsperados = reinterpret_cast<const unsigned char*>(esperado.data());
+    CHECK(lerU32BE(zlib, zlib.size() - 4) == calcularAdler32(bytesEsperados, esperado.size()));
+}
+
+TEST_CASE("Testa que o PNG comprimido é menor que os pixels crus") {
+    Imagem img(200, 150);
+    for (size_t y = 0; y < 150; y++) {
+        for (size_t x = 0; x < 200; x++) {
+            img(x, y) = Pixel(x, y, (x + y) / 2);  // Gradiente suave
+        }
+    }
+    CHECK(img.salvarPNG("teste.png", 6));
+
+    std::ifstream arquivo("teste.png", std::ios::binary | std::ios::ate);
+    CHECK(static_cast<size_t>(arquivo.tellg()) < 200 * 150 * 3 / 10);
+
+    Imagem vazia;
+    CHECK_FALSE(vazia.salvarPNG("teste_vazio.png"));
+}
+
+// Junta os dados dos chunks IDAT de um PNG
+static std::string extrairIDAT(const std::string& png) {
+    std::string zlib;
+    for (size_t pos = 8; pos + 12 <= png.size(); pos += 12 + lerU32BE(png, pos)) {
+        if (png.compare(pos + 4, 4, "IDAT") == 0) zlib += png.substr(pos + 8, lerU32BE(png, pos));
+    }
+    return zlib;
+}
+
+// Descompressor deflate mínimo (RFC 1951), independente do compressor testado: decodifica
+// os códigos de Huffman canônicos símbolo a símbolo, sem tabelas de aceleração
+class Inflador {
+public:
+    explicit Inflador(const std::string& dados) : dados(dados), pos(0), bit(0) {}
+
+    // Descomprime o fluxo inteiro; tiposBloco[t] conta os blocos de cada tipo (0 a 2)
+    bool inflar(std::string& saida, size_t tiposBloco[3]) {
+        bool final = false;
+        while (!final) {
+            final = ler(1) == 1;
+            unsigned tipo = ler(2);
+            if (tipo > 2 || pos > dados.size()) return false;
+            tiposBloco[tipo]++;
+            if (tipo == 0) {
+                if (bit != 0) { pos++; bit = 0; }
+                if (pos + 4 > dados.size()) return false;
+                size_t tamanho = byte(pos) | (byte(pos + 1) << 8);
+                if ((tamanho ^ 0xFFFF) != (byte(pos + 2) | (byte(pos + 3) << 8))) return false;
+                if (pos + 4 + tamanho > dados.size()) return false;
+                saida += dados.substr(pos + 4, tamanho);
+                pos += 4 + tamanho;
+                continue;
+            }
+            std::vector<int> literais(288, 0), distancias(30, 0);
+            if (tipo == 1) {
+                for (int i = 0; i < 288; i++) literais[i] = i < 144 ? 8 : i < 256 ? 9 : i < 280 ? 7 : 8;
+                for (int i = 0; i < 30; i++) distancias[i] = 5;
+            } else if (!lerCodigos(literais, distancias)) {
+                return false;
+            }
+            if (!inflarBloco(Huffman(literais), Huffman(distancias), saida)) return false;
+        }
+        return true;
+    }
+
+private:
+    struct Huffman {
+        std::vector<int> contagem, simbolos;
+        explicit Huffman(const std::vector<int>& comprimentos) : contagem(16, 0) {
+            for (int c : comprimentos) contagem[c]++;
+            contagem[0] = 0;
+            std::vector<int> inicio(16, 0);
+            for (int c = 1; c < 16; c++) inicio[c] = inicio[c - 1] + contagem[c - 1];
+            simbolos.resize(comprimentos.size());
+            for (size_t s = 0; s < comprimentos.size(); s++) {
+                if (comprimentos[s] != 0) simbolos[inicio[comprimentos[s]]++] = static_cast<int>(s);
+            }
+        }
+    };
+
+    std::string dados;
+    size_t pos;
+    int bit;
+
+    unsigned byte(size_t i) const { return static_cast<unsigned char>(dados[i]); }
+
+    // Lê n bits, do menos significativo para o mais (fora do fim, lê zeros)
+    unsigned ler(int n) {
+        unsigned valor = 0;
+        for (int i = 0; i < n; i++) {
+            unsigned b = pos < dados.size() ? (byte(pos) >> bit) & 1 : 0;
+            valor |= b << i;
+            if (++bit == 8) { bit = 0; pos++; }
+        }
+        return valor;
+    }
+
+    // Os códigos de Huffman chegam bit a bit a partir do mais significativo
+    int decodificar(const Huffman& h) {
+        int codigo = 0, primeiro = 0, indice = 0;
+        for (int c = 1; c < 16; c++) {
+            codigo |= static_cast<int>(ler(1));
+            int quantos = h.contagem[c];
+            if (codigo - quantos < primeiro) return h.simbolos[indice + (codigo - primeiro)];
+            indice += quantos;
+            primeiro = (primeiro + quantos) << 1;
+            codigo <<= 1;
+        }
+        return -1;
+    }
+
+    bool lerCodigos(std::vector<int>& literais, std::vector<int>& distancias) {
+        static const int ordem[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+        size_t nLiterais = ler(5) + 257, nDistancias = ler(5) + 1, nCodigos = ler(4) + 4;
+        std::vector<int> comprimentosCodigos(19, 0);
+        for (size_t i = 0; i < nCodigos; i++) comprimentosCodigos[ordem[i]] = static_cast<int>(ler(3));
+        Huffman codigos(comprimentosCodigos);
+        std::vector<int> comprimentos;
+        while (comprimentos.size() < nLiterais + nDistancias) {
+            int simbolo = decodificar(codigos);
+            if (simbolo < 0) return false;
+            if (simbolo < 16) {
+                comprimentos.push_back(simbolo);
+                continue;
+            }
+            if (simbolo == 16 && comprimentos.empty()) return false;
+            int valor = simbolo == 16 ? comprimentos.back() : 0;
+            unsigned repeticoes = simbolo == 16 ? 3 + ler(2) : simbolo == 17 ? 3 + ler(3) : 11 + ler(7);
+            comprimentos.insert(comprimentos.end(), repeticoes, valor);
+        }
+        if (comprimentos.size() != nLiterais + nDistancias) return false;
+        std::copy(comprimentos.begin(), comprimentos.begin() + nLiterais, literais.begin());
+        std::copy(comprimentos.begin() + nLiterais, comprimentos.end(), distancias.begin());
+        return true;
+    }
+
+    bool inflarBloco(const Huffman& literais, const Huffman& distancias, std::string& saida) {
+        static const int baseComprimento[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                                35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+        static const int extraComprimento[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                                 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+        static const int baseDistancia[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129,
+                                              193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097,
+                                              6145, 8193, 12289, 16385, 24577};
+        static const int extraDistancia[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6,
+                                               6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+        for (;;) {
+            if (pos > dados.size()) return false;
+            int simbolo = decodificar(literais);
+            if (simbolo < 0 || simbolo > 285) return false;
+            if (simbolo < 256) {
+                saida += static_cast<char>(simbolo);
+                continue;
+            }
+            if (simbolo == 256) return true;
+            size_t comprimento = baseComprimento[simbolo - 257] + ler(extraComprimento[simbolo - 257]);
+            int codigo = decodificar(distancias);
+            if (codigo < 0 || codigo > 29) return false;
+            size_t distancia = baseDistancia[codigo] + ler(extraDistancia[codigo]);
+            if (distancia > saida.size()) return false;
+            // Cópia byte a byte: a origem pode se sobrepor ao que está sendo escrito
+            for (size_t i = 0; i < comprimento; i++) saida += saida[saida.size() - distancia];
+        }
+    }
+};
+
+// Desfaz os filtros PNG (RGB de 8 bits) e compara com os pixels da imagem
+static bool pixelsIguais(const std::string& filtrado, const Imagem& img) {
+    const size_t largura = img.obterLargura(), altura = img.obterAltura(), bytes = largura * 3;
+    if (filtrado.size() != altura * (bytes + 1)) return false;
+    std::vector<unsigned char> anterior(bytes, 0), linha(bytes);
+    for (size_t y = 0; y < altura; y++) {
+        int filtro = static_cast<unsigned char>(filtrado[y * (bytes + 1)]);
+        for (size_t i = 0; i < bytes; i++) {
+            int x = static_cast<unsigned char>(filtrado[y * (bytes + 1) + 1 + i]);
+            int a = i >= 3 ? linha[i - 3] : 0, b = anterior[i], c = i >= 3 ? anterior[i - 3] : 0;
+            int p = a + b - c, pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+            int paeth = pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+            int preditor[5] = {0, a, b, (a + b) / 2, paeth};
+            if (filtro > 4) return false;
+            linha[i] = static_cast<unsigned char>(x + preditor[filtro]);
+        }
+        for (size_t x = 0; x < largura; x++) {
+            const Pixel& px = img(x, y);
+            if (linha[3 * x] != px.r || linha[3 * x + 1] != px.g || linha[3 * x + 2] != px.b) return false;
+        }
+        anterior.swap(linha);
+    }
+    return true;
+}
+
+TEST_CASE("Testa que o PNG comprimido descomprime para os mesmos pixels") {
+    // Gradiente com faixas repetidas e ruído: literais, repetições (LZ77) e todos os filtros.
+    // 1000 colunas dividem a imagem em vários pedaços comprimidos em paralelo
+    Imagem img(1000, 300);
+    uint32_t semente = 12345;
+    for (size_t y = 0; y < 300; y++) {
+        for (size_t x = 0; x < 1000; x++) {
+            semente = semente * 1103515245u + 12345u;
+            unsigned char ruido = (y / 50) % 2 == 0 ? static_cast<unsigned char>(semente >> 24) & 7 : 0;
+            img(x, y) = Pixel((x / 4) & 255, ((x / 40) * 16 + y) & 255, ((x + y) / 3 + ruido) & 255);
+        }
+    }
+    for (int nivel : {1, 6, 9}) {
+        CAPTURE(nivel);
+        REQUIRE(img.salvarPNG("teste.png", nivel));
+        std::ifstream arquivo("teste.png", std::ios::binary);
+        std::string png((std::istreambuf_iterator<char>(arquivo)), std::istreambuf_iterator<char>());
+        std::string zlib = extrairIDAT(png);
+        REQUIRE(zlib.size() > 6);
+        CHECK((static_cast<unsigned char>(zlib[0]) * 256 + static_cast<unsigned char>(zlib[1])) % 31 == 0);
+
+        std::string filtrado;
+        size_t tiposBloco[3] = {0, 0, 0};
+        Inflador inflador(zlib.substr(2, zlib.size() - 6));
+        REQUIRE(inflador.inflar(filtrado, tiposBloco));
+        CHECK(tiposBloco[2] > 0);  // Passou pelo Huffman dinâmico, não só por blocos stored
+        CHECK(pixelsIguais(filtrado, img));
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(filtrado.data());
+        CHECK(lerU32BE(zlib, zlib.size() - 4) == calcularAdler32(bytes, filtrado.size()));
+    }
+}
+
+TEST_CASE("Testa que escrever em faixas gera o mesmo arquivo que salvar de uma vez") {
+    // 1000 colunas: ~87 linhas por pedaço PNG, então faixas de 7 linhas cruzam pedaços
+    Imagem img(1000, 300);
+    for (size_t y = 0; y < 300; y++) {
+        for (size_t x = 0; x < 1000; x++) {
+            img(x, y) = Pixel((x * 7 + y) & 255, (x ^ y) & 255, (x * y) >> 6 & 255);
+        }
+    }
+    CHECK(img.salvarPNG("teste.png"));
+    CHECK(img.salvarPPM("teste.ppm", PPM_TEXTO));
+    
+    EscritorPNG png("teste_faixas.png", 1000, 300);
+    EscritorPPM ppm("teste_faixas.ppm", 1000, 300, PPM_TEXTO);
+    for (size_t y = 0; y < 300; y += 7) {
+        size_t linhas = std::min<size_t>(7, 300 - y);
+        CHECK(png.escreverLinhas(&img(0, y), linhas));
+        CHECK(ppm.escreverLinhas(&img(0, y), linhas));
+    }
+    CHECK(png.finalizar());
+    CHECK(ppm.finalizar());
+    
+    std::ifstream a("teste.png", std::ios::binary), b("teste_faixas.png", std::ios::binary);
+    std::string esperado((std::istreambuf_iterator<char>(a)), std::istreambuf_iterator<char>());
+    std::string obtido((std::istreambuf_iterator<char>(b)), std::istreambuf_iterator<char>());
+    CHECK(obtido == esperado);
+    
+    std::ifstream c("teste.ppm", std::ios::binary), d("teste_faixas.ppm", std::ios::binary);
+    std::string esperadoPPM((std::istreambuf_iterator<char>(c)), std::istreambuf_iterator<char>());
+    std::string obtidoPPM((std::istreambuf_iterator<char>(d)), std::istreambuf_iterator<char>());
+    CHECK(obtidoPPM == esperadoPPM);
+    
+    // Linhas a menos que a altura declarada: finalizar falha
+    EscritorPNG incompleto("teste_faixas.png", 1000, 300);
+    CHECK(incompleto.escreverLinhas(&img(0, 0), 10));
+    CHECK_FALSE(incompleto.finalizar());
+}
+
+TEST_CASE("Testa os layouts RGBA32 e planar") {
+    // 37 colunas: nem múltiplo de 4, 8 ou 16, então as linhas têm preenchimento
+    const size_t largura = 37, altura = 5;
+    Imagem rgb(largura, altura);
+    for (size_t y = 0; y < altura; y++) {
+        for (size_t x = 0; x < largura; x++) {
+            rgb(x, y) = Pixel((x * 7 + y) & 255, (x ^ y) & 255, (x * y * 13) & 255);
+        }
+    }
+    CHECK(rgb.salvarPPM("teste_p6.ppm", PPM_BINARIO));
+    CHECK(rgb.salvarPNG("teste.png"));
+    std::ifstream a("teste_p6.ppm", std::ios::binary), b("teste.png", std::ios::binary);
+    std::string esperadoPPM((std::istreambuf_iterator<char>(a)), std::istreambuf_iterator<char>());
+    std::string esperadoPNG((std::istreambuf_iterator<char>(b)), std::istreambuf_iterator<char>());
+
+    for (LayoutImagem layout : {LAYOUT_RGBA32, LAYOUT_PLANAR}) {
+        Imagem img(largura, altura, layout);
+        CHECK(img.obterLayout() == layout);
+        CHECK(img.obterPasso() % Imagem::ALINHAMENTO_LINHAS == 0);
+        CHECK(img.obterPasso() >= (layout == LAYOUT_RGBA32 ? 4 : 1) * largura);
+        VistaImagem vista = img.obterVista();
+        // Toda linha (de cada plano) começa num endereço alinhado
+        size_t numPlanos = layout == LAYOUT_PLANAR ? 3 : 1;
+        for (size_t c = 0; c < numPlanos; c++) {
+            CHECK(reinterpret_cast<size_t>(vista.deslocada(0, altura - 1).canais[c]) % Imagem::ALINHAMENTO_LINHAS == 0);
+        }
+        CHECK(img.obterPixel(36, 4).r == 0);
+        if (layout == LAYOUT_RGBA32) {
+            CHECK(vista.canais[0][4 * 10 + 3] == 255);  // Preto opaco
+        }
+
+        for (size_t y = 0; y < altura; y++) {
+            for (size_t x = 0; x < largura; x++) {
+                img.definirPixel(x, y, rgb(x, y));
+            }
+        }
+        Pixel p = img.obterPixel(20, 3);
+        CHECK(p.r == rgb(20, 3).r);
+        CHECK(p.g == rgb(20, 3).g);
+        CHECK(p.b == rgb(20, 3).b);
+
+        // A conversão para RGB intercalado só acontece ao salvar: mesmos arquivos do RGB24
+        CHECK(img.salvarPPM("teste_p6.ppm", PPM_BINARIO));
+        CHECK(img.salvarPNG("teste.png"));
+        std::ifstream c("teste_p6.ppm", std::ios::binary), d("teste.png", std::ios::binary);
+        std::string obtidoPPM((std::istreambuf_iterator<char>(c)), std::istreambuf_iterator<char>());
+        std::string obtidoPNG((std::istreambuf_iterator<char>(d)), std::istreambuf_iterator<char>());
+        CHECK(obtidoPPM == esperadoPPM);
+        CHECK(obtidoPNG == esperadoPNG);
+    }
+    std::remove("teste_p6.ppm");
+}
+
+TEST_CASE("Testa a vista de uma imagem vazia") {
+    for (LayoutImagem layout : {LAYOUT_RGB24, LAYOUT_RGBA32, LAYOUT_PLANAR}) {
+        Imagem vazia(0, 0, layout);
+        VistaImagem vista = vazia.obterVista();
+        CHECK(vista.layout == layout);
+        CHECK(vista.canais[0] == nullptr);
+        CHECK(vista.canais[1] == nullptr);
+        CHECK(vista.canais[2] == nullptr);
+        CHECK(vista.passoPixel == (layout == LAYOUT_RGBA32 ? 4u : layout == LAYOUT_PLANAR ? 1u : 3u));
+    }
+    Imagem padrao;
+    CHECK(padrao.obterVista().canais[0] == nullptr);
+}
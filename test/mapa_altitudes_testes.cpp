@@ -1,9 +1,19 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 #include "mapa_altitudes.h"
+#include "mapa_compactado.h"
+#include "arquivo_io.h"
+#include "escritor_imagem.h"
+#include "paleta.h"
+#include "paralelo.h"
 #include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
+#include <iterator>
+#include <string>
 #include <algorithm>
+#include <vector>
 
 using namespace std;
 
@@ -128,4 +138,767 @@ TEST_CASE("Testa tamanhos diferentes de mapa") {
     
     MapaAltitudes mapa4(5);  // 2^5 + 1 = 33×33
     CHECK(mapa4.obterLinhas() == 33);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Testa que salvar e ler preservam exatamente as altitudes") {
+    MapaAltitudes original;
+    original.gerar(6, 0.7);  // 65×65, valores com muitos dígitos significativos
+    
+    CHECK(original.salvar("teste_ida_volta.txt"));
+    
+    MapaAltitudes lido;
+    CHECK(lido.ler("teste_ida_volta.txt"));
+    REQUIRE(lido.obterLinhas() == original.obterLinhas());
+    
+    // Comparação exata (sem tolerância): o texto deve reproduzir o mesmo double
+    bool iguais = true;
+    for (size_t i = 0; i < original.obterLinhas(); i++) {
+        for (size_t j = 0; j < original.obterColunas(); j++) {
+            if (lido.obterAltitude(i, j) != original.obterAltitude(i, j)) {
+                iguais = false;
+            }
+        }
+    }
+    CHECK(iguais);
+}
+
+TEST_CASE("Testa exportação e importação de PGM 16 bits") {
+    MapaAltitudes original;
+    original.gerar(5, 0.5);  // 33×33 (quantidade de valores não múltipla de 8)
+    
+    CHECK(original.salvarPGM("teste_mapa.pgm", -1.0, 2.0));
+    
+    // Verifica cabeçalho e tamanho do arquivo
+    ifstream arquivo("teste_mapa.pgm", ios::binary);
+    string tipo;
+    size_t largura, altura, maxval;
+    arquivo >> tipo >> largura >> altura >> maxval;
+    CHECK(tipo == "P5");
+    CHECK(largura == 33);
+    CHECK(altura == 33);
+    CHECK(maxval == 65535);
+    arquivo.seekg(0, ios::end);
+    CHECK(static_cast<size_t>(arquivo.tellg()) == string("P5\n33 33\n65535\n").size() + 33 * 33 * 2);
+    arquivo.close();
+    
+    MapaAltitudes lido;
+    CHECK(lido.lerPGM("teste_mapa.pgm", -1.0, 2.0));
+    REQUIRE(lido.obterLinhas() == 33);
+    
+    // Erro máximo é meio passo de quantização
+    double meioPasso = 3.0 / 65535 / 2;
+    double erroMaximo = 0.0;
+    for (size_t i = 0; i < 33; i++) {
+        for (size_t j = 0; j < 33; j++) {
+            double alt = min(2.0, max(-1.0, original.obterAltitude(i, j)));
+            erroMaximo = max(erroMaximo, fabs(lido.obterAltitude(i, j) - alt));
+        }
+    }
+    CHECK(erroMaximo <= meioPasso * 1.0001);
+}
+
+TEST_CASE("Testa leitura de PGM 8 bits com comentário no cabeçalho") {
+    ofstream arquivo("teste_mapa8.pgm", ios::binary);
+    arquivo << "P5\n# gerado a mao\n2 2\n255\n";
+    arquivo.put(static_cast<char>(0));
+    arquivo.put(static_cast<char>(255));
+    arquivo.put(static_cast<char>(51));
+    arquivo.put(static_cast<char>(102));
+    arquivo.close();
+    
+    MapaAltitudes mapa;
+    CHECK(mapa.lerPGM("teste_mapa8.pgm"));
+    REQUIRE(mapa.obterLinhas() == 2);
+    CHECK(mapa.obterAltitude(0, 0) == 0.0);
+    CHECK(mapa.obterAltitude(0, 1) == 1.0);
+    CHECK(mapa.obterAltitude(1, 0) == doctest::Approx(0.2));
+    CHECK(mapa.obterAltitude(1, 1) == doctest::Approx(0.4));
+}
+
+TEST_CASE("Testa que dimensões absurdas são recusadas antes de alocar") {
+    MapaAltitudes mapa;
+    
+    SUBCASE("PGM cujo produto das dimensões estoura size_t") {
+        ofstream arquivo("teste_mapa_absurdo.pgm", ios::binary);
+        arquivo << "P5\n4294967296 4294967296\n255\n";
+        arquivo.put(static_cast<char>(0));
+        arquivo.close();
+        CHECK_FALSE(mapa.lerPGM("teste_mapa_absurdo.pgm"));
+    }
+    SUBCASE("PGM com dimensões maiores que o arquivo") {
+        ofstream arquivo("teste_mapa_absurdo.pgm", ios::binary);
+        arquivo << "P5\n8194 8194\n255\n";
+        arquivo << string(8194 * 8193, '\0');
+        arquivo.close();
+        CHECK_FALSE(mapa.lerPGM("teste_mapa_absurdo.pgm"));
+    }
+    SUBCASE("Mapa em texto com dimensões maiores que o arquivo") {
+        ofstream arquivo("teste_mapa_absurdo.txt");
+        arquivo << "100000000 100000000\n0.5\n";
+        arquivo.close();
+        CHECK_FALSE(mapa.ler("teste_mapa_absurdo.txt"));
+    }
+    CHECK(mapa.obterLinhas() == 0);
+    remove("teste_mapa_absurdo.pgm");
+    remove("teste_mapa_absurdo.txt");
+}
+
+TEST_CASE("Testa mapa em texto que ocupa o mínimo de bytes por altitude") {
+    ofstream arquivo("teste_mapa_minimo.txt");
+    arquivo << "2 2\n1 2 3 4";
+    arquivo.close();
+    MapaAltitudes mapa;
+    CHECK(mapa.ler("teste_mapa_minimo.txt"));
+    REQUIRE(mapa.obterLinhas() == 2);
+    CHECK(mapa.obterAltitude(1, 1) == 4.0);
+    remove("teste_mapa_minimo.txt");
+}
+
+TEST_CASE("Testa saturação de altitudes fora do intervalo no PGM") {
+    MapaAltitudes mapa;
+    mapa.gerar(4, 1.0);  // Rugosidade alta: valores saem de [0, 1]
+    CHECK(mapa.salvarPGM("teste_mapa.pgm", 0.25, 0.75));
+    
+    MapaAltitudes lido;
+    CHECK(lido.lerPGM("teste_mapa.pgm", 0.25, 0.75));
+    for (size_t i = 0; i < lido.obterLinhas(); i++) {
+        for (size_t j = 0; j < lido.obterColunas(); j++) {
+            CHECK(lido.obterAltitude(i, j) >= 0.25);
+            CHECK(lido.obterAltitude(i, j) <= 0.75);
+        }
+    }
+}
+
+TEST_CASE("Testa salvamento compactado respeitando o erro máximo") {
+    MapaAltitudes original;
+    original.gerar(7, 0.6);  // 129×129: com tiles de 32 sobram tiles de borda 1×32, 32×1 e 1×1
+    
+    const double erroMaximo = 1e-4;
+    CHECK(original.salvarCompactado("teste_mapa.mapc", erroMaximo, 32));
+    
+    MapaAltitudes lido;
+    CHECK(lido.lerCompactado("teste_mapa.mapc"));
+    REQUIRE(lido.obterLinhas() == 129);
+    
+    double erro = 0.0;
+    for (size_t i = 0; i < 129; i++) {
+        for (size_t j = 0; j < 129; j++) {
+            erro = max(erro, fabs(lido.obterAltitude(i, j) - original.obterAltitude(i, j)));
+        }
+    }
+    CHECK(erro <= erroMaximo * 1.000001);
+    
+    // Deve ocupar bem menos que os 8 bytes por altitude do formato bruto
+    ifstream arquivo("teste_mapa.mapc", ios::binary | ios::ate);
+    CHECK(static_cast<size_t>(arquivo.tellg()) < 129 * 129 * 8 / 2);
+}
+
+TEST_CASE("Testa decodificação isolada de um tile compactado") {
+    MapaAltitudes original;
+    original.gerar(6, 0.5);  // 65×65
+    CHECK(original.salvarCompactado("teste_mapa.mapc", 1e-6, 16));
+    
+    MapaCompactado arquivo("teste_mapa.mapc");
+    REQUIRE(arquivo.ehValido());
+    CHECK(arquivo.obterTamanho() == 65);
+    CHECK(arquivo.obterTilesPorLado() == 5);
+    
+    // Tile (2, 3): linhas 32-47, colunas 48-63
+    vector<double> tile(16 * 16);
+    CHECK(arquivo.decodificarTile(2, 3, tile.data(), 16));
+    double erro = 0.0;
+    for (size_t i = 0; i < 16; i++) {
+        for (size_t j = 0; j < 16; j++) {
+            erro = max(erro, fabs(tile[i * 16 + j] - original.obterAltitude(32 + i, 48 + j)));
+        }
+    }
+    CHECK(erro <= 1e-6 * 1.000001);
+    
+    CHECK_FALSE(arquivo.decodificarTile(5, 0, tile.data(), 16));  // Fora do mapa
+}
+
+TEST_CASE("Testa leitura de uma janela de um arquivo compactado") {
+    MapaAltitudes original;
+    original.gerar(8, 0.5);  // 257×257
+    CHECK(original.salvarCompactado("teste_mapa.mapc", 1e-6, 32));
+    
+    MapaAltitudes completo;
+    REQUIRE(completo.lerCompactado("teste_mapa.mapc"));
+    
+    // Janela que corta tiles nas quatro bordas e inclui a borda do mapa à direita
+    MapaAltitudes janela;
+    REQUIRE(janela.lerRegiaoCompactado("teste_mapa.mapc", 45, 157, 100));
+    CHECK(janela.obterLinhas() == 100);
+    bool iguais = true;
+    for (size_t i = 0; i < 100; i++) {
+        for (size_t j = 0; j < 100; j++) {
+            if (janela.obterAltitude(i, j) != completo.obterAltitude(45 + i, 157 + j)) {
+                iguais = false;
+            }
+        }
+    }
+    CHECK(iguais);
+    
+    // Região retangular direto pelo leitor
+    MapaCompactado arquivo("teste_mapa.mapc");
+    vector<double> regiao(3 * 70);
+    CHECK(arquivo.lerRegiao(250, 10, 3, 70, regiao.data(), 70));
+    CHECK(regiao[2 * 70 + 69] == completo.obterAltitude(252, 79));
+    
+    CHECK_FALSE(janela.lerRegiaoCompactado("teste_mapa.mapc", 200, 0, 100));  // Passa do fim
+    CHECK_FALSE(arquivo.lerRegiao(0, 0, 1, 258, regiao.data(), 258));
+}
+
+TEST_CASE("Testa leitura de arquivo compactado inválido") {
+    ofstream arquivo("teste_mapa_invalido.mapc", ios::binary);
+    arquivo << "isto nao e um mapa compactado";
+    arquivo.close();
+    
+    MapaAltitudes mapa;
+    CHECK_FALSE(mapa.lerCompactado("teste_mapa_invalido.mapc"));
+    CHECK_FALSE(mapa.lerCompactado("arquivo_inexistente.mapc"));
+}
+
+// Grava um cabeçalho compactado (versão 1) seguido de uma tabela de deslocamentos zerada
+// (ou, com bytesPorTile > 0, de um único tile com esse número de bytes)
+static void gravarCabecalhoCompactado(const char* nome, uint64_t tamanho, uint32_t ladoTile, size_t bytesTabela,
+                                      uint64_t bytesPorTile = 0) {
+    vector<unsigned char> dados = {'M', 'A', 'P', 'C', 1, 0, 0, 0};
+    for (int i = 0; i < 8; i++) dados.push_back(static_cast<unsigned char>(tamanho >> (8 * i)));
+    for (int i = 0; i < 4; i++) dados.push_back(static_cast<unsigned char>(ladoTile >> (8 * i)));
+    double passo = 1e-3;
+    uint64_t bitsPasso;
+    memcpy(&bitsPasso, &passo, sizeof(passo));
+    for (int i = 0; i < 8; i++) dados.push_back(static_cast<unsigned char>(bitsPasso >> (8 * i)));
+    dados.resize(dados.size() + bytesTabela, 0);
+    if (bytesPorTile > 0) {
+        uint64_t deslocamentos[2] = {dados.size(), dados.size() + bytesPorTile};
+        for (size_t t = 0; t < 2; t++) {
+            for (int i = 0; i < 8; i++) dados[28 + 8 * t + i] = static_cast<unsigned char>(deslocamentos[t] >> (8 * i));
+        }
+        dados.resize(dados.size() + bytesPorTile, 0);
+    }
+    ofstream arquivo(nome, ios::binary);
+    arquivo.write(reinterpret_cast<const char*>(dados.data()), dados.size());
+}
+
+TEST_CASE("Testa que cabeçalhos compactados absurdos são recusados antes de alocar") {
+    const char* nome = "teste_mapa_invalido.mapc";
+    // Lado de 2^32 com tiles de 1: a tabela transbordaria size_t
+    gravarCabecalhoCompactado(nome, uint64_t(1) << 32, 1, 80);
+    CHECK_FALSE(MapaCompactado(nome).ehValido());
+    // Tile de 2^32 - 1: um único tile, mas buffers de dezenas de GB na leitura
+    gravarCabecalhoCompactado(nome, uint64_t(1) << 32, 0xffffffffu, 80);
+    CHECK_FALSE(MapaCompactado(nome).ehValido());
+    // Tile maior que o mapa
+    gravarCabecalhoCompactado(nome, 65, 66, 16);
+    CHECK_FALSE(MapaCompactado(nome).ehValido());
+    // Tabela zerada: os tiles começariam dentro do cabeçalho
+    gravarCabecalhoCompactado(nome, 8194, 8194, 16);
+    CHECK_FALSE(MapaCompactado(nome).ehValido());
+    MapaAltitudes mapa;
+    CHECK_FALSE(mapa.lerRegiaoCompactado(nome, 0, 0, 4));
+    // Tabela correta, mas 1000 bytes não comportam 4096² altitudes de ao menos 1 bit
+    gravarCabecalhoCompactado(nome, 4096, 4096, 16, 1000);
+    CHECK_FALSE(MapaCompactado(nome).ehValido());
+    gravarCabecalhoCompactado(nome, 4096, 4096, 16, 4096 * 4096 / 8);
+    CHECK(MapaCompactado(nome).ehValido());
+    
+    // Tiles maiores que o mapa na gravação viram um tile do tamanho do mapa
+    MapaAltitudes original;
+    original.gerar(5, 0.5);  // 33×33
+    REQUIRE(original.salvarCompactado("teste_mapa.mapc", 1e-6, 256));
+    MapaCompactado arquivo("teste_mapa.mapc");
+    REQUIRE(arquivo.ehValido());
+    CHECK(arquivo.obterLadoTile() == 33);
+    CHECK(arquivo.obterTilesPorLado() == 1);
+}
+
+// Altitude com período 256 nas duas direções, em degraus (comprime a ~1 bit por altitude)
+static double altitudePeriodica(size_t lin, size_t col) {
+    return static_cast<double>((lin % 256) / 16 + (col % 256) / 16 % 3) * 0.01;
+}
+
+// Monta um arquivo compactado de lado 256·k + 1 sem passar o mapa pela memória: com
+// altitudes periódicas e tiles de 256, todos os tiles internos são iguais, assim como os
+// de cada borda. Os quatro tiles distintos vêm de um mapa 257×257 comprimido de verdade
+static bool gravarCompactadoPeriodico(const char* nome, size_t k, double erroMaximo) {
+    vector<double> base(257 * 257);
+    for (size_t lin = 0; lin < 257; lin++) {
+        for (size_t col = 0; col < 257; col++) {
+            base[lin * 257 + col] = altitudePeriodica(lin, col);
+        }
+    }
+    if (!comprimirMapa(base.data(), 257, "teste_mapa_base.mapc", erroMaximo, 256)) return false;
+    ifstream entrada("teste_mapa_base.mapc", ios::binary);
+    vector<unsigned char> dados((istreambuf_iterator<char>(entrada)), istreambuf_iterator<char>());
+    remove("teste_mapa_base.mapc");
+    auto lerU64 = [&](size_t pos) {
+        uint64_t valor = 0;
+        for (int i = 7; i >= 0; i--) valor = (valor << 8) | dados[pos + i];
+        return valor;
+    };
+    auto anexarU64 = [](vector<unsigned char>& saida, uint64_t valor) {
+        for (int i = 0; i < 8; i++) saida.push_back(static_cast<unsigned char>(valor >> (8 * i)));
+    };
+    
+    // Tiles da base: 0 = interno, 1 = borda direita, 2 = borda de baixo, 3 = canto
+    size_t tilesPorLado = k + 1;
+    vector<unsigned char> cabecalho(dados.begin(), dados.begin() + 28);
+    for (int i = 0; i < 8; i++) cabecalho[8 + i] = static_cast<unsigned char>((256 * k + 1) >> (8 * i));
+    uint64_t deslocamento = 28 + 8 * (tilesPorLado * tilesPorLado + 1);
+    vector<size_t> tipos;
+    for (size_t tileLin = 0; tileLin < tilesPorLado; tileLin++) {
+        for (size_t tileCol = 0; tileCol < tilesPorLado; tileCol++) {
+            size_t tipo = (tileLin == k ? 2 : 0) + (tileCol == k ? 1 : 0);
+            tipos.push_back(tipo);
+            anexarU64(cabecalho, deslocamento);
+            deslocamento += lerU64(28 + 8 * (tipo + 1)) - lerU64(28 + 8 * tipo);
+        }
+    }
+    anexarU64(cabecalho, deslocamento);
+    
+    ofstream saida(nome, ios::binary);
+    saida.write(reinterpret_cast<const char*>(cabecalho.data()), cabecalho.size());
+    for (size_t tipo : tipos) {
+        uint64_t inicio = lerU64(28 + 8 * tipo), fim = lerU64(28 + 8 * (tipo + 1));
+        saida.write(reinterpret_cast<const char*>(dados.data() + inicio), fim - inicio);
+    }
+    return static_cast<bool>(saida);
+}
+
+TEST_CASE("Testa leitura de uma janela de um arquivo compactado com mais de 8193 de lado") {
+    const double erroMaximo = 1e-3;
+    const char* nome = "teste_mapa_grande.mapc";
+    REQUIRE(gravarCompactadoPeriodico(nome, 33, erroMaximo));  // 8449×8449
+    
+    MapaCompactado arquivo(nome);
+    REQUIRE(arquivo.ehValido());
+    CHECK(arquivo.obterTamanho() == 8449);
+    CHECK(arquivo.obterTilesPorLado() == 34);
+    
+    // Janela que cruza tiles internos e chega aos tiles da borda direita e de baixo
+    const size_t lin = 8100, col = 8050, altura = 349, largura = 399;
+    vector<double> regiao(altura * largura);
+    REQUIRE(arquivo.lerRegiao(lin, col, altura, largura, regiao.data(), largura));
+    double erro = 0.0;
+    for (size_t i = 0; i < altura; i++) {
+        for (size_t j = 0; j < largura; j++) {
+            erro = max(erro, fabs(regiao[i * largura + j] - altitudePeriodica(lin + i, col + j)));
+        }
+    }
+    CHECK(erro <= erroMaximo * 1.000001);
+    
+    MapaAltitudes janela;
+    REQUIRE(janela.lerRegiaoCompactado(nome, 4000, 5000, 512));
+    CHECK(fabs(janela.obterAltitude(511, 511) - altitudePeriodica(4511, 5511)) <= erroMaximo * 1.000001);
+    remove(nome);
+}
+
+// Lê um arquivo inteiro como bytes
+static string lerConteudo(const char* nome) {
+    ifstream arquivo(nome, ios::binary);
+    return string((istreambuf_iterator<char>(arquivo)), istreambuf_iterator<char>());
+}
+
+// Referência pixel a pixel: a regra original de cor (índice truncado) e de sombra (vizinho NO)
+static Pixel pixelReferencia(const MapaAltitudes& mapa, const Paleta& paleta, size_t lin, size_t col, bool sombra) {
+    double altitude = mapa.obterAltitude(lin, col);
+    Cor cor;
+    int numCores = paleta.obterTamanho();
+    if (numCores > 0) {
+        int indice = static_cast<int>(altitude * (numCores - 1));
+        indice = max(0, min(indice, numCores - 1));
+        cor = paleta.obterCor(indice);
+    }
+    Pixel p(cor.r, cor.g, cor.b);
+    if (sombra && lin > 0 && col > 0) {
+        double diferenca = mapa.obterAltitude(lin - 1, col - 1) - altitude;
+        if (diferenca > 0) {
+            double fator = max(0.3, min(1.0, 1.0 - diferenca * 5.0));
+            p.r = static_cast<unsigned char>(p.r * fator);
+            p.g = static_cast<unsigned char>(p.g * fator);
+            p.b = static_cast<unsigned char>(p.b * fator);
+        }
+    }
+    return p;
+}
+
+TEST_CASE("Testa que a paleta pré-calculada gera os mesmos pixels da regra original") {
+    // Altitudes exatamente nas fronteiras entre cores, fora de [0, 1] e um terreno gerado
+    ofstream arquivo("teste_fronteiras.txt");
+    arquivo << "4 4\n-0.5\n0\n0.25\n0.5\n0.75\n1\n1.5\n0.3333333333333333\n"
+            << "0.6666666666666666\n0.999\n0.001\n0.5\n0.2\n0.8\n0.4\n0.6\n";
+    arquivo.close();
+    MapaAltitudes fronteiras;
+    REQUIRE(fronteiras.ler("teste_fronteiras.txt"));
+    MapaAltitudes terreno;
+    terreno.gerar(7, 0.7, 3);
+    
+    Paleta vazia, umaCor, cinco;
+    umaCor.adicionarCor(Cor {10, 20, 30});
+    for (int i = 0; i < 5; i++) {
+        cinco.adicionarCor(Cor(static_cast<unsigned char>(i * 60), 200, static_cast<unsigned char>(255 - i * 50)));
+    }
+    
+    for (const MapaAltitudes* mapa : {&fronteiras, &terreno}) {
+        for (const Paleta* paleta : {&vazia, &umaCor, &cinco}) {
+            for (bool sombra : {false, true}) {
+                Imagem img = mapa->gerarImagem(*paleta, sombra);
+                bool iguais = true;
+                for (size_t lin = 0; lin < mapa->obterLinhas(); lin++) {
+                    for (size_t col = 0; col < mapa->obterColunas(); col++) {
+                        Pixel esperado = pixelReferencia(*mapa, *paleta, lin, col, sombra);
+                        const Pixel& obtido = img(col, lin);
+                        iguais = iguais && obtido.r == esperado.r && obtido.g == esperado.g && obtido.b == esperado.b;
+                    }
+                }
+                CHECK(iguais);
+            }
+        }
+    }
+}
+
+TEST_CASE("Testa que a imagem não depende do número de threads") {
+    Paleta paleta;
+    paleta.adicionarCor(Cor {0, 0, 128});
+    paleta.adicionarCor(Cor {40, 160, 60});
+    paleta.adicionarCor(Cor {255, 255, 255});
+    MapaAltitudes mapa;
+    mapa.gerar(9, 0.6, 11);
+    
+    Sombreamento comSombras = Sombreamento::relevo(300.0, 20.0, 2.0);
+    comSombras.sombrasProjetadas = true;
+    comSombras.direcoesOclusao = 8;
+    for (const Sombreamento& sombreamento : {Sombreamento(true), Sombreamento::relevo(315.0, 45.0, 1.0), comSombras}) {
+        definirNumThreads(1);
+        Imagem serial = mapa.gerarImagem(paleta, sombreamento);
+        CHECK(serial.salvarPPM("teste_threads_1.ppm", PPM_BINARIO));
+        for (unsigned int threads : {2u, 3u, 8u}) {
+            definirNumThreads(threads);
+            Imagem paralela = mapa.gerarImagem(paleta, sombreamento);
+            CHECK(paralela.salvarPPM("teste_threads_n.ppm", PPM_BINARIO));
+            CHECK(lerConteudo("teste_threads_n.ppm") == lerConteudo("teste_threads_1.ppm"));
+        }
+    }
+    definirNumThreads(0);
+}
+
+TEST_CASE("Testa o normal map do terreno") {
+    MapaAltitudes mapa;
+    mapa.gerar(8, 0.6, 13);
+    size_t lado = mapa.obterLinhas();
+
+    definirNumThreads(1);
+    Imagem serial = mapa.gerarMapaNormais(1.5);
+    std::vector<float> normais = mapa.calcularNormais(1.5);
+    definirNumThreads(3);
+    Imagem paralela = mapa.gerarMapaNormais(1.5);
+    Imagem planar = mapa.gerarMapaNormais(1.5, LAYOUT_PLANAR);
+    std::vector<float> normaisParalelo = mapa.calcularNormais(1.5);
+    definirNumThreads(0);
+    REQUIRE(normais.size() == 3 * lado * lado);
+    CHECK(normais == normaisParalelo);
+
+    bool iguais = true, unitarias = true, empacotadas = true;
+    for (size_t lin = 0; lin < lado; lin++) {
+        for (size_t col = 0; col < lado; col++) {
+            const Pixel& a = serial(col, lin);
+            const Pixel& b = paralela(col, lin);
+            Pixel c = planar.obterPixel(col, lin);
+            iguais = iguais && a.r == b.r && a.g == b.g && a.b == b.b && a.r == c.r && a.g == c.g && a.b == c.b;
+            const float* n = &normais[3 * (lin * lado + col)];
+            unitarias = unitarias && std::fabs(n[0] * n[0] + n[1] * n[1] + n[2] * n[2] - 1.0f) < 1e-5f && n[2] > 0.0f;
+            // O byte é a normal levada de [-1, 1] para [0, 255] (com folga para o arredondamento do float)
+            empacotadas = empacotadas && std::fabs(a.r - (n[0] * 127.5f + 128.0f)) < 1.001f
+                && std::fabs(a.g - (n[1] * 127.5f + 128.0f)) < 1.001f && std::fabs(a.b - (n[2] * 127.5f + 128.0f)) < 1.001f;
+        }
+    }
+    CHECK(iguais);
+    CHECK(unitarias);
+    CHECK(empacotadas);
+
+    // Direto para arquivo, faixa por faixa: o mesmo arquivo da imagem inteira
+    CHECK(serial.salvarPPM("teste_threads_1.ppm", PPM_BINARIO));
+    {
+        EscritorPPM escritor("teste_threads_n.ppm", lado, lado, PPM_BINARIO);
+        CHECK(mapa.gerarMapaNormais(escritor, 1.5));
+    }
+    CHECK(lerConteudo("teste_threads_n.ppm") == lerConteudo("teste_threads_1.ppm"));
+
+    // Mais exagero, encostas mais inclinadas: z menor em média
+    std::vector<float> exageradas = mapa.calcularNormais(4.0);
+    double somaZ = 0.0, somaZExagerada = 0.0;
+    for (size_t i = 2; i < normais.size(); i += 3) {
+        somaZ += normais[i];
+        somaZExagerada += exageradas[i];
+    }
+    CHECK(somaZExagerada < somaZ);
+}
+
+TEST_CASE("Testa as sombras projetadas na imagem") {
+    Paleta paleta;
+    paleta.adicionarCor(Cor {200, 200, 200});
+    MapaAltitudes mapa;
+    mapa.gerar(7, 0.8, 5);
+    
+    // Luz a pino: nenhuma sombra, e o sombreamento Noroeste continua o mesmo
+    Sombreamento aPino(true);
+    aPino.elevacao = 90.0;
+    aPino.sombrasProjetadas = true;
+    Imagem semSombras = mapa.gerarImagem(paleta, true);
+    Imagem comMascaraVazia = mapa.gerarImagem(paleta, aPino);
+    bool iguais = true;
+    for (size_t lin = 0; lin < mapa.obterLinhas(); lin++) {
+        for (size_t col = 0; col < mapa.obterColunas(); col++) {
+            iguais = iguais && semSombras(col, lin).r == comMascaraVazia(col, lin).r;
+        }
+    }
+    CHECK(iguais);
+    
+    // Luz rasante: parte do mapa fica na sombra, mais escura
+    Sombreamento rasante(false);
+    rasante.elevacao = 5.0;
+    rasante.sombrasProjetadas = true;
+    Imagem sombreada = mapa.gerarImagem(paleta, rasante);
+    size_t escuros = 0;
+    for (size_t lin = 0; lin < mapa.obterLinhas(); lin++) {
+        for (size_t col = 0; col < mapa.obterColunas(); col++) {
+            CHECK((sombreada(col, lin).r == 200 || sombreada(col, lin).r == 100));
+            escuros += sombreada(col, lin).r == 100;
+        }
+    }
+    CHECK(escuros > 0);
+    CHECK(escuros < mapa.obterLinhas() * mapa.obterColunas());
+}
+
+TEST_CASE("Testa a imagem em outra resolução") {
+    Paleta paleta;
+    for (int i = 0; i < 8; i++) {
+        paleta.adicionarCor(Cor(static_cast<unsigned char>(i * 30), static_cast<unsigned char>(255 - i * 30), 90));
+    }
+    
+    SUBCASE("Reduzir com caixa: cada pixel é a média do bloco") {
+        ofstream arquivo("teste_fronteiras.txt");
+        arquivo << "4 4\n0.1\n0.3\n0.9\n0.9\n0.5\n0.3\n0.2\n0.2\n"
+                << "0\n0\n0.6\n0.7\n0.2\n0.2\n0.8\n0.9\n";
+        arquivo.close();
+        MapaAltitudes mapa;
+        REQUIRE(mapa.ler("teste_fronteiras.txt"));
+        Imagem reduzida = mapa.gerarImagem(paleta, 2, 2, false);
+        REQUIRE(reduzida.obterLargura() == 2);
+        double medias[4] = {0.3, 0.55, 0.1, 0.75};
+        PaletaCompilada compilada(paleta);
+        for (size_t i = 0; i < 4; i++) {
+            Pixel esperado;
+            renderizarLinha(compilada, &medias[i], nullptr, 0, 1, false, &esperado, SIMD_ESCALAR);
+            const Pixel& obtido = reduzida(i % 2, i / 2);
+            CHECK((obtido.r == esperado.r && obtido.g == esperado.g && obtido.b == esperado.b));
+        }
+    }
+    
+    MapaAltitudes mapa;
+    mapa.gerar(8, 0.6, 21);
+    SUBCASE("Mesmo tamanho: idêntica à imagem normal") {
+        Imagem normal = mapa.gerarImagem(paleta, Sombreamento::relevo(315.0, 45.0, 1.0));
+        Imagem mesma = mapa.gerarImagem(paleta, 257, 257, Sombreamento::relevo(315.0, 45.0, 1.0), FILTRO_BICUBICO);
+        CHECK(normal.salvarPPM("teste_threads_1.ppm", PPM_BINARIO));
+        CHECK(mesma.salvarPPM("teste_threads_n.ppm", PPM_BINARIO));
+        CHECK(lerConteudo("teste_threads_n.ppm") == lerConteudo("teste_threads_1.ppm"));
+    }
+    SUBCASE("Não depende do número de threads, e direto para arquivo é igual") {
+        Sombreamento sombreamento = Sombreamento::relevo(300.0, 30.0, 1.5);
+        sombreamento.sombrasProjetadas = true;
+        for (size_t largura : {size_t(640), size_t(100)}) {
+            definirNumThreads(1);
+            Imagem serial = mapa.gerarImagem(paleta, largura, 360, sombreamento);
+            REQUIRE(serial.obterLargura() == largura);
+            REQUIRE(serial.obterAltura() == 360);
+            CHECK(serial.salvarPPM("teste_threads_1.ppm", PPM_BINARIO));
+            definirNumThreads(4);
+            Imagem paralela = mapa.gerarImagem(paleta, largura, 360, sombreamento);
+            CHECK(paralela.salvarPPM("teste_threads_n.ppm", PPM_BINARIO));
+            CHECK(lerConteudo("teste_threads_n.ppm") == lerConteudo("teste_threads_1.ppm"));
+            EscritorPPM escritor("teste_threads_n.ppm", largura, 360, PPM_BINARIO);
+            CHECK(mapa.gerarImagem(escritor, paleta, largura, 360, sombreamento));
+            CHECK(lerConteudo("teste_threads_n.ppm") == lerConteudo("teste_threads_1.ppm"));
+        }
+        definirNumThreads(0);
+    }
+}
+
+TEST_CASE("Testa que a imagem nos layouts alinhados é salva igual à RGB24") {
+    Paleta paleta;
+    paleta.adicionarCor(Cor {0, 0, 128});
+    paleta.adicionarCor(Cor {40, 160, 60});
+    paleta.adicionarCor(Cor {255, 255, 255});
+    MapaAltitudes mapa;
+    mapa.gerar(7, 0.6, 5);
+    Sombreamento sombreamento = Sombreamento::relevo(315.0, 45.0, 1.0);
+    sombreamento.direcoesOclusao = 8;
+    
+    Imagem rgb = mapa.gerarImagem(paleta, sombreamento);
+    CHECK(rgb.salvarPPM("teste_threads_1.ppm", PPM_BINARIO));
+    Imagem reamostrada = mapa.gerarImagem(paleta, 150, 90, sombreamento);
+    CHECK(reamostrada.salvarPPM("teste_duas_etapas.ppm", PPM_BINARIO));
+    for (LayoutImagem layout : {LAYOUT_RGBA32, LAYOUT_PLANAR}) {
+        Imagem img = mapa.gerarImagem(paleta, sombreamento, layout);
+        CHECK(img.obterLayout() == layout);
+        CHECK(img.salvarPPM("teste_threads_n.ppm", PPM_BINARIO));
+        CHECK(lerConteudo("teste_threads_n.ppm") == lerConteudo("teste_threads_1.ppm"));
+        Imagem outra = mapa.gerarImagem(paleta, 150, 90, sombreamento, FILTRO_AUTOMATICO, layout);
+        CHECK(outra.salvarPPM("teste_threads_n.ppm", PPM_BINARIO));
+        CHECK(lerConteudo("teste_threads_n.ppm") == lerConteudo("teste_duas_etapas.ppm"));
+    }
+}
+
+TEST_CASE("Testa que gerar a imagem direto para arquivo é idêntico a gerar e salvar") {
+    Paleta paleta;
+    paleta.adicionarCor(Cor {0, 0, 128});
+    paleta.adicionarCor(Cor {40, 160, 60});
+    paleta.adicionarCor(Cor {120, 100, 80});
+    paleta.adicionarCor(Cor {255, 255, 255});
+    
+    MapaAltitudes mapa;
+    mapa.gerar(9, 0.6);  // 513×513: várias faixas e vários pedaços PNG
+    Imagem img = mapa.gerarImagem(paleta, true);
+    size_t lado = mapa.obterLinhas();
+    
+    SUBCASE("PPM binário") {
+        CHECK(img.salvarPPM("teste_duas_etapas.ppm", PPM_BINARIO));
+        EscritorPPM escritor("teste_direto.ppm", lado, lado, PPM_BINARIO);
+        CHECK(mapa.gerarImagem(escritor, paleta, true));
+        CHECK(lerConteudo("teste_direto.ppm") == lerConteudo("teste_duas_etapas.ppm"));
+    }
+    SUBCASE("PPM texto") {
+        CHECK(img.salvarPPM("teste_duas_etapas.ppm", PPM_TEXTO));
+        EscritorPPM escritor("teste_direto.ppm", lado, lado, PPM_TEXTO);
+        CHECK(mapa.gerarImagem(escritor, paleta, true));
+        CHECK(lerConteudo("teste_direto.ppm") == lerConteudo("teste_duas_etapas.ppm"));
+    }
+    SUBCASE("PNG") {
+        CHECK(img.salvarPNG("teste_duas_etapas.png"));
+        EscritorPNG escritor("teste_direto.png", lado, lado);
+        CHECK(mapa.gerarImagem(escritor, paleta, true));
+        CHECK(lerConteudo("teste_direto.png") == lerConteudo("teste_duas_etapas.png"));
+    }
+}
+
+TEST_CASE("Testa que gerar terreno e imagem juntos é idêntico a gerar o mapa e depois a imagem") {
+    Paleta paleta;
+    paleta.adicionarCor(Cor {0, 0, 128});
+    paleta.adicionarCor(Cor {40, 160, 60});
+    paleta.adicionarCor(Cor {120, 100, 80});
+    paleta.adicionarCor(Cor {255, 255, 255});
+
+    const int N = 10;  // 1025×1025: várias faixas de ~1 MB
+    MapaAltitudes mapa;
+    mapa.gerar(N, 0.6, 31);
+    size_t lado = mapa.obterLinhas();
+
+    const Sombreamento sombreamentos[] = {Sombreamento(true), Sombreamento(false),
+                                          Sombreamento::relevo(315.0, 45.0, 2.0)};
+    for (const Sombreamento& sombreamento : sombreamentos) {
+        EscritorPPM completo("teste_duas_etapas.ppm", lado, lado, PPM_BINARIO);
+        CHECK(mapa.gerarImagem(completo, paleta, sombreamento));
+        for (unsigned int threads : {1u, 3u}) {
+            definirNumThreads(threads);
+            EscritorPPM direto("teste_direto.ppm", lado, lado, PPM_BINARIO);
+            CHECK(MapaAltitudes::gerarImagemDireto(direto, N, 0.6, 31, paleta, sombreamento));
+            CHECK(lerConteudo("teste_direto.ppm") == lerConteudo("teste_duas_etapas.ppm"));
+        }
+        definirNumThreads(0);
+    }
+
+    SUBCASE("PNG e mapas menores que uma faixa") {
+        MapaAltitudes pequeno;
+        pequeno.gerar(4, 0.5, 8);
+        EscritorPNG completo("teste_duas_etapas.png", 17, 17);
+        CHECK(pequeno.gerarImagem(completo, paleta, true));
+        EscritorPNG direto("teste_direto.png", 17, 17);
+        CHECK(MapaAltitudes::gerarImagemDireto(direto, 4, 0.5, 8, paleta, true));
+        CHECK(lerConteudo("teste_direto.png") == lerConteudo("teste_duas_etapas.png"));
+    }
+    SUBCASE("Sombras projetadas precisam do mapa inteiro") {
+        Sombreamento comSombras = Sombreamento::relevo(315.0, 45.0, 1.0);
+        comSombras.sombrasProjetadas = true;
+        EscritorPPM direto("teste_direto.ppm", lado, lado, PPM_BINARIO);
+        CHECK_FALSE(MapaAltitudes::gerarImagemDireto(direto, N, 0.6, 31, paleta, comSombras));
+    }
+}
+
+TEST_CASE("Testa que a esteira gera o mesmo arquivo que a versão sequencial") {
+    Paleta paleta;
+    paleta.adicionarCor(Cor {0, 0, 128});
+    paleta.adicionarCor(Cor {40, 160, 60});
+    paleta.adicionarCor(Cor {255, 255, 255});
+    
+    MapaAltitudes mapa;
+    mapa.gerar(11, 0.6);  // 2049×2049: 13 faixas de ~1 MB, mais que as 4 em trânsito
+    size_t lado = mapa.obterLinhas();
+    
+    EscritorPNG sequencial("teste_duas_etapas.png", lado, lado);
+    CHECK(mapa.gerarImagem(sequencial, paleta, true));
+    
+    EscritorPNG esteira("teste_direto.png", lado, lado);
+    EstatisticasEsteira estatisticas;
+    CHECK(mapa.gerarImagemEmEsteira(esteira, paleta, true, &estatisticas));
+    CHECK(estatisticas.numFaixas > 4);
+    CHECK(estatisticas.segundosTotal > 0.0);
+    CHECK(lerConteudo("teste_direto.png") == lerConteudo("teste_duas_etapas.png"));
+    
+    EscritorPPM ppmSequencial("teste_duas_etapas.ppm", lado, lado, PPM_BINARIO);
+    CHECK(mapa.gerarImagem(ppmSequencial, paleta, false));
+    EscritorPPM ppmEsteira("teste_direto.ppm", lado, lado, PPM_BINARIO);
+    CHECK(mapa.gerarImagemEmEsteira(ppmEsteira, paleta, false));
+    CHECK(lerConteudo("teste_direto.ppm") == lerConteudo("teste_duas_etapas.ppm"));
+}
+
+TEST_CASE("Testa exportação da pirâmide de tiles z/x/y") {
+    Paleta paleta;
+    paleta.adicionarCor(Cor {0, 0, 128});
+    paleta.adicionarCor(Cor {40, 160, 60});
+    paleta.adicionarCor(Cor {255, 255, 255});
+    
+    MapaAltitudes mapa;
+    mapa.gerar(9, 0.6);  // 513×513 -> imagem de 512×512: zoom 0 (1 tile) e zoom 1 (4 tiles)
+    
+    EstatisticasPiramide estatisticas;
+    CHECK(mapa.salvarPiramideTiles("teste_tiles", paleta, true, 1, &estatisticas));
+    CHECK(estatisticas.zoomMaximo == 1);
+    CHECK(estatisticas.tilesGravados + estatisticas.tilesUniformes == 5);
+    
+    // Cada tile gravado é um PNG 256×256
+    size_t encontrados = 0;
+    const char* nomes[5] = {"teste_tiles/0/0/0.png", "teste_tiles/1/0/0.png", "teste_tiles/1/1/0.png",
+                            "teste_tiles/1/0/1.png", "teste_tiles/1/1/1.png"};
+    for (const char* nome : nomes) {
+        string conteudo = lerConteudo(nome);
+        if (conteudo.empty()) continue;
+        encontrados++;
+        CHECK(conteudo.compare(1, 3, "PNG") == 0);
+        CHECK(static_cast<unsigned char>(conteudo[18]) == 1);  // Largura 256 (big-endian)
+        CHECK(static_cast<unsigned char>(conteudo[22]) == 1);  // Altura 256
+    }
+    CHECK(encontrados == estatisticas.tilesGravados);
+    
+    // Uma cor só e sem sombra: todos os tiles são uniformes e nenhum é gravado
+    Paleta umaCor;
+    umaCor.adicionarCor(Cor {10, 20, 30});
+    CHECK(mapa.salvarPiramideTiles("teste_tiles_uniformes", umaCor, false, 1, &estatisticas));
+    CHECK(estatisticas.tilesGravados == 0);
+    CHECK(estatisticas.tilesUniformes == 5);
+    
+    // Um diretório no lugar de um dos PNG: a gravação falha e não entra na contagem
+    CHECK(criarDiretorio("teste_tiles_falha"));
+    CHECK(criarDiretorio("teste_tiles_falha/0"));
+    CHECK(criarDiretorio("teste_tiles_falha/0/0"));
+    CHECK(criarDiretorio("teste_tiles_falha/0/0/0.png"));
+    CHECK_FALSE(mapa.salvarPiramideTiles("teste_tiles_falha", paleta, true, 1, &estatisticas));
+    CHECK(estatisticas.tilesGravados < 5 - estatisticas.tilesUniformes);
+    
+    // Mapa menor que um tile
+    MapaAltitudes pequeno;
+    pequeno.gerar(5, 0.5);
+    CHECK_FALSE(pequeno.salvarPiramideTiles("teste_tiles_pequeno", paleta));
+}
@@ -1,6 +1,7 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 #include "paleta.h"
+#include <cstdio>
 
 TEST_CASE("Testa a criação de uma paleta padrão (sem nenhuma cor)") {
     Paleta paleta;
@@ -56,4 +57,46 @@ TEST_CASE("Testa a criação de uma paleta a partir de um arquivo inexistente")
 
     // a paleta deve estar vazia
     CHECK(paleta.obterTamanho() == 0);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Testa posições das cores lidas do arquivo") {
+    FILE* arquivo = std::fopen("teste_posicoes.hex", "w");
+    REQUIRE(arquivo != nullptr);
+    std::fputs("#000000 0\n#808080 0.2\n  #ffffff\t1.0\n", arquivo);
+    std::fclose(arquivo);
+
+    Paleta paleta("teste_posicoes.hex");
+    CHECK(paleta.obterTamanho() == 3);
+    CHECK(paleta.temPosicoes());
+    CHECK(paleta.obterPosicao(1) == doctest::Approx(0.2));
+    CHECK(paleta.obterCor(2).r == 255);
+    CHECK(paleta.obterInterpolacao() == PALETA_FAIXAS);
+    std::remove("teste_posicoes.hex");
+}
+
+TEST_CASE("Testa posições ausentes ou fora de ordem") {
+    Paleta semPosicoes;
+    semPosicoes.adicionarCor(Cor {0, 0, 0});
+    semPosicoes.adicionarCor(Cor {50, 50, 50});
+    semPosicoes.adicionarCor(Cor {100, 100, 100});
+    CHECK_FALSE(semPosicoes.temPosicoes());
+    CHECK(semPosicoes.obterPosicao(1) == doctest::Approx(0.5));  // Igualmente espaçadas
+
+    Paleta foraDeOrdem;
+    foraDeOrdem.adicionarCor(Cor {0, 0, 0}, 0.6);
+    foraDeOrdem.adicionarCor(Cor {50, 50, 50}, 0.3);
+    CHECK_FALSE(foraDeOrdem.temPosicoes());
+    CHECK(foraDeOrdem.obterPosicao(0) == doctest::Approx(0.0));
+    foraDeOrdem.adicionarCor(Cor {90, 90, 90}, 0.9);  // Uma cor em ordem depois não conserta
+    CHECK_FALSE(foraDeOrdem.temPosicoes());
+
+    // A validade acompanha cada cor adicionada
+    Paleta crescente;
+    CHECK_FALSE(crescente.temPosicoes());
+    crescente.adicionarCor(Cor {0, 0, 0}, 0.0);
+    CHECK(crescente.temPosicoes());
+    crescente.adicionarCor(Cor {50, 50, 50}, 0.4);
+    CHECK(crescente.temPosicoes());
+    crescente.adicionarCor(Cor {100, 100, 100});
+    CHECK_FALSE(crescente.temPosicoes());
+}
@@ -0,0 +1,59 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "paralelo.h"
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("Testa que cada faixa é processada exatamente uma vez") {
+    for (unsigned int threads : {1u, 3u, 8u}) {
+        definirNumThreads(threads);
+        // Várias chamadas seguidas reaproveitam as threads do pool
+        for (int repeticao = 0; repeticao < 50; repeticao++) {
+            std::vector<std::atomic<int>> visitas(1000);
+            for (std::atomic<int>& v : visitas) v = 0;
+            executarEmFaixas(visitas.size(), 7, [&](size_t, size_t inicio, size_t fim) {
+                for (size_t i = inicio; i < fim; i++) visitas[i]++;
+            });
+            bool todasUmaVez = true;
+            for (std::atomic<int>& v : visitas) todasUmaVez = todasUmaVez && v == 1;
+            CHECK(todasUmaVez);
+        }
+    }
+    definirNumThreads(0);
+}
+
+TEST_CASE("Testa chamadas aninhadas de executarEmFaixas") {
+    // Uma tarefa que chama executarEmFaixas não pode travar, mesmo com o pool todo ocupado
+    definirNumThreads(4);
+    std::atomic<size_t> soma(0);
+    executarEmFaixas(8, 8, [&](size_t, size_t, size_t) {
+        executarEmFaixas(100, 10, [&](size_t, size_t inicio, size_t fim) {
+            soma += fim - inicio;
+        });
+    });
+    CHECK(soma == 800);
+    definirNumThreads(0);
+}
+
+TEST_CASE("Testa que a exceção de uma tarefa chega a quem chamou") {
+    for (unsigned int threads : {1u, 4u}) {
+        definirNumThreads(threads);
+        for (int repeticao = 0; repeticao < 20; repeticao++) {
+            // Faixas lançando tanto na thread chamadora quanto nos trabalhadores
+            std::atomic<int> processadas(0);
+            CHECK_THROWS_AS(executarEmFaixas(64, 64, [&](size_t faixa, size_t, size_t) {
+                                if (faixa % 5 == 3) throw std::runtime_error("falha na faixa");
+                                processadas++;
+                            }),
+                            std::runtime_error);
+            CHECK(processadas < 64);
+
+            // O pool continua inteiro depois da falha
+            std::atomic<size_t> soma(0);
+            executarEmFaixas(100, 10, [&](size_t, size_t inicio, size_t fim) { soma += fim - inicio; });
+            CHECK(soma == 100);
+        }
+    }
+    definirNumThreads(0);
+}
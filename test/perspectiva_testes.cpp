@@ -0,0 +1,125 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "perspectiva.h"
+#include "mapa_altitudes.h"
+#include "paralelo.h"
+#include <vector>
+
+static bool mesmaCor(const Pixel& a, const Pixel& b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b;
+}
+
+// Mapa plano na altitude dada, com as cores de um tabuleiro (metade norte verde, sul marrom)
+struct Cenario {
+    size_t lado;
+    std::vector<double> altitudes;
+    std::vector<Pixel> cores;
+
+    Cenario(size_t lado, double altitude) : lado(lado), altitudes(lado * lado, altitude), cores(lado * lado) {
+        for (size_t lin = 0; lin < lado; lin++) {
+            for (size_t col = 0; col < lado; col++) {
+                cores[lin * lado + col] = lin < lado / 2 ? Pixel(20, 160, 40) : Pixel(120, 80, 30);
+            }
+        }
+    }
+};
+
+TEST_CASE("Testa o horizonte sobre um terreno plano") {
+    Cenario cenario(257, 0.2);
+    Camera camera;
+    camera.inclinacao = 0.0;  // Horizonte no meio da tela
+    camera.altura = 0.3;
+    const size_t largura = 64, altura = 48;
+    std::vector<Pixel> tela(largura * altura);
+    renderizarPerspectiva(cenario.altitudes.data(), cenario.lado, VistaImagem(cenario.cores.data(), cenario.lado),
+                          camera, largura, altura, VistaImagem(tela.data(), largura));
+
+    for (size_t col = 0; col < largura; col++) {
+        // Acima do horizonte, céu; na base da tela, o chão logo à frente (metade sul)
+        CHECK(mesmaCor(tela[col], camera.ceu));
+        CHECK(mesmaCor(tela[(altura / 2 - 1) * largura + col], camera.ceu));
+        CHECK(mesmaCor(tela[(altura - 1) * largura + col], Pixel(120, 80, 30)));
+    }
+    // Mais acima na tela, mais longe: a metade norte (de 128 a 256 pontos da câmera) fica
+    // entre as linhas ~27 e ~30, e mais perto do horizonte o mapa já acabou
+    CHECK(mesmaCor(tela[29 * largura + largura / 2], Pixel(20, 160, 40)));
+    CHECK(mesmaCor(tela[(altura / 2 + 1) * largura + largura / 2], camera.ceu));
+
+    SUBCASE("Olhando para baixo, o chão ocupa a tela inteira") {
+        camera.inclinacao = 60.0;
+        renderizarPerspectiva(cenario.altitudes.data(), cenario.lado, VistaImagem(cenario.cores.data(), cenario.lado),
+                              camera, largura, altura, VistaImagem(tela.data(), largura));
+        bool semCeu = true;
+        for (const Pixel& p : tela) {
+            semCeu = semCeu && !mesmaCor(p, camera.ceu);
+        }
+        CHECK(semCeu);
+    }
+}
+
+TEST_CASE("Testa que o relevo da frente esconde o de trás") {
+    // Muro alto (vermelho) no meio do mapa; atrás dele, a metade norte nunca aparece
+    Cenario cenario(129, 0.1);
+    for (size_t lin = 60; lin < 64; lin++) {
+        for (size_t col = 0; col < cenario.lado; col++) {
+            cenario.altitudes[lin * cenario.lado + col] = 0.9;
+            cenario.cores[lin * cenario.lado + col] = Pixel(200, 0, 0);
+        }
+    }
+    Camera camera;
+    camera.altura = 0.2;  // Olho em 0.3, abaixo do topo do muro
+    camera.inclinacao = 0.0;
+    const size_t largura = 40, altura = 60;
+    std::vector<Pixel> tela(largura * altura);
+    renderizarPerspectiva(cenario.altitudes.data(), cenario.lado, VistaImagem(cenario.cores.data(), cenario.lado),
+                          camera, largura, altura, VistaImagem(tela.data(), largura));
+    bool verde = false, vermelho = false;
+    for (const Pixel& p : tela) {
+        verde = verde || mesmaCor(p, Pixel(20, 160, 40));
+        vermelho = vermelho || mesmaCor(p, Pixel(200, 0, 0));
+    }
+    CHECK(vermelho);
+    CHECK_FALSE(verde);
+    // O muro passa acima do horizonte (está acima do olho)
+    CHECK(mesmaCor(tela[(altura / 2 - 2) * largura + largura / 2], Pixel(200, 0, 0)));
+}
+
+TEST_CASE("Testa a perspectiva de um terreno gerado") {
+    Paleta paleta;
+    paleta.adicionarCor(Cor {0, 0, 128});
+    paleta.adicionarCor(Cor {40, 160, 60});
+    paleta.adicionarCor(Cor {255, 255, 255});
+    MapaAltitudes mapa;
+    mapa.gerar(8, 0.6, 9);
+    Imagem cores = mapa.gerarImagem(paleta, Sombreamento::relevo(315.0, 45.0, 1.0));
+    Camera camera;
+    camera.direcao = 30.0;
+    camera.x = 0.3;
+
+    definirNumThreads(1);
+    Imagem serial(300, 170);
+    REQUIRE(mapa.gerarPerspectiva(serial, cores, camera));
+    definirNumThreads(4);
+    Imagem paralela(300, 170);
+    REQUIRE(mapa.gerarPerspectiva(paralela, cores, camera));
+    definirNumThreads(0);
+    Imagem planar(300, 170, LAYOUT_PLANAR);
+    REQUIRE(mapa.gerarPerspectiva(planar, paleta, Sombreamento::relevo(315.0, 45.0, 1.0), camera));
+
+    bool iguais = true;
+    size_t ceu = 0;
+    for (size_t lin = 0; lin < 170; lin++) {
+        for (size_t col = 0; col < 300; col++) {
+            iguais = iguais && mesmaCor(serial(col, lin), paralela(col, lin))
+                && mesmaCor(serial(col, lin), planar.obterPixel(col, lin));
+            ceu += mesmaCor(serial(col, lin), camera.ceu);
+        }
+    }
+    CHECK(iguais);
+    // Céu e terreno aparecem
+    CHECK(ceu > 0);
+    CHECK(ceu < 300 * 170);
+
+    Imagem pequena(10, 10);
+    CHECK_FALSE(mapa.gerarPerspectiva(serial, pequena, camera));
+}
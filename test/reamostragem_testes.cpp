@@ -0,0 +1,132 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "reamostragem.h"
+#include <cstdlib>
+#include <vector>
+
+// Reamostra uma linha inteira com os pesos dados
+static std::vector<double> reamostrar(const std::vector<double>& origem, FiltroReamostragem filtro, size_t destino,
+                                      NivelSimd nivel = SIMD_ESCALAR) {
+    PesosReamostragem pesos(origem.size(), destino, filtro);
+    std::vector<double> saida(destino);
+    reamostrarLinha(origem.data(), pesos, saida.data(), nivel);
+    return saida;
+}
+
+TEST_CASE("Testa que o mesmo tamanho copia a linha exatamente") {
+    std::vector<double> linha(37);
+    std::srand(1);
+    for (double& v : linha) {
+        v = std::rand() / static_cast<double>(RAND_MAX);
+    }
+    for (FiltroReamostragem filtro : {FILTRO_AUTOMATICO, FILTRO_BILINEAR, FILTRO_BICUBICO, FILTRO_CAIXA}) {
+        CHECK(reamostrar(linha, filtro, linha.size()) == linha);
+    }
+}
+
+TEST_CASE("Testa os pesos de cada filtro") {
+    SUBCASE("Caixa: média de cada par ao reduzir à metade") {
+        std::vector<double> saida = reamostrar({1.0, 3.0, 5.0, 7.0, 0.0, 2.0}, FILTRO_CAIXA, 3);
+        CHECK(saida[0] == doctest::Approx(2.0));
+        CHECK(saida[1] == doctest::Approx(6.0));
+        CHECK(saida[2] == doctest::Approx(1.0));
+    }
+    SUBCASE("Caixa: fator fracionário pondera pela área") {
+        // 3 → 2: a saída 0 cobre o ponto 0 inteiro e metade do 1
+        std::vector<double> saida = reamostrar({0.0, 3.0, 6.0}, FILTRO_CAIXA, 2);
+        CHECK(saida[0] == doctest::Approx((0.0 + 0.5 * 3.0) / 1.5));
+        CHECK(saida[1] == doctest::Approx((0.5 * 3.0 + 6.0) / 1.5));
+    }
+    SUBCASE("Bilinear e bicúbico reproduzem uma rampa longe das bordas") {
+        std::vector<double> rampa(16);
+        for (size_t i = 0; i < rampa.size(); i++) rampa[i] = static_cast<double>(i);
+        for (FiltroReamostragem filtro : {FILTRO_BILINEAR, FILTRO_BICUBICO}) {
+            std::vector<double> saida = reamostrar(rampa, filtro, 64);
+            for (size_t i = 8; i < 56; i++) {
+                CHECK(saida[i] == doctest::Approx((i + 0.5) / 4.0 - 0.5));
+            }
+        }
+    }
+    SUBCASE("Os pesos de cada saída somam 1") {
+        for (FiltroReamostragem filtro : {FILTRO_BILINEAR, FILTRO_BICUBICO, FILTRO_CAIXA}) {
+            for (size_t origem : {size_t(1), size_t(2), size_t(5), size_t(33), size_t(100)}) {
+                for (size_t destino : {size_t(1), size_t(3), size_t(17), size_t(64), size_t(250)}) {
+                    PesosReamostragem pesos(origem, destino, filtro);
+                    for (size_t i = 0; i < destino; i++) {
+                        double soma = 0.0;
+                        for (size_t p = 0; p < pesos.pontosPorSaida; p++) {
+                            soma += pesos.pesos[p * destino + i];
+                        }
+                        CHECK(soma == doctest::Approx(1.0));
+                        CHECK(pesos.inicio[i] >= 0);
+                        CHECK(pesos.inicio[i] + pesos.pontosPorSaida <= origem);
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Testa que as versões SIMD da reamostragem dão os mesmos bits da escalar") {
+    std::vector<double> linha(101);
+    std::srand(4);
+    for (double& v : linha) {
+        v = std::rand() / static_cast<double>(RAND_MAX);
+    }
+    for (FiltroReamostragem filtro : {FILTRO_BILINEAR, FILTRO_BICUBICO, FILTRO_CAIXA}) {
+        for (size_t destino : {size_t(23), size_t(50), size_t(333)}) {
+            std::vector<double> escalar = reamostrar(linha, filtro, destino, SIMD_ESCALAR);
+            for (int nivel = SIMD_SSE41; nivel <= obterNivelSimd(); nivel++) {
+                CHECK(reamostrar(linha, filtro, destino, static_cast<NivelSimd>(nivel)) == escalar);
+            }
+        }
+    }
+
+    // Etapa vertical: 5 linhas de 39 valores
+    std::vector<double> dados(5 * 39);
+    for (double& v : dados) {
+        v = std::rand() / static_cast<double>(RAND_MAX);
+    }
+    const double* linhas[5];
+    for (size_t l = 0; l < 5; l++) linhas[l] = &dados[l * 39];
+    double pesos[5] = {-0.0625, 0.5625, 0.5625, -0.0625, 0.125};
+    std::vector<double> escalar(39), vetorial(39);
+    combinarLinhas(linhas, pesos, 5, 39, escalar.data(), SIMD_ESCALAR);
+    for (int nivel = SIMD_SSE41; nivel <= obterNivelSimd(); nivel++) {
+        combinarLinhas(linhas, pesos, 5, 39, vetorial.data(), static_cast<NivelSimd>(nivel));
+        CHECK(vetorial == escalar);
+    }
+}
+
+TEST_CASE("Testa que a janela dá o mesmo resultado da reamostragem em duas passadas completas") {
+    const size_t lado = 21;
+    std::vector<double> grade(lado * lado);
+    std::srand(8);
+    for (double& v : grade) {
+        v = std::rand() / static_cast<double>(RAND_MAX);
+    }
+    for (size_t largura : {size_t(7), size_t(50)}) {
+        for (size_t altura : {size_t(5), size_t(64)}) {
+            PesosReamostragem horizontal(lado, largura, FILTRO_AUTOMATICO), vertical(lado, altura, FILTRO_AUTOMATICO);
+            // Referência: todas as linhas na horizontal, depois todas as colunas na vertical
+            std::vector<double> meio(lado * largura);
+            for (size_t lin = 0; lin < lado; lin++) {
+                reamostrarLinha(&grade[lin * lado], horizontal, &meio[lin * largura], SIMD_ESCALAR);
+            }
+            JanelaReamostragem janela(horizontal, vertical, [&](size_t lin) { return &grade[lin * lado]; });
+            std::vector<double> linha(largura);
+            bool iguais = true;
+            for (size_t y = 0; y < altura; y++) {
+                janela.calcularLinha(y, linha.data());
+                for (size_t x = 0; x < largura; x++) {
+                    double esperado = 0.0;
+                    for (size_t p = 0; p < vertical.pontosPorSaida; p++) {
+                        esperado += meio[(vertical.inicio[y] + p) * largura + x] * vertical.pesos[p * altura + y];
+                    }
+                    iguais = iguais && linha[x] == esperado;
+                }
+            }
+            CHECK(iguais);
+        }
+    }
+}
@@ -0,0 +1,373 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "renderizacao.h"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// Compara dois buffers de pixels byte a byte
+static bool pixelsIguais(const std::vector<Pixel>& a, const std::vector<Pixel>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].r != b[i].r || a[i].g != b[i].g || a[i].b != b[i].b) return false;
+    }
+    return true;
+}
+
+TEST_CASE("Testa que as versões SIMD geram os mesmos bytes da versão escalar") {
+    // Altitudes aleatórias, valores fora de [0, 1] e fronteiras exatas entre cores
+    const size_t linhas = 7, colunas = 53;  // Colunas não múltiplas de 4 nem de 8
+    std::vector<double> altitudes(linhas * colunas);
+    std::srand(42);
+    for (double& a : altitudes) {
+        a = std::rand() / static_cast<double>(RAND_MAX);
+    }
+    double especiais[] = {-0.5, 0.0, 0.25, 0.5, 0.75, 1.0, 1.5, 1e3, -1e3, 1.0 / 3.0, 2.0 / 3.0};
+    for (size_t i = 0; i < sizeof(especiais) / sizeof(especiais[0]); i++) {
+        altitudes[3 * colunas + 5 + i] = especiais[i];
+    }
+
+    Paleta vazia, umaCor, varias;
+    umaCor.adicionarCor(Cor(10, 20, 30));
+    for (int i = 0; i < 5; i++) {
+        varias.adicionarCor(Cor(static_cast<unsigned char>(i * 60), 255, static_cast<unsigned char>(255 - i * 50)));
+    }
+
+    for (const Paleta* paleta : {&vazia, &umaCor, &varias}) {
+        PaletaCompilada compilada(*paleta);
+        for (bool sombra : {false, true}) {
+            // Linhas inteiras e um trecho que começa depois da coluna 0
+            for (size_t colInicio : {size_t(0), size_t(3)}) {
+                size_t largura = colunas - colInicio;
+                std::vector<Pixel> escalar(linhas * largura);
+                for (size_t lin = 0; lin < linhas; lin++) {
+                    const double* linha = &altitudes[lin * colunas];
+                    renderizarLinha(compilada, linha, lin > 0 ? linha - colunas : nullptr, colInicio, colunas,
+                                    sombra, &escalar[lin * largura], SIMD_ESCALAR);
+                }
+                for (int nivel = SIMD_SSE41; nivel <= obterNivelSimd(); nivel++) {
+                    std::vector<Pixel> vetorial(linhas * largura);
+                    for (size_t lin = 0; lin < linhas; lin++) {
+                        const double* linha = &altitudes[lin * colunas];
+                        renderizarLinha(compilada, linha, lin > 0 ? linha - colunas : nullptr, colInicio, colunas,
+                                        sombra, &vetorial[lin * largura], static_cast<NivelSimd>(nivel));
+                    }
+                    CHECK(pixelsIguais(escalar, vetorial));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Testa o sombreamento escalar de um pixel") {
+    Paleta paleta;
+    paleta.adicionarCor(Cor(200, 100, 50));
+    PaletaCompilada compilada(paleta);
+
+    // Vizinho NO 0.1 mais alto → fator 0.5
+    double acima[2] = {0.6, 0.0};
+    double linha[2] = {0.0, 0.5};
+    Pixel saida[2];
+    renderizarLinha(compilada, linha, acima, 0, 2, true, saida, SIMD_ESCALAR);
+    CHECK(saida[0].r == 200);  // Primeira coluna: sem vizinho NO
+    CHECK(saida[1].r == 100);
+    CHECK(saida[1].g == 50);
+    CHECK(saida[1].b == 25);
+}
+
+// Cor de uma altitude pela paleta compilada (sem sombra)
+static Pixel corDaAltitude(const PaletaCompilada& paleta, double altitude) {
+    Pixel p;
+    renderizarLinha(paleta, &altitude, nullptr, 0, 1, false, &p, SIMD_ESCALAR);
+    return p;
+}
+
+TEST_CASE("Testa a paleta em gradiente") {
+    Paleta paleta;
+    paleta.adicionarCor(Cor(0, 0, 0));
+    paleta.adicionarCor(Cor(255, 255, 255));
+
+    SUBCASE("Faixas (padrão): cor da entrada de baixo") {
+        PaletaCompilada compilada(paleta);
+        CHECK(compilada.cores.size() == 2);
+        CHECK(corDaAltitude(compilada, 0.99).r == 0);
+        CHECK(corDaAltitude(compilada, 1.0).r == 255);
+    }
+    SUBCASE("Gradiente sRGB") {
+        paleta.definirInterpolacao(PALETA_GRADIENTE);
+        PaletaCompilada compilada(paleta);
+        CHECK(corDaAltitude(compilada, 0.0).r == 0);
+        CHECK(corDaAltitude(compilada, 0.25).r == 64);
+        CHECK(corDaAltitude(compilada, 0.5).r == 128);
+        CHECK(corDaAltitude(compilada, 1.0).r == 255);
+        // Sem degraus maiores que um nível entre altitudes próximas
+        bool suave = true;
+        for (int i = 1; i <= 1000; i++) {
+            int antes = corDaAltitude(compilada, (i - 1) / 1000.0).g;
+            int depois = corDaAltitude(compilada, i / 1000.0).g;
+            suave = suave && depois >= antes && depois - antes <= 1;
+        }
+        CHECK(suave);
+    }
+    SUBCASE("Gradiente em luz linear") {
+        paleta.definirInterpolacao(PALETA_GRADIENTE_LINEAR);
+        PaletaCompilada compilada(paleta);
+        CHECK(corDaAltitude(compilada, 0.0).r == 0);
+        CHECK(corDaAltitude(compilada, 0.5).r == 188);  // 50% de luz ≈ 73,5% em sRGB
+        CHECK(corDaAltitude(compilada, 1.0).r == 255);
+    }
+}
+
+TEST_CASE("Testa posições personalizadas das cores") {
+    Paleta paleta;
+    paleta.adicionarCor(Cor(0, 0, 0), 0.0);
+    paleta.adicionarCor(Cor(100, 100, 100), 0.8);
+    paleta.adicionarCor(Cor(200, 200, 200), 0.8);  // Mesma posição: transição brusca
+    paleta.adicionarCor(Cor(255, 255, 255), 1.0);
+    REQUIRE(paleta.temPosicoes());
+
+    SUBCASE("Faixas") {
+        PaletaCompilada compilada(paleta);
+        CHECK(corDaAltitude(compilada, 0.5).r == 0);
+        CHECK(corDaAltitude(compilada, 0.79).r == 0);
+        CHECK(corDaAltitude(compilada, 0.81).r == 200);
+        CHECK(corDaAltitude(compilada, 1.0).r == 255);
+    }
+    SUBCASE("Gradiente") {
+        paleta.definirInterpolacao(PALETA_GRADIENTE);
+        PaletaCompilada compilada(paleta);
+        CHECK(corDaAltitude(compilada, 0.4).r == 50);
+        CHECK(corDaAltitude(compilada, 0.799).r == 100);
+        CHECK(corDaAltitude(compilada, 0.801).r == 200);
+        CHECK(corDaAltitude(compilada, 0.9).r == 228);
+    }
+}
+
+TEST_CASE("Testa que o relevo vetorial calcula os mesmos fatores do escalar") {
+    const size_t lado = 37;  // Não múltiplo de 2 nem de 4
+    std::vector<double> altitudes(lado * lado);
+    std::srand(7);
+    for (double& a : altitudes) {
+        a = std::rand() / static_cast<double>(RAND_MAX);
+    }
+    IluminacaoRelevo luz(Sombreamento::relevo(300.0, 35.0, 2.5), lado);
+
+    for (size_t lin = 0; lin < lado; lin++) {
+        const double* linha = &altitudes[lin * lado];
+        const double* acima = lin > 0 ? linha - lado : linha;
+        const double* abaixo = lin + 1 < lado ? linha + lado : linha;
+        for (size_t colInicio : {size_t(0), size_t(1), size_t(5)}) {
+            size_t colFim = colInicio == 5 ? 30 : lado;
+            std::vector<double> escalar(colFim - colInicio), vetorial(colFim - colInicio);
+            calcularRelevoLinha(luz, acima, linha, abaixo, lado, colInicio, colFim, escalar.data(), SIMD_ESCALAR);
+            for (int nivel = SIMD_SSE41; nivel <= obterNivelSimd(); nivel++) {
+                calcularRelevoLinha(luz, acima, linha, abaixo, lado, colInicio, colFim, vetorial.data(),
+                                    static_cast<NivelSimd>(nivel));
+                CHECK(escalar == vetorial);
+            }
+        }
+    }
+}
+
+TEST_CASE("Testa a direção da luz no relevo") {
+    // Rampa subindo para o leste: a encosta olha para o oeste
+    const size_t lado = 5;
+    std::vector<double> rampa(lado * lado);
+    for (size_t lin = 0; lin < lado; lin++) {
+        for (size_t col = 0; col < lado; col++) {
+            rampa[lin * lado + col] = col * 0.1;
+        }
+    }
+    const double* meio = &rampa[2 * lado];
+    double fator;
+
+    // Terreno plano: fator = ambiente + difusa × sen(elevação)
+    std::vector<double> plano(lado * lado, 0.5);
+    IluminacaoRelevo luz(Sombreamento::relevo(315.0, 30.0, 1.0), lado);
+    calcularRelevoLinha(luz, &plano[lado], &plano[2 * lado], &plano[3 * lado], lado, 2, 3, &fator);
+    CHECK(fator == doctest::Approx(0.3 + 0.7 * 0.5));
+
+    double luzOeste, luzLeste;
+    IluminacaoRelevo oeste(Sombreamento::relevo(270.0, 45.0, 1.0), lado);
+    IluminacaoRelevo leste(Sombreamento::relevo(90.0, 45.0, 1.0), lado);
+    calcularRelevoLinha(oeste, meio - lado, meio, meio + lado, lado, 2, 3, &luzOeste);
+    calcularRelevoLinha(leste, meio - lado, meio, meio + lado, lado, 2, 3, &luzLeste);
+    CHECK(luzOeste > luzLeste);
+    CHECK(luzLeste >= 0.3);
+    CHECK(luzOeste <= 1.0);
+}
+
+TEST_CASE("Testa que aplicar fatores prontos dá o mesmo resultado em todas as versões") {
+    const size_t colunas = 45;
+    std::vector<double> altitudes(colunas), fatores(colunas);
+    std::srand(3);
+    for (size_t i = 0; i < colunas; i++) {
+        altitudes[i] = std::rand() / static_cast<double>(RAND_MAX);
+        fatores[i] = 0.3 + 0.7 * std::rand() / static_cast<double>(RAND_MAX);
+    }
+    Paleta paleta;
+    paleta.adicionarCor(Cor(250, 10, 100));
+    paleta.adicionarCor(Cor(3, 200, 255));
+    paleta.definirInterpolacao(PALETA_GRADIENTE);
+    PaletaCompilada compilada(paleta);
+
+    std::vector<Pixel> escalar(colunas - 2);
+    renderizarLinhaComFatores(compilada, altitudes.data(), fatores.data(), 2, colunas, escalar.data(), SIMD_ESCALAR);
+    for (int nivel = SIMD_SSE41; nivel <= obterNivelSimd(); nivel++) {
+        std::vector<Pixel> vetorial(colunas - 2);
+        renderizarLinhaComFatores(compilada, altitudes.data(), fatores.data(), 2, colunas, vetorial.data(),
+                                  static_cast<NivelSimd>(nivel));
+        CHECK(pixelsIguais(escalar, vetorial));
+    }
+}
+
+TEST_CASE("Testa que os layouts alinhados recebem os mesmos pixels do RGB24") {
+    const size_t linhas = 4, colunas = 61;
+    std::vector<double> altitudes(linhas * colunas);
+    std::srand(5);
+    for (double& a : altitudes) {
+        a = std::rand() / static_cast<double>(RAND_MAX);
+    }
+    Paleta paleta;
+    for (int i = 0; i < 7; i++) {
+        paleta.adicionarCor(Cor(static_cast<unsigned char>(i * 40), static_cast<unsigned char>(200 - i * 25), 90));
+    }
+    PaletaCompilada compilada(paleta);
+
+    // Referência: escalar, em RGB24, a partir da coluna 1 (trecho desalinhado)
+    std::vector<Pixel> esperado(linhas * colunas);
+    for (size_t lin = 0; lin < linhas; lin++) {
+        const double* linha = &altitudes[lin * colunas];
+        renderizarLinha(compilada, linha, lin > 0 ? linha - colunas : nullptr, 1, colunas, true,
+                        &esperado[lin * colunas + 1], SIMD_ESCALAR);
+    }
+
+    for (LayoutImagem layout : {LAYOUT_RGBA32, LAYOUT_PLANAR}) {
+        for (int nivel = SIMD_ESCALAR; nivel <= obterNivelSimd(); nivel++) {
+            Imagem img(colunas, linhas, layout);
+            VistaImagem vista = img.obterVista();
+            for (size_t lin = 0; lin < linhas; lin++) {
+                const double* linha = &altitudes[lin * colunas];
+                renderizarLinha(compilada, linha, lin > 0 ? linha - colunas : nullptr, 1, colunas, true,
+                                vista.deslocada(1, lin), static_cast<NivelSimd>(nivel));
+            }
+            // Volta para RGB24 com cada versão da conversão
+            for (int nivelConversao = SIMD_ESCALAR; nivelConversao <= obterNivelSimd(); nivelConversao++) {
+                std::vector<Pixel> obtido(linhas * colunas);
+                for (size_t lin = 0; lin < linhas; lin++) {
+                    converterLinhaRGB24(vista.deslocada(0, lin), colunas, &obtido[lin * colunas],
+                                        static_cast<NivelSimd>(nivelConversao));
+                }
+                CHECK(pixelsIguais(esperado, obtido));
+            }
+            if (layout == LAYOUT_RGBA32) {
+                bool opacos = true;
+                for (size_t col = 0; col < colunas; col++) {
+                    opacos = opacos && vista.canais[0][4 * col + 3] == 255;
+                }
+                CHECK(opacos);
+            }
+        }
+    }
+}
+
+TEST_CASE("Testa que as normais vetoriais são as mesmas da versão escalar") {
+    const size_t lado = 39;  // Não múltiplo de 4 nem de 8
+    std::vector<double> altitudes(lado * lado);
+    std::srand(9);
+    for (double& a : altitudes) {
+        a = std::rand() / static_cast<double>(RAND_MAX);
+    }
+    const double escala = 2.0 * (lado - 1) / LADO_POR_ALTURA;
+
+    for (size_t lin = 0; lin < lado; lin++) {
+        const double* linha = &altitudes[lin * lado];
+        const double* acima = lin > 0 ? linha - lado : linha;
+        const double* abaixo = lin + 1 < lado ? linha + lado : linha;
+        for (size_t colInicio : {size_t(0), size_t(1), size_t(6)}) {
+            size_t colFim = colInicio == 6 ? 33 : lado;
+            size_t n = colFim - colInicio;
+            std::vector<float> escalar(3 * n);
+            std::vector<Pixel> pixelsEscalar(n);
+            calcularNormaisLinha(escala, acima, linha, abaixo, lado, colInicio, colFim, escalar.data(), SIMD_ESCALAR);
+            renderizarNormaisLinha(escala, acima, linha, abaixo, lado, colInicio, colFim, pixelsEscalar.data(),
+                                   SIMD_ESCALAR);
+            for (int nivel = SIMD_SSE41; nivel <= obterNivelSimd(); nivel++) {
+                std::vector<float> vetorial(3 * n);
+                calcularNormaisLinha(escala, acima, linha, abaixo, lado, colInicio, colFim, vetorial.data(),
+                                     static_cast<NivelSimd>(nivel));
+                CHECK(escalar == vetorial);
+                std::vector<Pixel> pixelsVetorial(n);
+                renderizarNormaisLinha(escala, acima, linha, abaixo, lado, colInicio, colFim,
+                                       pixelsVetorial.data(), static_cast<NivelSimd>(nivel));
+                CHECK(pixelsIguais(pixelsEscalar, pixelsVetorial));
+                // Layouts alinhados: mesmos pixels, gravados direto no formato da imagem
+                for (LayoutImagem layout : {LAYOUT_RGBA32, LAYOUT_PLANAR}) {
+                    Imagem img(lado, 1, layout);
+                    renderizarNormaisLinha(escala, acima, linha, abaixo, lado, colInicio, colFim,
+                                           img.obterVista().deslocada(colInicio, 0), static_cast<NivelSimd>(nivel));
+                    bool iguais = true;
+                    for (size_t i = 0; i < n; i++) {
+                        Pixel p = img.obterPixel(colInicio + i, 0);
+                        iguais = iguais && p.r == pixelsEscalar[i].r && p.g == pixelsEscalar[i].g
+                            && p.b == pixelsEscalar[i].b;
+                    }
+                    CHECK(iguais);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Testa a direção das normais e a borda") {
+    // Rampa subindo para o leste e para o sul, 0.1 por ponto nos dois eixos
+    const size_t lado = 6;
+    std::vector<double> rampa(lado * lado);
+    for (size_t lin = 0; lin < lado; lin++) {
+        for (size_t col = 0; col < lado; col++) {
+            rampa[lin * lado + col] = (col + lin) * 0.1;
+        }
+    }
+    // Com escala 10, cada diferença de 0.1 vira inclinação 1: normal (-1, 1, 1) / √3
+    const double esperado = 1.0 / std::sqrt(3.0);
+    for (size_t lin = 0; lin < lado; lin++) {
+        const double* linha = &rampa[lin * lado];
+        std::vector<float> normais(3 * lado);
+        calcularNormaisLinha(10.0, lin > 0 ? linha - lado : linha, linha, lin + 1 < lado ? linha + lado : linha,
+                             lado, 0, lado, normais.data());
+        // Também na primeira e na última linha e coluna (diferença de um lado só)
+        for (size_t col = 0; col < lado; col++) {
+            CHECK(normais[3 * col] == doctest::Approx(-esperado));
+            CHECK(normais[3 * col + 1] == doctest::Approx(esperado));
+            CHECK(normais[3 * col + 2] == doctest::Approx(esperado));
+        }
+    }
+
+    // O inverso da norma é raiz e divisão IEEE em todos os níveis (nada de estimativa rsqrt,
+    // que muda de uma CPU para outra): nz sai bit a bit igual à conta direta
+    std::vector<double> ondulado(3 * 16);
+    for (size_t i = 0; i < ondulado.size(); i++) {
+        ondulado[i] = std::sin(i * 0.7) * 0.3;
+    }
+    for (int nivel = SIMD_ESCALAR; nivel <= obterNivelSimd(); nivel++) {
+        std::vector<float> normais(3 * 16);
+        calcularNormaisLinha(7.0, &ondulado[0], &ondulado[16], &ondulado[32], 16, 0, 16, normais.data(),
+                             static_cast<NivelSimd>(nivel));
+        bool exatas = true;
+        for (size_t col = 1; col < 15; col++) {
+            float gx = static_cast<float>((ondulado[16 + col + 1] - ondulado[16 + col - 1]) * 3.5);
+            float gy = static_cast<float>((ondulado[32 + col] - ondulado[col]) * 3.5);
+            exatas = exatas && normais[3 * col + 2] == 1.0f / std::sqrt(1.0f + gx * gx + gy * gy);
+        }
+        CHECK(exatas);
+    }
+
+    // Plano: (0, 0, 1) → (128, 128, 255)
+    std::vector<double> plano(3 * lado, 0.4);
+    Pixel p;
+    renderizarNormaisLinha(10.0, &plano[0], &plano[lado], &plano[2 * lado], lado, 3, 4, &p);
+    CHECK(p.r == 128);
+    CHECK(p.g == 128);
+    CHECK(p.b == 255);
+}